@@ -0,0 +1,69 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_EXPERIMENTAL_MICROFRONTEND_LIB_ALLOCATOR_H_
+#define TENSORFLOW_LITE_EXPERIMENTAL_MICROFRONTEND_LIB_ALLOCATOR_H_
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Supplies the buffers of a state to the *PopulateStateWithAllocator()
+// functions, e.g. from an interpreter's persistent arena. Memory from an
+// allocator is never freed by the frontend, so the *FreeStateContents()
+// functions must not be called on such a state.
+struct FrontendAllocator {
+  // Returns size bytes that stay valid for the lifetime of the state, or NULL.
+  void* (*allocate)(void* context, size_t size);
+  void* context;
+};
+
+// Allocates from allocator, or with malloc() if allocator is NULL.
+static inline void* FrontendAllocate(const struct FrontendAllocator* allocator,
+                                     size_t size) {
+  if (allocator == NULL) {
+    return malloc(size);
+  }
+  return allocator->allocate(allocator->context, size);
+}
+
+// Like FrontendAllocate(), but for zeroed memory, as calloc() returns.
+static inline void* FrontendAllocateZeroed(
+    const struct FrontendAllocator* allocator, size_t count, size_t size) {
+  if (allocator == NULL) {
+    return calloc(count, size);
+  }
+  void* buffer = allocator->allocate(allocator->context, count * size);
+  if (buffer != NULL) {
+    memset(buffer, 0, count * size);
+  }
+  return buffer;
+}
+
+// Frees memory from FrontendAllocate() if it came from the heap.
+static inline void FrontendRelease(const struct FrontendAllocator* allocator,
+                                   void* buffer) {
+  if (allocator == NULL) {
+    free(buffer);
+  }
+}
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // TENSORFLOW_LITE_EXPERIMENTAL_MICROFRONTEND_LIB_ALLOCATOR_H_
@@ -23,6 +23,12 @@ void FftCompute(struct FftState* state, const int16_t* input,
   const size_t input_size = state->input_size;
   const size_t fft_size = state->fft_size;
 
+  if (state->use_radix4) {
+    FftRadix4Compute(&state->radix4, input, input_size, input_scale_shift,
+                     state->output);
+    return;
+  }
+
   int16_t* fft_input = state->input;
   // First, scale the input by the given shift.
   size_t i;
@@ -43,7 +49,12 @@ void FftCompute(struct FftState* state, const int16_t* input,
 }
 
 void FftInit(struct FftState* state) {
-  // All the initialization is done in FftPopulateState()
+  // The buffers are set up by FftPopulateState(), but the kissfft
+  // configuration holds pointers into scratch, so it is (re)built here for
+  // wherever scratch currently lives.
+  size_t scratch_size = state->scratch_size;
+  kissfft_fixed16::kiss_fftr_alloc(state->fft_size, 0, state->scratch,
+                                   &scratch_size);
 }
 
 void FftReset(struct FftState* state) {
@@ -18,6 +18,8 @@ limitations under the License.
 #include <stdint.h>
 #include <stdlib.h>
 
+#include "tensorflow/lite/experimental/microfrontend/lib/fft_radix4.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -34,11 +36,17 @@ struct FftState {
   size_t input_size;
   void* scratch;
   size_t scratch_size;
+  // When non-zero, FftCompute uses the radix-4 implementation instead of
+  // kissfft. Set up by FftPopulateState for the sizes it supports.
+  int use_radix4;
+  struct FftRadix4State radix4;
 };
 
 void FftCompute(struct FftState* state, const int16_t* input,
                 int input_scale_shift);
 
+// Configures kissfft inside state->scratch. Must be called again whenever the
+// scratch contents are moved to a different buffer.
 void FftInit(struct FftState* state);
 
 void FftReset(struct FftState* state);
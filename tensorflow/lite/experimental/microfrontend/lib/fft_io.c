@@ -30,4 +30,6 @@ void FftWriteMemmap(FILE* fp, const struct FftState* state,
   fprintf(fp, "%s->input_size = %zu;\n", variable, state->input_size);
   fprintf(fp, "%s->scratch = fft_scratch;\n", variable);
   fprintf(fp, "%s->scratch_size = %zu;\n", variable, state->scratch_size);
+  // The memmapped state only carries the kissfft tables.
+  fprintf(fp, "%s->use_radix4 = 0;\n", variable);
 }
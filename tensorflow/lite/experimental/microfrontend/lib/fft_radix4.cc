@@ -0,0 +1,237 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/experimental/microfrontend/lib/fft_radix4.h"
+
+#include "tensorflow/lite/experimental/microfrontend/lib/fft.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// The helpers below reproduce the FIXED_POINT == 16 arithmetic of kissfft
+// (sround, C_FIXDIV, C_MUL, ...) including the truncation to int16 whenever
+// kissfft stores an intermediate value in a kiss_fft_cpx.
+
+inline int16_t RoundQ15(int32_t x) {
+  return static_cast<int16_t>((x + (1 << 14)) >> 15);
+}
+
+inline int16_t FixDiv(int16_t x, int divisor) {
+  return RoundQ15(static_cast<int32_t>(x) * (32767 / divisor));
+}
+
+inline complex_int16_t FixDiv(complex_int16_t x, int divisor) {
+  return {FixDiv(x.real, divisor), FixDiv(x.imag, divisor)};
+}
+
+inline complex_int16_t Mul(complex_int16_t a, complex_int16_t b) {
+  const int32_t real = static_cast<int32_t>(a.real) * b.real -
+                       static_cast<int32_t>(a.imag) * b.imag;
+  const int32_t imag = static_cast<int32_t>(a.real) * b.imag +
+                       static_cast<int32_t>(a.imag) * b.real;
+  return {RoundQ15(real), RoundQ15(imag)};
+}
+
+inline complex_int16_t Add(complex_int16_t a, complex_int16_t b) {
+  return {static_cast<int16_t>(a.real + b.real),
+          static_cast<int16_t>(a.imag + b.imag)};
+}
+
+inline complex_int16_t Sub(complex_int16_t a, complex_int16_t b) {
+  return {static_cast<int16_t>(a.real - b.real),
+          static_cast<int16_t>(a.imag - b.imag)};
+}
+
+// Radix-4 decimation in time butterflies over one group of 4 * m entries,
+// starting at butterfly k. Equivalent to kissfft's kf_bfly4.
+void Butterfly4(complex_int16_t* data, const complex_int16_t* twiddles,
+                int m, int k) {
+  const complex_int16_t* twiddles1 = twiddles;
+  const complex_int16_t* twiddles2 = twiddles + m;
+  const complex_int16_t* twiddles3 = twiddles + 2 * m;
+  for (; k < m; ++k) {
+    const complex_int16_t a0 = FixDiv(data[k], 4);
+    const complex_int16_t a1 = FixDiv(data[k + m], 4);
+    const complex_int16_t a2 = FixDiv(data[k + 2 * m], 4);
+    const complex_int16_t a3 = FixDiv(data[k + 3 * m], 4);
+
+    const complex_int16_t s0 = Mul(a1, twiddles1[k]);
+    const complex_int16_t s1 = Mul(a2, twiddles2[k]);
+    const complex_int16_t s2 = Mul(a3, twiddles3[k]);
+    const complex_int16_t s5 = Sub(a0, s1);
+    const complex_int16_t a0_s1 = Add(a0, s1);
+    const complex_int16_t s3 = Add(s0, s2);
+    const complex_int16_t s4 = Sub(s0, s2);
+
+    data[k + 2 * m] = Sub(a0_s1, s3);
+    data[k] = Add(a0_s1, s3);
+    data[k + m].real = static_cast<int16_t>(s5.real + s4.imag);
+    data[k + m].imag = static_cast<int16_t>(s5.imag - s4.real);
+    data[k + 3 * m].real = static_cast<int16_t>(s5.real - s4.imag);
+    data[k + 3 * m].imag = static_cast<int16_t>(s5.imag + s4.real);
+  }
+}
+
+#if defined(__SSE2__)
+
+// Rounds the Q15 products of four complex values and packs them back into
+// interleaved (real, imag) int16 pairs, truncating like the scalar code.
+inline __m128i RoundQ15Complex(__m128i real, __m128i imag) {
+  const __m128i round = _mm_set1_epi32(1 << 14);
+  real = _mm_srai_epi32(_mm_add_epi32(real, round), 15);
+  imag = _mm_srai_epi32(_mm_add_epi32(imag, round), 15);
+  return _mm_or_si128(_mm_and_si128(real, _mm_set1_epi32(0xFFFF)),
+                      _mm_slli_epi32(imag, 16));
+}
+
+inline __m128i FixDiv4(__m128i x) {
+  const __m128i real_scale = _mm_set1_epi32(32767 / 4);
+  const __m128i imag_scale = _mm_set1_epi32((32767 / 4) << 16);
+  return RoundQ15Complex(_mm_madd_epi16(x, real_scale),
+                         _mm_madd_epi16(x, imag_scale));
+}
+
+inline __m128i Mul(__m128i a, __m128i w) {
+  // (w.real, -w.imag) and (w.imag, w.real) pairs for the two dot products.
+  const __m128i imag_mask = _mm_set1_epi32(static_cast<int>(0xFFFF0000));
+  const __m128i w_conj = _mm_sub_epi16(_mm_xor_si128(w, imag_mask), imag_mask);
+  const __m128i w_swap = _mm_shufflehi_epi16(
+      _mm_shufflelo_epi16(w, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+  return RoundQ15Complex(_mm_madd_epi16(a, w_conj), _mm_madd_epi16(a, w_swap));
+}
+
+// Same as the scalar Butterfly4, four butterflies at a time. m must be a
+// multiple of 4.
+void Butterfly4Sse2(complex_int16_t* data, const complex_int16_t* twiddles,
+                    int m) {
+  const __m128i real_mask = _mm_set1_epi32(0xFFFF);
+  __m128i* data0 = reinterpret_cast<__m128i*>(data);
+  __m128i* data1 = reinterpret_cast<__m128i*>(data + m);
+  __m128i* data2 = reinterpret_cast<__m128i*>(data + 2 * m);
+  __m128i* data3 = reinterpret_cast<__m128i*>(data + 3 * m);
+  const __m128i* twiddles1 = reinterpret_cast<const __m128i*>(twiddles);
+  const __m128i* twiddles2 = reinterpret_cast<const __m128i*>(twiddles + m);
+  const __m128i* twiddles3 =
+      reinterpret_cast<const __m128i*>(twiddles + 2 * m);
+  for (int i = 0; i < m / 4; ++i) {
+    const __m128i a0 = FixDiv4(_mm_loadu_si128(data0 + i));
+    const __m128i a1 = FixDiv4(_mm_loadu_si128(data1 + i));
+    const __m128i a2 = FixDiv4(_mm_loadu_si128(data2 + i));
+    const __m128i a3 = FixDiv4(_mm_loadu_si128(data3 + i));
+
+    const __m128i s0 = Mul(a1, _mm_loadu_si128(twiddles1 + i));
+    const __m128i s1 = Mul(a2, _mm_loadu_si128(twiddles2 + i));
+    const __m128i s2 = Mul(a3, _mm_loadu_si128(twiddles3 + i));
+    const __m128i s5 = _mm_sub_epi16(a0, s1);
+    const __m128i a0_s1 = _mm_add_epi16(a0, s1);
+    const __m128i s3 = _mm_add_epi16(s0, s2);
+    const __m128i s4 = _mm_sub_epi16(s0, s2);
+
+    // (s4.imag, s4.real) pairs, added to and subtracted from s5.
+    const __m128i s4_swap = _mm_shufflehi_epi16(
+        _mm_shufflelo_epi16(s4, _MM_SHUFFLE(2, 3, 0, 1)),
+        _MM_SHUFFLE(2, 3, 0, 1));
+    const __m128i sum = _mm_add_epi16(s5, s4_swap);
+    const __m128i diff = _mm_sub_epi16(s5, s4_swap);
+
+    _mm_storeu_si128(data2 + i, _mm_sub_epi16(a0_s1, s3));
+    _mm_storeu_si128(data0 + i, _mm_add_epi16(a0_s1, s3));
+    _mm_storeu_si128(data1 + i, _mm_or_si128(_mm_and_si128(sum, real_mask),
+                                             _mm_andnot_si128(real_mask, diff)));
+    _mm_storeu_si128(data3 + i, _mm_or_si128(_mm_and_si128(diff, real_mask),
+                                             _mm_andnot_si128(real_mask, sum)));
+  }
+}
+
+#endif  // defined(__SSE2__)
+
+}  // namespace
+
+int FftRadix4IsSupported(size_t fft_size) {
+  // The input permutation is stored as uint16_t indices.
+  size_t complex_size = fft_size / 2;
+  if (fft_size % 2 != 0 || complex_size < 4 || complex_size > 16384) {
+    return 0;
+  }
+  while (complex_size % 4 == 0) {
+    complex_size /= 4;
+  }
+  return complex_size == 1;
+}
+
+void FftRadix4Compute(const struct FftRadix4State* state, const int16_t* input,
+                      size_t input_size, int input_scale_shift,
+                      struct complex_int16_t* output) {
+  const int complex_size = state->fft_size / 2;
+  complex_int16_t* data = state->work;
+
+  // Scale, zero pad and reorder the input in a single pass. Pairs of real
+  // samples are treated as one complex value, as kiss_fftr does.
+  for (int i = 0; i < complex_size; ++i) {
+    const size_t sample = 2 * static_cast<size_t>(state->input_index[i]);
+    data[i].real =
+        sample < input_size
+            ? static_cast<int16_t>(static_cast<uint16_t>(input[sample])
+                                   << input_scale_shift)
+            : 0;
+    data[i].imag =
+        sample + 1 < input_size
+            ? static_cast<int16_t>(static_cast<uint16_t>(input[sample + 1])
+                                   << input_scale_shift)
+            : 0;
+  }
+
+  const complex_int16_t* twiddles = state->twiddles;
+  int m = 1;
+  for (int stage = 0; stage < state->num_stages; ++stage) {
+    for (int group = 0; group < complex_size; group += 4 * m) {
+#if defined(__SSE2__)
+      if (m % 4 == 0) {
+        Butterfly4Sse2(data + group, twiddles, m);
+        continue;
+      }
+#endif
+      Butterfly4(data + group, twiddles, m, 0);
+    }
+    twiddles += 3 * m;
+    m *= 4;
+  }
+
+  // Split the complex FFT of the even/odd samples into the real spectrum.
+  // Equivalent to the second half of kiss_fftr.
+  const complex_int16_t dc = FixDiv(data[0], 2);
+  output[0].real = static_cast<int16_t>(dc.real + dc.imag);
+  output[0].imag = 0;
+  output[complex_size].real = static_cast<int16_t>(dc.real - dc.imag);
+  output[complex_size].imag = 0;
+  for (int k = 1; k <= complex_size / 2; ++k) {
+    const complex_int16_t fpk = FixDiv(data[k], 2);
+    complex_int16_t fpnk = data[complex_size - k];
+    fpnk.imag = static_cast<int16_t>(-fpnk.imag);
+    fpnk = FixDiv(fpnk, 2);
+
+    const complex_int16_t f1k = Add(fpk, fpnk);
+    const complex_int16_t f2k = Sub(fpk, fpnk);
+    const complex_int16_t tw = Mul(f2k, state->super_twiddles[k - 1]);
+    output[k].real = static_cast<int16_t>((f1k.real + tw.real) >> 1);
+    output[k].imag = static_cast<int16_t>((f1k.imag + tw.imag) >> 1);
+    output[complex_size - k].real =
+        static_cast<int16_t>((f1k.real - tw.real) >> 1);
+    output[complex_size - k].imag =
+        static_cast<int16_t>((tw.imag - f1k.imag) >> 1);
+  }
+}
@@ -0,0 +1,63 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_EXPERIMENTAL_MICROFRONTEND_LIB_FFT_RADIX4_H_
+#define TENSORFLOW_LITE_EXPERIMENTAL_MICROFRONTEND_LIB_FFT_RADIX4_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct complex_int16_t;
+
+// Real FFT for sizes where the underlying complex FFT has a power of four
+// length (fft_size = 2 * 4^k, e.g. 32, 128, 512 or 2048). The output is
+// bit-exact with the kissfft int16 real FFT used by FftCompute: the same
+// radix-4 butterflies and fixed-point rounding are applied, but iteratively
+// over precomputed per-stage twiddle tables instead of through kissfft's
+// recursion. On hosts with SSE2 the butterflies are vectorized.
+struct FftRadix4State {
+  size_t fft_size;
+  // Number of radix-4 stages, log4(fft_size / 2).
+  int num_stages;
+  // For each complex input position, the index of the complex sample that is
+  // loaded into it (the base-4 digit reversal of the position).
+  uint16_t* input_index;
+  // Per-stage twiddles, stored stage after stage. A stage with m butterflies
+  // per group holds m twiddles for each of its three non-trivial legs.
+  struct complex_int16_t* twiddles;
+  // Twiddles used to split the complex FFT output into the real spectrum.
+  struct complex_int16_t* super_twiddles;
+  // Complex FFT work buffer of fft_size / 2 entries.
+  struct complex_int16_t* work;
+};
+
+// Returns 1 if fft_size can be computed by FftRadix4Compute.
+int FftRadix4IsSupported(size_t fft_size);
+
+// Computes the fft_size / 2 + 1 bins of the real FFT of the first input_size
+// samples of input, each shifted left by input_scale_shift, zero padded to
+// fft_size. This matches FftCompute for the same inputs.
+void FftRadix4Compute(const struct FftRadix4State* state, const int16_t* input,
+                      size_t input_size, int input_scale_shift,
+                      struct complex_int16_t* output);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // TENSORFLOW_LITE_EXPERIMENTAL_MICROFRONTEND_LIB_FFT_RADIX4_H_
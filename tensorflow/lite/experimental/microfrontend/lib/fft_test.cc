@@ -24,6 +24,16 @@ const int16_t kFakeWindow[] = {
     0, -28328, 0, 21447, 0, -13312, 0, 5943,   0, -1152, 0};
 const int kScaleShift = 0;
 
+// Fills input with a deterministic full scale pattern.
+void FillTestInput(int16_t* input, size_t size) {
+  uint32_t seed = 12345;
+  size_t i;
+  for (i = 0; i < size; ++i) {
+    seed = seed * 1103515245 + 12345;
+    input[i] = static_cast<int16_t>(seed >> 16);
+  }
+}
+
 }  // namespace
 
 TF_LITE_MICRO_TESTS_BEGIN
@@ -51,4 +61,51 @@ TF_LITE_MICRO_TEST(FftTest_CheckOutputValues) {
   FftFreeStateContents(&state);
 }
 
+TF_LITE_MICRO_TEST(FftTest_CheckRadix4MatchesKissFft) {
+  const size_t kInputSizes[] = {25, 100, 480, 2048};
+  const int kShifts[] = {0, 3};
+  int16_t input[2048];
+  FillTestInput(input, sizeof(input) / sizeof(input[0]));
+
+  unsigned int size_index;
+  for (size_index = 0;
+       size_index < sizeof(kInputSizes) / sizeof(kInputSizes[0]);
+       ++size_index) {
+    struct FftState state;
+    TF_LITE_MICRO_EXPECT(FftPopulateState(&state, kInputSizes[size_index]));
+    TF_LITE_MICRO_EXPECT_EQ(state.use_radix4, 1);
+    FftInit(&state);
+
+    const size_t output_size = state.fft_size / 2 + 1;
+    struct complex_int16_t kiss_output[1025];
+    unsigned int shift_index;
+    for (shift_index = 0; shift_index < sizeof(kShifts) / sizeof(kShifts[0]);
+         ++shift_index) {
+      state.use_radix4 = 0;
+      FftCompute(&state, input, kShifts[shift_index]);
+      unsigned int i;
+      for (i = 0; i < output_size; ++i) {
+        kiss_output[i] = state.output[i];
+      }
+
+      state.use_radix4 = 1;
+      FftCompute(&state, input, kShifts[shift_index]);
+      for (i = 0; i < output_size; ++i) {
+        TF_LITE_MICRO_EXPECT_EQ(state.output[i].real, kiss_output[i].real);
+        TF_LITE_MICRO_EXPECT_EQ(state.output[i].imag, kiss_output[i].imag);
+      }
+    }
+
+    FftFreeStateContents(&state);
+  }
+}
+
+TF_LITE_MICRO_TEST(FftTest_CheckRadix4IsSupported) {
+  TF_LITE_MICRO_EXPECT(FftRadix4IsSupported(32));
+  TF_LITE_MICRO_EXPECT(FftRadix4IsSupported(512));
+  TF_LITE_MICRO_EXPECT(!FftRadix4IsSupported(64));
+  TF_LITE_MICRO_EXPECT(!FftRadix4IsSupported(256));
+  TF_LITE_MICRO_EXPECT(!FftRadix4IsSupported(4));
+}
+
 TF_LITE_MICRO_TESTS_END
@@ -15,24 +15,43 @@ limitations under the License.
 #include "tensorflow/lite/experimental/microfrontend/lib/fft_util.h"
 #include "tensorflow/lite/experimental/microfrontend/lib/kiss_fft_int16.h"
 
+#include <math.h>
 #include <stdio.h>
 
+namespace {
+
+// Same rounding as kissfft's fixed point kf_cexp.
+complex_int16_t Int16Cexp(double phase) {
+  complex_int16_t result;
+  result.real = static_cast<int16_t>(floor(.5 + 32767 * cos(phase)));
+  result.imag = static_cast<int16_t>(floor(.5 + 32767 * sin(phase)));
+  return result;
+}
+
+}  // namespace
+
 int FftPopulateState(struct FftState* state, size_t input_size) {
+  return FftPopulateStateWithAllocator(state, input_size, nullptr);
+}
+
+int FftPopulateStateWithAllocator(struct FftState* state, size_t input_size,
+                                  const struct FrontendAllocator* allocator) {
   state->input_size = input_size;
+  state->use_radix4 = 0;
   state->fft_size = 1;
   while (state->fft_size < state->input_size) {
     state->fft_size <<= 1;
   }
 
   state->input = reinterpret_cast<int16_t*>(
-      malloc(state->fft_size * sizeof(*state->input)));
+      FrontendAllocate(allocator, state->fft_size * sizeof(*state->input)));
   if (state->input == nullptr) {
     fprintf(stderr, "Failed to alloc fft input buffer\n");
     return 0;
   }
 
-  state->output = reinterpret_cast<complex_int16_t*>(
-      malloc((state->fft_size / 2 + 1) * sizeof(*state->output) * 2));
+  state->output = reinterpret_cast<complex_int16_t*>(FrontendAllocate(
+      allocator, (state->fft_size / 2 + 1) * sizeof(*state->output) * 2));
   if (state->output == nullptr) {
     fprintf(stderr, "Failed to alloc fft output buffer\n");
     return 0;
@@ -46,7 +65,7 @@ int FftPopulateState(struct FftState* state, size_t input_size) {
     fprintf(stderr, "Kiss memory sizing failed.\n");
     return 0;
   }
-  state->scratch = malloc(scratch_size);
+  state->scratch = FrontendAllocate(allocator, scratch_size);
   if (state->scratch == nullptr) {
     fprintf(stderr, "Failed to alloc fft scratch buffer\n");
     return 0;
@@ -59,6 +78,14 @@ int FftPopulateState(struct FftState* state, size_t input_size) {
     fprintf(stderr, "Kiss memory preallocation strategy failed.\n");
     return 0;
   }
+
+  if (FftRadix4IsSupported(state->fft_size)) {
+    if (!FftRadix4PopulateStateWithAllocator(&state->radix4, state->fft_size,
+                                             allocator)) {
+      return 0;
+    }
+    state->use_radix4 = 1;
+  }
   return 1;
 }
 
@@ -66,4 +93,98 @@ void FftFreeStateContents(struct FftState* state) {
   free(state->input);
   free(state->output);
   free(state->scratch);
+  if (state->use_radix4) {
+    FftRadix4FreeStateContents(&state->radix4);
+  }
+}
+
+int FftRadix4PopulateState(struct FftRadix4State* state, size_t fft_size) {
+  return FftRadix4PopulateStateWithAllocator(state, fft_size, nullptr);
+}
+
+int FftRadix4PopulateStateWithAllocator(
+    struct FftRadix4State* state, size_t fft_size,
+    const struct FrontendAllocator* allocator) {
+  if (!FftRadix4IsSupported(fft_size)) {
+    fprintf(stderr, "Radix-4 fft does not support size %zu\n", fft_size);
+    return 0;
+  }
+  const int complex_size = fft_size / 2;
+  state->fft_size = fft_size;
+  state->num_stages = 0;
+  while ((1 << (2 * state->num_stages)) < complex_size) {
+    ++state->num_stages;
+  }
+
+  // Each stage with m butterflies per group uses 3 * m twiddles, and m goes
+  // 1, 4, ..., complex_size / 4.
+  const int num_twiddles = complex_size - 1;
+  state->input_index = reinterpret_cast<uint16_t*>(FrontendAllocate(
+      allocator, complex_size * sizeof(*state->input_index)));
+  state->twiddles = reinterpret_cast<complex_int16_t*>(FrontendAllocate(
+      allocator, num_twiddles * sizeof(*state->twiddles)));
+  state->super_twiddles = reinterpret_cast<complex_int16_t*>(FrontendAllocate(
+      allocator, complex_size / 2 * sizeof(*state->super_twiddles)));
+  state->work = reinterpret_cast<complex_int16_t*>(
+      FrontendAllocate(allocator, complex_size * sizeof(*state->work)));
+  if (state->input_index == nullptr || state->twiddles == nullptr ||
+      state->super_twiddles == nullptr || state->work == nullptr) {
+    fprintf(stderr, "Failed to alloc radix-4 fft buffers\n");
+    // Don't leak the tables that were allocated, and leave nothing behind for
+    // FftRadix4FreeStateContents to free twice.
+    FrontendRelease(allocator, state->input_index);
+    FrontendRelease(allocator, state->twiddles);
+    FrontendRelease(allocator, state->super_twiddles);
+    FrontendRelease(allocator, state->work);
+    state->input_index = nullptr;
+    state->twiddles = nullptr;
+    state->super_twiddles = nullptr;
+    state->work = nullptr;
+    return 0;
+  }
+
+  // kissfft loads its input in base-4 digit reversed order.
+  int i;
+  for (i = 0; i < complex_size; ++i) {
+    int index = 0;
+    int remaining = i;
+    int stage;
+    for (stage = 0; stage < state->num_stages; ++stage) {
+      index = (index << 2) | (remaining & 3);
+      remaining >>= 2;
+    }
+    state->input_index[i] = index;
+  }
+
+  // These match the phases (and the value of pi) used by kiss_fft_alloc and
+  // kiss_fftr_alloc, so that the rounded twiddles are identical.
+  const double pi = 3.141592653589793238462643383279502884197169399375105820974944;
+  complex_int16_t* twiddles = state->twiddles;
+  int m;
+  for (m = 1; m < complex_size; m *= 4) {
+    const int stride = complex_size / (4 * m);
+    int leg;
+    for (leg = 1; leg <= 3; ++leg) {
+      int k;
+      for (k = 0; k < m; ++k) {
+        const double phase = -2 * pi * (leg * k * stride) / complex_size;
+        *twiddles++ = Int16Cexp(phase);
+      }
+    }
+  }
+
+  const double super_pi = 3.14159265358979323846264338327;
+  for (i = 0; i < complex_size / 2; ++i) {
+    const double phase =
+        -super_pi * (static_cast<double>(i + 1) / complex_size + .5);
+    state->super_twiddles[i] = Int16Cexp(phase);
+  }
+  return 1;
+}
+
+void FftRadix4FreeStateContents(struct FftRadix4State* state) {
+  free(state->input_index);
+  free(state->twiddles);
+  free(state->super_twiddles);
+  free(state->work);
 }
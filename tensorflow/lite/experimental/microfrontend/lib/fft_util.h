@@ -15,6 +15,7 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_EXPERIMENTAL_MICROFRONTEND_LIB_FFT_UTIL_H_
 #define TENSORFLOW_LITE_EXPERIMENTAL_MICROFRONTEND_LIB_FFT_UTIL_H_
 
+#include "tensorflow/lite/experimental/microfrontend/lib/allocator.h"
 #include "tensorflow/lite/experimental/microfrontend/lib/fft.h"
 
 #ifdef __cplusplus
@@ -24,9 +25,25 @@ extern "C" {
 // Prepares and FFT for the given input size.
 int FftPopulateState(struct FftState* state, size_t input_size);
 
+// Like FftPopulateState(), with the buffers from allocator.
+int FftPopulateStateWithAllocator(struct FftState* state, size_t input_size,
+                                  const struct FrontendAllocator* allocator);
+
 // Frees any allocated buffers.
 void FftFreeStateContents(struct FftState* state);
 
+// Prepares the radix-4 tables for the given fft size, which must satisfy
+// FftRadix4IsSupported.
+int FftRadix4PopulateState(struct FftRadix4State* state, size_t fft_size);
+
+// Like FftRadix4PopulateState(), with the buffers from allocator.
+int FftRadix4PopulateStateWithAllocator(
+    struct FftRadix4State* state, size_t fft_size,
+    const struct FrontendAllocator* allocator);
+
+// Frees any allocated radix-4 buffers.
+void FftRadix4FreeStateContents(struct FftRadix4State* state);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -63,6 +63,49 @@ void FilterbankAccumulateChannels(struct FilterbankState* state,
   }
 }
 
+void FilterbankAccumulateFftChannels(struct FilterbankState* state,
+                                     const struct complex_int16_t* fft_output) {
+  uint64_t* work = state->work;
+  uint64_t weight_accumulator = 0;
+  uint64_t unweight_accumulator = 0;
+
+  const int16_t* channel_frequency_starts = state->channel_frequency_starts;
+  const int16_t* channel_weight_starts = state->channel_weight_starts;
+  const int16_t* channel_widths = state->channel_widths;
+  const int start_index = state->start_index;
+  const int end_index = state->end_index;
+
+  int num_channels_plus_1 = state->num_channels + 1;
+  int i;
+  for (i = 0; i < num_channels_plus_1; ++i) {
+    const int frequency_start = *channel_frequency_starts++;
+    const int weight_start = *channel_weight_starts++;
+    const int width = *channel_widths++;
+    // Weights outside of [start_index, end_index) are padding and always zero.
+    const int begin = frequency_start > start_index ? frequency_start
+                                                    : start_index;
+    const int end = frequency_start + width < end_index
+                        ? frequency_start + width
+                        : end_index;
+    const int16_t* weights = state->weights + weight_start;
+    const int16_t* unweights = state->unweights + weight_start;
+    int j;
+    for (j = begin; j < end; ++j) {
+      const int offset = j - frequency_start;
+      const int32_t real = fft_output[j].real;
+      const int32_t imag = fft_output[j].imag;
+      // Wraps like the int32_t energy buffer of the two pass version.
+      const int32_t energy =
+          (int32_t)((uint32_t)(real * real) + (uint32_t)(imag * imag));
+      weight_accumulator += weights[offset] * ((uint64_t)energy);
+      unweight_accumulator += unweights[offset] * ((uint64_t)energy);
+    }
+    *work++ = weight_accumulator;
+    weight_accumulator = unweight_accumulator;
+    unweight_accumulator = 0;
+  }
+}
+
 static uint16_t Sqrt32(uint32_t num) {
   if (num == 0) {
     return 0;
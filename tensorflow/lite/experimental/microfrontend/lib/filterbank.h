@@ -49,6 +49,13 @@ void FilterbankConvertFftComplexToEnergy(struct FilterbankState* state,
 void FilterbankAccumulateChannels(struct FilterbankState* state,
                                   const int32_t* energy);
 
+// Same as FilterbankConvertFftComplexToEnergy followed by
+// FilterbankAccumulateChannels, but computes each energy value as it is
+// accumulated and skips the bins that only carry zero padding weights. The
+// result is identical and the FFT output is left untouched.
+void FilterbankAccumulateFftChannels(struct FilterbankState* state,
+                                     const struct complex_int16_t* fft_output);
+
 // Applies an integer square root to the 64 bit intermediate values of the
 // filterbank, and returns a pointer to them. Memory will be invalidated the
 // next time FilterbankAccumulateChannels is called.
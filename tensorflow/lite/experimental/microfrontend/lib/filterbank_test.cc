@@ -196,6 +196,28 @@ TF_LITE_MICRO_TEST(FilterbankTest_CheckAccumulateChannels) {
   FilterbankFreeStateContents(&state);
 }
 
+TF_LITE_MICRO_TEST(FilterbankTest_CheckAccumulateFftChannels) {
+  FilterbankTestConfig config;
+  struct FilterbankState state;
+  TF_LITE_MICRO_EXPECT(FilterbankPopulateState(&config.config_, &state,
+                                               kSampleRate, kSpectrumSize));
+
+  const struct complex_int16_t fake_fft[] = {
+      {0, 0},    {-10, 9},     {-20, 0},   {-9, -10},     {0, 25},  {-119, 119},
+      {-887, 0}, {3000, 3000}, {0, -6401}, {-3000, 3000}, {886, 0}, {118, 119},
+      {0, 25},   {9, -10},     {19, 0},    {9, 9},        {0, 0}};
+  FilterbankAccumulateFftChannels(&state, fake_fft);
+
+  TF_LITE_MICRO_EXPECT_EQ(state.num_channels + 1,
+                          sizeof(kWork) / sizeof(kWork[0]));
+  int i;
+  for (i = 0; i <= state.num_channels; ++i) {
+    TF_LITE_MICRO_EXPECT_EQ(state.work[i], kWork[i]);
+  }
+
+  FilterbankFreeStateContents(&state);
+}
+
 TF_LITE_MICRO_TEST(FilterbankTest_CheckSqrt) {
   FilterbankTestConfig config;
   struct FilterbankState state;
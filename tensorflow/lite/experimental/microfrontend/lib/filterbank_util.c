@@ -56,6 +56,14 @@ static void QuantizeFilterbankWeights(const float float_weight, int16_t* weight,
 int FilterbankPopulateState(const struct FilterbankConfig* config,
                             struct FilterbankState* state, int sample_rate,
                             int spectrum_size) {
+  return FilterbankPopulateStateWithAllocator(config, state, sample_rate,
+                                              spectrum_size, NULL);
+}
+
+int FilterbankPopulateStateWithAllocator(
+    const struct FilterbankConfig* config, struct FilterbankState* state,
+    int sample_rate, int spectrum_size,
+    const struct FrontendAllocator* allocator) {
   state->num_channels = config->num_channels;
   const int num_channels_plus_1 = config->num_channels + 1;
 
@@ -65,28 +73,30 @@ int FilterbankPopulateState(const struct FilterbankConfig* config,
            ? 1
            : kFilterbankIndexAlignment / sizeof(int16_t));
 
-  state->channel_frequency_starts =
-      malloc(num_channels_plus_1 * sizeof(*state->channel_frequency_starts));
-  state->channel_weight_starts =
-      malloc(num_channels_plus_1 * sizeof(*state->channel_weight_starts));
-  state->channel_widths =
-      malloc(num_channels_plus_1 * sizeof(*state->channel_widths));
-  state->work = malloc(num_channels_plus_1 * sizeof(*state->work));
-
-  float* center_mel_freqs =
-      malloc(num_channels_plus_1 * sizeof(*center_mel_freqs));
-  int16_t* actual_channel_starts =
-      malloc(num_channels_plus_1 * sizeof(*actual_channel_starts));
-  int16_t* actual_channel_widths =
-      malloc(num_channels_plus_1 * sizeof(*actual_channel_widths));
+  state->channel_frequency_starts = FrontendAllocate(
+      allocator,
+      num_channels_plus_1 * sizeof(*state->channel_frequency_starts));
+  state->channel_weight_starts = FrontendAllocate(
+      allocator, num_channels_plus_1 * sizeof(*state->channel_weight_starts));
+  state->channel_widths = FrontendAllocate(
+      allocator, num_channels_plus_1 * sizeof(*state->channel_widths));
+  state->work =
+      FrontendAllocate(allocator, num_channels_plus_1 * sizeof(*state->work));
+
+  float* center_mel_freqs = FrontendAllocate(
+      allocator, num_channels_plus_1 * sizeof(*center_mel_freqs));
+  int16_t* actual_channel_starts = FrontendAllocate(
+      allocator, num_channels_plus_1 * sizeof(*actual_channel_starts));
+  int16_t* actual_channel_widths = FrontendAllocate(
+      allocator, num_channels_plus_1 * sizeof(*actual_channel_widths));
 
   if (state->channel_frequency_starts == NULL ||
       state->channel_weight_starts == NULL || state->channel_widths == NULL ||
       center_mel_freqs == NULL || actual_channel_starts == NULL ||
       actual_channel_widths == NULL) {
-    free(center_mel_freqs);
-    free(actual_channel_starts);
-    free(actual_channel_widths);
+    FrontendRelease(allocator, center_mel_freqs);
+    FrontendRelease(allocator, actual_channel_starts);
+    FrontendRelease(allocator, actual_channel_widths);
     fprintf(stderr, "Failed to allocate channel buffers\n");
     return 0;
   }
@@ -160,14 +170,16 @@ int FilterbankPopulateState(const struct FilterbankConfig* config,
   // Allocate the two arrays to store the weights - weight_index_start contains
   // the index of what would be the next set of weights that we would need to
   // add, so that's how many weights we need to allocate.
-  state->weights = calloc(weight_index_start, sizeof(*state->weights));
-  state->unweights = calloc(weight_index_start, sizeof(*state->unweights));
+  state->weights = FrontendAllocateZeroed(allocator, weight_index_start,
+                                          sizeof(*state->weights));
+  state->unweights = FrontendAllocateZeroed(allocator, weight_index_start,
+                                            sizeof(*state->unweights));
 
   // If the alloc failed, we also need to nuke the arrays.
   if (state->weights == NULL || state->unweights == NULL) {
-    free(center_mel_freqs);
-    free(actual_channel_starts);
-    free(actual_channel_widths);
+    FrontendRelease(allocator, center_mel_freqs);
+    FrontendRelease(allocator, actual_channel_starts);
+    FrontendRelease(allocator, actual_channel_widths);
     fprintf(stderr, "Failed to allocate weights or unweights\n");
     return 0;
   }
@@ -200,9 +212,9 @@ int FilterbankPopulateState(const struct FilterbankConfig* config,
     }
   }
 
-  free(center_mel_freqs);
-  free(actual_channel_starts);
-  free(actual_channel_widths);
+  FrontendRelease(allocator, center_mel_freqs);
+  FrontendRelease(allocator, actual_channel_starts);
+  FrontendRelease(allocator, actual_channel_widths);
   if (state->end_index >= spectrum_size) {
     fprintf(stderr, "Filterbank end_index is above spectrum size.\n");
     return 0;
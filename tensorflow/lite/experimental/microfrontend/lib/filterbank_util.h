@@ -15,6 +15,7 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_EXPERIMENTAL_MICROFRONTEND_LIB_FILTERBANK_UTIL_H_
 #define TENSORFLOW_LITE_EXPERIMENTAL_MICROFRONTEND_LIB_FILTERBANK_UTIL_H_
 
+#include "tensorflow/lite/experimental/microfrontend/lib/allocator.h"
 #include "tensorflow/lite/experimental/microfrontend/lib/filterbank.h"
 
 #ifdef __cplusplus
@@ -40,6 +41,13 @@ int FilterbankPopulateState(const struct FilterbankConfig* config,
                             struct FilterbankState* state, int sample_rate,
                             int spectrum_size);
 
+// Like FilterbankPopulateState(), with the buffers from allocator. The
+// temporary tables used while computing the weights come from allocator too.
+int FilterbankPopulateStateWithAllocator(
+    const struct FilterbankConfig* config, struct FilterbankState* state,
+    int sample_rate, int spectrum_size,
+    const struct FrontendAllocator* allocator);
+
 // Frees any allocated buffers.
 void FilterbankFreeStateContents(struct FilterbankState* state);
 
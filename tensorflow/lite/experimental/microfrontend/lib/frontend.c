@@ -14,21 +14,13 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/lite/experimental/microfrontend/lib/frontend.h"
 
+#include <string.h>
+
 #include "tensorflow/lite/experimental/microfrontend/lib/bits.h"
 
-struct FrontendOutput FrontendProcessSamples(struct FrontendState* state,
-                                             const int16_t* samples,
-                                             size_t num_samples,
-                                             size_t* num_samples_read) {
+// Runs everything after the window on the current window output.
+static struct FrontendOutput ProcessWindowOutput(struct FrontendState* state) {
   struct FrontendOutput output;
-  output.values = NULL;
-  output.size = 0;
-
-  // Try to apply the window - if it fails, return and wait for more data.
-  if (!WindowProcessSamples(&state->window, samples, num_samples,
-                            num_samples_read)) {
-    return output;
-  }
 
   // Apply the FFT to the window's output (and scale it so that the fixed point
   // FFT can have as much resolution as possible).
@@ -36,13 +28,7 @@ struct FrontendOutput FrontendProcessSamples(struct FrontendState* state,
       15 - MostSignificantBit32(state->window.max_abs_output_value);
   FftCompute(&state->fft, state->window.output, input_shift);
 
-  // We can re-ruse the fft's output buffer to hold the energy.
-  int32_t* energy = (int32_t*)state->fft.output;
-
-  FilterbankConvertFftComplexToEnergy(&state->filterbank, state->fft.output,
-                                      energy);
-
-  FilterbankAccumulateChannels(&state->filterbank, energy);
+  FilterbankAccumulateFftChannels(&state->filterbank, state->fft.output);
   uint32_t* scaled_filterbank = FilterbankSqrt(&state->filterbank, input_shift);
 
   // Apply noise reduction.
@@ -64,6 +50,86 @@ struct FrontendOutput FrontendProcessSamples(struct FrontendState* state,
   return output;
 }
 
+struct FrontendOutput FrontendProcessSamples(struct FrontendState* state,
+                                             const int16_t* samples,
+                                             size_t num_samples,
+                                             size_t* num_samples_read) {
+  // Try to apply the window - if it fails, return and wait for more data.
+  if (!WindowProcessSamples(&state->window, samples, num_samples,
+                            num_samples_read)) {
+    struct FrontendOutput output;
+    output.values = NULL;
+    output.size = 0;
+    return output;
+  }
+  return ProcessWindowOutput(state);
+}
+
+size_t FrontendNumFrames(const struct FrontendState* state,
+                         size_t num_samples) {
+  const size_t available = state->window.input_used + num_samples;
+  if (available < state->window.size) {
+    return 0;
+  }
+  return 1 + (available - state->window.size) / state->window.step;
+}
+
+size_t FrontendProcessSamplesBatch(struct FrontendState* state,
+                                   const int16_t* samples, size_t num_samples,
+                                   uint16_t* output, size_t max_frames,
+                                   size_t* num_samples_read) {
+  struct WindowState* window = &state->window;
+  const size_t num_channels = state->filterbank.num_channels;
+  size_t num_frames = 0;
+  size_t consumed = 0;
+
+  // While the next window still overlaps samples buffered by earlier calls,
+  // go through the regular streaming path. Once output is full, samples are
+  // still buffered as long as they do not complete another window.
+  while (consumed < window->input_used && consumed < num_samples &&
+         (num_frames < max_frames ||
+          num_samples - consumed < window->size - window->input_used)) {
+    size_t read;
+    struct FrontendOutput frame = FrontendProcessSamples(
+        state, samples + consumed, num_samples - consumed, &read);
+    consumed += read;
+    if (frame.values != NULL) {
+      memcpy(output, frame.values, num_channels * sizeof(*output));
+      output += num_channels;
+      ++num_frames;
+    }
+  }
+
+  // From here on the buffered samples are the last input_used samples that
+  // were consumed, so every window can be read straight out of the caller's
+  // buffer instead of being copied and shifted through the window's input.
+  if (consumed >= window->input_used) {
+    size_t buffered = window->input_used;
+    while (num_frames < max_frames &&
+           num_samples - consumed >= window->size - buffered) {
+      consumed += window->size - buffered;
+      WindowApply(window, samples + consumed - window->size);
+      buffered = window->size - window->step;
+      struct FrontendOutput frame = ProcessWindowOutput(state);
+      memcpy(output, frame.values, num_channels * sizeof(*output));
+      output += num_channels;
+      ++num_frames;
+    }
+    // Leave the window's input as the streaming path would have, including
+    // any trailing samples that are not enough for another frame.
+    if (num_samples - consumed < window->size - buffered) {
+      buffered += num_samples - consumed;
+      consumed = num_samples;
+    }
+    memcpy(window->input, samples + consumed - buffered,
+           buffered * sizeof(*window->input));
+    window->input_used = buffered;
+  }
+
+  *num_samples_read = consumed;
+  return num_frames;
+}
+
 void FrontendReset(struct FrontendState* state) {
   WindowReset(&state->window);
   FftReset(&state->fft);
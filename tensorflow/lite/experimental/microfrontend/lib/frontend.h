@@ -55,6 +55,24 @@ struct FrontendOutput FrontendProcessSamples(struct FrontendState* state,
                                              size_t num_samples,
                                              size_t* num_samples_read);
 
+// Returns how many feature vectors FrontendProcessSamplesBatch will generate
+// from num_samples more samples, given the samples already buffered in state.
+size_t FrontendNumFrames(const struct FrontendState* state, size_t num_samples);
+
+// Offline version of FrontendProcessSamples that generates all the feature
+// vectors it can from the given samples, up to max_frames, in a single call.
+// Each feature vector takes state->filterbank.num_channels values of output,
+// which must have room for max_frames of them. Windows that lie entirely
+// within samples are read in place rather than being copied through the
+// window's input buffer. The results and the state left behind are the same
+// as for calling FrontendProcessSamples repeatedly on the same samples. Samples
+// are only left unread when output has no room for the next feature vector.
+// Updates num_samples_read and returns the number of feature vectors written.
+size_t FrontendProcessSamplesBatch(struct FrontendState* state,
+                                   const int16_t* samples, size_t num_samples,
+                                   uint16_t* output, size_t max_frames,
+                                   size_t* num_samples_read);
+
 void FrontendReset(struct FrontendState* state);
 
 #ifdef __cplusplus
@@ -0,0 +1,204 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+// Offline feature extraction for many files at once. Usage:
+//
+//   frontend_batch_main <num_threads> <output_dir> <input.raw>...
+//
+// Each input is a file of 16KHz int16 PCM samples, as for frontend_main. The
+// features for input.raw are written to <output_dir>/input.raw.features in the
+// same text format frontend_main prints. Files are handed out to num_threads
+// worker threads, each owning its own frontend state, and every file is
+// mmapped and processed with a single FrontendProcessSamplesBatch call.
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "tensorflow/lite/experimental/microfrontend/lib/frontend.h"
+#include "tensorflow/lite/experimental/microfrontend/lib/frontend_util.h"
+
+#define kMaxPathLength 4096
+
+struct BatchJob {
+  const struct FrontendConfig* config;
+  int sample_rate;
+  const char* output_dir;
+  char** filenames;
+  int num_files;
+  // Index of the next file to process, guarded by mutex.
+  int next_file;
+  int num_failures;
+  pthread_mutex_t mutex;
+};
+
+static int ProcessFile(struct FrontendState* state, const char* filename,
+                       const char* output_dir) {
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0) {
+    fprintf(stderr, "Failed to open %s for read\n", filename);
+    return 0;
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    fprintf(stderr, "Failed to stat %s\n", filename);
+    close(fd);
+    return 0;
+  }
+  const size_t num_samples = file_stat.st_size / sizeof(int16_t);
+  const int16_t* samples = NULL;
+  if (num_samples > 0) {
+    samples = mmap(NULL, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (samples == MAP_FAILED) {
+      fprintf(stderr, "Failed to mmap %s\n", filename);
+      close(fd);
+      return 0;
+    }
+  }
+  close(fd);
+
+  FrontendReset(state);
+  const size_t num_channels = state->filterbank.num_channels;
+  const size_t max_frames = FrontendNumFrames(state, num_samples);
+  uint16_t* features = malloc((max_frames * num_channels + 1) *
+                              sizeof(*features));
+  if (features == NULL) {
+    fprintf(stderr, "Failed to alloc features for %s\n", filename);
+    if (samples != NULL) {
+      munmap((void*)samples, file_stat.st_size);
+    }
+    return 0;
+  }
+  size_t num_samples_read;
+  const size_t num_frames =
+      FrontendProcessSamplesBatch(state, samples, num_samples, features,
+                                  max_frames, &num_samples_read);
+  if (samples != NULL) {
+    munmap((void*)samples, file_stat.st_size);
+  }
+
+  const char* basename = strrchr(filename, '/');
+  basename = basename == NULL ? filename : basename + 1;
+  char output_filename[kMaxPathLength];
+  snprintf(output_filename, sizeof(output_filename), "%s/%s.features",
+           output_dir, basename);
+  FILE* fp = fopen(output_filename, "w");
+  if (fp == NULL) {
+    fprintf(stderr, "Failed to open %s for write\n", output_filename);
+    free(features);
+    return 0;
+  }
+  size_t frame;
+  for (frame = 0; frame < num_frames; ++frame) {
+    const uint16_t* values = features + frame * num_channels;
+    size_t i;
+    for (i = 0; i < num_channels; ++i) {
+      fprintf(fp, "%d ", values[i]);
+    }
+    fprintf(fp, "\n");
+  }
+  fclose(fp);
+  free(features);
+  return 1;
+}
+
+static void* Worker(void* arg) {
+  struct BatchJob* job = (struct BatchJob*)arg;
+  struct FrontendState state;
+  if (!FrontendPopulateState(job->config, &state, job->sample_rate)) {
+    fprintf(stderr, "Failed to populate frontend state\n");
+    FrontendFreeStateContents(&state);
+    pthread_mutex_lock(&job->mutex);
+    ++job->num_failures;
+    pthread_mutex_unlock(&job->mutex);
+    return NULL;
+  }
+
+  while (1) {
+    pthread_mutex_lock(&job->mutex);
+    const int file_index = job->next_file++;
+    pthread_mutex_unlock(&job->mutex);
+    if (file_index >= job->num_files) {
+      break;
+    }
+    if (!ProcessFile(&state, job->filenames[file_index], job->output_dir)) {
+      pthread_mutex_lock(&job->mutex);
+      ++job->num_failures;
+      pthread_mutex_unlock(&job->mutex);
+    }
+  }
+
+  FrontendFreeStateContents(&state);
+  return NULL;
+}
+
+int main(int argc, char** argv) {
+  if (argc < 4) {
+    fprintf(stderr,
+            "Usage: %s <num_threads> <output_dir> <input.raw>...\n", argv[0]);
+    return 1;
+  }
+  int num_threads = atoi(argv[1]);
+  if (num_threads < 1) {
+    num_threads = 1;
+  }
+
+  struct FrontendConfig frontend_config;
+  FrontendFillConfigWithDefaults(&frontend_config);
+
+  struct BatchJob job;
+  job.config = &frontend_config;
+  job.sample_rate = 16000;
+  job.output_dir = argv[2];
+  job.filenames = argv + 3;
+  job.num_files = argc - 3;
+  job.next_file = 0;
+  job.num_failures = 0;
+  pthread_mutex_init(&job.mutex, NULL);
+
+  pthread_t* threads = malloc(num_threads * sizeof(*threads));
+  if (threads == NULL) {
+    fprintf(stderr, "Failed to alloc threads\n");
+    return 1;
+  }
+  int i;
+  int num_started = 0;
+  for (i = 0; i < num_threads; ++i) {
+    if (pthread_create(&threads[i], NULL, Worker, &job) != 0) {
+      fprintf(stderr, "Failed to start thread %d\n", i);
+      break;
+    }
+    ++num_started;
+  }
+  if (num_started == 0) {
+    // Still get the work done on this thread.
+    Worker(&job);
+  }
+  for (i = 0; i < num_started; ++i) {
+    pthread_join(threads[i], NULL);
+  }
+  free(threads);
+  pthread_mutex_destroy(&job.mutex);
+
+  if (job.num_failures > 0) {
+    fprintf(stderr, "Failed to process %d of %d files\n", job.num_failures,
+            job.num_files);
+    return 1;
+  }
+  return 0;
+}
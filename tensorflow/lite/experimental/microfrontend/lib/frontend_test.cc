@@ -14,6 +14,8 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/lite/experimental/microfrontend/lib/frontend.h"
 
+#include <string.h>
+
 #include "tensorflow/lite/experimental/microfrontend/lib/frontend_util.h"
 #include "tensorflow/lite/micro/testing/micro_test.h"
 
@@ -128,4 +130,135 @@ TF_LITE_MICRO_TEST(FrontendTest_CheckNotEnoughSamples) {
   FrontendFreeStateContents(&state);
 }
 
+TF_LITE_MICRO_TEST(FrontendTest_CheckBatchOutputValues) {
+  FrontendTestConfig config;
+  struct FrontendState state;
+  TF_LITE_MICRO_EXPECT(
+      FrontendPopulateState(&config.config_, &state, kSampleRate));
+  const size_t num_samples = sizeof(kFakeAudioData) / sizeof(kFakeAudioData[0]);
+
+  const uint16_t expected[] = {479, 425, 436, 378};
+  const size_t expected_frames = 2;
+  TF_LITE_MICRO_EXPECT_EQ(FrontendNumFrames(&state, num_samples),
+                          expected_frames);
+
+  uint16_t output[sizeof(expected) / sizeof(expected[0])];
+  size_t num_samples_read;
+  size_t num_frames =
+      FrontendProcessSamplesBatch(&state, kFakeAudioData, num_samples, output,
+                                  expected_frames, &num_samples_read);
+
+  TF_LITE_MICRO_EXPECT_EQ(num_frames, expected_frames);
+  TF_LITE_MICRO_EXPECT_EQ(num_samples_read, num_samples);
+  int i;
+  for (i = 0; i < sizeof(expected) / sizeof(expected[0]); ++i) {
+    TF_LITE_MICRO_EXPECT_EQ(output[i], expected[i]);
+  }
+  // The trailing samples stay buffered, as with FrontendProcessSamples.
+  TF_LITE_MICRO_EXPECT_EQ(state.window.input_used,
+                          kWindowSamples - kStepSamples + 1);
+
+  FrontendFreeStateContents(&state);
+}
+
+TF_LITE_MICRO_TEST(FrontendTest_CheckBatchStopsAtMaxFrames) {
+  FrontendTestConfig config;
+  struct FrontendState state;
+  TF_LITE_MICRO_EXPECT(
+      FrontendPopulateState(&config.config_, &state, kSampleRate));
+  const size_t num_samples = sizeof(kFakeAudioData) / sizeof(kFakeAudioData[0]);
+
+  uint16_t output[2];
+  size_t num_samples_read;
+  size_t num_frames = FrontendProcessSamplesBatch(
+      &state, kFakeAudioData, num_samples, output, 1, &num_samples_read);
+  TF_LITE_MICRO_EXPECT_EQ(num_frames, static_cast<size_t>(1));
+  TF_LITE_MICRO_EXPECT_EQ(num_samples_read,
+                          static_cast<size_t>(kWindowSamples));
+  TF_LITE_MICRO_EXPECT_EQ(output[0], 479);
+  TF_LITE_MICRO_EXPECT_EQ(output[1], 425);
+
+  // The streaming path picks up where the batch call stopped.
+  struct FrontendOutput next = FrontendProcessSamples(
+      &state, kFakeAudioData + num_samples_read,
+      num_samples - num_samples_read, &num_samples_read);
+  TF_LITE_MICRO_EXPECT_EQ(next.size, static_cast<size_t>(2));
+  TF_LITE_MICRO_EXPECT_EQ(next.values[0], 436);
+  TF_LITE_MICRO_EXPECT_EQ(next.values[1], 378);
+
+  FrontendFreeStateContents(&state);
+}
+
+TF_LITE_MICRO_TEST(FrontendTest_CheckBatchAfterStreamingAndReset) {
+  FrontendTestConfig config;
+  constexpr size_t kAudioSize =
+      sizeof(kFakeAudioData) / sizeof(kFakeAudioData[0]);
+  // Enough audio to stream a few frames first and then batch many more.
+  constexpr int kNumCopies = 4;
+  constexpr size_t kNumSamples = kNumCopies * kAudioSize;
+  constexpr size_t kNumFrames =
+      (kNumSamples - kWindowSamples) / kStepSamples + 1;
+  int16_t audio[kNumSamples];
+  int i;
+  for (i = 0; i < kNumCopies; ++i) {
+    memcpy(audio + i * kAudioSize, kFakeAudioData, sizeof(kFakeAudioData));
+  }
+
+  struct FrontendState streamed;
+  TF_LITE_MICRO_EXPECT(
+      FrontendPopulateState(&config.config_, &streamed, kSampleRate));
+  // Stream in chunks that don't line up with the window step, so that the
+  // window, noise estimate and filterbank all carry state between calls.
+  const int16_t* samples = audio;
+  size_t num_remaining = kNumSamples;
+  size_t num_samples_read;
+  int num_streamed_frames = 0;
+  while (num_streamed_frames < 3) {
+    const size_t chunk_size = num_remaining < 7 ? num_remaining : 7;
+    struct FrontendOutput output = FrontendProcessSamples(
+        &streamed, samples, chunk_size, &num_samples_read);
+    samples += num_samples_read;
+    num_remaining -= num_samples_read;
+    if (output.values != nullptr) {
+      ++num_streamed_frames;
+    }
+  }
+  FrontendReset(&streamed);
+
+  struct FrontendState fresh;
+  TF_LITE_MICRO_EXPECT(
+      FrontendPopulateState(&config.config_, &fresh, kSampleRate));
+
+  // After a reset, a batch call gives exactly what it gives on a new state.
+  TF_LITE_MICRO_EXPECT_EQ(FrontendNumFrames(&streamed, kNumSamples),
+                          kNumFrames);
+  TF_LITE_MICRO_EXPECT_EQ(FrontendNumFrames(&fresh, kNumSamples), kNumFrames);
+  constexpr size_t kNumChannels = 2;
+  TF_LITE_MICRO_EXPECT_EQ(config.config_.filterbank.num_channels,
+                          static_cast<int>(kNumChannels));
+  uint16_t streamed_output[kNumFrames * kNumChannels];
+  uint16_t fresh_output[kNumFrames * kNumChannels];
+  size_t streamed_samples_read;
+  size_t fresh_samples_read;
+  TF_LITE_MICRO_EXPECT_EQ(
+      FrontendProcessSamplesBatch(&streamed, audio, kNumSamples,
+                                  streamed_output, kNumFrames,
+                                  &streamed_samples_read),
+      kNumFrames);
+  TF_LITE_MICRO_EXPECT_EQ(
+      FrontendProcessSamplesBatch(&fresh, audio, kNumSamples, fresh_output,
+                                  kNumFrames, &fresh_samples_read),
+      kNumFrames);
+  TF_LITE_MICRO_EXPECT_EQ(streamed_samples_read, fresh_samples_read);
+  size_t j;
+  for (j = 0; j < kNumFrames * kNumChannels; ++j) {
+    TF_LITE_MICRO_EXPECT_EQ(streamed_output[j], fresh_output[j]);
+  }
+  TF_LITE_MICRO_EXPECT_EQ(streamed.window.input_used,
+                          fresh.window.input_used);
+
+  FrontendFreeStateContents(&streamed);
+  FrontendFreeStateContents(&fresh);
+}
+
 TF_LITE_MICRO_TESTS_END
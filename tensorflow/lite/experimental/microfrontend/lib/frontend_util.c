@@ -29,38 +29,48 @@ void FrontendFillConfigWithDefaults(struct FrontendConfig* config) {
 
 int FrontendPopulateState(const struct FrontendConfig* config,
                           struct FrontendState* state, int sample_rate) {
+  return FrontendPopulateStateWithAllocator(config, state, sample_rate, NULL);
+}
+
+int FrontendPopulateStateWithAllocator(
+    const struct FrontendConfig* config, struct FrontendState* state,
+    int sample_rate, const struct FrontendAllocator* allocator) {
   memset(state, 0, sizeof(*state));
 
-  if (!WindowPopulateState(&config->window, &state->window, sample_rate)) {
+  if (!WindowPopulateStateWithAllocator(&config->window, &state->window,
+                                        sample_rate, allocator)) {
     fprintf(stderr, "Failed to populate window state\n");
     return 0;
   }
 
-  if (!FftPopulateState(&state->fft, state->window.size)) {
+  if (!FftPopulateStateWithAllocator(&state->fft, state->window.size,
+                                     allocator)) {
     fprintf(stderr, "Failed to populate fft state\n");
     return 0;
   }
   FftInit(&state->fft);
 
-  if (!FilterbankPopulateState(&config->filterbank, &state->filterbank,
-                               sample_rate, state->fft.fft_size / 2 + 1)) {
+  if (!FilterbankPopulateStateWithAllocator(
+          &config->filterbank, &state->filterbank, sample_rate,
+          state->fft.fft_size / 2 + 1, allocator)) {
     fprintf(stderr, "Failed to populate filterbank state\n");
     return 0;
   }
 
-  if (!NoiseReductionPopulateState(&config->noise_reduction,
-                                   &state->noise_reduction,
-                                   state->filterbank.num_channels)) {
+  if (!NoiseReductionPopulateStateWithAllocator(
+          &config->noise_reduction, &state->noise_reduction,
+          state->filterbank.num_channels, allocator)) {
     fprintf(stderr, "Failed to populate noise reduction state\n");
     return 0;
   }
 
   int input_correction_bits =
       MostSignificantBit32(state->fft.fft_size) - 1 - (kFilterbankBits / 2);
-  if (!PcanGainControlPopulateState(
+  if (!PcanGainControlPopulateStateWithAllocator(
           &config->pcan_gain_control, &state->pcan_gain_control,
           state->noise_reduction.estimate, state->filterbank.num_channels,
-          state->noise_reduction.smoothing_bits, input_correction_bits)) {
+          state->noise_reduction.smoothing_bits, input_correction_bits,
+          allocator)) {
     fprintf(stderr, "Failed to populate pcan gain control state\n");
     return 0;
   }
@@ -42,6 +42,13 @@ void FrontendFillConfigWithDefaults(struct FrontendConfig* config);
 int FrontendPopulateState(const struct FrontendConfig* config,
                           struct FrontendState* state, int sample_rate);
 
+// Like FrontendPopulateState(), with every buffer from allocator, so that e.g.
+// a TFLM kernel can keep the whole state in its persistent arena without
+// touching the heap. FrontendFreeStateContents() must not be called on it.
+int FrontendPopulateStateWithAllocator(
+    const struct FrontendConfig* config, struct FrontendState* state,
+    int sample_rate, const struct FrontendAllocator* allocator);
+
 // Frees any allocated buffers.
 void FrontendFreeStateContents(struct FrontendState* state);
 
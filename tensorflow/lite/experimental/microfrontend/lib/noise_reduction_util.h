@@ -15,6 +15,7 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_EXPERIMENTAL_MICROFRONTEND_LIB_NOISE_REDUCTION_UTIL_H_
 #define TENSORFLOW_LITE_EXPERIMENTAL_MICROFRONTEND_LIB_NOISE_REDUCTION_UTIL_H_
 
+#include "tensorflow/lite/experimental/microfrontend/lib/allocator.h"
 #include "tensorflow/lite/experimental/microfrontend/lib/noise_reduction.h"
 
 #ifdef __cplusplus
@@ -40,6 +41,12 @@ int NoiseReductionPopulateState(const struct NoiseReductionConfig* config,
                                 struct NoiseReductionState* state,
                                 int num_channels);
 
+// Like NoiseReductionPopulateState(), with the buffers from allocator.
+int NoiseReductionPopulateStateWithAllocator(
+    const struct NoiseReductionConfig* config,
+    struct NoiseReductionState* state, int num_channels,
+    const struct FrontendAllocator* allocator);
+
 // Frees any allocated buffers.
 void NoiseReductionFreeStateContents(struct NoiseReductionState* state);
 
@@ -46,13 +46,25 @@ int PcanGainControlPopulateState(const struct PcanGainControlConfig* config,
                                  const int num_channels,
                                  const uint16_t smoothing_bits,
                                  const int32_t input_correction_bits) {
+  return PcanGainControlPopulateStateWithAllocator(
+      config, state, noise_estimate, num_channels, smoothing_bits,
+      input_correction_bits, NULL);
+}
+
+int PcanGainControlPopulateStateWithAllocator(
+    const struct PcanGainControlConfig* config,
+    struct PcanGainControlState* state, uint32_t* noise_estimate,
+    const int num_channels, const uint16_t smoothing_bits,
+    const int32_t input_correction_bits,
+    const struct FrontendAllocator* allocator) {
   state->enable_pcan = config->enable_pcan;
   if (!state->enable_pcan) {
     return 1;
   }
   state->noise_estimate = noise_estimate;
   state->num_channels = num_channels;
-  state->gain_lut = malloc(kWideDynamicFunctionLUTSize * sizeof(int16_t));
+  state->gain_lut = FrontendAllocate(
+      allocator, kWideDynamicFunctionLUTSize * sizeof(int16_t));
   if (state->gain_lut == NULL) {
     fprintf(stderr, "Failed to allocate gain LUT\n");
     return 0;
@@ -40,6 +40,11 @@ struct WindowState {
 int WindowProcessSamples(struct WindowState* state, const int16_t* samples,
                          size_t num_samples, size_t* num_samples_read);
 
+// Applies the window to the state->size samples starting at input and stores
+// the result in state->output, without going through the internal input
+// buffer. Used when a whole frame is already available in the caller's memory.
+void WindowApply(struct WindowState* state, const int16_t* input);
+
 void WindowReset(struct WindowState* state);
 
 #ifdef __cplusplus
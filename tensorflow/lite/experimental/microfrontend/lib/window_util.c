@@ -31,10 +31,17 @@ void WindowFillConfigWithDefaults(struct WindowConfig* config) {
 
 int WindowPopulateState(const struct WindowConfig* config,
                         struct WindowState* state, int sample_rate) {
+  return WindowPopulateStateWithAllocator(config, state, sample_rate, NULL);
+}
+
+int WindowPopulateStateWithAllocator(
+    const struct WindowConfig* config, struct WindowState* state,
+    int sample_rate, const struct FrontendAllocator* allocator) {
   state->size = config->size_ms * sample_rate / 1000;
   state->step = config->step_size_ms * sample_rate / 1000;
 
-  state->coefficients = malloc(state->size * sizeof(*state->coefficients));
+  state->coefficients = FrontendAllocate(
+      allocator, state->size * sizeof(*state->coefficients));
   if (state->coefficients == NULL) {
     fprintf(stderr, "Failed to allocate window coefficients\n");
     return 0;
@@ -51,13 +58,15 @@ int WindowPopulateState(const struct WindowConfig* config,
   }
 
   state->input_used = 0;
-  state->input = malloc(state->size * sizeof(*state->input));
+  state->input =
+      FrontendAllocate(allocator, state->size * sizeof(*state->input));
   if (state->input == NULL) {
     fprintf(stderr, "Failed to allocate window input\n");
     return 0;
   }
 
-  state->output = malloc(state->size * sizeof(*state->output));
+  state->output =
+      FrontendAllocate(allocator, state->size * sizeof(*state->output));
   if (state->output == NULL) {
     fprintf(stderr, "Failed to allocate window output\n");
     return 0;
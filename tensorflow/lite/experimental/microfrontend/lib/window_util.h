@@ -15,6 +15,7 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_EXPERIMENTAL_MICROFRONTEND_LIB_WINDOW_UTIL_H_
 #define TENSORFLOW_LITE_EXPERIMENTAL_MICROFRONTEND_LIB_WINDOW_UTIL_H_
 
+#include "tensorflow/lite/experimental/microfrontend/lib/allocator.h"
 #include "tensorflow/lite/experimental/microfrontend/lib/window.h"
 
 #ifdef __cplusplus
@@ -35,6 +36,12 @@ void WindowFillConfigWithDefaults(struct WindowConfig* config);
 int WindowPopulateState(const struct WindowConfig* config,
                         struct WindowState* state, int sample_rate);
 
+// Like WindowPopulateState(), with the buffers from allocator.
+int WindowPopulateStateWithAllocator(const struct WindowConfig* config,
+                                     struct WindowState* state,
+                                     int sample_rate,
+                                     const struct FrontendAllocator* allocator);
+
 // Frees any allocated buffers.
 void WindowFreeStateContents(struct WindowState* state);
 
@@ -64,7 +64,11 @@ inline void Concatenation(const ConcatenationParams& params,
     for (int i = 0; i < inputs_count; ++i) {
       const int copy_size = input_shapes[i]->Dims(axis) * base_inner_size;
       const Scalar* input_ptr = input_data[i] + k * copy_size;
-      memcpy(output_ptr, input_ptr, copy_size * sizeof(Scalar));
+      // An input that is planned as a view of the output is already in place,
+      // and memcpy() must not be called on overlapping buffers.
+      if (input_ptr != output_ptr) {
+        memcpy(output_ptr, input_ptr, copy_size * sizeof(Scalar));
+      }
       output_ptr += copy_size;
     }
   }
@@ -118,7 +122,9 @@ inline void ConcatenationWithScaling(const ConcatenationParams& params,
       const uint8_t* input_ptr = input_data[i] + k * copy_size;
       if (input_zeropoint[i] == output_zeropoint &&
           input_scale[i] == output_scale) {
-        memcpy(output_ptr, input_ptr, copy_size);
+        if (input_ptr != output_ptr) {
+          memcpy(output_ptr, input_ptr, copy_size);
+        }
       } else {
         const float scale = input_scale[i] * inverse_output_scale;
         const float bias = -input_zeropoint[i] * scale;
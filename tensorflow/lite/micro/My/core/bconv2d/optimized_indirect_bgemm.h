@@ -3,20 +3,23 @@
 
 #include "tensorflow/lite/micro/My/core/bconv2d/zero_padding_correction.h"
 #include "tensorflow/lite/micro/My/core/indirect_bgemm/kernel.h"
-#include "ruy/profiler/instrumentation.h"
 #include "tensorflow/lite/kernels/internal/types.h"
 
 namespace compute_engine {
 namespace core {
 namespace bconv2d {
 
-template <typename AccumScalar, typename DstScalar>
+using namespace ::tflite;
+
+// With a `thread_pool`, a ThreadPool from thread_pool.h, both the BGEMM and
+// the zero-padding correction are split over its threads.
+template <typename AccumScalar, typename DstScalar,
+          typename ThreadPoolT = indirect_bgemm::NoThreadPool>
 inline void BConv2DOptimizedIndirectBGEMM(
     const indirect_bgemm::Kernel* kernel, const BConv2DParams* bconv2d_params,
     const RuntimeShape& bitpacked_input_shape, const RuntimeShape& output_shape,
-    DstScalar* output_ptr, const float* padding_buffer, const int pad_value) {
-  ruy::profiler::ScopeLabel label("BConv2D (optimized, indirect BGEMM)");
-
+    DstScalar* output_ptr, const float* padding_buffer, const int pad_value,
+    ThreadPoolT* thread_pool = nullptr) {
   // If writing bitpacked output with a channel count that isn't a multiple of
   // 32 (i.e. where padding bits will be required in the output), fill the
   // output tensor with zeroes in advance so that the BGEMM doesn't have to
@@ -30,20 +33,16 @@ inline void BConv2DOptimizedIndirectBGEMM(
         TBitpacked(0));
   }
 
-  kernel->Dispatch(reinterpret_cast<void*>(output_ptr));
+  kernel->Dispatch(reinterpret_cast<void*>(output_ptr), thread_pool);
 
   if (std::is_same<DstScalar, float>::value &&
       bconv2d_params->padding_type == TfLitePadding::kTfLitePaddingSame &&
       pad_value == 0) {
-    ruy::profiler::ScopeLabel label("Zero padding correction");
-
     const int stride_width = bconv2d_params->stride_width;
     const int stride_height = bconv2d_params->stride_height;
     const int dilation_width_factor = bconv2d_params->dilation_width_factor;
     const int dilation_height_factor = bconv2d_params->dilation_height_factor;
     const int batches = MatchingDim(bitpacked_input_shape, 0, output_shape, 0);
-    const int input_depth_per_group =
-        bconv2d_params->channels_in / bconv2d_params->groups;
     const int input_width = bitpacked_input_shape.Dims(2);
     const int input_height = bitpacked_input_shape.Dims(1);
     const int filter_height = bconv2d_params->filter_height;
@@ -52,12 +51,22 @@ inline void BConv2DOptimizedIndirectBGEMM(
     const int output_width = output_shape.Dims(2);
     const int output_height = output_shape.Dims(1);
 
-    zero_padding_correction::ApplyCorrection(
-        batches, input_height, input_width, input_depth_per_group,
-        filter_height, filter_width, output_depth, stride_height, stride_width,
-        dilation_height_factor, dilation_width_factor,
-        reinterpret_cast<float*>(output_ptr), output_height, output_width,
-        padding_buffer);
+    const auto apply_correction = [&](const std::int32_t row_start,
+                                      const std::int32_t row_end) {
+      zero_padding_correction::ApplyCorrectionToRows(
+          input_height, input_width, filter_height, filter_width, output_depth,
+          stride_height, stride_width, dilation_height_factor,
+          dilation_width_factor, reinterpret_cast<float*>(output_ptr),
+          output_height, output_width, padding_buffer, row_start, row_end);
+    };
+    const int num_rows = batches * output_height;
+    if (thread_pool == nullptr) {
+      apply_correction(0, num_rows);
+    } else {
+      // Only the rows near the top and bottom edges need a correction, so
+      // use small chunks to spread them over the threads.
+      thread_pool->ParallelFor(0, num_rows, 1, apply_correction);
+    }
   }
 }
 
@@ -0,0 +1,203 @@
+#ifndef COMPUTE_ENGINE_CORE_BCONV2D_PORTABLE_BGEMM_H_
+#define COMPUTE_ENGINE_CORE_BCONV2D_PORTABLE_BGEMM_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+
+#include "tensorflow/lite/micro/My/core/bconv2d/output_transform.h"
+#include "tensorflow/lite/micro/My/core/bconv2d/params.h"
+#include "tensorflow/lite/micro/My/core/bconv2d/zero_padding_correction.h"
+#include "tensorflow/lite/micro/My/core/bitpacking/bitpack.h"
+#include "tensorflow/lite/micro/My/core/types.h"
+#include "tensorflow/lite/kernels/internal/types.h"
+
+namespace compute_engine {
+namespace core {
+namespace bconv2d {
+
+using namespace ::tflite;
+
+// Returns true when the receptive fields have to be gathered with Im2colRow()
+// first. Only a 1x1 filter with unit stride and dilation, where every output
+// pixel sees exactly the input pixel at the same position, lets the BGEMM read
+// the bitpacked input directly.
+inline bool NeedsIm2col(const BConv2DParams* bconv2d_params) {
+  return bconv2d_params->stride_width != 1 ||
+         bconv2d_params->stride_height != 1 ||
+         bconv2d_params->dilation_width_factor != 1 ||
+         bconv2d_params->dilation_height_factor != 1 ||
+         bconv2d_params->filter_width != 1 ||
+         bconv2d_params->filter_height != 1;
+}
+
+// Number of TBitpacked words of im2col scratch needed for one output row.
+inline int GetIm2colRowSize(const BConv2DParams* bconv2d_params,
+                            const int output_width) {
+  return output_width * bconv2d_params->filter_height *
+         bconv2d_params->filter_width *
+         bitpacking::GetBitpackedSize(bconv2d_params->channels_in);
+}
+
+// Gathers the receptive fields of the output pixels (batch, out_y, 0..width)
+// into `im2col_data`, one row of filter_height * filter_width * input_depth
+// words per pixel, in the same order as the filter. Taps that fall outside of
+// the input are filled with zero bits, which represent +1.
+inline void Im2colRow(const BConv2DParams* bconv2d_params,
+                      const RuntimeShape& input_shape,
+                      const TBitpacked* input_data, const int batch,
+                      const int out_y, const int output_width,
+                      TBitpacked* im2col_data) {
+  const int input_height = input_shape.Dims(1);
+  const int input_width = input_shape.Dims(2);
+  const int input_depth = input_shape.Dims(3);
+  const int filter_height = bconv2d_params->filter_height;
+  const int filter_width = bconv2d_params->filter_width;
+  const int in_y_origin = out_y * bconv2d_params->stride_height -
+                          bconv2d_params->padding_values.height;
+
+  for (int out_x = 0; out_x < output_width; ++out_x) {
+    const int in_x_origin = out_x * bconv2d_params->stride_width -
+                            bconv2d_params->padding_values.width;
+    for (int filter_y = 0; filter_y < filter_height; ++filter_y) {
+      const int in_y =
+          in_y_origin + bconv2d_params->dilation_height_factor * filter_y;
+      for (int filter_x = 0; filter_x < filter_width; ++filter_x) {
+        const int in_x =
+            in_x_origin + bconv2d_params->dilation_width_factor * filter_x;
+        if (FastBoundsCheck(in_y, input_height) &&
+            FastBoundsCheck(in_x, input_width)) {
+          const TBitpacked* src =
+              input_data + Offset(input_shape, batch, in_y, in_x, 0);
+          std::copy(src, src + input_depth, im2col_data);
+        } else {
+          std::fill(im2col_data, im2col_data + input_depth, TBitpacked(0));
+        }
+        im2col_data += input_depth;
+      }
+    }
+  }
+}
+
+// Multiplies `num_pixels` rows of `depth` bitpacked words with every row of
+// the packed filter and writes the transformed result for each pixel to
+// `output_data`. For bitpacked output each pixel takes
+// GetBitpackedSize(channels_out) words, otherwise channels_out values.
+template <typename DstScalar>
+inline void BGemmRow(const TBitpacked* filter_data, const int channels_out,
+                     const int depth, const TBitpacked* pixels_data,
+                     const int num_pixels,
+                     const OutputTransform<DstScalar>& output_transform,
+                     DstScalar* output_data) {
+  constexpr bool kBitpackedOutput = std::is_same<DstScalar, TBitpacked>::value;
+  const int output_depth = kBitpackedOutput
+                               ? bitpacking::GetBitpackedSize(channels_out)
+                               : channels_out;
+
+  for (int pixel = 0; pixel < num_pixels; ++pixel) {
+    const TBitpacked* pixel_data = pixels_data + pixel * depth;
+    DstScalar* out = output_data + pixel * output_depth;
+    TBitpacked bitpacked_column = 0;
+    for (int out_channel = 0; out_channel < channels_out; ++out_channel) {
+      const TBitpacked* filter_row = filter_data + out_channel * depth;
+      std::int32_t accum = 0;
+      for (int d = 0; d < depth; ++d) {
+        accum += xor_popcount(pixel_data[d], filter_row[d]);
+      }
+      if (kBitpackedOutput) {
+        if (output_transform.Run(accum, out_channel)) {
+          bitpacked_column |= TBitpacked(1)
+                              << (out_channel % bitpacking_bitwidth);
+        }
+        if ((out_channel + 1) % bitpacking_bitwidth == 0 ||
+            out_channel + 1 == channels_out) {
+          out[out_channel / bitpacking_bitwidth] =
+              static_cast<DstScalar>(bitpacked_column);
+          bitpacked_column = 0;
+        }
+      } else {
+        out[out_channel] =
+            static_cast<DstScalar>(output_transform.Run(accum, out_channel));
+      }
+    }
+  }
+}
+
+// Computes the output row (batch, out_y) of the convolution, using
+// `im2col_data` as scratch when `need_im2col` is true.
+template <typename DstScalar>
+inline void BConv2DRow(const BConv2DParams* bconv2d_params,
+                       const RuntimeShape& input_shape,
+                       const TBitpacked* input_data, const int channels_out,
+                       const int depth, const TBitpacked* packed_filter_data,
+                       const OutputTransform<DstScalar>& output_transform,
+                       const int batch, const int out_y, const int output_width,
+                       const bool need_im2col, TBitpacked* im2col_data,
+                       DstScalar* output_row_data) {
+  const TBitpacked* pixels_data;
+  if (need_im2col) {
+    Im2colRow(bconv2d_params, input_shape, input_data, batch, out_y,
+              output_width, im2col_data);
+    pixels_data = im2col_data;
+  } else {
+    pixels_data = input_data + Offset(input_shape, batch, out_y, 0, 0);
+  }
+  BGemmRow(packed_filter_data, channels_out, depth, pixels_data, output_width,
+           output_transform, output_row_data);
+}
+
+// Binary convolution as an im2col + BGEMM that only needs scratch memory for a
+// single output row. `im2col_data` must hold GetIm2colRowSize() words and may
+// be nullptr when NeedsIm2col() is false. Grouped convolutions are not
+// supported. With 'same-zero' padding the output must be float, and
+// `padding_buffer` must hold the values from CacheCorrectionValues().
+template <typename DstScalar>
+inline void BConv2DPortableBGEMM(
+    const BConv2DParams* bconv2d_params, const RuntimeShape& input_shape,
+    const TBitpacked* input_data, const RuntimeShape& filter_shape,
+    const TBitpacked* packed_filter_data,
+    const OutputTransform<DstScalar>& output_transform,
+    const RuntimeShape& output_shape, DstScalar* output_data,
+    TBitpacked* im2col_data, const float* padding_buffer) {
+  TFLITE_DCHECK_EQ(input_shape.DimensionsCount(), 4);
+  TFLITE_DCHECK_EQ(filter_shape.DimensionsCount(), 4);
+  TFLITE_DCHECK_EQ(output_shape.DimensionsCount(), 4);
+  TFLITE_DCHECK_EQ(bconv2d_params->groups, 1);
+
+  const int batches = MatchingDim(input_shape, 0, output_shape, 0);
+  const int output_height = output_shape.Dims(1);
+  const int output_width = output_shape.Dims(2);
+  const int output_depth = output_shape.Dims(3);
+  const int channels_out = filter_shape.Dims(0);
+  const int depth = FlatSizeSkipDim(filter_shape, 0);
+  const bool need_im2col = NeedsIm2col(bconv2d_params);
+  TFLITE_DCHECK(!need_im2col || im2col_data != nullptr);
+
+  for (int batch = 0; batch < batches; ++batch) {
+    for (int out_y = 0; out_y < output_height; ++out_y) {
+      BConv2DRow(bconv2d_params, input_shape, input_data, channels_out, depth,
+                 packed_filter_data, output_transform, batch, out_y,
+                 output_width, need_im2col, im2col_data,
+                 output_data + Offset(output_shape, batch, out_y, 0, 0));
+    }
+  }
+
+  if (std::is_same<DstScalar, float>::value &&
+      bconv2d_params->padding_type == kTfLitePaddingSame &&
+      bconv2d_params->pad_value == 0) {
+    zero_padding_correction::ApplyCorrection(
+        batches, input_shape.Dims(1), input_shape.Dims(2), input_shape.Dims(3),
+        bconv2d_params->filter_height, bconv2d_params->filter_width,
+        output_depth, bconv2d_params->stride_height,
+        bconv2d_params->stride_width, bconv2d_params->dilation_height_factor,
+        bconv2d_params->dilation_width_factor,
+        reinterpret_cast<float*>(output_data), output_height, output_width,
+        padding_buffer);
+  }
+}
+
+}  // namespace bconv2d
+}  // namespace core
+}  // namespace compute_engine
+
+#endif  // COMPUTE_ENGINE_CORE_BCONV2D_PORTABLE_BGEMM_H_
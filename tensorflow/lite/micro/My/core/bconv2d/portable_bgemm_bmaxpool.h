@@ -0,0 +1,114 @@
+#ifndef COMPUTE_ENGINE_CORE_BCONV2D_PORTABLE_BGEMM_BMAXPOOL_H_
+#define COMPUTE_ENGINE_CORE_BCONV2D_PORTABLE_BGEMM_BMAXPOOL_H_
+
+#include <algorithm>
+#include <cstdint>
+
+#include "tensorflow/lite/micro/My/core/bconv2d/output_transform.h"
+#include "tensorflow/lite/micro/My/core/bconv2d/params.h"
+#include "tensorflow/lite/micro/My/core/bconv2d/portable_bgemm.h"
+#include "tensorflow/lite/micro/My/core/bitpacking/bitpack.h"
+#include "tensorflow/lite/micro/My/core/bmaxpool.h"
+#include "tensorflow/lite/micro/My/core/types.h"
+#include "tensorflow/lite/kernels/internal/types.h"
+
+namespace compute_engine {
+namespace core {
+namespace bconv2d {
+
+using namespace ::tflite;
+
+// Number of TBitpacked words of scratch needed for the convolution rows that
+// are kept around for the pooling windows.
+inline int GetConvRowsBufferSize(const BMaxPoolParams& pool_params,
+                                 const int conv_output_width,
+                                 const int channels_out) {
+  return pool_params.filter_height * conv_output_width *
+         bitpacking::GetBitpackedSize(channels_out);
+}
+
+// A binary convolution with bitpacked output followed by BMaxPool(), without
+// materialising the full-resolution convolution output.
+//     Each pooled output row is computed from the convolution rows in its
+// pooling window. These are computed with BConv2DRow() into a ring of
+// `pool_params.filter_height` rows in `conv_rows_data`, which must hold
+// GetConvRowsBufferSize() words, so rows shared by overlapping windows are
+// only computed once. The pooling then ANDs the rows while they are still in
+// cache. `im2col_data` is as in BConv2DPortableBGEMM().
+inline void BConv2DBMaxPoolPortableBGEMM(
+    const BConv2DParams* bconv2d_params, const BMaxPoolParams& pool_params,
+    const RuntimeShape& input_shape, const TBitpacked* input_data,
+    const RuntimeShape& filter_shape, const TBitpacked* packed_filter_data,
+    const OutputTransform<TBitpacked>& output_transform,
+    const int conv_output_height, const int conv_output_width,
+    const RuntimeShape& output_shape, TBitpacked* output_data,
+    TBitpacked* im2col_data, TBitpacked* conv_rows_data) {
+  TFLITE_DCHECK_EQ(input_shape.DimensionsCount(), 4);
+  TFLITE_DCHECK_EQ(filter_shape.DimensionsCount(), 4);
+  TFLITE_DCHECK_EQ(output_shape.DimensionsCount(), 4);
+  TFLITE_DCHECK_EQ(bconv2d_params->groups, 1);
+
+  const int batches = MatchingDim(input_shape, 0, output_shape, 0);
+  const int output_height = output_shape.Dims(1);
+  const int output_width = output_shape.Dims(2);
+  const int channels_out = filter_shape.Dims(0);
+  const int depth = FlatSizeSkipDim(filter_shape, 0);
+  const int packed_channels = bitpacking::GetBitpackedSize(channels_out);
+  TFLITE_DCHECK_EQ(output_shape.Dims(3), packed_channels);
+  const int conv_row_size = conv_output_width * packed_channels;
+  const bool need_im2col = NeedsIm2col(bconv2d_params);
+  TFLITE_DCHECK(!need_im2col || im2col_data != nullptr);
+
+  for (int batch = 0; batch < batches; ++batch) {
+    // The pooling windows only move down, so every convolution row is
+    // computed at most once per batch. A row y lives in ring slot
+    // y % filter_height until row y + filter_height replaces it, and by then
+    // the windows have moved past it.
+    int next_conv_row = 0;
+    for (int out_y = 0; out_y < output_height; ++out_y) {
+      const int in_y_origin =
+          out_y * pool_params.stride_height - pool_params.padding.height;
+      const int y_start = std::max(0, in_y_origin);
+      const int y_end =
+          std::min(conv_output_height, in_y_origin + pool_params.filter_height);
+
+      for (int y = std::max(next_conv_row, y_start); y < y_end; ++y) {
+        BConv2DRow(bconv2d_params, input_shape, input_data, channels_out, depth,
+                   packed_filter_data, output_transform, batch, y,
+                   conv_output_width, need_im2col, im2col_data,
+                   conv_rows_data +
+                       (y % pool_params.filter_height) * conv_row_size);
+      }
+      next_conv_row = std::max(next_conv_row, y_end);
+
+      for (int out_x = 0; out_x < output_width; ++out_x) {
+        const int in_x_origin =
+            out_x * pool_params.stride_width - pool_params.padding.width;
+        const int x_start = std::max(0, in_x_origin);
+        const int x_end =
+            std::min(conv_output_width, in_x_origin + pool_params.filter_width);
+
+        TBitpacked* out_ptr =
+            output_data + Offset(output_shape, batch, out_y, out_x, 0);
+        // Start with all ones
+        std::fill(out_ptr, out_ptr + packed_channels, ~TBitpacked(0));
+        for (int y = y_start; y < y_end; ++y) {
+          const TBitpacked* row_ptr =
+              conv_rows_data + (y % pool_params.filter_height) * conv_row_size;
+          for (int x = x_start; x < x_end; ++x) {
+            const TBitpacked* in_ptr = row_ptr + x * packed_channels;
+            for (int c = 0; c < packed_channels; ++c) {
+              out_ptr[c] &= in_ptr[c];
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+}  // namespace bconv2d
+}  // namespace core
+}  // namespace compute_engine
+
+#endif  // COMPUTE_ENGINE_CORE_BCONV2D_PORTABLE_BGEMM_BMAXPOOL_H_
@@ -30,6 +30,8 @@ namespace compute_engine {
 namespace core {
 namespace bconv2d {
 
+using namespace ::tflite;
+
 template <typename AccumScalar, typename DstScalar,
           OutputTransformDetails details>
 inline void BConv2DReference(
@@ -0,0 +1,145 @@
+#include "tensorflow/lite/micro/My/core/bconv2d/optimized_indirect_bgemm.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include "tensorflow/lite/micro/My/core/bconv2d/output_transform.h"
+#include "tensorflow/lite/micro/My/core/bconv2d/params.h"
+#include "tensorflow/lite/micro/My/core/bconv2d/reference.h"
+#include "tensorflow/lite/micro/My/core/bconv2d/zero_padding_correction.h"
+#include "tensorflow/lite/micro/My/core/bitpacking/bitpack.h"
+#include "tensorflow/lite/micro/My/core/indirect_bgemm/select_kernel.h"
+#include "tensorflow/lite/micro/My/core/thread_pool.h"
+#include "tensorflow/lite/kernels/internal/types.h"
+#include "tensorflow/lite/kernels/padding.h"
+
+namespace compute_engine {
+namespace core {
+namespace bconv2d {
+
+using ::tflite::RuntimeShape;
+
+// input height/width, filter size, channels in/out, stride, dilation, number
+// of threads. The padding is always 'same-zero'.
+using ConvShape = std::tuple<int, int, int, int, int, int, int, int>;
+
+class BConv2DIndirectBGEMMThreadingTest
+    : public ::testing::TestWithParam<ConvShape> {};
+
+TEST_P(BConv2DIndirectBGEMMThreadingTest, ZeroPaddingCorrection) {
+  const ConvShape& shape = GetParam();
+  const int input_height = std::get<0>(shape);
+  const int input_width = std::get<1>(shape);
+  BConv2DParams params;
+  params.filter_height = params.filter_width = std::get<2>(shape);
+  params.channels_in = std::get<3>(shape);
+  params.channels_out = std::get<4>(shape);
+  params.stride_height = params.stride_width = std::get<5>(shape);
+  params.dilation_height_factor = params.dilation_width_factor =
+      std::get<6>(shape);
+  params.groups = 1;
+  params.padding_type = kTfLitePaddingSame;
+  params.pad_value = 0;
+  const int num_threads = std::get<7>(shape);
+
+  const int batches = 2;
+  int output_height, output_width;
+  params.padding_values = ::tflite::ComputePaddingHeightWidth(
+      params.stride_height, params.stride_width, params.dilation_height_factor,
+      params.dilation_width_factor, input_height, input_width,
+      params.filter_height, params.filter_width, params.padding_type,
+      &output_height, &output_width);
+
+  const int input_depth = bitpacking::GetBitpackedSize(params.channels_in);
+  const std::int32_t input_dims[] = {batches, input_height, input_width,
+                                     input_depth};
+  const std::int32_t filter_dims[] = {params.channels_out, params.filter_height,
+                                      params.filter_width, input_depth};
+  const std::int32_t output_dims[] = {batches, output_height, output_width,
+                                      params.channels_out};
+  const RuntimeShape input_shape(4, input_dims);
+  const RuntimeShape filter_shape(4, filter_dims);
+  const RuntimeShape output_shape(4, output_dims);
+
+  std::mt19937 gen(1234);
+  std::uniform_int_distribution<TBitpacked> bits_distribution(
+      std::numeric_limits<TBitpacked>::lowest(),
+      std::numeric_limits<TBitpacked>::max());
+  std::vector<TBitpacked> input_data(input_shape.FlatSize());
+  std::vector<TBitpacked> filter_data(filter_shape.FlatSize());
+  for (auto& x : input_data) x = bits_distribution(gen);
+  for (auto& x : filter_data) x = bits_distribution(gen);
+
+  const int backtransform_add =
+      params.filter_height * params.filter_width * params.channels_in;
+  std::uniform_real_distribution<float> float_distribution(-1.0f, 1.0f);
+  std::vector<float> post_activation_multiplier(params.channels_out);
+  std::vector<float> multiplier(params.channels_out);
+  std::vector<float> bias(params.channels_out);
+  for (int i = 0; i < params.channels_out; ++i) {
+    post_activation_multiplier[i] = float_distribution(gen);
+    multiplier[i] = -1 * post_activation_multiplier[i];
+    bias[i] = float_distribution(gen) +
+              backtransform_add * post_activation_multiplier[i];
+  }
+  OutputTransform<float> output_transform;
+  output_transform.multiplier = multiplier.data();
+  output_transform.bias = bias.data();
+
+  std::vector<float> padding_buffer(zero_padding_correction::GetCacheSize(
+      params.filter_height, params.filter_width, params.channels_out,
+      params.dilation_height_factor, params.dilation_width_factor));
+  zero_padding_correction::CacheCorrectionValues(
+      filter_data.data(), params.filter_height, params.filter_width,
+      params.channels_out, params.channels_in, params.dilation_height_factor,
+      params.dilation_width_factor, post_activation_multiplier.data(),
+      padding_buffer.data());
+
+  auto kernel = indirect_bgemm::SelectRuntimeKernel<float>(
+      &params, input_shape, output_shape, output_transform);
+  kernel->PackWeights(filter_data.data());
+  kernel->FillIndirectionBuffer(&params, input_shape, output_shape,
+                                input_data.data());
+
+  std::vector<float> serial(output_shape.FlatSize());
+  BConv2DOptimizedIndirectBGEMM<std::int32_t, float>(
+      kernel.get(), &params, input_shape, output_shape, serial.data(),
+      padding_buffer.data(), params.pad_value);
+
+  ThreadPool thread_pool(num_threads);
+  std::vector<float> threaded(output_shape.FlatSize());
+  BConv2DOptimizedIndirectBGEMM<std::int32_t, float>(
+      kernel.get(), &params, input_shape, output_shape, threaded.data(),
+      padding_buffer.data(), params.pad_value, &thread_pool);
+
+  // Every row is corrected by exactly one thread, with the same arithmetic.
+  EXPECT_EQ(threaded, serial);
+
+  std::vector<float> expected(output_shape.FlatSize());
+  BConv2DReference<std::int32_t, float>(
+      &params, input_shape, input_data.data(), filter_shape, filter_data.data(),
+      output_transform, output_shape, expected.data());
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_NEAR(expected[i], threaded[i], 1e-3f * std::abs(expected[i]) + 1e-3f)
+        << "at output index " << i;
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    BConv2DOptimizedIndirectBGEMM, BConv2DIndirectBGEMMThreadingTest,
+    ::testing::Values(ConvShape{9, 7, 3, 70, 40, 1, 1, 2},
+                      ConvShape{9, 7, 3, 70, 40, 1, 1, 4},
+                      ConvShape{10, 10, 5, 64, 32, 2, 1, 3},
+                      ConvShape{11, 12, 3, 40, 24, 1, 2, 4},
+                      // More threads than output rows.
+                      ConvShape{3, 4, 3, 32, 8, 1, 1, 8}));
+
+}  // namespace bconv2d
+}  // namespace core
+}  // namespace compute_engine
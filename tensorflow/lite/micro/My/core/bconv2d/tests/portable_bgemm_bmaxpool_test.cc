@@ -0,0 +1,151 @@
+#include "tensorflow/lite/micro/My/core/bconv2d/portable_bgemm_bmaxpool.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include "tensorflow/lite/micro/My/core/bconv2d/output_transform.h"
+#include "tensorflow/lite/micro/My/core/bconv2d/params.h"
+#include "tensorflow/lite/micro/My/core/bconv2d/reference.h"
+#include "tensorflow/lite/micro/My/core/bitpacking/bitpack.h"
+#include "tensorflow/lite/micro/My/core/bmaxpool.h"
+#include "tensorflow/lite/kernels/internal/types.h"
+#include "tensorflow/lite/kernels/padding.h"
+
+namespace compute_engine {
+namespace core {
+namespace bconv2d {
+
+using ::tflite::RuntimeShape;
+
+// input height/width, filter size, channels in/out, stride, padding.
+using ConvShape = std::tuple<int, int, int, int, int, int, TfLitePadding>;
+// filter size, stride, padding.
+using PoolShape = std::tuple<int, int, TfLitePadding>;
+
+class BConv2DBMaxPoolTest
+    : public ::testing::TestWithParam<std::tuple<ConvShape, PoolShape>> {};
+
+TEST_P(BConv2DBMaxPoolTest, MatchesUnfusedOps) {
+  const ConvShape& conv_shape = std::get<0>(GetParam());
+  const PoolShape& pool_shape = std::get<1>(GetParam());
+
+  BConv2DParams bconv2d_params;
+  const int input_height = std::get<0>(conv_shape);
+  const int input_width = std::get<1>(conv_shape);
+  bconv2d_params.filter_height = bconv2d_params.filter_width =
+      std::get<2>(conv_shape);
+  bconv2d_params.channels_in = std::get<3>(conv_shape);
+  bconv2d_params.channels_out = std::get<4>(conv_shape);
+  bconv2d_params.stride_height = bconv2d_params.stride_width =
+      std::get<5>(conv_shape);
+  bconv2d_params.dilation_height_factor =
+      bconv2d_params.dilation_width_factor = 1;
+  bconv2d_params.groups = 1;
+  bconv2d_params.padding_type = std::get<6>(conv_shape);
+  bconv2d_params.pad_value = 1;
+
+  BMaxPoolParams pool_params;
+  pool_params.filter_height = pool_params.filter_width =
+      std::get<0>(pool_shape);
+  pool_params.stride_height = pool_params.stride_width =
+      std::get<1>(pool_shape);
+  pool_params.padding_type = std::get<2>(pool_shape);
+
+  const int batches = 2;
+  int conv_height, conv_width;
+  bconv2d_params.padding_values = ::tflite::ComputePaddingHeightWidth(
+      bconv2d_params.stride_height, bconv2d_params.stride_width, 1, 1,
+      input_height, input_width, bconv2d_params.filter_height,
+      bconv2d_params.filter_width, bconv2d_params.padding_type, &conv_height,
+      &conv_width);
+  int pooled_height, pooled_width;
+  pool_params.padding = ::tflite::ComputePaddingHeightWidth(
+      pool_params.stride_height, pool_params.stride_width, 1, 1, conv_height,
+      conv_width, pool_params.filter_height, pool_params.filter_width,
+      pool_params.padding_type, &pooled_height, &pooled_width);
+
+  const int input_depth =
+      bitpacking::GetBitpackedSize(bconv2d_params.channels_in);
+  const int output_depth =
+      bitpacking::GetBitpackedSize(bconv2d_params.channels_out);
+  const std::int32_t input_dims[] = {batches, input_height, input_width,
+                                     input_depth};
+  const std::int32_t filter_dims[] = {
+      bconv2d_params.channels_out, bconv2d_params.filter_height,
+      bconv2d_params.filter_width, input_depth};
+  const std::int32_t conv_dims[] = {batches, conv_height, conv_width,
+                                    output_depth};
+  const std::int32_t pooled_dims[] = {batches, pooled_height, pooled_width,
+                                      output_depth};
+  const RuntimeShape input_shape(4, input_dims);
+  const RuntimeShape filter_shape(4, filter_dims);
+  const RuntimeShape conv_shape_4d(4, conv_dims);
+  const RuntimeShape pooled_shape(4, pooled_dims);
+
+  std::mt19937 gen(1234);
+  std::uniform_int_distribution<TBitpacked> bits_distribution(
+      std::numeric_limits<TBitpacked>::lowest(),
+      std::numeric_limits<TBitpacked>::max());
+  std::vector<TBitpacked> input_data(input_shape.FlatSize());
+  std::vector<TBitpacked> filter_data(filter_shape.FlatSize());
+  for (auto& x : input_data) x = bits_distribution(gen);
+  for (auto& x : filter_data) x = bits_distribution(gen);
+
+  // Thresholds around the expected accumulator value, so that the output bits
+  // are mixed and the pooling has something to do.
+  const int depth = bconv2d_params.filter_height *
+                    bconv2d_params.filter_width * input_depth *
+                    bitpacking_bitwidth;
+  std::uniform_int_distribution<std::int32_t> threshold_distribution(
+      depth / 2 - 8, depth / 2 + 8);
+  std::vector<std::int32_t> thresholds(bconv2d_params.channels_out);
+  for (auto& x : thresholds) x = threshold_distribution(gen);
+  OutputTransform<TBitpacked> output_transform;
+  output_transform.thresholds = thresholds.data();
+
+  std::vector<TBitpacked> conv_output(conv_shape_4d.FlatSize());
+  BConv2DReference<std::int32_t, TBitpacked>(
+      &bconv2d_params, input_shape, input_data.data(), filter_shape,
+      filter_data.data(), output_transform, conv_shape_4d, conv_output.data());
+  std::vector<TBitpacked> expected(pooled_shape.FlatSize());
+  BMaxPool(pool_params, conv_shape_4d, conv_output.data(), pooled_shape,
+           expected.data());
+
+  std::vector<TBitpacked> im2col_data(
+      GetIm2colRowSize(&bconv2d_params, conv_width));
+  std::vector<TBitpacked> conv_rows_data(GetConvRowsBufferSize(
+      pool_params, conv_width, bconv2d_params.channels_out));
+  std::vector<TBitpacked> actual(pooled_shape.FlatSize());
+  BConv2DBMaxPoolPortableBGEMM(
+      &bconv2d_params, pool_params, input_shape, input_data.data(),
+      filter_shape, filter_data.data(), output_transform, conv_height,
+      conv_width, pooled_shape, actual.data(), im2col_data.data(),
+      conv_rows_data.data());
+
+  EXPECT_EQ(actual, expected);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    BConv2DBMaxPool, BConv2DBMaxPoolTest,
+    ::testing::Combine(
+        ::testing::Values(
+            // A 1x1 convolution, which reads the input without im2col.
+            ConvShape{8, 8, 1, 64, 32, 1, kTfLitePaddingValid},
+            ConvShape{9, 7, 3, 70, 40, 1, kTfLitePaddingSame},
+            ConvShape{10, 10, 3, 32, 96, 2, kTfLitePaddingValid}),
+        ::testing::Values(
+            PoolShape{2, 2, kTfLitePaddingValid},
+            // Overlapping windows, which share convolution rows.
+            PoolShape{3, 2, kTfLitePaddingSame},
+            PoolShape{3, 1, kTfLitePaddingValid},
+            // Windows that skip convolution rows.
+            PoolShape{1, 2, kTfLitePaddingValid})));
+
+}  // namespace bconv2d
+}  // namespace core
+}  // namespace compute_engine
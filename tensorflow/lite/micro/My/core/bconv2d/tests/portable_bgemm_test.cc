@@ -0,0 +1,214 @@
+#include "tensorflow/lite/micro/My/core/bconv2d/portable_bgemm.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include "tensorflow/lite/micro/My/core/bconv2d/output_transform.h"
+#include "tensorflow/lite/micro/My/core/bconv2d/params.h"
+#include "tensorflow/lite/micro/My/core/bconv2d/reference.h"
+#include "tensorflow/lite/micro/My/core/bconv2d/zero_padding_correction.h"
+#include "tensorflow/lite/micro/My/core/bitpacking/bitpack.h"
+#include "tensorflow/lite/kernels/internal/types.h"
+#include "tensorflow/lite/kernels/padding.h"
+
+namespace compute_engine {
+namespace core {
+namespace bconv2d {
+
+using ::tflite::RuntimeShape;
+
+// input height/width, filter size, channels in/out, stride, dilation, padding,
+// pad value.
+using ConvShape =
+    std::tuple<int, int, int, int, int, int, int, TfLitePadding, int>;
+
+class BConv2DPortableBGEMMTest : public ::testing::TestWithParam<ConvShape> {
+ protected:
+  void SetUp() override {
+    const ConvShape& shape = GetParam();
+    const int input_height = std::get<0>(shape);
+    const int input_width = std::get<1>(shape);
+    params_.filter_height = params_.filter_width = std::get<2>(shape);
+    params_.channels_in = std::get<3>(shape);
+    params_.channels_out = std::get<4>(shape);
+    params_.stride_height = params_.stride_width = std::get<5>(shape);
+    params_.dilation_height_factor = params_.dilation_width_factor =
+        std::get<6>(shape);
+    params_.groups = 1;
+    params_.padding_type = std::get<7>(shape);
+    params_.pad_value = std::get<8>(shape);
+
+    const int batches = 2;
+    params_.padding_values = ::tflite::ComputePaddingHeightWidth(
+        params_.stride_height, params_.stride_width,
+        params_.dilation_height_factor, params_.dilation_width_factor,
+        input_height, input_width, params_.filter_height, params_.filter_width,
+        params_.padding_type, &output_height_, &output_width_);
+
+    const int input_depth = bitpacking::GetBitpackedSize(params_.channels_in);
+    const std::int32_t input_dims[] = {batches, input_height, input_width,
+                                       input_depth};
+    const std::int32_t filter_dims[] = {params_.channels_out,
+                                        params_.filter_height,
+                                        params_.filter_width, input_depth};
+    input_shape_.ReplaceWith(4, input_dims);
+    filter_shape_.ReplaceWith(4, filter_dims);
+
+    std::mt19937 gen(1234);
+    std::uniform_int_distribution<TBitpacked> bits_distribution(
+        std::numeric_limits<TBitpacked>::lowest(),
+        std::numeric_limits<TBitpacked>::max());
+    input_data_.resize(input_shape_.FlatSize());
+    filter_data_.resize(filter_shape_.FlatSize());
+    for (auto& x : input_data_) x = bits_distribution(gen);
+    for (auto& x : filter_data_) x = bits_distribution(gen);
+
+    // The multiplier and bias as the kernel computes them from the
+    // post-activation multiplier and bias, including the back-transformation.
+    const int backtransform_add =
+        params_.filter_height * params_.filter_width * params_.channels_in;
+    std::uniform_real_distribution<float> float_distribution(-1.0f, 1.0f);
+    post_activation_multiplier_.resize(params_.channels_out);
+    multiplier_.resize(params_.channels_out);
+    bias_.resize(params_.channels_out);
+    for (int i = 0; i < params_.channels_out; ++i) {
+      post_activation_multiplier_[i] = float_distribution(gen);
+      multiplier_[i] = -1 * post_activation_multiplier_[i];
+      bias_[i] = float_distribution(gen) +
+                 backtransform_add * post_activation_multiplier_[i];
+    }
+
+    // Thresholds around the expected accumulator value, so that the output
+    // bits are mixed.
+    std::uniform_int_distribution<std::int32_t> threshold_distribution(
+        backtransform_add / 2 - 8, backtransform_add / 2 + 8);
+    thresholds_.resize(params_.channels_out);
+    for (auto& x : thresholds_) x = threshold_distribution(gen);
+  }
+
+  RuntimeShape GetOutputShape(const int output_depth) const {
+    const std::int32_t output_dims[] = {input_shape_.Dims(0), output_height_,
+                                        output_width_, output_depth};
+    return RuntimeShape(4, output_dims);
+  }
+
+  template <typename DstScalar>
+  void Run(const OutputTransform<DstScalar>& output_transform,
+           const RuntimeShape& output_shape, std::vector<DstScalar>* expected,
+           std::vector<DstScalar>* actual) {
+    expected->resize(output_shape.FlatSize());
+    BConv2DReference<std::int32_t, DstScalar>(
+        &params_, input_shape_, input_data_.data(), filter_shape_,
+        filter_data_.data(), output_transform, output_shape, expected->data());
+
+    // A 1x1 convolution must not need the im2col buffer.
+    std::vector<TBitpacked> im2col_data;
+    if (NeedsIm2col(&params_)) {
+      im2col_data.resize(GetIm2colRowSize(&params_, output_width_));
+    }
+    std::vector<float> padding_buffer;
+    if (params_.padding_type == kTfLitePaddingSame && params_.pad_value == 0) {
+      padding_buffer.resize(zero_padding_correction::GetCacheSize(
+          params_.filter_height, params_.filter_width, params_.channels_out,
+          params_.dilation_height_factor, params_.dilation_width_factor));
+      zero_padding_correction::CacheCorrectionValues(
+          filter_data_.data(), params_.filter_height, params_.filter_width,
+          params_.channels_out, params_.channels_in,
+          params_.dilation_height_factor, params_.dilation_width_factor,
+          post_activation_multiplier_.data(), padding_buffer.data());
+    }
+
+    actual->resize(output_shape.FlatSize());
+    BConv2DPortableBGEMM<DstScalar>(
+        &params_, input_shape_, input_data_.data(), filter_shape_,
+        filter_data_.data(), output_transform, output_shape, actual->data(),
+        im2col_data.empty() ? nullptr : im2col_data.data(),
+        padding_buffer.empty() ? nullptr : padding_buffer.data());
+  }
+
+  bool ZeroPadding() const {
+    return params_.padding_type == kTfLitePaddingSame && params_.pad_value == 0;
+  }
+
+  BConv2DParams params_;
+  int output_height_, output_width_;
+  RuntimeShape input_shape_, filter_shape_;
+  std::vector<TBitpacked> input_data_, filter_data_;
+  std::vector<float> post_activation_multiplier_, multiplier_, bias_;
+  std::vector<std::int32_t> thresholds_;
+};
+
+TEST_P(BConv2DPortableBGEMMTest, FloatOutput) {
+  OutputTransform<float> output_transform;
+  output_transform.multiplier = multiplier_.data();
+  output_transform.bias = bias_.data();
+  std::vector<float> expected, actual;
+  Run(output_transform, GetOutputShape(params_.channels_out), &expected,
+      &actual);
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    // The zero-padding correction is applied in float, after the transform.
+    ASSERT_NEAR(expected[i], actual[i], 1e-3f * std::abs(expected[i]) + 1e-3f)
+        << "at output index " << i;
+  }
+}
+
+TEST_P(BConv2DPortableBGEMMTest, Int8Output) {
+  if (ZeroPadding()) {
+    GTEST_SKIP() << "Zero-padding is only supported with float output.";
+  }
+  // Scale the transform so that the outputs span the int8 range.
+  const float output_scale = 1.0f / (params_.filter_height *
+                                     params_.filter_width * params_.channels_in);
+  for (int i = 0; i < params_.channels_out; ++i) {
+    multiplier_[i] *= 127 * output_scale;
+    bias_[i] *= 127 * output_scale;
+  }
+  OutputTransform<std::int8_t> output_transform;
+  output_transform.multiplier = multiplier_.data();
+  output_transform.bias = bias_.data();
+  std::vector<std::int8_t> expected, actual;
+  Run(output_transform, GetOutputShape(params_.channels_out), &expected,
+      &actual);
+  EXPECT_EQ(actual, expected);
+}
+
+TEST_P(BConv2DPortableBGEMMTest, BitpackedOutput) {
+  if (ZeroPadding()) {
+    GTEST_SKIP() << "Zero-padding is only supported with float output.";
+  }
+  OutputTransform<TBitpacked> output_transform;
+  output_transform.thresholds = thresholds_.data();
+  std::vector<TBitpacked> expected, actual;
+  Run(output_transform,
+      GetOutputShape(bitpacking::GetBitpackedSize(params_.channels_out)),
+      &expected, &actual);
+  EXPECT_EQ(actual, expected);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    BConv2DPortableBGEMM, BConv2DPortableBGEMMTest,
+    ::testing::Values(
+        // A 1x1 convolution, which reads the input without im2col.
+        ConvShape{8, 8, 1, 64, 32, 1, 1, kTfLitePaddingValid, 1},
+        ConvShape{9, 7, 3, 70, 40, 1, 1, kTfLitePaddingValid, 1},
+        ConvShape{9, 7, 3, 70, 40, 1, 1, kTfLitePaddingSame, 1},
+        // Strided, with a 1x1 filter that still needs im2col.
+        ConvShape{10, 10, 3, 32, 96, 2, 1, kTfLitePaddingSame, 1},
+        ConvShape{10, 9, 1, 32, 33, 2, 1, kTfLitePaddingValid, 1},
+        // Dilated.
+        ConvShape{11, 12, 3, 40, 24, 1, 2, kTfLitePaddingValid, 1},
+        ConvShape{11, 12, 3, 40, 24, 1, 2, kTfLitePaddingSame, 1},
+        // 'same-zero' padding, corrected after the BGEMM.
+        ConvShape{9, 7, 3, 70, 40, 1, 1, kTfLitePaddingSame, 0},
+        ConvShape{10, 10, 5, 64, 32, 2, 1, kTfLitePaddingSame, 0},
+        ConvShape{11, 12, 3, 40, 24, 1, 2, kTfLitePaddingSame, 0}));
+
+}  // namespace bconv2d
+}  // namespace core
+}  // namespace compute_engine
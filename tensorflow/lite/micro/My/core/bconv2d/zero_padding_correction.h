@@ -175,14 +175,16 @@ void CacheCorrectionValues(const TBitpacked* filter_data,
   return;
 }
 
-void ApplyCorrection(const int input_batches, const int input_height,
-                     const int input_width, const int input_channels,
-                     const int filter_height, const int filter_width,
-                     const int filter_count, const int stride_rows,
-                     const int stride_cols, const int dilation_rows,
-                     const int dilation_cols, float* output_data,
-                     const int output_height, const int output_width,
-                     const float* padding_cache) {
+// Applies the correction to the output rows [row_start, row_end), where the
+// rows of all batches are numbered consecutively, i.e. row `r` is output row
+// `r % output_height` of batch `r / output_height`. Disjoint row ranges can be
+// corrected in parallel.
+inline void ApplyCorrectionToRows(
+    const int input_height, const int input_width, const int filter_height,
+    const int filter_width, const int filter_count, const int stride_rows,
+    const int stride_cols, const int dilation_rows, const int dilation_cols,
+    float* output_data, const int output_height, const int output_width,
+    const float* padding_cache, const int row_start, const int row_end) {
   const int effective_filter_width = (filter_width - 1) * dilation_cols + 1;
   const int effective_filter_height = (filter_height - 1) * dilation_rows + 1;
 
@@ -198,104 +200,118 @@ void ApplyCorrection(const int input_batches, const int input_height,
   // We assume that the input numbers are correct because they
   // are already checked by the bconv functor
 
-  for (int batch = 0; batch < input_batches; ++batch) {
-    for (int out_y = 0; out_y < output_height; ++out_y) {
-      // See the `create_cache` function for an explanation of these
-      // parameters:
-      // How many pixels does the kernel stick out at the
-      // left, top, right, bottom
-      const int overflow_top = filter_top_offset - out_y * stride_rows;
-      const int overflow_bot =
-          -overflow_top - input_height + effective_filter_height;
-      for (int out_x = 0; out_x < output_width; ++out_x) {
-        const int overflow_left = filter_left_offset - out_x * stride_cols;
-        const int overflow_right =
-            -overflow_left - input_width + effective_filter_width;
+  for (int row = row_start; row < row_end; ++row) {
+    const int batch = row / output_height;
+    const int out_y = row % output_height;
+    // See the `create_cache` function for an explanation of these
+    // parameters:
+    // How many pixels does the kernel stick out at the
+    // left, top, right, bottom
+    const int overflow_top = filter_top_offset - out_y * stride_rows;
+    const int overflow_bot =
+        -overflow_top - input_height + effective_filter_height;
+    for (int out_x = 0; out_x < output_width; ++out_x) {
+      const int overflow_left = filter_left_offset - out_x * stride_cols;
+      const int overflow_right =
+          -overflow_left - input_width + effective_filter_width;
 
-        if (overflow_left <= 0 && overflow_right <= 0 && overflow_top <= 0 &&
-            overflow_bot <= 0) {
-          // clang-format off
-          // The kernel does not stick out.
-          // This output pixel corresponds to a completely 'valid' region
-          // of the input and there is no padding: we are entering the inside
-          // of the image.
-          // We now *skip* from the left to the right edge of the image.
-          // We want to find `out_x` such that `overflow_right >= 1`
-          // We have
-          // overflow_right = out_x * stride - offset + effective_filter_width - width
-          // So we want
-          // out_x * stride >= width + offset - effective_filter_width + 1
-          // So we want `out_x` to be the ceiling of
-          // (input_with + offset - effective_filter_width + 1) / stride
-          // clang-format on
-          int new_out_x = (input_width + filter_left_offset -
-                           effective_filter_width + stride_cols - 1) /
-                              stride_cols -
-                          1;
-          // The extra -1 is because the for-loop will increment it again
-          if (new_out_x > out_x) out_x = new_out_x;
-          continue;
-        }
-        // See the `create_cache` function for an explanation of these cases
-        int case_num;
-        int cache_X;
-        int cache_Y;
-        if (overflow_right <= 0 && overflow_top > 0 && overflow_bot < 0) {
-          case_num = 0;
-          cache_X = (overflow_left >= 0 ? overflow_left : 0);
-          cache_Y = overflow_top;
-        } else if (overflow_left < 0 && overflow_right > 0 &&
-                   overflow_bot <= 0) {
-          case_num = 1;
-          cache_X = overflow_right;
-          cache_Y = (overflow_top >= 0 ? overflow_top : 0);
-        } else if (overflow_left > 0 && overflow_right < 0 &&
-                   overflow_top <= 0) {
-          case_num = 2;
-          cache_X = overflow_left;
-          cache_Y = (overflow_bot >= 0 ? overflow_bot : 0);
-        } else if (overflow_left <= 0 && overflow_top < 0 && overflow_bot > 0) {
-          case_num = 3;
-          cache_X = (overflow_right >= 0 ? overflow_right : 0);
-          cache_Y = overflow_bot;
-        } else {
-          // This cannot happen.
-          continue;
-        }
+      if (overflow_left <= 0 && overflow_right <= 0 && overflow_top <= 0 &&
+          overflow_bot <= 0) {
+        // clang-format off
+        // The kernel does not stick out.
+        // This output pixel corresponds to a completely 'valid' region
+        // of the input and there is no padding: we are entering the inside
+        // of the image.
+        // We now *skip* from the left to the right edge of the image.
+        // We want to find `out_x` such that `overflow_right >= 1`
+        // We have
+        // overflow_right = out_x * stride - offset + effective_filter_width - width
+        // So we want
+        // out_x * stride >= width + offset - effective_filter_width + 1
+        // So we want `out_x` to be the ceiling of
+        // (input_with + offset - effective_filter_width + 1) / stride
+        // clang-format on
+        int new_out_x = (input_width + filter_left_offset -
+                         effective_filter_width + stride_cols - 1) /
+                            stride_cols -
+                        1;
+        // The extra -1 is because the for-loop will increment it again
+        if (new_out_x > out_x) out_x = new_out_x;
+        continue;
+      }
+      // See the `create_cache` function for an explanation of these cases
+      int case_num;
+      int cache_X;
+      int cache_Y;
+      if (overflow_right <= 0 && overflow_top > 0 && overflow_bot < 0) {
+        case_num = 0;
+        cache_X = (overflow_left >= 0 ? overflow_left : 0);
+        cache_Y = overflow_top;
+      } else if (overflow_left < 0 && overflow_right > 0 &&
+                 overflow_bot <= 0) {
+        case_num = 1;
+        cache_X = overflow_right;
+        cache_Y = (overflow_top >= 0 ? overflow_top : 0);
+      } else if (overflow_left > 0 && overflow_right < 0 &&
+                 overflow_top <= 0) {
+        case_num = 2;
+        cache_X = overflow_left;
+        cache_Y = (overflow_bot >= 0 ? overflow_bot : 0);
+      } else if (overflow_left <= 0 && overflow_top < 0 && overflow_bot > 0) {
+        case_num = 3;
+        cache_X = (overflow_right >= 0 ? overflow_right : 0);
+        cache_Y = overflow_bot;
+      } else {
+        // This cannot happen.
+        continue;
+      }
 
-        // Cache is out_channels last
-        // Output is also out_channels last
-        // So we can have a very effective loop here
+      // Cache is out_channels last
+      // Output is also out_channels last
+      // So we can have a very effective loop here
 
-        // Cache shape is [case, filter_height, filter_width,
-        // out_channels]
-        int cache_idx = case_num * (effective_filter_height *
-                                    effective_filter_width * filter_count) +
-                        cache_Y * (effective_filter_width * filter_count) +
-                        cache_X * filter_count;
-        // Output shape is [batch, height, width, out_channels]
-        const int out_idx =
-            batch * output_height * output_width * filter_count +
-            out_y * output_width * filter_count + out_x * filter_count;
+      // Cache shape is [case, filter_height, filter_width,
+      // out_channels]
+      int cache_idx = case_num * (effective_filter_height *
+                                  effective_filter_width * filter_count) +
+                      cache_Y * (effective_filter_width * filter_count) +
+                      cache_X * filter_count;
+      // Output shape is [batch, height, width, out_channels]
+      const int out_idx =
+          batch * output_height * output_width * filter_count +
+          out_y * output_width * filter_count + out_x * filter_count;
 
-        const float* cache_ptr = &padding_cache[cache_idx];
-        float* output_ptr = &output_data[out_idx];
+      const float* cache_ptr = &padding_cache[cache_idx];
+      float* output_ptr = &output_data[out_idx];
 
-        // Apply pre-computed correction
-        // im2col padded the input with 0s which effectively became +1s.
-        // The convolution therefore computed
-        // out = correct_part + (+1) * (outside_filter_values)
-        // So to correct for this we add (-1) * (outside_filter_values)
-        for (int out_c = 0; out_c < filter_count; ++out_c) {
-          *output_ptr++ += *cache_ptr++;
-        }
+      // Apply pre-computed correction
+      // im2col padded the input with 0s which effectively became +1s.
+      // The convolution therefore computed
+      // out = correct_part + (+1) * (outside_filter_values)
+      // So to correct for this we add (-1) * (outside_filter_values)
+      for (int out_c = 0; out_c < filter_count; ++out_c) {
+        *output_ptr++ += *cache_ptr++;
+      }
 
-      }  // out_x
-    }    // out_y
-  }      // batch
+    }  // out_x
+  }  // row
   return;
 }
 
+void ApplyCorrection(const int input_batches, const int input_height,
+                     const int input_width, const int input_channels,
+                     const int filter_height, const int filter_width,
+                     const int filter_count, const int stride_rows,
+                     const int stride_cols, const int dilation_rows,
+                     const int dilation_cols, float* output_data,
+                     const int output_height, const int output_width,
+                     const float* padding_cache) {
+  ApplyCorrectionToRows(input_height, input_width, filter_height, filter_width,
+                        filter_count, stride_rows, stride_cols, dilation_rows,
+                        dilation_cols, output_data, output_height, output_width,
+                        padding_cache, 0, input_batches * output_height);
+}
+
 }  // namespace zero_padding_correction
 }  // namespace bconv2d
 }  // namespace core
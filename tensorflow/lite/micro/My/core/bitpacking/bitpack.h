@@ -1,6 +1,7 @@
 #ifndef COMPUTE_ENGINE_CORE_BITPACKING_BITPACK_H_
 #define COMPUTE_ENGINE_CORE_BITPACKING_BITPACK_H_
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <cstring>
@@ -8,11 +9,13 @@
 
 #include "tensorflow/lite/micro/My/core/types.h"
 #ifdef __aarch64__
-#include "larq_compute_engine/core/bitpacking/bitpack_aarch64.h"
+#include "tensorflow/lite/micro/My/core/bitpacking/bitpack_aarch64.h"
+#endif
+#if defined(__x86_64__) && defined(__GNUC__)
+#include "tensorflow/lite/micro/My/core/bitpacking/bitpack_x86.h"
 #endif
 
 #include "flatbuffers/base.h"  // Used for the FLATBUFFERS_LITTLEENDIAN macro
-#include "ruy/profiler/instrumentation.h"
 #include "tensorflow/lite/kernels/internal/types.h"
 
 namespace compute_engine {
@@ -32,8 +35,6 @@ constexpr int GetBitpackedMatrixSize(int rows, int cols) {
 template <class TIn>
 inline void bitpack_bitfield_quantized(const TIn* in, TBitpacked* out,
                                        const TIn zero_point) {
-  ruy::profiler::ScopeLabel label(
-      "Bitpack bitfield (quantized input, unoptimised)");
   struct bf {
     unsigned int b0 : 1;
     unsigned int b1 : 1;
@@ -112,9 +113,6 @@ inline void bitpack_bitfield_quantized(const TIn* in, TBitpacked* out,
 
 template <class T>
 inline void bitpack_bitfield(const T* fptr, TBitpacked* buf) {
-  ruy::profiler::ScopeLabel label(
-      "Bitpack bitfield (non-quantized input, unoptimised)");
-
   struct bf {
     unsigned int b0 : 1;
     unsigned int b1 : 1;
@@ -225,6 +223,15 @@ inline void bitpack_array(const TIn* input_array, const std::size_t n,
     out += 4 * num_4x32_blocks;
     num_packed_elems %= 4;
   }
+#endif
+#if defined(__x86_64__) && defined(__GNUC__)
+  if ((std::is_same<TIn, float>::value && zero_point == 0) ||
+      std::is_same<TIn, std::int8_t>::value) {
+    bitpack_x86_32(in, num_packed_elems, out, zero_point);
+    in += bitpacking_bitwidth * num_packed_elems;
+    out += num_packed_elems;
+    num_packed_elems = 0;
+  }
 #endif
   while (num_packed_elems--) {
     bitpack_bitfield(in, out++, zero_point);
@@ -311,7 +318,6 @@ template <typename TUnpacked>
 void unpack_bitfield(const TBitpacked in, TUnpacked*& out,
                      std::size_t num_elements, const TUnpacked zero_bit_result,
                      const TUnpacked one_bit_result) {
-  ruy::profiler::ScopeLabel label("Unpack bitfield (unoptimised)");
   for (size_t i = 0; i < num_elements; ++i) {
     *out++ = (in & (TBitpacked(1) << i)) ? one_bit_result : zero_bit_result;
   }
@@ -7,8 +7,7 @@
 
 #include <cstdint>
 
-#include "larq_compute_engine/core/types.h"
-#include "ruy/profiler/instrumentation.h"
+#include "tensorflow/lite/micro/My/core/types.h"
 #include "tensorflow/lite/kernels/op_macros.h"
 
 namespace compute_engine {
@@ -30,7 +29,6 @@ inline void bitpack_aarch64_4x32(const float* input, std::size_t num_blocks,
                 "Correctness of this function relies on the size of TBitpacked "
                 "being 4 bytes.");
 
-  ruy::profiler::ScopeLabel label("Bitpack 4x32 floats (optimised)");
 
   if (num_blocks < 1) return;
 
@@ -243,7 +241,6 @@ inline void bitpack_aarch64_4x32(const std::int8_t* input,
                 "Correctness of this function relies on the size of TBitpacked "
                 "being 4 bytes.");
 
-  ruy::profiler::ScopeLabel label("Bitpack 4x32 Int8 bytes (optimised)");
 
   if (num_blocks < 1) return;
 
@@ -0,0 +1,131 @@
+#ifndef COMPUTE_ENGINE_CORE_BITPACKING_BITPACK_X86_H_
+#define COMPUTE_ENGINE_CORE_BITPACKING_BITPACK_X86_H_
+
+#ifndef __x86_64__
+#pragma GCC error "ERROR: This file should only be compiled for x86-64."
+#endif
+
+#include <immintrin.h>
+
+#include <cstdint>
+
+#include "tensorflow/lite/micro/My/core/types.h"
+#include "tensorflow/lite/kernels/op_macros.h"
+
+namespace compute_engine {
+namespace core {
+namespace bitpacking {
+
+// SSE2 is part of the x86-64 baseline, so only the AVX2 functions, which are
+// compiled with a target attribute, need a check at runtime.
+inline bool CpuSupportsAvx2Bitpacking() {
+  static const bool supported = __builtin_cpu_supports("avx2");
+  return supported;
+}
+
+// The functions below bitpack `32 * num_blocks` values into `num_blocks`
+// words. Bit i of a word is set when value i is negative (for float) or less
+// than the zero point (for int8), exactly as in bitpack_bitfield(). For float
+// the comparison is done with an ordered less-than rather than by moving the
+// sign bits out directly, so that -0.0 and negative NaNs pack to 0.
+
+inline void bitpack_sse2_32(const float* input, std::size_t num_blocks,
+                            TBitpacked* output) {
+  const __m128 zero = _mm_setzero_ps();
+  for (std::size_t b = 0; b < num_blocks; ++b) {
+    std::uint32_t word = 0;
+    for (int i = 0; i < 8; ++i) {
+      const __m128 x = _mm_loadu_ps(input + 4 * i);
+      word |= std::uint32_t(_mm_movemask_ps(_mm_cmplt_ps(x, zero))) << (4 * i);
+    }
+    *output++ = static_cast<TBitpacked>(word);
+    input += 32;
+  }
+}
+
+inline void bitpack_sse2_32(const std::int8_t* input, std::size_t num_blocks,
+                            TBitpacked* output, const std::int8_t zero_point) {
+  const __m128i zp = _mm_set1_epi8(zero_point);
+  for (std::size_t b = 0; b < num_blocks; ++b) {
+    const __m128i lo =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(input));
+    const __m128i hi =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + 16));
+    const std::uint32_t word =
+        std::uint32_t(_mm_movemask_epi8(_mm_cmplt_epi8(lo, zp))) |
+        (std::uint32_t(_mm_movemask_epi8(_mm_cmplt_epi8(hi, zp))) << 16);
+    *output++ = static_cast<TBitpacked>(word);
+    input += 32;
+  }
+}
+
+__attribute__((target("avx2"))) inline void bitpack_avx2_32(
+    const float* input, std::size_t num_blocks, TBitpacked* output) {
+  const __m256 zero = _mm256_setzero_ps();
+  for (std::size_t b = 0; b < num_blocks; ++b) {
+    std::uint32_t word = 0;
+    for (int i = 0; i < 4; ++i) {
+      const __m256 x = _mm256_loadu_ps(input + 8 * i);
+      word |= std::uint32_t(_mm256_movemask_ps(
+                  _mm256_cmp_ps(x, zero, _CMP_LT_OQ)))
+              << (8 * i);
+    }
+    *output++ = static_cast<TBitpacked>(word);
+    input += 32;
+  }
+}
+
+__attribute__((target("avx2"))) inline void bitpack_avx2_32(
+    const std::int8_t* input, std::size_t num_blocks, TBitpacked* output,
+    const std::int8_t zero_point) {
+  const __m256i zp = _mm256_set1_epi8(zero_point);
+  for (std::size_t b = 0; b < num_blocks; ++b) {
+    const __m256i x =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input));
+    // There is no signed less-than for bytes, so compute zero_point > x.
+    *output++ = static_cast<TBitpacked>(
+        _mm256_movemask_epi8(_mm256_cmpgt_epi8(zp, x)));
+    input += 32;
+  }
+}
+
+template <typename T>
+inline void bitpack_x86_32(const T* input, std::size_t num_blocks,
+                           TBitpacked* output, const T zero_point) {
+  TFLITE_ASSERT_FALSE;
+}
+
+// Bitpack an array of `32 * num_blocks` floats.
+template <>
+inline void bitpack_x86_32(const float* input, std::size_t num_blocks,
+                           TBitpacked* output,
+                           const float zero_point /*ignored*/) {
+  static_assert(sizeof(TBitpacked) == 4,
+                "Correctness of this function relies on the size of TBitpacked "
+                "being 4 bytes.");
+  if (CpuSupportsAvx2Bitpacking()) {
+    bitpack_avx2_32(input, num_blocks, output);
+  } else {
+    bitpack_sse2_32(input, num_blocks, output);
+  }
+}
+
+// Bitpack an array of `32 * num_blocks` int8 values.
+template <>
+inline void bitpack_x86_32(const std::int8_t* input, std::size_t num_blocks,
+                           TBitpacked* output, const std::int8_t zero_point) {
+  static_assert(sizeof(TBitpacked) == 4,
+                "Correctness of this function relies on the size of TBitpacked "
+                "being 4 bytes.");
+  if (CpuSupportsAvx2Bitpacking()) {
+    bitpack_avx2_32(input, num_blocks, output, zero_point);
+  } else {
+    bitpack_sse2_32(input, num_blocks, output, zero_point);
+  }
+}
+
+}  // namespace bitpacking
+}  // namespace core
+}  // namespace compute_engine
+
+#endif  // COMPUTE_ENGINE_CORE_BITPACKING_BITPACK_X86_H_
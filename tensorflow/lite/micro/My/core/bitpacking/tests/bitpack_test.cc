@@ -4,6 +4,7 @@
 
 #include <array>
 #include <cstdint>
+#include <limits>
 #include <random>
 #include <vector>
 
@@ -104,11 +105,103 @@ INSTANTIATE_TEST_SUITE_P(Bitpacking, BitpackingTest,
                              // num_rows
                              ::testing::Values(1, 2, 3, 8, 10, 15, 64),
                              // num_cols
-                             ::testing::Values(1, 3, 16, 32, 33, 63, 64, 128),
+                             ::testing::Values(1, 3, 16, 32, 33, 63, 64, 128,
+                                               300),
                              // zero_point
                              ::testing::Values(-1000, -1, 0, 23, 127, 128)),
                          TestName);
 
+#if defined(__x86_64__) && defined(__GNUC__)
+
+// The SSE2 and AVX2 bitpacking functions are also tested directly, so that
+// both are covered regardless of which one bitpack_array() picks at runtime.
+// The inputs contain the values for which a sign-bit based implementation
+// would differ from the scalar comparison.
+
+template <typename TIn, typename PackFn>
+void runX86BitpackingTest(const std::vector<TIn>& input, const TIn zero_point,
+                          PackFn pack) {
+  const std::size_t num_blocks = input.size() / bitpacking_bitwidth;
+  std::vector<TBitpacked> expected(num_blocks);
+  std::vector<TBitpacked> output(num_blocks);
+  for (std::size_t b = 0; b < num_blocks; ++b) {
+    bitpack_bitfield(input.data() + b * bitpacking_bitwidth, &expected[b],
+                     zero_point);
+  }
+  pack(input.data(), num_blocks, output.data());
+  EXPECT_EQ(output, expected);
+}
+
+TEST(BitpackX86Test, Float) {
+  std::mt19937 gen(1234);
+  const float special_values[] = {
+      0.0f,
+      -0.0f,
+      std::numeric_limits<float>::infinity(),
+      -std::numeric_limits<float>::infinity(),
+      std::numeric_limits<float>::quiet_NaN(),
+      -std::numeric_limits<float>::quiet_NaN(),
+      std::numeric_limits<float>::denorm_min(),
+      -std::numeric_limits<float>::denorm_min()};
+
+  for (const int num_blocks : {1, 3, 17}) {
+    std::vector<float> input(num_blocks * bitpacking_bitwidth);
+    for (float& value : input) {
+      if (std::uniform_int_distribution<>(0, 3)(gen) == 0) {
+        value = special_values[std::uniform_int_distribution<>(0, 7)(gen)];
+      } else {
+        value = std::uniform_real_distribution<float>(-1.5f, 1.5f)(gen);
+      }
+    }
+
+    runX86BitpackingTest<float>(
+        input, 0.0f, [](const float* in, std::size_t n, TBitpacked* out) {
+          bitpack_sse2_32(in, n, out);
+        });
+    if (CpuSupportsAvx2Bitpacking()) {
+      runX86BitpackingTest<float>(
+          input, 0.0f, [](const float* in, std::size_t n, TBitpacked* out) {
+            bitpack_avx2_32(in, n, out);
+          });
+    }
+  }
+}
+
+TEST(BitpackX86Test, Int8) {
+  std::mt19937 gen(1234);
+  for (const int zero_point : {-128, -1, 0, 23, 127}) {
+    for (const int num_blocks : {1, 3, 17}) {
+      std::vector<std::int8_t> input(num_blocks * bitpacking_bitwidth);
+      for (std::int8_t& value : input) {
+        // Use the zero point and its neighbours more often than the rest.
+        const int offset = std::uniform_int_distribution<>(-2, 2)(gen);
+        if (std::uniform_int_distribution<>(0, 1)(gen) == 0 &&
+            zero_point + offset >= -128 && zero_point + offset <= 127) {
+          value = zero_point + offset;
+        } else {
+          value = std::uniform_int_distribution<>(-128, 127)(gen);
+        }
+      }
+
+      const std::int8_t zp = zero_point;
+      runX86BitpackingTest<std::int8_t>(
+          input, zp,
+          [zp](const std::int8_t* in, std::size_t n, TBitpacked* out) {
+            bitpack_sse2_32(in, n, out, zp);
+          });
+      if (CpuSupportsAvx2Bitpacking()) {
+        runX86BitpackingTest<std::int8_t>(
+            input, zp,
+            [zp](const std::int8_t* in, std::size_t n, TBitpacked* out) {
+              bitpack_avx2_32(in, n, out, zp);
+            });
+      }
+    }
+  }
+}
+
+#endif
+
 }  // namespace bitpacking
 }  // namespace core
 }  // namespace compute_engine
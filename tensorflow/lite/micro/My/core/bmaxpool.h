@@ -1,7 +1,7 @@
 #ifndef COMPUTE_ENGINE_CORE_BMAXPOOL_H_
 #define COMPUTE_ENGINE_CORE_BMAXPOOL_H_
 
-#include "larq_compute_engine/core/types.h"
+#include "tensorflow/lite/micro/My/core/types.h"
 #include "tensorflow/lite/kernels/internal/common.h"
 #include "tensorflow/lite/kernels/internal/types.h"
 #include "tensorflow/lite/kernels/padding.h"
@@ -9,7 +9,7 @@
 namespace compute_engine {
 namespace core {
 
-using namespace tflite;
+using namespace ::tflite;
 
 struct BMaxPoolParams {
   std::int32_t filter_height{0};
@@ -21,9 +21,11 @@ struct BMaxPoolParams {
 };
 
 // Effectively takes the AND of everything in the filter region
-void BMaxPool(const BMaxPoolParams& params, const RuntimeShape& input_shape,
-              const TBitpacked* input_data, const RuntimeShape& output_shape,
-              TBitpacked* output_data) {
+inline void BMaxPool(const BMaxPoolParams& params,
+                     const RuntimeShape& input_shape,
+                     const TBitpacked* input_data,
+                     const RuntimeShape& output_shape,
+                     TBitpacked* output_data) {
   TFLITE_DCHECK_EQ(input_shape.DimensionsCount(), 4);
   TFLITE_DCHECK_EQ(output_shape.DimensionsCount(), 4);
   const int batches = MatchingDim(input_shape, 0, output_shape, 0);
@@ -1,6 +1,7 @@
 #ifndef COMPUTE_ENGINE_INDIRECT_BGEMM_KERNEL_H_
 #define COMPUTE_ENGINE_INDIRECT_BGEMM_KERNEL_H_
 
+#include <algorithm>
 #include <cstdint>
 #include <vector>
 
@@ -13,6 +14,96 @@ namespace compute_engine {
 namespace core {
 namespace indirect_bgemm {
 
+using ::tflite::RuntimeShape;
+
+// Stands in for a ThreadPool from thread_pool.h when there is none: it runs
+// the whole range on the calling thread. The thread pool is a template
+// parameter of the functions that split work over it, so that the kernels
+// don't depend on <thread> in single-threaded builds.
+struct NoThreadPool {
+  int num_threads() const { return 1; }
+
+  template <typename RangeFunction>
+  void ParallelFor(const std::int32_t begin, const std::int32_t end,
+                   const std::int32_t, const RangeFunction& fn) const {
+    if (begin < end) fn(begin, end);
+  }
+};
+
+// The shape parameters that determine the layout of the packed weights: the
+// tile shape of a micro-kernel and the shape of the convolution.
+struct PackedWeightsLayout {
+  std::int32_t block_size_output_channels;
+  std::int32_t block_size_depth;
+  std::int32_t input_depth;
+  std::int32_t output_channels;
+  std::int32_t filter_size;
+  std::int32_t groups;
+};
+
+// Number of TBitpacked words of packed weights for `layout`.
+inline std::int32_t GetPackedWeightsSize(const PackedWeightsLayout& layout) {
+  const auto output_channels_per_group = layout.output_channels / layout.groups;
+  return layout.groups *
+             Ceil(output_channels_per_group,
+                  layout.block_size_output_channels) *
+             layout.filter_size * (layout.input_depth / layout.groups) +
+         /* padding */ layout.block_size_output_channels *
+             layout.block_size_depth;
+}
+
+/**
+ * Pack the weights in the correct order into `packed_weights`, which must hold
+ * GetPackedWeightsSize(layout) words. This only depends on the layout, so it
+ * can also be done offline. This procedure is (heavily) adapted from the
+ * following XNNPack function:
+ * https://github.com/google/XNNPACK/blob/80a8ac59849bfdae8d2e1409f5642baa502c0b9e/src/packing.c#L429-L484
+ */
+inline void PackWeights(const PackedWeightsLayout& layout,
+                        const TBitpacked* weights_ptr,
+                        TBitpacked* packed_weights) {
+  const auto block_size_output_channels = layout.block_size_output_channels;
+  const auto block_size_depth = layout.block_size_depth;
+  const auto filter_size = layout.filter_size;
+  const auto groups = layout.groups;
+  const auto input_depth_per_group = layout.input_depth / groups;
+  const auto output_channels_per_group = layout.output_channels / groups;
+
+  // The blocks of output channels at the end of each group, and the padding
+  // at the end, are filled with zeroes.
+  std::fill(packed_weights, packed_weights + GetPackedWeightsSize(layout),
+            TBitpacked(0));
+  std::int32_t packed_weights_index = 0;
+  for (std::int32_t group_id = 0; group_id < groups; group_id++) {
+    for (std::int32_t block_start = 0; block_start < output_channels_per_group;
+         block_start += block_size_output_channels) {
+      const std::int32_t block_size = std::min(
+          output_channels_per_group - block_start, block_size_output_channels);
+      for (std::int32_t fi = 0; fi < filter_size; fi++) {
+        for (std::int32_t ci = 0; ci < input_depth_per_group;
+             ci += block_size_depth) {
+          for (std::int32_t block_offset = 0; block_offset < block_size;
+               block_offset++) {
+            for (std::int32_t ci_offset = 0; ci_offset < block_size_depth;
+                 ci_offset++) {
+              const std::int32_t weights_index =
+                  (group_id * output_channels_per_group * filter_size *
+                   input_depth_per_group) +
+                  ((block_start + block_offset) * filter_size *
+                   input_depth_per_group) +
+                  fi * input_depth_per_group + ci + ci_offset;
+              packed_weights[packed_weights_index++] =
+                  weights_ptr[weights_index];
+            }
+          }
+          packed_weights_index +=
+              (block_size_output_channels - block_size) * block_size_depth;
+        }
+      }
+    }
+  }
+}
+
 class Kernel {
  public:
   const std::int32_t block_size_output_channels;
@@ -25,19 +116,28 @@ class Kernel {
   const std::int32_t groups;
   const std::int32_t num_output_pixels;
 
+  // The packed weights used by Run(). They point either into
+  // `packed_weights` or to weights that were packed ahead of time.
+  const TBitpacked* packed_weights_ptr = nullptr;
   std::vector<TBitpacked> packed_weights;
+
+  // The indirection buffer used by Run(). It points either into
+  // `indirection_buffer` or to the storage given to UseIndirectionStorage().
+  const TBitpacked* const* indirection_buffer_ptr = nullptr;
   std::vector<const TBitpacked*> indirection_buffer;
   std::vector<TBitpacked> zero_buffer;
+  const TBitpacked** indirection_storage = nullptr;
+  TBitpacked* zero_storage = nullptr;
 
-  Kernel(const std::int32_t block_size_output_channels,
-         const std::int32_t block_size_pixels,
-         const std::int32_t block_size_depth,
+  Kernel(const std::int32_t block_size_output_channels_in,
+         const std::int32_t block_size_pixels_in,
+         const std::int32_t block_size_depth_in,
          const bconv2d::BConv2DParams* bconv2d_params,
          const RuntimeShape& bitpacked_input_shape,
          const RuntimeShape& output_shape)
-      : block_size_output_channels(block_size_output_channels),
-        block_size_pixels(block_size_pixels),
-        block_size_depth(block_size_depth),
+      : block_size_output_channels(block_size_output_channels_in),
+        block_size_pixels(block_size_pixels_in),
+        block_size_depth(block_size_depth_in),
         input_depth(bitpacked_input_shape.Dims(3)),
         output_channels(bconv2d_params->channels_out),
         filter_size(bconv2d_params->filter_height *
@@ -46,51 +146,46 @@ class Kernel {
         num_output_pixels(bitpacked_input_shape.Dims(0) * output_shape.Dims(1) *
                           output_shape.Dims(2)) {}
 
-  /**
-   * Pack the weights in the correct order. This procedure is (heavily)
-   * adapted from the following XNNPack function:
-   * https://github.com/google/XNNPACK/blob/80a8ac59849bfdae8d2e1409f5642baa502c0b9e/src/packing.c#L429-L484
-   */
+  PackedWeightsLayout GetPackedWeightsLayout() const {
+    return {block_size_output_channels, block_size_depth, input_depth,
+            output_channels, filter_size, groups};
+  }
+
+  // Packs the weights into memory owned by the kernel.
   void PackWeights(const TBitpacked* weights_ptr) {
-    const auto input_depth_per_group = input_depth / groups;
-    const auto output_channels_per_group = output_channels / groups;
-    const auto rounded_up_output_channels_per_group =
-        Ceil(output_channels_per_group, block_size_output_channels);
-    packed_weights.resize(groups * rounded_up_output_channels_per_group *
-                              filter_size * input_depth_per_group +
-                          /* padding */ block_size_output_channels *
-                              block_size_depth);
-    std::int32_t packed_weights_index = 0;
-    for (std::int32_t group_id = 0; group_id < groups; group_id++) {
-      for (std::int32_t block_start = 0;
-           block_start < output_channels_per_group;
-           block_start += block_size_output_channels) {
-        const std::int32_t block_size =
-            std::min(output_channels_per_group - block_start,
-                     block_size_output_channels);
-        for (std::int32_t fi = 0; fi < filter_size; fi++) {
-          for (std::int32_t ci = 0; ci < input_depth_per_group;
-               ci += block_size_depth) {
-            for (std::int32_t block_offset = 0; block_offset < block_size;
-                 block_offset++) {
-              for (std::int32_t ci_offset = 0; ci_offset < block_size_depth;
-                   ci_offset++) {
-                const std::int32_t weights_index =
-                    (group_id * output_channels_per_group * filter_size *
-                     input_depth_per_group) +
-                    ((block_start + block_offset) * filter_size *
-                     input_depth_per_group) +
-                    fi * input_depth_per_group + ci + ci_offset;
-                packed_weights.at(packed_weights_index++) =
-                    weights_ptr[weights_index];
-              }
-            }
-            packed_weights_index +=
-                (block_size_output_channels - block_size) * block_size_depth;
-          }
-        }
-      }
-    }
+    const PackedWeightsLayout layout = GetPackedWeightsLayout();
+    packed_weights.resize(GetPackedWeightsSize(layout));
+    indirect_bgemm::PackWeights(layout, weights_ptr, packed_weights.data());
+    packed_weights_ptr = packed_weights.data();
+  }
+
+  // Uses weights that were packed ahead of time for this kernel's layout, for
+  // example with PackWeights() in an offline tool. They are not copied, so
+  // they must outlive the kernel.
+  void UsePackedWeights(const TBitpacked* prepacked_weights) {
+    packed_weights.clear();
+    packed_weights.shrink_to_fit();
+    packed_weights_ptr = prepacked_weights;
+  }
+
+  // Number of pointers in the indirection buffer.
+  std::int32_t GetIndirectionBufferSize() const {
+    return Ceil(num_output_pixels, block_size_pixels) * filter_size +
+           block_size_pixels;
+  }
+
+  // Number of words in the zero buffer that the indirection buffer points to
+  // for padding.
+  std::int32_t GetZeroBufferSize() const { return filter_size * input_depth; }
+
+  // Makes FillIndirectionBuffer() write to memory owned by the caller, for
+  // example in a TFLM arena, instead of allocating it.
+  // `indirection_storage_in` must hold GetIndirectionBufferSize() pointers and
+  // `zero_storage_in` GetZeroBufferSize() words.
+  void UseIndirectionStorage(const TBitpacked** indirection_storage_in,
+                             TBitpacked* zero_storage_in) {
+    indirection_storage = indirection_storage_in;
+    zero_storage = zero_storage_in;
   }
 
   /**
@@ -117,13 +212,22 @@ class Kernel {
     const auto output_size = num_output_pixels;
     const auto tiled_output_size = Ceil(output_size, block_size_pixels);
 
-    // Create the indirection buffer with padding (+ block_size_pixels) and fill
-    // it with pointers to the first element of the input, so that the padding
-    // at the end of the array contains pointers to valid memory.
-    indirection_buffer.assign(
-        tiled_output_size * filter_size + block_size_pixels, input_ptr);
-    // Assign the zero buffer that will be used for padding.
-    zero_buffer.assign(filter_size * input_depth, 0);
+    const TBitpacked** indirection = indirection_storage;
+    TBitpacked* zeros = zero_storage;
+    if (indirection == nullptr) {
+      indirection_buffer.resize(GetIndirectionBufferSize());
+      zero_buffer.resize(GetZeroBufferSize());
+      indirection = indirection_buffer.data();
+      zeros = zero_buffer.data();
+    }
+    indirection_buffer_ptr = indirection;
+
+    // The indirection buffer has padding (+ block_size_pixels). Fill it with
+    // pointers to the first element of the input, so that the padding at the
+    // end of the array contains pointers to valid memory.
+    std::fill(indirection, indirection + GetIndirectionBufferSize(), input_ptr);
+    // Clear the zero buffer that will be used for padding.
+    std::fill(zeros, zeros + GetZeroBufferSize(), TBitpacked(0));
 
     for (std::int32_t output_tile_start = 0;
          output_tile_start < tiled_output_size;
@@ -151,12 +255,12 @@ class Kernel {
                                          kernel_index * block_size_pixels +
                                          output_tile_offset;
               if (FastBoundsCheck(input_x, input_width)) {
-                indirection_buffer.at(index) =
+                indirection[index] =
                     (input_ptr + (batch_index * input_height * input_width +
                                   input_y * input_width + input_x) *
                                      input_depth);
               } else {
-                indirection_buffer.at(index) = zero_buffer.data();
+                indirection[index] = zeros;
               }
             }
           } else {
@@ -165,7 +269,7 @@ class Kernel {
               const std::int32_t index = output_tile_start * filter_size +
                                          kernel_index * block_size_pixels +
                                          output_tile_offset;
-              indirection_buffer.at(index) = zero_buffer.data();
+              indirection[index] = zeros;
             }
           }
         }
@@ -177,10 +281,40 @@ class Kernel {
   virtual void Run(const std::int32_t pixel_start, const std::int32_t pixel_end,
                    void* output_ptr) const = 0;
 
-  void Dispatch(void* output_ptr) const {
-    // TODO: implement multithreading here.
-    Run(0, num_output_pixels, output_ptr);
-  };
+  // Returns the number of output pixels that are computed per Run() call
+  // when dispatching to a thread pool. A chunk is a whole number of pixel
+  // tiles, so that Run() can start at the beginning of the chunk. It is
+  // sized so that the activations it reads and the outputs it writes fit in
+  // about `kChunkBytes`, but is made smaller for small convolutions, so that
+  // every thread still gets a few chunks to balance the load.
+  std::int32_t GetPixelChunkSize(const int num_threads) const {
+    constexpr std::int32_t kChunkBytes = 32 * 1024;
+    constexpr std::int32_t kMinChunksPerThread = 4;
+    const std::int32_t bytes_per_pixel =
+        (filter_size * input_depth + output_channels) * sizeof(TBitpacked);
+    const std::int32_t num_tiles =
+        CeilDiv(num_output_pixels, block_size_pixels);
+    const std::int32_t tiles_per_chunk = std::max<std::int32_t>(
+        1, std::min(kChunkBytes / (bytes_per_pixel * block_size_pixels),
+                    num_tiles / (kMinChunksPerThread * num_threads)));
+    return tiles_per_chunk * block_size_pixels;
+  }
+
+  // Computes all output pixels, split over the threads of `thread_pool` if
+  // one is given. The caller of the threaded version includes thread_pool.h.
+  template <typename ThreadPoolT = NoThreadPool>
+  void Dispatch(void* output_ptr, ThreadPoolT* thread_pool = nullptr) const {
+    if (thread_pool == nullptr || thread_pool->num_threads() == 1) {
+      Run(0, num_output_pixels, output_ptr);
+      return;
+    }
+    thread_pool->ParallelFor(
+        0, num_output_pixels, GetPixelChunkSize(thread_pool->num_threads()),
+        [this, output_ptr](const std::int32_t pixel_start,
+                           const std::int32_t pixel_end) {
+          Run(pixel_start, pixel_end, output_ptr);
+        });
+  }
 
   virtual ~Kernel() {}
 };
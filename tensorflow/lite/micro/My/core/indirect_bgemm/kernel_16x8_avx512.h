@@ -0,0 +1,137 @@
+#ifndef COMPUTE_ENGINE_INDIRECT_BGEMM_KERNEL_16x8_AVX512_H_
+#define COMPUTE_ENGINE_INDIRECT_BGEMM_KERNEL_16x8_AVX512_H_
+
+#if !defined(__x86_64__) && !defined(__i386__)
+#pragma GCC error "ERROR: This file should only be compiled for x86."
+#endif
+
+#include <immintrin.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+
+#include "tensorflow/lite/micro/My/core/bconv2d/output_transform.h"
+#include "tensorflow/lite/micro/My/core/bconv2d/params.h"
+#include "tensorflow/lite/micro/My/core/indirect_bgemm/kernel.h"
+#include "tensorflow/lite/micro/My/core/indirect_bgemm/kernel_8x4_avx2.h"
+#include "tensorflow/lite/micro/My/core/types.h"
+#include "tensorflow/lite/kernels/internal/types.h"
+
+namespace compute_engine {
+namespace core {
+namespace indirect_bgemm {
+
+// Returns true if the CPU we are running on supports the AVX-512 VPOPCNTDQ
+// kernel.
+inline bool CpuSupportsAvx512Vpopcntdq() {
+  static const bool supported = __builtin_cpu_supports("avx512f") &&
+                                __builtin_cpu_supports("avx512vpopcntdq");
+  return supported;
+}
+
+/**
+ * An AVX-512 micro-kernel for float or int8 output that computes a tile of 16
+ * output channels by 8 pixels.
+ *
+ * The weights use the same layout as in the AVX2 kernel, with a depth block
+ * of one word: one 512-bit load holds an input word for 16 output channels.
+ * VPOPCNTDQ counts each 32-bit lane directly, so the counts are added straight
+ * into the int32 accumulators. With 32 vector registers there is room for 8
+ * pixels of accumulators, which halves the number of weight loads per output
+ * compared with a 4-pixel tile.
+ */
+template <typename DstScalar>
+class Kernel16x8Avx512 : public Kernel {
+  static_assert(std::is_same<DstScalar, float>::value ||
+                    std::is_same<DstScalar, std::int8_t>::value,
+                "");
+
+  static constexpr int kChannels = 16;
+  static constexpr int kPixels = 8;
+
+  const bconv2d::OutputTransform<DstScalar> output_transform;
+
+ public:
+  Kernel16x8Avx512(
+      const bconv2d::BConv2DParams* bconv2d_params,
+      const RuntimeShape& bitpacked_input_shape,
+      const RuntimeShape& output_shape,
+      const bconv2d::OutputTransform<DstScalar>& output_transform_in)
+      : Kernel(kChannels, kPixels, 1, bconv2d_params, bitpacked_input_shape,
+               output_shape),
+        output_transform(output_transform_in) {}
+
+  __attribute__((target("avx512f,avx512vpopcntdq"))) void Run(
+      const std::int32_t pixel_start, const std::int32_t pixel_end,
+      void* output_ptr) const override {
+    TFLITE_DCHECK_GE(this->input_depth, 1);
+    TFLITE_DCHECK_GE(this->output_channels, 1);
+    TFLITE_DCHECK_GE(this->filter_size, 1);
+    TFLITE_DCHECK_GE(this->groups, 1);
+    TFLITE_DCHECK_EQ(this->input_depth % this->groups, 0);
+    TFLITE_DCHECK_EQ(this->output_channels % this->groups, 0);
+
+    const std::int32_t input_depth_per_group = this->input_depth / this->groups;
+    const std::int32_t output_channels_per_group =
+        this->output_channels / this->groups;
+
+    alignas(64) std::int32_t accumulators[kPixels][kChannels];
+
+    for (std::int32_t p_index = pixel_start; p_index < pixel_end;
+         p_index += kPixels) {
+      const int num_pixels = std::min(kPixels, pixel_end - p_index);
+      const TBitpacked* weights_ptr = this->packed_weights_ptr;
+      const TBitpacked* const* indirection_ptr =
+          this->indirection_buffer_ptr + p_index * this->filter_size;
+      DstScalar* pixel_output_ptr = reinterpret_cast<DstScalar*>(output_ptr) +
+                                    p_index * this->output_channels;
+
+      for (std::int32_t group = 0; group < this->groups; ++group) {
+        const std::int32_t input_depth_offset = group * input_depth_per_group;
+        for (std::int32_t block_start = 0;
+             block_start < output_channels_per_group;
+             block_start += kChannels) {
+          __m512i acc[kPixels];
+          for (int p = 0; p < kPixels; ++p) {
+            acc[p] = _mm512_setzero_si512();
+          }
+
+          for (std::int32_t f = 0; f < this->filter_size; ++f) {
+            const TBitpacked* activations_ptr[kPixels];
+            for (int p = 0; p < kPixels; ++p) {
+              activations_ptr[p] =
+                  indirection_ptr[f * kPixels + p] + input_depth_offset;
+            }
+            for (std::int32_t d = 0; d < input_depth_per_group; ++d) {
+              const __m512i w = _mm512_loadu_si512(weights_ptr);
+              weights_ptr += kChannels;
+              for (int p = 0; p < kPixels; ++p) {
+                const __m512i a = _mm512_set1_epi32(activations_ptr[p][d]);
+                acc[p] = _mm512_add_epi32(
+                    acc[p], _mm512_popcnt_epi32(_mm512_xor_si512(w, a)));
+              }
+            }
+          }
+          for (int p = 0; p < kPixels; ++p) {
+            _mm512_store_si512(accumulators[p], acc[p]);
+          }
+
+          const std::int32_t c_out_index =
+              group * output_channels_per_group + block_start;
+          WriteOutputTile<DstScalar, kChannels>(
+              output_transform, accumulators, num_pixels,
+              std::min(kChannels, output_channels_per_group - block_start),
+              c_out_index, this->output_channels,
+              pixel_output_ptr + c_out_index);
+        }
+      }
+    }
+  }
+};
+
+}  // namespace indirect_bgemm
+}  // namespace core
+}  // namespace compute_engine
+
+#endif  // COMPUTE_ENGINE_INDIRECT_BGEMM_KERNEL_16x8_AVX512_H_
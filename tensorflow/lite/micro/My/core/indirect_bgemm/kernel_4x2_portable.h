@@ -9,7 +9,6 @@
 #include "tensorflow/lite/micro/My/core/bitpacking/bitpack.h"
 #include "tensorflow/lite/micro/My/core/indirect_bgemm/kernel.h"
 #include "tensorflow/lite/micro/My/core/types.h"
-#include "ruy/profiler/instrumentation.h"
 #include "tensorflow/lite/kernels/internal/types.h"
 
 namespace compute_engine {
@@ -28,17 +27,16 @@ class Kernel4x2Portable : public Kernel {
   const bconv2d::OutputTransform<DstScalar> output_transform;
 
  public:
-  Kernel4x2Portable(const bconv2d::BConv2DParams* bconv2d_params,
-                    const RuntimeShape& bitpacked_input_shape,
-                    const RuntimeShape& output_shape,
-                    const bconv2d::OutputTransform<DstScalar>& output_transform)
+  Kernel4x2Portable(
+      const bconv2d::BConv2DParams* bconv2d_params,
+      const RuntimeShape& bitpacked_input_shape,
+      const RuntimeShape& output_shape,
+      const bconv2d::OutputTransform<DstScalar>& output_transform_in)
       : Kernel(4, 2, 1, bconv2d_params, bitpacked_input_shape, output_shape),
-        output_transform(output_transform) {}
+        output_transform(output_transform_in) {}
 
   void Run(const std::int32_t pixel_start, const std::int32_t pixel_end,
            void* output_ptr) const override {
-    ruy::profiler::ScopeLabel label("Indirect BGEMM block (4x2, portable)");
-
     TFLITE_DCHECK_GE(this->input_depth, 1);
     TFLITE_DCHECK_GE(this->output_channels, 1);
     TFLITE_DCHECK_GE(this->filter_size, 1);
@@ -51,9 +49,9 @@ class Kernel4x2Portable : public Kernel {
 
     for (std::int32_t p_index = pixel_start; p_index < pixel_end;
          p_index += 2) {
-      const TBitpacked* weights_ptr = this->packed_weights.data();
+      const TBitpacked* weights_ptr = this->packed_weights_ptr;
       const TBitpacked* const* indirection_ptr =
-          this->indirection_buffer.data() + p_index * this->filter_size;
+          this->indirection_buffer_ptr + p_index * this->filter_size;
       auto output_ptr_0 = reinterpret_cast<DstScalar*>(output_ptr) +
                           p_index * this->output_channels;
       auto output_ptr_1 = output_ptr_0 + this->output_channels;
@@ -169,14 +167,12 @@ class Kernel4x2Portable<TBitpacked> : public Kernel {
       const bconv2d::BConv2DParams* bconv2d_params,
       const RuntimeShape& bitpacked_input_shape,
       const RuntimeShape& output_shape,
-      const bconv2d::OutputTransform<TBitpacked>& output_transform)
+      const bconv2d::OutputTransform<TBitpacked>& output_transform_in)
       : Kernel(4, 2, 1, bconv2d_params, bitpacked_input_shape, output_shape),
-        output_transform(output_transform) {}
+        output_transform(output_transform_in) {}
 
   void Run(const std::int32_t pixel_start, const std::int32_t pixel_end,
            void* output_ptr) const override {
-    ruy::profiler::ScopeLabel label("Indirect BGEMM block (4x2, portable)");
-
     TFLITE_DCHECK_GE(this->input_depth, 1);
     TFLITE_DCHECK_GE(this->output_channels, 1);
     TFLITE_DCHECK_GE(this->filter_size, 1);
@@ -189,9 +185,9 @@ class Kernel4x2Portable<TBitpacked> : public Kernel {
 
     for (std::int32_t p_index = pixel_start; p_index < pixel_end;
          p_index += 2) {
-      const TBitpacked* weights_ptr = this->packed_weights.data();
+      const TBitpacked* weights_ptr = this->packed_weights_ptr;
       const TBitpacked* const* indirection_ptr =
-          this->indirection_buffer.data() + p_index * this->filter_size;
+          this->indirection_buffer_ptr + p_index * this->filter_size;
       auto output_ptr_0 =
           reinterpret_cast<TBitpacked*>(output_ptr) +
           p_index * bitpacking::GetBitpackedSize(this->output_channels);
@@ -0,0 +1,192 @@
+#ifndef COMPUTE_ENGINE_INDIRECT_BGEMM_KERNEL_8x4_AVX2_H_
+#define COMPUTE_ENGINE_INDIRECT_BGEMM_KERNEL_8x4_AVX2_H_
+
+#if !defined(__x86_64__) && !defined(__i386__)
+#pragma GCC error "ERROR: This file should only be compiled for x86."
+#endif
+
+#include <immintrin.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+
+#include "tensorflow/lite/micro/My/core/bconv2d/output_transform.h"
+#include "tensorflow/lite/micro/My/core/bconv2d/params.h"
+#include "tensorflow/lite/micro/My/core/indirect_bgemm/kernel.h"
+#include "tensorflow/lite/micro/My/core/types.h"
+#include "tensorflow/lite/kernels/internal/types.h"
+
+namespace compute_engine {
+namespace core {
+namespace indirect_bgemm {
+
+// Returns true if the CPU we are running on supports the AVX2 kernel. The
+// kernel is compiled with a target attribute, so the rest of the library does
+// not need to be built with -mavx2.
+inline bool CpuSupportsAvx2() {
+  static const bool supported = __builtin_cpu_supports("avx2");
+  return supported;
+}
+
+// Adds the unsigned per-byte counts in `byte_counts` to the int32 lanes of
+// `accumulator`.
+__attribute__((target("avx2"))) inline __m256i AddByteCounts(
+    const __m256i accumulator, const __m256i byte_counts) {
+  const __m256i pair_counts =
+      _mm256_maddubs_epi16(byte_counts, _mm256_set1_epi8(1));
+  return _mm256_add_epi32(accumulator,
+                          _mm256_madd_epi16(pair_counts, _mm256_set1_epi16(1)));
+}
+
+// Applies the output transform to a tile of int32 accumulators, laid out as
+// [pixel][output channel], and writes the first `num_pixels` x `num_channels`
+// values. Shared by the x86 kernels.
+//     This is kept out of line: if it were inlined into a kernel compiled for
+// an ISA that implies FMA, the float multiply-add of the output transform
+// could be contracted and would no longer match the other kernels bit-exactly.
+template <typename DstScalar, int kChannels>
+__attribute__((noinline)) void WriteOutputTile(
+    const bconv2d::OutputTransform<DstScalar>& output_transform,
+    const std::int32_t (*accumulators)[kChannels], const int num_pixels,
+    const int num_channels, const std::int32_t c_out_index,
+    const std::int32_t output_channels, DstScalar* output_ptr) {
+  for (int p = 0; p < num_pixels; ++p) {
+    DstScalar* out = output_ptr + p * output_channels;
+    for (int c = 0; c < num_channels; ++c) {
+      out[c] = output_transform.Run(accumulators[p][c], c_out_index + c);
+    }
+  }
+}
+
+/**
+ * An AVX2 micro-kernel for float or int8 output that computes a tile of 8
+ * output channels by 4 pixels.
+ *
+ * The weights are packed with a depth block of one word, so a single 256-bit
+ * load holds the same input word for 8 consecutive output channels, and each
+ * activation word is broadcast across the register. This works for any input
+ * depth. There is no popcount instruction in AVX2, so the XOR result is
+ * counted per nibble with two pshufb table lookups. The byte counts are
+ * accumulated in 8-bit lanes for up to 31 steps (at most 8 per step, so they
+ * cannot overflow) and then widened into the int32 accumulators with
+ * pmaddubsw/pmaddwd.
+ */
+template <typename DstScalar>
+class Kernel8x4Avx2 : public Kernel {
+  static_assert(std::is_same<DstScalar, float>::value ||
+                    std::is_same<DstScalar, std::int8_t>::value,
+                "");
+
+  static constexpr int kChannels = 8;
+  static constexpr int kPixels = 4;
+  static constexpr int kMaxByteSteps = 31;
+
+  const bconv2d::OutputTransform<DstScalar> output_transform;
+
+ public:
+  Kernel8x4Avx2(const bconv2d::BConv2DParams* bconv2d_params,
+                const RuntimeShape& bitpacked_input_shape,
+                const RuntimeShape& output_shape,
+                const bconv2d::OutputTransform<DstScalar>& output_transform_in)
+      : Kernel(kChannels, kPixels, 1, bconv2d_params, bitpacked_input_shape,
+               output_shape),
+        output_transform(output_transform_in) {}
+
+  __attribute__((target("avx2"))) void Run(const std::int32_t pixel_start,
+                                           const std::int32_t pixel_end,
+                                           void* output_ptr) const override {
+    TFLITE_DCHECK_GE(this->input_depth, 1);
+    TFLITE_DCHECK_GE(this->output_channels, 1);
+    TFLITE_DCHECK_GE(this->filter_size, 1);
+    TFLITE_DCHECK_GE(this->groups, 1);
+    TFLITE_DCHECK_EQ(this->input_depth % this->groups, 0);
+    TFLITE_DCHECK_EQ(this->output_channels % this->groups, 0);
+
+    const std::int32_t input_depth_per_group = this->input_depth / this->groups;
+    const std::int32_t output_channels_per_group =
+        this->output_channels / this->groups;
+
+    const __m256i popcount_lut =
+        _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1,
+                         1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_nibble_mask = _mm256_set1_epi8(0x0f);
+
+    alignas(32) std::int32_t accumulators[kPixels][kChannels];
+
+    for (std::int32_t p_index = pixel_start; p_index < pixel_end;
+         p_index += kPixels) {
+      const int num_pixels = std::min(kPixels, pixel_end - p_index);
+      const TBitpacked* weights_ptr = this->packed_weights_ptr;
+      const TBitpacked* const* indirection_ptr =
+          this->indirection_buffer_ptr + p_index * this->filter_size;
+      DstScalar* pixel_output_ptr = reinterpret_cast<DstScalar*>(output_ptr) +
+                                    p_index * this->output_channels;
+
+      for (std::int32_t group = 0; group < this->groups; ++group) {
+        const std::int32_t input_depth_offset = group * input_depth_per_group;
+        for (std::int32_t block_start = 0;
+             block_start < output_channels_per_group;
+             block_start += kChannels) {
+          __m256i acc[kPixels];
+          __m256i byte_acc[kPixels];
+          for (int p = 0; p < kPixels; ++p) {
+            acc[p] = _mm256_setzero_si256();
+            byte_acc[p] = _mm256_setzero_si256();
+          }
+          int byte_steps = 0;
+
+          for (std::int32_t f = 0; f < this->filter_size; ++f) {
+            const TBitpacked* activations_ptr[kPixels];
+            for (int p = 0; p < kPixels; ++p) {
+              activations_ptr[p] =
+                  indirection_ptr[f * kPixels + p] + input_depth_offset;
+            }
+            for (std::int32_t d = 0; d < input_depth_per_group; ++d) {
+              const __m256i w = _mm256_loadu_si256(
+                  reinterpret_cast<const __m256i*>(weights_ptr));
+              weights_ptr += kChannels;
+              for (int p = 0; p < kPixels; ++p) {
+                const __m256i a = _mm256_set1_epi32(activations_ptr[p][d]);
+                const __m256i x = _mm256_xor_si256(w, a);
+                const __m256i lo = _mm256_and_si256(x, low_nibble_mask);
+                const __m256i hi =
+                    _mm256_and_si256(_mm256_srli_epi16(x, 4), low_nibble_mask);
+                byte_acc[p] = _mm256_add_epi8(
+                    byte_acc[p],
+                    _mm256_add_epi8(_mm256_shuffle_epi8(popcount_lut, lo),
+                                    _mm256_shuffle_epi8(popcount_lut, hi)));
+              }
+              if (++byte_steps == kMaxByteSteps) {
+                for (int p = 0; p < kPixels; ++p) {
+                  acc[p] = AddByteCounts(acc[p], byte_acc[p]);
+                  byte_acc[p] = _mm256_setzero_si256();
+                }
+                byte_steps = 0;
+              }
+            }
+          }
+          for (int p = 0; p < kPixels; ++p) {
+            acc[p] = AddByteCounts(acc[p], byte_acc[p]);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(accumulators[p]),
+                               acc[p]);
+          }
+
+          const std::int32_t c_out_index =
+              group * output_channels_per_group + block_start;
+          WriteOutputTile<DstScalar, kChannels>(
+              output_transform, accumulators, num_pixels,
+              std::min(kChannels, output_channels_per_group - block_start),
+              c_out_index, this->output_channels,
+              pixel_output_ptr + c_out_index);
+        }
+      }
+    }
+  }
+};
+
+}  // namespace indirect_bgemm
+}  // namespace core
+}  // namespace compute_engine
+
+#endif  // COMPUTE_ENGINE_INDIRECT_BGEMM_KERNEL_8x4_AVX2_H_
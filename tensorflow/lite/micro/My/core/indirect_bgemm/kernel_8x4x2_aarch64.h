@@ -10,11 +10,10 @@
 #include <cstdint>
 #include <type_traits>
 
-#include "larq_compute_engine/core/bconv2d/output_transform.h"
-#include "larq_compute_engine/core/bconv2d/params.h"
-#include "larq_compute_engine/core/indirect_bgemm/kernel.h"
-#include "larq_compute_engine/core/types.h"
-#include "ruy/profiler/instrumentation.h"
+#include "tensorflow/lite/micro/My/core/bconv2d/output_transform.h"
+#include "tensorflow/lite/micro/My/core/bconv2d/params.h"
+#include "tensorflow/lite/micro/My/core/indirect_bgemm/kernel.h"
+#include "tensorflow/lite/micro/My/core/types.h"
 #include "tensorflow/lite/kernels/internal/types.h"
 
 namespace compute_engine {
@@ -151,8 +150,6 @@ inline void AccumulationLoop_Depth2OrMore(
     const std::size_t input_depth_offset, int32x4_t weights[4],
     int32x4_t activations[4], uint16x8_t accumulators[4],
     const TBitpacked*& weights_ptr, const TBitpacked* const* indirection_ptr) {
-  ruy::profiler::ScopeLabel label("Accumulation loop (depth > 1)");
-
   // Declare these variables so we can use named registers in the ASM block.
   const TBitpacked* a_ptr_0;
   const TBitpacked* a_ptr_1;
@@ -228,8 +225,6 @@ inline void AccumulationLoop_Depth1(
     const std::int32_t filter_size, const std::size_t input_depth_offset,
     int32x4_t weights[4], int32x4_t activations[4], uint16x8_t accumulators[4],
     const TBitpacked*& weights_ptr, const TBitpacked* const* indirection_ptr) {
-  ruy::profiler::ScopeLabel label("Accumulation loop (depth = 1)");
-
   // Declare these variables so we can use named registers in the ASM block.
   const TBitpacked* a_ptr_0;
   const TBitpacked* a_ptr_1;
@@ -300,8 +295,6 @@ inline void OutputTransformAndLoadNextAndStore(
     const TBitpacked* weights_ptr, const TBitpacked* const* indirection_ptr,
     float*& output_ptr_0, float*& output_ptr_1, float*& output_ptr_2,
     float*& output_ptr_3) {
-  ruy::profiler::ScopeLabel label("Float output transform and store");
-
   // Declare result registers.
   float32x4x2_t results[4];
 
@@ -473,8 +466,6 @@ inline void OutputTransformAndLoadNextAndStore(
     const TBitpacked* weights_ptr, const TBitpacked* const* indirection_ptr,
     std::int8_t*& output_ptr_0, std::int8_t*& output_ptr_1,
     std::int8_t*& output_ptr_2, std::int8_t*& output_ptr_3) {
-  ruy::profiler::ScopeLabel label("Int8 output transform and store");
-
   // Declare result registers. These are wider than we need for just the final
   // int8 values, which is necessary for intermediate results.
   int8x16x2_t results[4];
@@ -669,15 +660,12 @@ class Kernel8x4x2Aarch64 : public Kernel {
       const bconv2d::BConv2DParams* bconv2d_params,
       const RuntimeShape& bitpacked_input_shape,
       const RuntimeShape& output_shape,
-      const bconv2d::OutputTransform<DstScalar>& output_transform)
+      const bconv2d::OutputTransform<DstScalar>& output_transform_in)
       : Kernel(8, 4, 2, bconv2d_params, bitpacked_input_shape, output_shape),
-        output_transform(output_transform) {}
+        output_transform(output_transform_in) {}
 
   void Run(const std::int32_t pixel_start, const std::int32_t pixel_end,
            void* output_ptr) const override {
-    ruy::profiler::ScopeLabel label(
-        "Indirect BGEMM block (8x4x2, Aarch64 optimised)");
-
     TFLITE_DCHECK_GE(this->input_depth, 1);
     TFLITE_DCHECK_GE(this->output_channels, 1);
     TFLITE_DCHECK_GE(this->filter_size, 1);
@@ -695,9 +683,9 @@ class Kernel8x4x2Aarch64 : public Kernel {
 
     for (std::int32_t p_index = pixel_start; p_index < pixel_end;
          p_index += 4) {
-      const TBitpacked* weights_ptr = this->packed_weights.data();
+      const TBitpacked* weights_ptr = this->packed_weights_ptr;
       const TBitpacked* const* indirection_ptr =
-          this->indirection_buffer.data() + p_index * this->filter_size;
+          this->indirection_buffer_ptr + p_index * this->filter_size;
       auto output_ptr_0 = reinterpret_cast<DstScalar*>(output_ptr) +
                           p_index * this->output_channels;
       auto output_ptr_1 = output_ptr_0 + this->output_channels;
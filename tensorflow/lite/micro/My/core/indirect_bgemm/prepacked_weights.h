@@ -0,0 +1,114 @@
+#ifndef COMPUTE_ENGINE_INDIRECT_BGEMM_PREPACKED_WEIGHTS_H_
+#define COMPUTE_ENGINE_INDIRECT_BGEMM_PREPACKED_WEIGHTS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "tensorflow/lite/micro/My/core/indirect_bgemm/kernel.h"
+#include "tensorflow/lite/micro/My/core/types.h"
+
+namespace compute_engine {
+namespace core {
+namespace indirect_bgemm {
+
+/*
+ * Weights that are packed ahead of time are stored as a blob that starts with
+ * a PrepackedWeightsHeader, followed by GetPackedWeightsSize(layout) words in
+ * the order written by PackWeights().
+ *
+ * The header records the layout, including the tile shape of the micro-kernel
+ * that the weights were packed for. A kernel only uses the blob if its layout
+ * matches exactly, so a model that was packed for another target still works:
+ * the kernel then packs the weights itself, as before.
+ *
+ * In a .tflite model, lce_prepack_weights concatenates the blobs of all binary
+ * convolutions into one buffer, referenced by a metadata entry named
+ * kPrepackedWeightsMetadataName. Buffers are 16-byte aligned and every blob is
+ * a whole number of words, so the words can be used in place.
+ */
+
+constexpr char kPrepackedWeightsMetadataName[] = "lce_prepacked_weights";
+constexpr std::uint32_t kPrepackedWeightsMagic = 0x5057434c;  // "LCWP"
+constexpr std::uint32_t kPrepackedWeightsVersion = 1;
+
+struct PrepackedWeightsHeader {
+  std::uint32_t magic;
+  std::uint32_t version;
+  // Index of the model buffer that holds the unpacked filter.
+  std::int32_t filter_buffer;
+  PackedWeightsLayout layout;
+  // Number of packed words that follow the header.
+  std::int32_t num_words;
+};
+
+static_assert(sizeof(PrepackedWeightsHeader) % sizeof(TBitpacked) == 0,
+              "The packed words must stay aligned after the header.");
+
+// Number of bytes of a blob for `layout`.
+inline std::size_t GetPrepackedWeightsBytes(const PackedWeightsLayout& layout) {
+  return sizeof(PrepackedWeightsHeader) +
+         GetPackedWeightsSize(layout) * sizeof(TBitpacked);
+}
+
+// Writes the blob for the unpacked `weights` to `blob`, which must hold
+// GetPrepackedWeightsBytes(layout) bytes and be aligned to TBitpacked.
+inline void WritePrepackedWeights(const PackedWeightsLayout& layout,
+                                  const std::int32_t filter_buffer,
+                                  const TBitpacked* weights,
+                                  std::uint8_t* blob) {
+  PrepackedWeightsHeader header;
+  header.magic = kPrepackedWeightsMagic;
+  header.version = kPrepackedWeightsVersion;
+  header.filter_buffer = filter_buffer;
+  header.layout = layout;
+  header.num_words = GetPackedWeightsSize(layout);
+  std::memcpy(blob, &header, sizeof(header));
+  PackWeights(layout, weights,
+              reinterpret_cast<TBitpacked*>(blob + sizeof(header)));
+}
+
+// Returns the packed words of the blob in `blobs`, a sequence of consecutive
+// blobs of `size` bytes in total, that holds the weights in `filter_buffer`
+// packed for `layout`, or nullptr if there is none.
+inline const TBitpacked* FindPrepackedWeights(const PackedWeightsLayout& layout,
+                                              const std::int32_t filter_buffer,
+                                              const std::uint8_t* blobs,
+                                              const std::size_t size) {
+  if (blobs == nullptr ||
+      reinterpret_cast<std::uintptr_t>(blobs) % alignof(TBitpacked) != 0) {
+    return nullptr;
+  }
+  std::size_t offset = 0;
+  while (size - offset >= sizeof(PrepackedWeightsHeader)) {
+    PrepackedWeightsHeader header;
+    std::memcpy(&header, blobs + offset, sizeof(header));
+    if (header.magic != kPrepackedWeightsMagic ||
+        header.version != kPrepackedWeightsVersion || header.num_words < 0) {
+      return nullptr;
+    }
+    const std::size_t blob_size =
+        sizeof(header) + std::size_t(header.num_words) * sizeof(TBitpacked);
+    if (size - offset < blob_size) return nullptr;
+    if (header.filter_buffer == filter_buffer &&
+        header.layout.block_size_output_channels ==
+            layout.block_size_output_channels &&
+        header.layout.block_size_depth == layout.block_size_depth &&
+        header.layout.input_depth == layout.input_depth &&
+        header.layout.output_channels == layout.output_channels &&
+        header.layout.filter_size == layout.filter_size &&
+        header.layout.groups == layout.groups &&
+        header.num_words == GetPackedWeightsSize(layout)) {
+      return reinterpret_cast<const TBitpacked*>(blobs + offset +
+                                                 sizeof(header));
+    }
+    offset += blob_size;
+  }
+  return nullptr;
+}
+
+}  // namespace indirect_bgemm
+}  // namespace core
+}  // namespace compute_engine
+
+#endif  // COMPUTE_ENGINE_INDIRECT_BGEMM_PREPACKED_WEIGHTS_H_
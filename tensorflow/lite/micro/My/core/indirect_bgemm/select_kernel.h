@@ -1,16 +1,25 @@
 #ifndef COMPUTE_ENGINE_INDIRECT_BGEMM_SELECT_KERNEL_H_
 #define COMPUTE_ENGINE_INDIRECT_BGEMM_SELECT_KERNEL_H_
 
+#include <cstddef>
 #include <cstdint>
+#include <limits>
 #include <memory>
+#include <new>
 #include <type_traits>
+#include <utility>
 
 #include "tensorflow/lite/micro/My/core/indirect_bgemm/kernel.h"
 
 #ifdef __aarch64__
-#include "larq_compute_engine/core/indirect_bgemm/kernel_8x4x1_aarch64.h"
-#include "larq_compute_engine/core/indirect_bgemm/kernel_8x4x2_aarch64.h"
-#include "larq_compute_engine/core/indirect_bgemm/kernel_8x4x4_aarch64.h"
+#include "tensorflow/lite/micro/My/core/indirect_bgemm/kernel_8x4x1_aarch64.h"
+#include "tensorflow/lite/micro/My/core/indirect_bgemm/kernel_8x4x2_aarch64.h"
+#include "tensorflow/lite/micro/My/core/indirect_bgemm/kernel_8x4x4_aarch64.h"
+#endif
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define LCE_INDIRECT_BGEMM_X86
+#include "tensorflow/lite/micro/My/core/indirect_bgemm/kernel_16x8_avx512.h"
+#include "tensorflow/lite/micro/My/core/indirect_bgemm/kernel_8x4_avx2.h"
 #endif
 #include "tensorflow/lite/micro/My/core/bconv2d/output_transform.h"
 #include "tensorflow/lite/micro/My/core/bconv2d/params.h"
@@ -24,121 +33,210 @@ namespace indirect_bgemm {
 // These functions allow us to select which kernel to use at runtime based on
 // any parameter we choose: destination scalar; conv params; input/output
 // shapes; even detected CPU features.
+//
+// The selected kernel is constructed by a factory: by default it is allocated
+// with `new`, but a caller without a heap can construct it in memory of its
+// own with PlacementKernelFactory. The TFLM op from
+// Register_BCONV_2D_OPT_INDIRECT_BGEMM does so in its persistent arena.
+
+// Constructs the selected kernel on the heap.
+struct HeapKernelFactory {
+  using Pointer = std::unique_ptr<Kernel>;
+
+  template <typename KernelClass, typename... Args>
+  Pointer Make(Args&&... args) const {
+    return Pointer(new KernelClass(std::forward<Args>(args)...));
+  }
+};
+
+// Constructs the selected kernel with placement new in the memory returned by
+// `allocate(size_in_bytes)`, which must be suitably aligned for a Kernel, and
+// returns nullptr if the allocation fails. The kernel is never destroyed, so
+// its memory must outlive it; the kernel only allocates memory itself when it
+// is not given storage for its packed weights and indirection buffer.
+template <typename Allocate>
+struct PlacementKernelFactory {
+  using Pointer = Kernel*;
+
+  Allocate allocate;
+
+  template <typename KernelClass, typename... Args>
+  Pointer Make(Args&&... args) const {
+    static_assert(alignof(KernelClass) <= alignof(std::max_align_t),
+                  "The kernel needs more than the fundamental alignment.");
+    void* memory = allocate(sizeof(KernelClass));
+    if (memory == nullptr) return nullptr;
+    return new (memory) KernelClass(std::forward<Args>(args)...);
+  }
+};
+
+template <typename Allocate>
+inline PlacementKernelFactory<Allocate> MakePlacementKernelFactory(
+    Allocate allocate) {
+  return PlacementKernelFactory<Allocate>{allocate};
+}
 
 // Select a kernel for float or int8 output.
 template <typename DstScalar>
-inline std::unique_ptr<Kernel> SelectRuntimeKernel(
-    const bconv2d::BConv2DParams* bconv2d_params,
-    const ::tflite::RuntimeShape& bitpacked_input_shape,
-    const ::tflite::RuntimeShape& output_shape,
-    const bconv2d::OutputTransform<DstScalar>& output_transform) {
+struct RuntimeKernelSelector {
   static_assert(std::is_same<DstScalar, float>::value ||
                     std::is_same<DstScalar, std::int8_t>::value,
                 "");
 
+  template <typename Factory>
+  static typename Factory::Pointer Select(
+      const bconv2d::BConv2DParams* bconv2d_params,
+      const ::tflite::RuntimeShape& bitpacked_input_shape,
+      const ::tflite::RuntimeShape& output_shape,
+      const bconv2d::OutputTransform<DstScalar>& output_transform,
+      const Factory& factory) {
 #ifdef __aarch64__
-  // There are optimised assembly kernels for float and int8 output on Aarch64.
-  // They all use int16 accumulators. A different kernel is selected depending
-  // on whether the bitpacked number of input channels is a multiple of 4, 2, or
-  // 1, and whether that multiple is 1 or more than 1.
-
-  const auto max_accumulator_value = bitpacking_bitwidth *
-                                     bitpacked_input_shape.FlatSize() /
-                                     bconv2d_params->groups;
-  const bool fits_in_uint16_accumulators =
-      max_accumulator_value < std::numeric_limits<std::uint16_t>::max();
-
-  if (fits_in_uint16_accumulators) {
-    const auto input_depth_per_group =
-        bitpacked_input_shape.Dims(3) / bconv2d_params->groups;
-
-    if (input_depth_per_group % 4 == 0) {
-      if (input_depth_per_group > 4) {
-        if (bconv2d_params->groups > 1) {
-          return std::make_unique<Kernel8x4x4Aarch64<DstScalar, true, true>>(
-              bconv2d_params, bitpacked_input_shape, output_shape,
-              output_transform);
+    // There are optimised assembly kernels for float and int8 output on
+    // Aarch64. They all use int16 accumulators. A different kernel is selected
+    // depending on whether the bitpacked number of input channels is a
+    // multiple of 4, 2, or 1, and whether that multiple is 1 or more than 1.
+
+    const auto max_accumulator_value = bitpacking_bitwidth *
+                                       bitpacked_input_shape.FlatSize() /
+                                       bconv2d_params->groups;
+    const bool fits_in_uint16_accumulators =
+        max_accumulator_value < std::numeric_limits<std::uint16_t>::max();
+
+    if (fits_in_uint16_accumulators) {
+      const auto input_depth_per_group =
+          bitpacked_input_shape.Dims(3) / bconv2d_params->groups;
+
+      if (input_depth_per_group % 4 == 0) {
+        if (input_depth_per_group > 4) {
+          if (bconv2d_params->groups > 1) {
+            return factory
+                .template Make<Kernel8x4x4Aarch64<DstScalar, true, true>>(
+                    bconv2d_params, bitpacked_input_shape, output_shape,
+                    output_transform);
+          } else {
+            return factory
+                .template Make<Kernel8x4x4Aarch64<DstScalar, true, false>>(
+                    bconv2d_params, bitpacked_input_shape, output_shape,
+                    output_transform);
+          }
         } else {
-          return std::make_unique<Kernel8x4x4Aarch64<DstScalar, true, false>>(
-              bconv2d_params, bitpacked_input_shape, output_shape,
-              output_transform);
+          if (bconv2d_params->groups > 1) {
+            return factory
+                .template Make<Kernel8x4x4Aarch64<DstScalar, false, true>>(
+                    bconv2d_params, bitpacked_input_shape, output_shape,
+                    output_transform);
+          } else {
+            return factory
+                .template Make<Kernel8x4x4Aarch64<DstScalar, false, false>>(
+                    bconv2d_params, bitpacked_input_shape, output_shape,
+                    output_transform);
+          }
         }
-      } else {
-        if (bconv2d_params->groups > 1) {
-          return std::make_unique<Kernel8x4x4Aarch64<DstScalar, false, true>>(
-              bconv2d_params, bitpacked_input_shape, output_shape,
-              output_transform);
+      } else if (input_depth_per_group % 2 == 0) {
+        if (input_depth_per_group > 2) {
+          if (bconv2d_params->groups > 1) {
+            return factory
+                .template Make<Kernel8x4x2Aarch64<DstScalar, true, true>>(
+                    bconv2d_params, bitpacked_input_shape, output_shape,
+                    output_transform);
+          } else {
+            return factory
+                .template Make<Kernel8x4x2Aarch64<DstScalar, true, false>>(
+                    bconv2d_params, bitpacked_input_shape, output_shape,
+                    output_transform);
+          }
         } else {
-          return std::make_unique<Kernel8x4x4Aarch64<DstScalar, false, false>>(
-              bconv2d_params, bitpacked_input_shape, output_shape,
-              output_transform);
-        }
-      }
-    } else if (input_depth_per_group % 2 == 0) {
-      if (input_depth_per_group > 2) {
-        if (bconv2d_params->groups > 1) {
-          return std::make_unique<Kernel8x4x2Aarch64<DstScalar, true, true>>(
-              bconv2d_params, bitpacked_input_shape, output_shape,
-              output_transform);
-        } else {
-          return std::make_unique<Kernel8x4x2Aarch64<DstScalar, true, false>>(
-              bconv2d_params, bitpacked_input_shape, output_shape,
-              output_transform);
+          if (bconv2d_params->groups > 1) {
+            return factory
+                .template Make<Kernel8x4x2Aarch64<DstScalar, false, true>>(
+                    bconv2d_params, bitpacked_input_shape, output_shape,
+                    output_transform);
+          } else {
+            return factory
+                .template Make<Kernel8x4x2Aarch64<DstScalar, false, false>>(
+                    bconv2d_params, bitpacked_input_shape, output_shape,
+                    output_transform);
+          }
         }
       } else {
-        if (bconv2d_params->groups > 1) {
-          return std::make_unique<Kernel8x4x2Aarch64<DstScalar, false, true>>(
-              bconv2d_params, bitpacked_input_shape, output_shape,
-              output_transform);
+        if (input_depth_per_group > 1) {
+          if (bconv2d_params->groups > 1) {
+            return factory
+                .template Make<Kernel8x4x1Aarch64<DstScalar, true, true>>(
+                    bconv2d_params, bitpacked_input_shape, output_shape,
+                    output_transform);
+
+          } else {
+            return factory
+                .template Make<Kernel8x4x1Aarch64<DstScalar, true, false>>(
+                    bconv2d_params, bitpacked_input_shape, output_shape,
+                    output_transform);
+          }
         } else {
-          return std::make_unique<Kernel8x4x2Aarch64<DstScalar, false, false>>(
-              bconv2d_params, bitpacked_input_shape, output_shape,
-              output_transform);
+          if (bconv2d_params->groups > 1) {
+            return factory
+                .template Make<Kernel8x4x1Aarch64<DstScalar, false, true>>(
+                    bconv2d_params, bitpacked_input_shape, output_shape,
+                    output_transform);
+
+          } else {
+            return factory
+                .template Make<Kernel8x4x1Aarch64<DstScalar, false, false>>(
+                    bconv2d_params, bitpacked_input_shape, output_shape,
+                    output_transform);
+          }
         }
       }
-    } else {
-      if (input_depth_per_group > 1) {
-        if (bconv2d_params->groups > 1) {
-          return std::make_unique<Kernel8x4x1Aarch64<DstScalar, true, true>>(
-              bconv2d_params, bitpacked_input_shape, output_shape,
-              output_transform);
-
-        } else {
-          return std::make_unique<Kernel8x4x1Aarch64<DstScalar, true, false>>(
-              bconv2d_params, bitpacked_input_shape, output_shape,
-              output_transform);
-        }
-      } else {
-        if (bconv2d_params->groups > 1) {
-          return std::make_unique<Kernel8x4x1Aarch64<DstScalar, false, true>>(
-              bconv2d_params, bitpacked_input_shape, output_shape,
-              output_transform);
+    }
+#endif
 
-        } else {
-          return std::make_unique<Kernel8x4x1Aarch64<DstScalar, false, false>>(
-              bconv2d_params, bitpacked_input_shape, output_shape,
-              output_transform);
-        }
-      }
+#ifdef LCE_INDIRECT_BGEMM_X86
+    // On x86 the kernel is chosen from the features reported by CPUID, so that
+    // a single binary uses the widest popcount that the host supports.
+    if (CpuSupportsAvx512Vpopcntdq()) {
+      return factory.template Make<Kernel16x8Avx512<DstScalar>>(
+          bconv2d_params, bitpacked_input_shape, output_shape,
+          output_transform);
+    }
+    if (CpuSupportsAvx2()) {
+      return factory.template Make<Kernel8x4Avx2<DstScalar>>(
+          bconv2d_params, bitpacked_input_shape, output_shape,
+          output_transform);
     }
-  }
 #endif
 
-  // Fallback C++ kernel
-  return std::make_unique<Kernel4x2Portable<DstScalar>>(
-      bconv2d_params, bitpacked_input_shape, output_shape, output_transform);
-}
+    // Fallback C++ kernel
+    return factory.template Make<Kernel4x2Portable<DstScalar>>(
+        bconv2d_params, bitpacked_input_shape, output_shape, output_transform);
+  }
+};
 
 // A specialisation: select a kernel for bitpacked output.
 template <>
-inline std::unique_ptr<Kernel> SelectRuntimeKernel<TBitpacked>(
+struct RuntimeKernelSelector<TBitpacked> {
+  template <typename Factory>
+  static typename Factory::Pointer Select(
+      const bconv2d::BConv2DParams* bconv2d_params,
+      const ::tflite::RuntimeShape& bitpacked_input_shape,
+      const ::tflite::RuntimeShape& output_shape,
+      const bconv2d::OutputTransform<TBitpacked>& output_transform,
+      const Factory& factory) {
+    // Only the C++ kernel currently supports bitpacked output.
+    return factory.template Make<Kernel4x2Portable<TBitpacked>>(
+        bconv2d_params, bitpacked_input_shape, output_shape, output_transform);
+  }
+};
+
+template <typename DstScalar, typename Factory = HeapKernelFactory>
+inline typename Factory::Pointer SelectRuntimeKernel(
     const bconv2d::BConv2DParams* bconv2d_params,
     const ::tflite::RuntimeShape& bitpacked_input_shape,
     const ::tflite::RuntimeShape& output_shape,
-    const bconv2d::OutputTransform<TBitpacked>& output_transform) {
-  // Only the C++ kernel currently supports bitpacked output.
-  return std::make_unique<Kernel4x2Portable<TBitpacked>>(
-      bconv2d_params, bitpacked_input_shape, output_shape, output_transform);
+    const bconv2d::OutputTransform<DstScalar>& output_transform,
+    const Factory& factory = Factory()) {
+  return RuntimeKernelSelector<DstScalar>::Select(
+      bconv2d_params, bitpacked_input_shape, output_shape, output_transform,
+      factory);
 }
 
 }  // namespace indirect_bgemm
@@ -0,0 +1,273 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include "tensorflow/lite/micro/My/core/bconv2d/output_transform.h"
+#include "tensorflow/lite/micro/My/core/bconv2d/params.h"
+#include "tensorflow/lite/micro/My/core/bconv2d/reference.h"
+#include "tensorflow/lite/micro/My/core/bitpacking/bitpack.h"
+#include "tensorflow/lite/micro/My/core/indirect_bgemm/kernel_16x8_avx512.h"
+#include "tensorflow/lite/micro/My/core/indirect_bgemm/kernel_8x4_avx2.h"
+#include "tensorflow/lite/micro/My/core/indirect_bgemm/select_kernel.h"
+#include "tensorflow/lite/micro/My/core/thread_pool.h"
+#include "tensorflow/lite/kernels/internal/types.h"
+#include "tensorflow/lite/kernels/padding.h"
+
+namespace compute_engine {
+namespace core {
+namespace indirect_bgemm {
+
+using ::tflite::RuntimeShape;
+
+enum class X86Kernel { kAvx2, kAvx512 };
+
+// input height/width, filter height/width, channels in/out, stride, dilation,
+// groups, padding.
+using ConvShape = std::tuple<int, int, int, int, int, int, int, int, int,
+                             TfLitePadding>;
+
+class IndirectBGemmX86Test
+    : public ::testing::TestWithParam<std::tuple<X86Kernel, ConvShape>> {};
+
+template <typename DstScalar>
+std::unique_ptr<Kernel> MakeKernel(
+    const X86Kernel kernel_type, const bconv2d::BConv2DParams* bconv2d_params,
+    const RuntimeShape& bitpacked_input_shape, const RuntimeShape& output_shape,
+    const bconv2d::OutputTransform<DstScalar>& output_transform) {
+  if (kernel_type == X86Kernel::kAvx512) {
+    return std::make_unique<Kernel16x8Avx512<DstScalar>>(
+        bconv2d_params, bitpacked_input_shape, output_shape, output_transform);
+  }
+  return std::make_unique<Kernel8x4Avx2<DstScalar>>(
+      bconv2d_params, bitpacked_input_shape, output_shape, output_transform);
+}
+
+template <typename DstScalar>
+void RunKernelTest(const X86Kernel kernel_type, const ConvShape& conv_shape) {
+  if ((kernel_type == X86Kernel::kAvx2 && !CpuSupportsAvx2()) ||
+      (kernel_type == X86Kernel::kAvx512 && !CpuSupportsAvx512Vpopcntdq())) {
+    GTEST_SKIP();
+  }
+
+  bconv2d::BConv2DParams bconv2d_params;
+  const int input_height = std::get<0>(conv_shape);
+  const int input_width = std::get<1>(conv_shape);
+  bconv2d_params.filter_height = std::get<2>(conv_shape);
+  bconv2d_params.filter_width = std::get<3>(conv_shape);
+  bconv2d_params.channels_in = std::get<4>(conv_shape);
+  bconv2d_params.channels_out = std::get<5>(conv_shape);
+  bconv2d_params.stride_height = bconv2d_params.stride_width =
+      std::get<6>(conv_shape);
+  bconv2d_params.dilation_height_factor =
+      bconv2d_params.dilation_width_factor = std::get<7>(conv_shape);
+  bconv2d_params.groups = std::get<8>(conv_shape);
+  bconv2d_params.padding_type = std::get<9>(conv_shape);
+  // The indirection buffer pads with zero bits, i.e. with +1.
+  bconv2d_params.pad_value = 1;
+
+  const int batches = 2;
+  int output_height, output_width;
+  bconv2d_params.padding_values = ::tflite::ComputePaddingHeightWidth(
+      bconv2d_params.stride_height, bconv2d_params.stride_width,
+      bconv2d_params.dilation_height_factor,
+      bconv2d_params.dilation_width_factor, input_height, input_width,
+      bconv2d_params.filter_height, bconv2d_params.filter_width,
+      bconv2d_params.padding_type, &output_height, &output_width);
+
+  const int input_depth =
+      bitpacking::GetBitpackedSize(bconv2d_params.channels_in);
+  const int input_depth_per_group = input_depth / bconv2d_params.groups;
+  const std::int32_t input_dims[] = {batches, input_height, input_width,
+                                     input_depth};
+  const std::int32_t filter_dims[] = {
+      bconv2d_params.channels_out, bconv2d_params.filter_height,
+      bconv2d_params.filter_width, input_depth_per_group};
+  const std::int32_t output_dims[] = {batches, output_height, output_width,
+                                      bconv2d_params.channels_out};
+  const RuntimeShape bitpacked_input_shape(4, input_dims);
+  const RuntimeShape filter_shape(4, filter_dims);
+  const RuntimeShape output_shape(4, output_dims);
+
+  std::random_device rd;
+  std::mt19937 gen(rd());
+  std::uniform_int_distribution<TBitpacked> bits_distribution(
+      std::numeric_limits<TBitpacked>::lowest(),
+      std::numeric_limits<TBitpacked>::max());
+
+  std::vector<TBitpacked> input_data(bitpacked_input_shape.FlatSize());
+  std::vector<TBitpacked> filter_data(filter_shape.FlatSize());
+  for (auto& x : input_data) x = bits_distribution(gen);
+  for (auto& x : filter_data) x = bits_distribution(gen);
+
+  std::vector<float> multiplier(bconv2d_params.channels_out);
+  std::vector<float> bias(bconv2d_params.channels_out);
+  std::uniform_real_distribution<float> float_distribution(-1.5, 1.5);
+  for (auto& x : multiplier) x = float_distribution(gen);
+  for (auto& x : bias) x = float_distribution(gen);
+
+  bconv2d::OutputTransform<DstScalar> output_transform;
+  output_transform.clamp_min = -100;
+  output_transform.clamp_max = 500;
+  output_transform.multiplier = multiplier.data();
+  output_transform.bias = bias.data();
+
+  std::vector<DstScalar> expected(output_shape.FlatSize());
+  bconv2d::BConv2DReference<std::int32_t, DstScalar>(
+      &bconv2d_params, bitpacked_input_shape, input_data.data(), filter_shape,
+      filter_data.data(), output_transform, output_shape, expected.data());
+
+  std::vector<DstScalar> actual(output_shape.FlatSize());
+  auto kernel = MakeKernel<DstScalar>(kernel_type, &bconv2d_params,
+                                      bitpacked_input_shape, output_shape,
+                                      output_transform);
+  kernel->PackWeights(filter_data.data());
+  kernel->FillIndirectionBuffer(&bconv2d_params, bitpacked_input_shape,
+                                output_shape, input_data.data());
+  kernel->Dispatch(actual.data());
+
+  // The accumulators are exact, and both sides apply the same output
+  // transform, so the results must be bit-exact.
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_EQ(expected[i], actual[i]) << "at output index " << i;
+  }
+
+  // Splitting the pixels over threads must not change the result.
+  ThreadPool thread_pool(4);
+  std::vector<DstScalar> actual_threaded(output_shape.FlatSize());
+  kernel->Dispatch(actual_threaded.data(), &thread_pool);
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_EQ(expected[i], actual_threaded[i]) << "at output index " << i;
+  }
+}
+
+TEST_P(IndirectBGemmX86Test, FloatOutput) {
+  RunKernelTest<float>(std::get<0>(GetParam()), std::get<1>(GetParam()));
+}
+
+TEST_P(IndirectBGemmX86Test, Int8Output) {
+  RunKernelTest<std::int8_t>(std::get<0>(GetParam()), std::get<1>(GetParam()));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    IndirectBGemmX86, IndirectBGemmX86Test,
+    ::testing::Combine(
+        ::testing::Values(X86Kernel::kAvx2, X86Kernel::kAvx512),
+        ::testing::Values(
+            // A 1x1 convolution.
+            ConvShape{7, 5, 1, 1, 64, 24, 1, 1, 1, kTfLitePaddingValid},
+            // Output channels that are not a multiple of the tile size.
+            ConvShape{6, 6, 3, 3, 32, 13, 1, 1, 1, kTfLitePaddingSame},
+            // Deep input, so the AVX2 byte counters are flushed mid-tap.
+            ConvShape{5, 5, 3, 3, 1280, 17, 1, 1, 1, kTfLitePaddingSame},
+            // Input channels that are not a multiple of the bitwidth.
+            ConvShape{8, 7, 3, 3, 70, 40, 2, 1, 1, kTfLitePaddingSame},
+            ConvShape{9, 9, 3, 3, 96, 33, 1, 2, 1, kTfLitePaddingValid},
+            ConvShape{9, 8, 5, 5, 64, 48, 2, 1, 1, kTfLitePaddingSame},
+            // Grouped convolutions.
+            ConvShape{6, 6, 3, 3, 128, 36, 1, 1, 2, kTfLitePaddingSame},
+            ConvShape{7, 7, 3, 3, 256, 40, 1, 1, 4, kTfLitePaddingValid})));
+
+// SelectRuntimeKernel() must pick the widest kernel that the CPU supports,
+// also when it constructs the kernel in memory of the caller, as a TFLM op
+// does with its arena, and the kernel must then run on caller-owned storage
+// only.
+TEST(IndirectBGemmX86SelectTest, SelectsWidestKernelInPlace) {
+  bconv2d::BConv2DParams bconv2d_params;
+  bconv2d_params.filter_height = bconv2d_params.filter_width = 3;
+  bconv2d_params.channels_in = 96;
+  bconv2d_params.channels_out = 20;
+  bconv2d_params.stride_height = bconv2d_params.stride_width = 1;
+  bconv2d_params.dilation_height_factor =
+      bconv2d_params.dilation_width_factor = 1;
+  bconv2d_params.groups = 1;
+  bconv2d_params.padding_type = kTfLitePaddingSame;
+  bconv2d_params.pad_value = 1;
+
+  const int input_height = 7, input_width = 6;
+  int output_height, output_width;
+  bconv2d_params.padding_values = ::tflite::ComputePaddingHeightWidth(
+      1, 1, 1, 1, input_height, input_width, 3, 3, kTfLitePaddingSame,
+      &output_height, &output_width);
+
+  const int input_depth =
+      bitpacking::GetBitpackedSize(bconv2d_params.channels_in);
+  const std::int32_t input_dims[] = {1, input_height, input_width,
+                                     input_depth};
+  const std::int32_t filter_dims[] = {bconv2d_params.channels_out, 3, 3,
+                                      input_depth};
+  const std::int32_t output_dims[] = {1, output_height, output_width,
+                                      bconv2d_params.channels_out};
+  const RuntimeShape bitpacked_input_shape(4, input_dims);
+  const RuntimeShape filter_shape(4, filter_dims);
+  const RuntimeShape output_shape(4, output_dims);
+
+  std::mt19937 gen(1234);
+  std::uniform_int_distribution<TBitpacked> bits_distribution(
+      std::numeric_limits<TBitpacked>::lowest(),
+      std::numeric_limits<TBitpacked>::max());
+  std::vector<TBitpacked> input_data(bitpacked_input_shape.FlatSize());
+  std::vector<TBitpacked> filter_data(filter_shape.FlatSize());
+  for (auto& x : input_data) x = bits_distribution(gen);
+  for (auto& x : filter_data) x = bits_distribution(gen);
+
+  const std::vector<float> multiplier(bconv2d_params.channels_out, 0.25f);
+  const std::vector<float> bias(bconv2d_params.channels_out, -3.0f);
+  bconv2d::OutputTransform<float> output_transform;
+  output_transform.multiplier = multiplier.data();
+  output_transform.bias = bias.data();
+
+  std::vector<float> expected(output_shape.FlatSize());
+  bconv2d::BConv2DReference<std::int32_t, float>(
+      &bconv2d_params, bitpacked_input_shape, input_data.data(), filter_shape,
+      filter_data.data(), output_transform, output_shape, expected.data());
+
+  // A bump allocator over a fixed buffer stands in for the arena.
+  std::vector<std::max_align_t> arena(1024);
+  std::size_t arena_used = 0;
+  auto allocate = [&](const std::size_t bytes) -> void* {
+    const std::size_t words = CeilDiv(bytes, sizeof(std::max_align_t));
+    if (arena_used + words > arena.size()) return nullptr;
+    void* memory = arena.data() + arena_used;
+    arena_used += words;
+    return memory;
+  };
+  Kernel* kernel = SelectRuntimeKernel<float>(
+      &bconv2d_params, bitpacked_input_shape, output_shape, output_transform,
+      MakePlacementKernelFactory(allocate));
+  ASSERT_NE(kernel, nullptr);
+  EXPECT_EQ(static_cast<void*>(kernel), static_cast<void*>(arena.data()));
+  const std::int32_t expected_block_size =
+      CpuSupportsAvx512Vpopcntdq() ? 16 : CpuSupportsAvx2() ? 8 : 4;
+  EXPECT_EQ(kernel->block_size_output_channels, expected_block_size);
+
+  const PackedWeightsLayout layout = kernel->GetPackedWeightsLayout();
+  std::vector<TBitpacked> packed_weights(GetPackedWeightsSize(layout));
+  PackWeights(layout, filter_data.data(), packed_weights.data());
+  kernel->UsePackedWeights(packed_weights.data());
+  std::vector<const TBitpacked*> indirection_storage(
+      kernel->GetIndirectionBufferSize());
+  std::vector<TBitpacked> zero_storage(kernel->GetZeroBufferSize());
+  kernel->UseIndirectionStorage(indirection_storage.data(),
+                                zero_storage.data());
+  kernel->FillIndirectionBuffer(&bconv2d_params, bitpacked_input_shape,
+                                output_shape, input_data.data());
+  EXPECT_TRUE(kernel->indirection_buffer.empty());
+  EXPECT_TRUE(kernel->zero_buffer.empty());
+  EXPECT_EQ(kernel->indirection_buffer_ptr, indirection_storage.data());
+
+  std::vector<float> actual(output_shape.FlatSize());
+  kernel->Dispatch(actual.data());
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_EQ(expected[i], actual[i]) << "at output index " << i;
+  }
+}
+
+}  // namespace indirect_bgemm
+}  // namespace core
+}  // namespace compute_engine
@@ -0,0 +1,177 @@
+#include "tensorflow/lite/micro/My/core/indirect_bgemm/prepacked_weights.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "tensorflow/lite/micro/My/core/bconv2d/output_transform.h"
+#include "tensorflow/lite/micro/My/core/bconv2d/params.h"
+#include "tensorflow/lite/micro/My/core/bconv2d/reference.h"
+#include "tensorflow/lite/micro/My/core/bitpacking/bitpack.h"
+#include "tensorflow/lite/micro/My/core/indirect_bgemm/kernel_4x2_portable.h"
+#include "tensorflow/lite/kernels/internal/types.h"
+#include "tensorflow/lite/kernels/padding.h"
+
+namespace compute_engine {
+namespace core {
+namespace indirect_bgemm {
+
+using ::tflite::RuntimeShape;
+
+namespace {
+
+std::vector<TBitpacked> RandomBits(const int size) {
+  std::mt19937 gen(1234);
+  std::uniform_int_distribution<TBitpacked> distribution(
+      std::numeric_limits<TBitpacked>::lowest(),
+      std::numeric_limits<TBitpacked>::max());
+  std::vector<TBitpacked> bits(size);
+  for (auto& x : bits) x = distribution(gen);
+  return bits;
+}
+
+// Concatenates the blobs for `layouts`, all packed from the same `weights`,
+// with filter buffer indices 0, 1, ...
+std::vector<TBitpacked> WriteBlobs(
+    const std::vector<PackedWeightsLayout>& layouts,
+    const std::vector<TBitpacked>& weights) {
+  std::size_t num_bytes = 0;
+  for (const auto& layout : layouts) {
+    num_bytes += GetPrepackedWeightsBytes(layout);
+  }
+  // Use words as the storage, so that the blobs are aligned.
+  std::vector<TBitpacked> storage(num_bytes / sizeof(TBitpacked));
+  auto* blob = reinterpret_cast<std::uint8_t*>(storage.data());
+  for (std::size_t i = 0; i < layouts.size(); ++i) {
+    WritePrepackedWeights(layouts[i], i, weights.data(), blob);
+    blob += GetPrepackedWeightsBytes(layouts[i]);
+  }
+  return storage;
+}
+
+}  // namespace
+
+TEST(PrepackedWeightsTest, KernelUsesPrepackedWeights) {
+  bconv2d::BConv2DParams bconv2d_params;
+  bconv2d_params.filter_height = bconv2d_params.filter_width = 3;
+  bconv2d_params.channels_in = 96;
+  bconv2d_params.channels_out = 10;
+  bconv2d_params.stride_height = bconv2d_params.stride_width = 1;
+  bconv2d_params.dilation_height_factor =
+      bconv2d_params.dilation_width_factor = 1;
+  bconv2d_params.groups = 1;
+  bconv2d_params.padding_type = kTfLitePaddingSame;
+  bconv2d_params.pad_value = 1;
+
+  const int input_height = 6, input_width = 5;
+  int output_height, output_width;
+  bconv2d_params.padding_values = ::tflite::ComputePaddingHeightWidth(
+      1, 1, 1, 1, input_height, input_width, 3, 3, kTfLitePaddingSame,
+      &output_height, &output_width);
+
+  const int input_depth =
+      bitpacking::GetBitpackedSize(bconv2d_params.channels_in);
+  const std::int32_t input_dims[] = {1, input_height, input_width,
+                                     input_depth};
+  const std::int32_t filter_dims[] = {bconv2d_params.channels_out, 3, 3,
+                                      input_depth};
+  const std::int32_t output_dims[] = {1, output_height, output_width,
+                                      bconv2d_params.channels_out};
+  const RuntimeShape input_shape(4, input_dims);
+  const RuntimeShape filter_shape(4, filter_dims);
+  const RuntimeShape output_shape(4, output_dims);
+
+  const auto input_data = RandomBits(input_shape.FlatSize());
+  const auto filter_data = RandomBits(filter_shape.FlatSize());
+
+  const std::vector<float> multiplier(bconv2d_params.channels_out, 0.5f);
+  const std::vector<float> bias(bconv2d_params.channels_out, 1.0f);
+  bconv2d::OutputTransform<float> output_transform;
+  output_transform.multiplier = multiplier.data();
+  output_transform.bias = bias.data();
+  std::vector<float> expected(output_shape.FlatSize());
+  bconv2d::BConv2DReference<std::int32_t, float>(
+      &bconv2d_params, input_shape, input_data.data(), filter_shape,
+      filter_data.data(), output_transform, output_shape, expected.data());
+
+  Kernel4x2Portable<float> kernel(&bconv2d_params, input_shape, output_shape,
+                                  output_transform);
+  const auto layout = kernel.GetPackedWeightsLayout();
+
+  // Put a blob for another tile shape first, so that the lookup has to skip
+  // it.
+  PackedWeightsLayout other_layout = layout;
+  other_layout.block_size_output_channels = 8;
+  const auto blobs = WriteBlobs({other_layout, layout}, filter_data);
+  const std::size_t blobs_size = blobs.size() * sizeof(TBitpacked);
+  const auto* blobs_ptr = reinterpret_cast<const std::uint8_t*>(blobs.data());
+
+  const TBitpacked* prepacked_weights =
+      FindPrepackedWeights(layout, 1, blobs_ptr, blobs_size);
+  ASSERT_NE(prepacked_weights, nullptr);
+
+  // The blob holds exactly what the kernel would have packed itself.
+  kernel.PackWeights(filter_data.data());
+  const std::vector<TBitpacked> packed_weights = kernel.packed_weights;
+  ASSERT_EQ(packed_weights.size(), GetPackedWeightsSize(layout));
+  for (std::size_t i = 0; i < packed_weights.size(); ++i) {
+    ASSERT_EQ(prepacked_weights[i], packed_weights[i]) << "at index " << i;
+  }
+
+  kernel.UsePackedWeights(prepacked_weights);
+  EXPECT_TRUE(kernel.packed_weights.empty());
+  kernel.FillIndirectionBuffer(&bconv2d_params, input_shape, output_shape,
+                               input_data.data());
+  std::vector<float> actual(output_shape.FlatSize());
+  kernel.Dispatch(actual.data());
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_EQ(expected[i], actual[i]) << "at output index " << i;
+  }
+}
+
+TEST(PrepackedWeightsTest, RejectsMismatchedBlobs) {
+  PackedWeightsLayout layout;
+  layout.block_size_output_channels = 4;
+  layout.block_size_depth = 1;
+  layout.input_depth = 4;
+  layout.output_channels = 6;
+  layout.filter_size = 9;
+  layout.groups = 2;
+  const auto weights = RandomBits(layout.output_channels * layout.filter_size *
+                                  layout.input_depth / layout.groups);
+  const auto blobs = WriteBlobs({layout}, weights);
+  const std::size_t blobs_size = blobs.size() * sizeof(TBitpacked);
+  const auto* blobs_ptr = reinterpret_cast<const std::uint8_t*>(blobs.data());
+
+  EXPECT_NE(FindPrepackedWeights(layout, 0, blobs_ptr, blobs_size), nullptr);
+  // Another filter buffer.
+  EXPECT_EQ(FindPrepackedWeights(layout, 1, blobs_ptr, blobs_size), nullptr);
+  // Another tile shape or convolution shape.
+  PackedWeightsLayout other_layout = layout;
+  other_layout.block_size_depth = 2;
+  EXPECT_EQ(FindPrepackedWeights(other_layout, 0, blobs_ptr, blobs_size),
+            nullptr);
+  other_layout = layout;
+  other_layout.groups = 1;
+  EXPECT_EQ(FindPrepackedWeights(other_layout, 0, blobs_ptr, blobs_size),
+            nullptr);
+  // A truncated or misaligned blob.
+  EXPECT_EQ(FindPrepackedWeights(layout, 0, blobs_ptr, blobs_size - 1),
+            nullptr);
+  EXPECT_EQ(FindPrepackedWeights(layout, 0, blobs_ptr + 1, blobs_size - 1),
+            nullptr);
+  // Something that is not a blob at all.
+  const std::vector<TBitpacked> garbage(64, 0);
+  const auto* garbage_ptr =
+      reinterpret_cast<const std::uint8_t*>(garbage.data());
+  EXPECT_EQ(FindPrepackedWeights(layout, 0, garbage_ptr,
+                                 garbage.size() * sizeof(TBitpacked)),
+            nullptr);
+}
+
+}  // namespace indirect_bgemm
+}  // namespace core
+}  // namespace compute_engine
@@ -0,0 +1,70 @@
+#include "tensorflow/lite/micro/My/core/thread_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace compute_engine {
+namespace core {
+
+class ThreadPoolTest : public ::testing::TestWithParam<int> {};
+
+TEST_P(ThreadPoolTest, CoversRangeExactlyOnce) {
+  ThreadPool thread_pool(GetParam());
+  EXPECT_EQ(thread_pool.num_threads(), std::max(1, GetParam()));
+
+  // Run several ranges through the same pool, including ones with fewer
+  // chunks than threads and a last chunk that is shorter.
+  for (const auto& range : std::vector<std::vector<std::int32_t>>{
+           {0, 1000, 7}, {5, 6, 1}, {-20, 20, 3}, {0, 3, 16}, {0, 4096, 64}}) {
+    const std::int32_t begin = range[0], end = range[1], chunk = range[2];
+    std::vector<std::atomic<int>> counts(end - begin);
+    for (auto& count : counts) count = 0;
+    thread_pool.ParallelFor(begin, end, chunk,
+                            [&](std::int32_t start, std::int32_t stop) {
+                              EXPECT_EQ((start - begin) % chunk, 0);
+                              EXPECT_LE(stop - start, chunk);
+                              for (std::int32_t i = start; i < stop; ++i) {
+                                ++counts[i - begin];
+                              }
+                            });
+    for (std::size_t i = 0; i < counts.size(); ++i) {
+      ASSERT_EQ(counts[i], 1) << "at index " << begin + i;
+    }
+  }
+}
+
+TEST_P(ThreadPoolTest, BalancesUnevenWork) {
+  ThreadPool thread_pool(GetParam());
+
+  // All of the slow chunks are in the first thread's share, so the other
+  // threads have to steal them for every chunk to be run.
+  std::mutex mutex;
+  std::set<std::thread::id> thread_ids;
+  std::atomic<int> num_chunks{0};
+  thread_pool.ParallelFor(0, 64, 1, [&](std::int32_t start, std::int32_t) {
+    if (start < 64 / thread_pool.num_threads()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      thread_ids.insert(std::this_thread::get_id());
+    }
+    ++num_chunks;
+  });
+  EXPECT_EQ(num_chunks, 64);
+  EXPECT_LE(static_cast<int>(thread_ids.size()), thread_pool.num_threads());
+}
+
+INSTANTIATE_TEST_SUITE_P(ThreadPool, ThreadPoolTest,
+                         ::testing::Values(0, 1, 2, 4, 8));
+
+}  // namespace core
+}  // namespace compute_engine
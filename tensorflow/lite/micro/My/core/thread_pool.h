@@ -0,0 +1,166 @@
+#ifndef COMPUTE_ENGINE_CORE_THREAD_POOL_H_
+#define COMPUTE_ENGINE_CORE_THREAD_POOL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace compute_engine {
+namespace core {
+
+/**
+ * A fixed-size pool of worker threads for hosted (e.g. Linux) builds, used to
+ * split the pixel range of a binary convolution across cores.
+ *
+ * ParallelFor() divides the range into chunks and gives every thread a
+ * contiguous share of them, so that neighbouring chunks, which share input
+ * rows, tend to run on the same core. A thread that runs out of chunks steals
+ * the next unclaimed chunk from the other threads' shares. Owners and thieves
+ * both claim a chunk with a single fetch_add on the share's cursor, so there
+ * are no locks on this path.
+ *
+ * The calling thread takes part in the work, so a pool of `num_threads` starts
+ * `num_threads - 1` workers. ParallelFor() must not be called concurrently or
+ * recursively on the same pool.
+ */
+class ThreadPool {
+ public:
+  using RangeFunction = std::function<void(std::int32_t, std::int32_t)>;
+
+  explicit ThreadPool(const int num_threads)
+      : num_threads_(std::max(1, num_threads)),
+        shares_(new Share[std::max(1, num_threads)]) {
+    for (int i = 1; i < num_threads_; ++i) {
+      workers_.emplace_back(&ThreadPool::WorkerLoop, this, i);
+    }
+  }
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto& worker : workers_) worker.join();
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  int num_threads() const { return num_threads_; }
+
+  // Calls `fn(chunk_start, chunk_end)` for consecutive chunks of `chunk_size`
+  // elements (the last one may be shorter) that together cover [begin, end),
+  // and returns when all of them are done.
+  void ParallelFor(const std::int32_t begin, const std::int32_t end,
+                   const std::int32_t chunk_size, const RangeFunction& fn) {
+    if (end <= begin) return;
+    const std::int32_t step = std::max<std::int32_t>(1, chunk_size);
+    const std::int32_t num_chunks = (end - begin + step - 1) / step;
+    if (num_threads_ == 1 || num_chunks == 1) {
+      for (std::int32_t start = begin; start < end; start += step) {
+        fn(start, std::min(end, start + step));
+      }
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      fn_ = &fn;
+      begin_ = begin;
+      end_ = end;
+      chunk_size_ = step;
+      for (int t = 0; t < num_threads_; ++t) {
+        shares_[t].next.store(
+            static_cast<std::int32_t>(std::int64_t(num_chunks) * t /
+                                      num_threads_),
+            std::memory_order_relaxed);
+        shares_[t].end = static_cast<std::int32_t>(
+            std::int64_t(num_chunks) * (t + 1) / num_threads_);
+      }
+      pending_workers_ = num_threads_ - 1;
+      ++generation_;
+    }
+    work_cv_.notify_all();
+
+    RunChunks(0);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this] { return pending_workers_ == 0; });
+    fn_ = nullptr;
+  }
+
+ private:
+  // The chunks [next, end) of one thread's share. Padded to the size of a
+  // cache line, so that the cursors of two shares, which are written by
+  // different threads, are never on the same line. The array isn't aligned
+  // to a line, as over-aligned new needs C++17.
+  static constexpr std::size_t kCacheLineSize = 64;
+  struct Share {
+    std::atomic<std::int32_t> next{0};
+    std::int32_t end = 0;
+    char padding[kCacheLineSize - sizeof(std::atomic<std::int32_t>) -
+                 sizeof(std::int32_t)];
+  };
+
+  void RunChunks(const int thread_index) {
+    for (int i = 0; i < num_threads_; ++i) {
+      Share& share = shares_[(thread_index + i) % num_threads_];
+      while (true) {
+        const std::int32_t chunk =
+            share.next.fetch_add(1, std::memory_order_relaxed);
+        if (chunk >= share.end) break;
+        const std::int32_t start = begin_ + chunk * chunk_size_;
+        (*fn_)(start, std::min(end_, start + chunk_size_));
+      }
+    }
+  }
+
+  void WorkerLoop(const int thread_index) {
+    std::uint64_t seen_generation = 0;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        work_cv_.wait(lock, [&] {
+          return stop_ || generation_ != seen_generation;
+        });
+        if (stop_) return;
+        seen_generation = generation_;
+      }
+      RunChunks(thread_index);
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--pending_workers_ == 0) done_cv_.notify_one();
+      }
+    }
+  }
+
+  const int num_threads_;
+  std::unique_ptr<Share[]> shares_;
+  std::vector<std::thread> workers_;
+
+  std::mutex mutex_;
+  std::condition_variable work_cv_;
+  std::condition_variable done_cv_;
+  std::uint64_t generation_ = 0;
+  int pending_workers_ = 0;
+  bool stop_ = false;
+
+  // The current ParallelFor() call. Published to the workers under `mutex_`.
+  const RangeFunction* fn_ = nullptr;
+  std::int32_t begin_ = 0;
+  std::int32_t end_ = 0;
+  std::int32_t chunk_size_ = 1;
+};
+
+}  // namespace core
+}  // namespace compute_engine
+
+#endif  // COMPUTE_ENGINE_CORE_THREAD_POOL_H_
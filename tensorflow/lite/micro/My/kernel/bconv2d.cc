@@ -1,23 +1,34 @@
-#include <cmath>
+#include <algorithm>
 #include <cstdint>
 
 #include "flatbuffers/flexbuffers.h"
-#include "tensorflow/lite/micro/My/core/bconv2d/optimized_bgemm.h"
-#include "tensorflow/lite/micro/My/core/bconv2d/optimized_indirect_bgemm.h"
+#include "tensorflow/lite/micro/My/core/bconv2d/output_transform.h"
 #include "tensorflow/lite/micro/My/core/bconv2d/params.h"
+#include "tensorflow/lite/micro/My/core/bconv2d/portable_bgemm.h"
+#include "tensorflow/lite/micro/My/core/bconv2d/portable_bgemm_bmaxpool.h"
 #include "tensorflow/lite/micro/My/core/bconv2d/reference.h"
 #include "tensorflow/lite/micro/My/core/bconv2d/zero_padding_correction.h"
-#include "tensorflow/lite/micro/My/core/indirect_bgemm/kernel.h"
-#include "tensorflow/lite/micro/My/core/indirect_bgemm/select_kernel.h"
+#include "tensorflow/lite/micro/My/core/bitpacking/utils.h"
+#include "tensorflow/lite/micro/My/core/bmaxpool.h"
 #include "tensorflow/lite/micro/My/core/types.h"
-// #include "larq_compute_engine/tflite/kernels/utils.h"
+#include "tensorflow/lite/micro/My/kernel/lce_ops_register.h"
 #include "tensorflow/lite/micro/My/kernel/utils.h"
 #include "tensorflow/lite/c/builtin_op_data.h"
-#include "tensorflow/lite/micro/My/lite/kernels/cpu_backend_context.h"
-#include "tensorflow/lite/kernels/internal/quantization_util.h"
+#include "tensorflow/lite/c/common.h"
 #include "tensorflow/lite/kernels/internal/tensor_ctypes.h"
 #include "tensorflow/lite/kernels/kernel_util.h"
 #include "tensorflow/lite/kernels/padding.h"
+#include "tensorflow/lite/micro/kernels/kernel_util.h"
+
+#ifdef LCE_INDIRECT_BGEMM
+#include "tensorflow/lite/micro/My/core/bconv2d/optimized_indirect_bgemm.h"
+#include "tensorflow/lite/micro/My/core/indirect_bgemm/kernel.h"
+#include "tensorflow/lite/micro/My/core/indirect_bgemm/select_kernel.h"
+#include "tensorflow/lite/micro/My/kernel/prepacked_weights.h"
+#endif
+#ifdef LCE_INDIRECT_BGEMM_THREADED
+#include "tensorflow/lite/micro/My/core/thread_pool.h"
+#endif
 
 using namespace tflite;
 
@@ -33,15 +44,35 @@ enum class KernelType {
   // The reference implementation with for-loops.
   kReference,
 
-  // The Ruy implementation with im2col and hand-optimized BGEMM kernels.
+  // The portable implementation with a row-wise im2col and BGEMM.
   kOptimizedBGEMM,
 
-  // The XNNPack-derived implementation with indirect BGEMM kernels.
+  // The XNNPack-derived implementation with indirect BGEMM kernels, only
+  // built when LCE_INDIRECT_BGEMM is defined.
   kOptimizedIndirectBGEMM,
+
+  // The same, split over the core::ThreadPool that the application passed as
+  // the external context, if any. Only built when LCE_INDIRECT_BGEMM_THREADED
+  // is defined.
+  kOptimizedIndirectBGEMMThreaded,
 };
 
-constexpr int kTensorNotAllocated = -1;
+constexpr bool IsIndirectBGEMM(const KernelType kernel_type) {
+  return kernel_type == KernelType::kOptimizedIndirectBGEMM ||
+         kernel_type == KernelType::kOptimizedIndirectBGEMMThreaded;
+}
 
+constexpr int kInputTensor = 0;
+constexpr int kFilterTensor = 1;
+constexpr int kPostActivationMultiplierTensor = 2;
+constexpr int kPostActivationBiasTensor = 3;
+constexpr int kThresholdsTensor = 4;
+constexpr int kOutputTensor = 0;
+
+// All of the state lives in the persistent arena: the struct itself is
+// allocated in Init and the arrays it points to in Prepare. The temporary
+// buffers are scratch buffers, so the memory planner sees the whole footprint
+// of the op.
 struct OpData {
   BConv2DParams params;
 
@@ -49,29 +80,46 @@ struct OpData {
   TfLiteFusedActivation fused_activation_function;
 
   // Computed output transform values. These are only used when writing
-  // float/int8 output.
+  // float/int8 output, and hold `channels_out` values.
   std::int32_t output_transform_clamp_min;
   std::int32_t output_transform_clamp_max;
-  std::vector<float> output_transform_multiplier;
-  std::vector<float> output_transform_bias;
-
-  // This is used when we have 'same-zero' padding.
-  std::vector<float> padding_buffer;
-
-  // This is used for the 'indirect bgemm' kernel type.
-  std::unique_ptr<core::indirect_bgemm::Kernel> indirect_bgemm_kernel;
-
-  // IDs are the arbitrary identifiers used by TF Lite to identify and access
-  // memory buffers. They are unique in the entire TF Lite context.
-  int im2col_id = kTensorNotAllocated;
-  // In node->temporaries there is a list of tensor id's that are part
-  // of this node in particular. The indices below are offsets into this array.
-  // So in pseudo-code: `node->temporaries[index] = id;`
-  std::int32_t im2col_index = -1;
-
-  bool successfully_initialized = false;
+  float* output_transform_multiplier;
+  float* output_transform_bias;
+
+  // This is used when we have 'same-zero' padding with the BGEMM or indirect
+  // BGEMM kernel.
+  float* padding_buffer;
+
+  // Zero point used to bitpack an int8 input.
+  std::int32_t input_zero_point;
+
+  // Index of the scratch buffer that holds one output row of im2col data, or
+  // -1 if the BGEMM can read the input directly.
+  int im2col_scratch_index;
+
+  // Index of the scratch buffer that holds the bitpacked input, or -1 if the
+  // input is already bitpacked.
+  int bitpacked_input_scratch_index;
+
+  // Set for the fused LceBconv2dBMaxPool2d op, whose output is the bitpacked
+  // convolution output max-pooled with `pool_params`. The convolution rows in
+  // the current pooling windows are kept in a scratch buffer.
+  bool fused_bmaxpool;
+  core::BMaxPoolParams pool_params;
+  int conv_output_height;
+  int conv_output_width;
+  int conv_rows_scratch_index;
+
+#ifdef LCE_INDIRECT_BGEMM
+  // The indirect BGEMM kernel, constructed in the persistent arena in
+  // Prepare, together with its packed weights and indirection buffer.
+  core::indirect_bgemm::Kernel* indirect_bgemm_kernel;
+  // The bitpacked input that the indirection buffer points into. It is filled
+  // again in Eval if the input moves.
+  const TBitpacked* indirection_input;
+#endif
 
-  bool one_time_setup_complete = false;
+  bool successfully_initialized;
 };
 
 #define LCE_ENSURE_PARAM(op_data, context, a)                           \
@@ -84,7 +132,29 @@ struct OpData {
   } while (0)
 
 void* Init(TfLiteContext* context, const char* buffer, std::size_t length) {
-  auto* op_data = new OpData{};
+  TFLITE_DCHECK(context->AllocatePersistentBuffer != nullptr);
+  auto* op_data = static_cast<OpData*>(
+      context->AllocatePersistentBuffer(context, sizeof(OpData)));
+  if (op_data == nullptr) {
+    return nullptr;
+  }
+  op_data->output_transform_multiplier = nullptr;
+  op_data->output_transform_bias = nullptr;
+  op_data->padding_buffer = nullptr;
+  op_data->input_zero_point = 0;
+  op_data->im2col_scratch_index = -1;
+  op_data->bitpacked_input_scratch_index = -1;
+  op_data->fused_bmaxpool = false;
+  op_data->pool_params = core::BMaxPoolParams{};
+  op_data->conv_output_height = 0;
+  op_data->conv_output_width = 0;
+  op_data->conv_rows_scratch_index = -1;
+#ifdef LCE_INDIRECT_BGEMM
+  op_data->indirect_bgemm_kernel = nullptr;
+  op_data->indirection_input = nullptr;
+#endif
+  op_data->successfully_initialized = false;
+
   auto* bconv2d_params = &op_data->params;
 
   const std::uint8_t* buffer_t = reinterpret_cast<const std::uint8_t*>(buffer);
@@ -131,30 +201,160 @@ void* Init(TfLiteContext* context, const char* buffer, std::size_t length) {
   return op_data;
 }
 
-void Free(TfLiteContext* context, void* buffer) {
-  delete reinterpret_cast<OpData*>(buffer);
+// The fused op has all of the LceBconv2d attributes, plus the attributes of
+// LceBMaxPool2d with a "pool_" prefix.
+void* InitBMaxPool(TfLiteContext* context, const char* buffer,
+                   std::size_t length) {
+  auto* op_data = static_cast<OpData*>(Init(context, buffer, length));
+  if (op_data == nullptr || !op_data->successfully_initialized) {
+    return op_data;
+  }
+  op_data->successfully_initialized = false;
+  op_data->fused_bmaxpool = true;
+
+  const std::uint8_t* buffer_t = reinterpret_cast<const std::uint8_t*>(buffer);
+  const flexbuffers::Map& m = flexbuffers::GetRoot(buffer_t, length).AsMap();
+
+  LCE_ENSURE_PARAM(op_data, context, !m["pool_filter_height"].IsNull());
+  LCE_ENSURE_PARAM(op_data, context, !m["pool_filter_width"].IsNull());
+  LCE_ENSURE_PARAM(op_data, context, !m["pool_stride_height"].IsNull());
+  LCE_ENSURE_PARAM(op_data, context, !m["pool_stride_width"].IsNull());
+  LCE_ENSURE_PARAM(op_data, context, !m["pool_padding"].IsNull());
+
+  auto* pool_params = &op_data->pool_params;
+  pool_params->filter_height = m["pool_filter_height"].AsInt32();
+  pool_params->filter_width = m["pool_filter_width"].AsInt32();
+  pool_params->stride_height = m["pool_stride_height"].AsInt32();
+  pool_params->stride_width = m["pool_stride_width"].AsInt32();
+  pool_params->padding_type =
+      ConvertPadding((Padding)m["pool_padding"].AsInt32());
+
+  op_data->successfully_initialized = true;
+  return op_data;
+}
+
+// For 'same-zero' padding, caches the padding correction in the persistent
+// arena.
+TfLiteStatus CalculatePaddingCorrection(TfLiteContext* context,
+                                        const TfLiteTensor* filter,
+                                        const TfLiteTensor* multiplier,
+                                        OpData* op_data) {
+  const auto* bconv2d_params = &op_data->params;
+  const std::size_t cache_size = zero_padding_correction::GetCacheSize(
+      bconv2d_params->filter_height, bconv2d_params->filter_width,
+      bconv2d_params->channels_out, bconv2d_params->dilation_height_factor,
+      bconv2d_params->dilation_width_factor);
+  op_data->padding_buffer = static_cast<float*>(
+      context->AllocatePersistentBuffer(context, cache_size * sizeof(float)));
+  TF_LITE_ENSURE(context, op_data->padding_buffer != nullptr);
+
+  zero_padding_correction::CacheCorrectionValues(
+      GetTensorData<TBitpacked>(filter), bconv2d_params->filter_height,
+      bconv2d_params->filter_width, bconv2d_params->channels_out,
+      bconv2d_params->channels_in / bconv2d_params->groups,
+      bconv2d_params->dilation_height_factor,
+      bconv2d_params->dilation_width_factor, GetTensorData<float>(multiplier),
+      op_data->padding_buffer);
+  return kTfLiteOk;
+}
+
+#ifdef LCE_INDIRECT_BGEMM
+// Selects the indirect BGEMM kernel for this CPU and output type, and packs
+// the weights for it. The kernel, the packed weights and the indirection
+// buffer all live in the persistent arena, so nothing is allocated on the heap.
+// If lce_prepack_weights stored the weights in the model for exactly this
+// kernel's layout, they are used in place and not packed again.
+template <typename DstScalar>
+TfLiteStatus PrepareIndirectBGEMM(TfLiteContext* context, TfLiteNode* node,
+                                  const TfLiteTensor* filter,
+                                  const RuntimeShape& bitpacked_input_shape,
+                                  const RuntimeShape& output_shape,
+                                  OpData* op_data) {
+  OutputTransform<DstScalar> output_transform;
+  GetOutputTransform(output_transform, context, node, op_data,
+                     kThresholdsTensor);
+  const auto allocate = [context](const std::size_t bytes) {
+    return context->AllocatePersistentBuffer(context, bytes);
+  };
+  auto* kernel = core::indirect_bgemm::SelectRuntimeKernel<DstScalar>(
+      &op_data->params, bitpacked_input_shape, output_shape, output_transform,
+      core::indirect_bgemm::MakePlacementKernelFactory(allocate));
+  TF_LITE_ENSURE(context, kernel != nullptr);
+
+  const auto layout = kernel->GetPackedWeightsLayout();
+  MicroContext* micro_context = GetMicroContext(context);
+  const ::tflite::Model* model = micro_context->model();
+  const TBitpacked* packed_weights = FindPrepackedWeights(
+      model,
+      GetInputBuffer(model, micro_context->graph().GetCurrentSubgraphIndex(),
+                     node, kFilterTensor),
+      layout);
+  if (packed_weights == nullptr) {
+    auto* weights = static_cast<TBitpacked*>(
+        allocate(core::indirect_bgemm::GetPackedWeightsSize(layout) *
+                 sizeof(TBitpacked)));
+    TF_LITE_ENSURE(context, weights != nullptr);
+    core::indirect_bgemm::PackWeights(
+        layout, GetTensorData<TBitpacked>(filter), weights);
+    packed_weights = weights;
+  }
+  kernel->UsePackedWeights(packed_weights);
+
+  auto* indirection_storage = static_cast<const TBitpacked**>(allocate(
+      kernel->GetIndirectionBufferSize() * sizeof(const TBitpacked*)));
+  auto* zero_storage = static_cast<TBitpacked*>(
+      allocate(kernel->GetZeroBufferSize() * sizeof(TBitpacked)));
+  TF_LITE_ENSURE(context, indirection_storage != nullptr);
+  TF_LITE_ENSURE(context, zero_storage != nullptr);
+  kernel->UseIndirectionStorage(indirection_storage, zero_storage);
+
+  op_data->indirect_bgemm_kernel = kernel;
+  op_data->indirection_input = nullptr;
+  return kTfLiteOk;
 }
+#endif
 
 template <KernelType kernel_type>
 TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
-  auto* op_data = reinterpret_cast<OpData*>(node->user_data);
+  TFLITE_DCHECK(node->user_data != nullptr);
+  auto* op_data = static_cast<OpData*>(node->user_data);
   auto* bconv2d_params = &op_data->params;
 
   // If an error happened in Init, then return an error code.
   if (!op_data->successfully_initialized) return kTfLiteError;
 
-  TF_LITE_ENSURE_EQ(context, node->inputs->size, 5);
-
-  const auto* input = GetInput(context, node, 0);
-  const auto* filter = GetInput(context, node, 1);
-  const auto* post_activation_multiplier = GetInput(context, node, 2);
-  const auto* post_activation_bias = GetInput(context, node, 3);
-  const auto* thresholds = GetInput(context, node, 4);
-  auto* output = GetOutput(context, node, 0);
+  TF_LITE_ENSURE_EQ(context, NumInputs(node), 5);
+  TF_LITE_ENSURE_EQ(context, NumOutputs(node), 1);
+
+  MicroContext* micro_context = GetMicroContext(context);
+  TfLiteTensor* input =
+      micro_context->AllocateTempInputTensor(node, kInputTensor);
+  TF_LITE_ENSURE(context, input != nullptr);
+  TfLiteTensor* filter =
+      micro_context->AllocateTempInputTensor(node, kFilterTensor);
+  TF_LITE_ENSURE(context, filter != nullptr);
+  TfLiteTensor* post_activation_multiplier =
+      micro_context->AllocateTempInputTensor(node,
+                                             kPostActivationMultiplierTensor);
+  TF_LITE_ENSURE(context, post_activation_multiplier != nullptr);
+  TfLiteTensor* post_activation_bias =
+      micro_context->AllocateTempInputTensor(node, kPostActivationBiasTensor);
+  TF_LITE_ENSURE(context, post_activation_bias != nullptr);
+  TfLiteTensor* thresholds =
+      micro_context->AllocateTempInputTensor(node, kThresholdsTensor);
+  TF_LITE_ENSURE(context, thresholds != nullptr);
+  TfLiteTensor* output =
+      micro_context->AllocateTempOutputTensor(node, kOutputTensor);
+  TF_LITE_ENSURE(context, output != nullptr);
 
   TF_LITE_ENSURE_EQ(context, NumDimensions(input), 4);
   TF_LITE_ENSURE_EQ(context, NumDimensions(filter), 4);
-  TF_LITE_ENSURE_EQ(context, input->type, kTfLiteInt32);
+  TF_LITE_ENSURE_EQ(context, NumDimensions(output), 4);
+  TF_LITE_ENSURE_MSG(context,
+                     input->type == kTfLiteInt32 ||
+                         input->type == kTfLiteInt8 ||
+                         input->type == kTfLiteFloat32,
+                     "Supported input types are int8, int32, and float32.");
   TF_LITE_ENSURE_EQ(context, filter->type, kTfLiteInt32);
   TF_LITE_ENSURE_MSG(context,
                      output->type == kTfLiteInt32 ||
@@ -162,6 +362,18 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
                          output->type == kTfLiteFloat32,
                      "Supported output types are int8, int32, and float32.");
 
+  // An int32 input is already bitpacked along the channels; an int8 or float
+  // input is bitpacked into a scratch buffer at the start of Eval.
+  if (input->type == kTfLiteInt32) {
+    TF_LITE_ENSURE_EQ(context, SizeOfDimension(input, 3),
+                      GetBitpackedSize(bconv2d_params->channels_in));
+  } else {
+    TF_LITE_ENSURE_EQ(context, SizeOfDimension(input, 3),
+                      bconv2d_params->channels_in);
+  }
+  op_data->input_zero_point =
+      input->type == kTfLiteInt8 ? input->params.zero_point : 0;
+
   // Read the filter dimensions
   bconv2d_params->channels_out = SizeOfDimension(filter, 0);
   bconv2d_params->filter_height = SizeOfDimension(filter, 1);
@@ -186,8 +398,10 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
     bconv2d_params->groups = groups;
   }
 
-  if (bconv2d_params->padding_type == kTfLitePaddingSame &&
-      bconv2d_params->pad_value == 0) {
+  const bool zero_padding =
+      bconv2d_params->padding_type == kTfLitePaddingSame &&
+      bconv2d_params->pad_value == 0;
+  if (zero_padding) {
     TF_LITE_ENSURE_MSG(
         context,
         (kernel_type == KernelType::kReference &&
@@ -210,6 +424,38 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
       bconv2d_params->filter_width, bconv2d_params->padding_type, &out_height,
       &out_width);
 
+  // For the fused op, the output is the pooled convolution output.
+  op_data->conv_output_height = out_height;
+  op_data->conv_output_width = out_width;
+  int pooled_height = out_height, pooled_width = out_width;
+  if (op_data->fused_bmaxpool) {
+    auto* pool_params = &op_data->pool_params;
+    TF_LITE_ENSURE_MSG(context, output->type == kTfLiteInt32,
+                       "The fused binary max-pool needs bitpacked output.");
+    TF_LITE_ENSURE_MSG(
+        context, kernel_type == KernelType::kOptimizedBGEMM,
+        "The fused binary max-pool is only supported with this kernel.");
+    TF_LITE_ENSURE(context, pool_params->stride_height != 0);
+    TF_LITE_ENSURE(context, pool_params->stride_width != 0);
+    TF_LITE_ENSURE(context, pool_params->filter_height != 0);
+    TF_LITE_ENSURE(context, pool_params->filter_width != 0);
+    pool_params->padding = ComputePaddingHeightWidth(
+        pool_params->stride_height, pool_params->stride_width, 1, 1,
+        out_height, out_width, pool_params->filter_height,
+        pool_params->filter_width, pool_params->padding_type, &pooled_height,
+        &pooled_width);
+  }
+
+  // The output shape is fixed by the model, so it is only checked here.
+  TF_LITE_ENSURE_EQ(context, SizeOfDimension(output, 0),
+                    SizeOfDimension(input, 0));
+  TF_LITE_ENSURE_EQ(context, SizeOfDimension(output, 1), pooled_height);
+  TF_LITE_ENSURE_EQ(context, SizeOfDimension(output, 2), pooled_width);
+  TF_LITE_ENSURE_EQ(context, SizeOfDimension(output, 3),
+                    output->type == kTfLiteInt32
+                        ? GetBitpackedSize(bconv2d_params->channels_out)
+                        : bconv2d_params->channels_out);
+
   if (output->type == kTfLiteInt32) {
     TF_LITE_ENSURE_EQ(context, NumDimensions(thresholds), 1);
     TF_LITE_ENSURE_EQ(context, thresholds->type, kTfLiteInt32);
@@ -225,6 +471,16 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
                       bconv2d_params->channels_out);
     TF_LITE_ENSURE_EQ(context, SizeOfDimension(post_activation_bias, 0),
                       bconv2d_params->channels_out);
+    // Division is safe because at this point we know that channels_in is a
+    // multiple of the number of groups.
+    const std::int32_t channels_in_per_group =
+        bconv2d_params->channels_in / bconv2d_params->groups;
+    const std::int32_t backtransform_add = SizeOfDimension(filter, 1) *
+                                           SizeOfDimension(filter, 2) *
+                                           channels_in_per_group;
+    TF_LITE_ENSURE_STATUS(CalculateOutputTransform(
+        context, post_activation_multiplier, post_activation_bias, output,
+        bconv2d_params->channels_out, backtransform_add, op_data));
   }
 
   if (output->type == kTfLiteInt8) {
@@ -232,326 +488,236 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
                       kTfLiteAffineQuantization);
   }
 
-  if (kernel_type == KernelType::kOptimizedIndirectBGEMM) {
-    TF_LITE_ENSURE_MSG(
-        context, input->allocation_type != kTfLiteDynamic,
-        "The input tensor must not have dynamic allocation type");
+  if (kernel_type != KernelType::kReference && zero_padding) {
+    TF_LITE_ENSURE_STATUS(CalculatePaddingCorrection(
+        context, filter, post_activation_multiplier, op_data));
   }
 
-  // Determine the output dimensions and allocate the output buffer
-  TfLiteIntArray* output_shape = TfLiteIntArrayCreate(4);
-  output_shape->data[0] = SizeOfDimension(input, 0);
-  output_shape->data[1] = out_height;
-  output_shape->data[2] = out_width;
-  output_shape->data[3] = output->type == kTfLiteInt32
-                              ? GetBitpackedSize(bconv2d_params->channels_out)
-                              : bconv2d_params->channels_out;
-  TF_LITE_ENSURE_STATUS(context->ResizeTensor(context, output, output_shape));
-
-  // Figure out how many temporary buffers we need
-  int temporaries_count = 0;
-
-  const bool need_im2col =
-      kernel_type == KernelType::kOptimizedBGEMM &&
-      (bconv2d_params->stride_width != 1 ||
-       bconv2d_params->stride_height != 1 ||
-       bconv2d_params->dilation_width_factor != 1 ||
-       bconv2d_params->dilation_height_factor != 1 ||
-       bconv2d_params->filter_width != 1 || bconv2d_params->filter_height != 1);
-
-  // Pre-allocate temporary tensors
-  if (need_im2col) {
-    op_data->im2col_index = temporaries_count++;
-  } else {
-    op_data->im2col_index = -1;
+#ifdef LCE_INDIRECT_BGEMM
+  if (IsIndirectBGEMM(kernel_type)) {
+    // The weights are packed once, here, and the kernel keeps a pointer to
+    // the thresholds, so both must be constant.
+    TF_LITE_ENSURE_MSG(context, IsConstantTensor(filter),
+                       "The indirect BGEMM kernel needs a constant filter.");
+    const RuntimeShape bitpacked_input_shape =
+        input->type == kTfLiteInt32 ? GetTensorShape(input)
+                                    : bitpacked_shape(GetTensorShape(input));
+    const RuntimeShape output_shape = GetTensorShape(output);
+    if (output->type == kTfLiteFloat32) {
+      TF_LITE_ENSURE_STATUS(PrepareIndirectBGEMM<float>(
+          context, node, filter, bitpacked_input_shape, output_shape,
+          op_data));
+    } else if (output->type == kTfLiteInt8) {
+      TF_LITE_ENSURE_STATUS(PrepareIndirectBGEMM<std::int8_t>(
+          context, node, filter, bitpacked_input_shape, output_shape,
+          op_data));
+    } else {
+      TF_LITE_ENSURE_MSG(
+          context, IsConstantTensor(thresholds),
+          "The indirect BGEMM kernel needs constant thresholds.");
+      TF_LITE_ENSURE_STATUS(PrepareIndirectBGEMM<TBitpacked>(
+          context, node, filter, bitpacked_input_shape, output_shape,
+          op_data));
+    }
   }
+#endif
 
-  if (temporaries_count != 0) {
-    // Allocate int array of that size
-    TfLiteIntArrayFree(node->temporaries);
-    node->temporaries = TfLiteIntArrayCreate(temporaries_count);
+  if (input->type != kTfLiteInt32) {
+    const int bitpacked_input_size =
+        GetBitpackedTensorSize(GetTensorShape(input));
+    TF_LITE_ENSURE_STATUS(context->RequestScratchBufferInArena(
+        context, bitpacked_input_size * sizeof(TBitpacked),
+        &op_data->bitpacked_input_scratch_index));
+  } else {
+    op_data->bitpacked_input_scratch_index = -1;
   }
 
-  // Now allocate the buffers
-  if (need_im2col) {
-    // Allocate the im2col tensor if necessary
-    if (op_data->im2col_id == kTensorNotAllocated) {
-      context->AddTensors(context, 1, &op_data->im2col_id);
-    }
-    node->temporaries->data[op_data->im2col_index] = op_data->im2col_id;
-
-    // Resize the im2col tensor
-    const std::int32_t bitpacked_channels_in =
-        GetBitpackedSize(bconv2d_params->channels_in);
-    TfLiteIntArray* im2col_size = TfLiteIntArrayCopy(output_shape);
-    im2col_size->data[3] = bitpacked_channels_in *
-                           bconv2d_params->filter_height *
-                           bconv2d_params->filter_width;
-    TfLiteTensor* im2col = GetTemporary(context, node, op_data->im2col_index);
-    im2col->type = kTfLiteInt32;
-    im2col->allocation_type = kTfLiteArenaRw;
-    TF_LITE_ENSURE_STATUS(context->ResizeTensor(context, im2col, im2col_size));
+  if (kernel_type == KernelType::kOptimizedBGEMM &&
+      NeedsIm2col(bconv2d_params)) {
+    TF_LITE_ENSURE_STATUS(context->RequestScratchBufferInArena(
+        context,
+        GetIm2colRowSize(bconv2d_params, out_width) * sizeof(TBitpacked),
+        &op_data->im2col_scratch_index));
+  } else {
+    op_data->im2col_scratch_index = -1;
   }
 
-  // Prepare could be called multiple times; when the input tensor is resized,
-  // we shoud always re-do the one-time setup.
-  op_data->one_time_setup_complete = false;
+  if (op_data->fused_bmaxpool) {
+    TF_LITE_ENSURE_STATUS(context->RequestScratchBufferInArena(
+        context,
+        GetConvRowsBufferSize(op_data->pool_params, out_width,
+                              bconv2d_params->channels_out) *
+            sizeof(TBitpacked),
+        &op_data->conv_rows_scratch_index));
+  } else {
+    op_data->conv_rows_scratch_index = -1;
+  }
 
+  micro_context->DeallocateTempTfLiteTensor(input);
+  micro_context->DeallocateTempTfLiteTensor(filter);
+  micro_context->DeallocateTempTfLiteTensor(post_activation_multiplier);
+  micro_context->DeallocateTempTfLiteTensor(post_activation_bias);
+  micro_context->DeallocateTempTfLiteTensor(thresholds);
+  micro_context->DeallocateTempTfLiteTensor(output);
   return kTfLiteOk;
 }
 
-inline void GetConvParamsType(const OpData* op_data,
-                              ConvParams& conv2d_params) {
-  const auto* bconv2d_params = &op_data->params;
-
-  // Padding
-  conv2d_params.padding_type = RuntimePaddingType(bconv2d_params->padding_type);
-  conv2d_params.padding_values.width = bconv2d_params->padding_values.width;
-  conv2d_params.padding_values.height = bconv2d_params->padding_values.height;
-
-  // Strides
-  conv2d_params.stride_height = bconv2d_params->stride_height;
-  conv2d_params.stride_width = bconv2d_params->stride_width;
-
-  // Dilations
-  conv2d_params.dilation_height_factor = bconv2d_params->dilation_height_factor;
-  conv2d_params.dilation_width_factor = bconv2d_params->dilation_width_factor;
-
-  // Activation function
-  conv2d_params.quantized_activation_min = op_data->output_transform_clamp_min;
-  conv2d_params.quantized_activation_max = op_data->output_transform_clamp_max;
-}
-
-void OneTimeSetup(TfLiteContext* context, TfLiteNode* node, OpData* op_data) {
-  const auto* bconv2d_params = &op_data->params;
-
-  const auto* filter = GetInput(context, node, 1);
-  const auto* post_activation_multiplier = GetInput(context, node, 2);
-  const auto* post_activation_bias = GetInput(context, node, 3);
-  const auto* output = GetOutput(context, node, 0);
-
-  // Division is safe because at this point we know that channels_in is a
-  // multiple of the number of groups.
-  const std::int32_t channels_in_per_group =
-      bconv2d_params->channels_in / bconv2d_params->groups;
-
-  // For 'same-zero' padding, compute the padding-correction.
-  if (bconv2d_params->padding_type == kTfLitePaddingSame &&
-      bconv2d_params->pad_value == 0) {
-    op_data->padding_buffer.resize(zero_padding_correction::GetCacheSize(
-        bconv2d_params->filter_height, bconv2d_params->filter_width,
-        bconv2d_params->channels_out, bconv2d_params->dilation_height_factor,
-        bconv2d_params->dilation_width_factor));
-    zero_padding_correction::CacheCorrectionValues(
-        GetTensorData<TBitpacked>(filter), bconv2d_params->filter_height,
-        bconv2d_params->filter_width, bconv2d_params->channels_out,
-        channels_in_per_group, bconv2d_params->dilation_height_factor,
-        bconv2d_params->dilation_width_factor,
-        GetTensorData<float>(post_activation_multiplier),
-        op_data->padding_buffer.data());
+// Returns the bitpacked input data, packing an int8 or float input into its
+// scratch buffer first.
+const TBitpacked* GetBitpackedInput(TfLiteContext* context,
+                                    const TfLiteEvalTensor* input,
+                                    const OpData* op_data,
+                                    RuntimeShape* bitpacked_input_shape) {
+  const RuntimeShape input_shape = ::tflite::micro::GetTensorShape(input);
+  if (op_data->bitpacked_input_scratch_index < 0) {
+    bitpacked_input_shape->ReplaceWith(input_shape.DimensionsCount(),
+                                       input_shape.DimsData());
+    return ::tflite::micro::GetTensorData<TBitpacked>(input);
   }
 
-  // If applicable, fuse the back-transformation and int8 scale/zero-point into
-  // the output transform multiplier/bias.
-  if (output->type == kTfLiteFloat32 || output->type == kTfLiteInt8) {
-    op_data->output_transform_multiplier.resize(
-        bconv2d_params->channels_out + LCE_EXTRA_BYTES / sizeof(float));
-    op_data->output_transform_bias.resize(bconv2d_params->channels_out +
-                                          LCE_EXTRA_BYTES / sizeof(float));
-
-    const auto filter_shape = GetTensorShape(GetInput(context, node, 1));
-    const std::int32_t backtransform_add =
-        filter_shape.Dims(1) * filter_shape.Dims(2) * channels_in_per_group;
-    const double output_scale =
-        output->type == kTfLiteInt8 ? output->params.scale : 1.0;
-    const double output_zero_point =
-        output->type == kTfLiteInt8 ? output->params.zero_point : 0.0;
-
-    for (int i = 0; i < bconv2d_params->channels_out; ++i) {
-      const double post_mul =
-          GetTensorData<float>(post_activation_multiplier)[i];
-      const double post_bias = GetTensorData<float>(post_activation_bias)[i];
-      op_data->output_transform_multiplier.at(i) = -1 * post_mul / output_scale;
-      op_data->output_transform_bias.at(i) =
-          (post_bias + static_cast<double>(backtransform_add) * post_mul) /
-              output_scale +
-          output_zero_point;
-    }
-
-    std::int32_t nominal_clamp_min, nominal_clamp_max;
-    CalculateActivationRange(op_data->fused_activation_function,
-                             &nominal_clamp_min, &nominal_clamp_max);
-    nominal_clamp_min = std::max(nominal_clamp_min, -1 * backtransform_add);
-    nominal_clamp_max = std::min(nominal_clamp_max, backtransform_add);
-    op_data->output_transform_clamp_min =
-        -1 * nominal_clamp_max + backtransform_add;
-    op_data->output_transform_clamp_max =
-        -1 * nominal_clamp_min + backtransform_add;
+  TBitpacked* bitpacked_input = static_cast<TBitpacked*>(
+      context->GetScratchBuffer(context,
+                                op_data->bitpacked_input_scratch_index));
+  if (input->type == kTfLiteInt8) {
+    bitpack_tensor(input_shape,
+                   ::tflite::micro::GetTensorData<std::int8_t>(input),
+                   op_data->input_zero_point, bitpacked_input);
+  } else {
+    bitpack_tensor(input_shape, ::tflite::micro::GetTensorData<float>(input),
+                   0, bitpacked_input);
   }
-
-  op_data->one_time_setup_complete = true;
+  const RuntimeShape packed_shape = bitpacked_shape(input_shape);
+  bitpacked_input_shape->ReplaceWith(packed_shape.DimensionsCount(),
+                                     packed_shape.DimsData());
+  return bitpacked_input;
 }
 
-// Fill in the OutputTransform values for float and/or int8 outputs
-template <typename DstScalar>
-void GetOutputTransform(OutputTransform<DstScalar>& output_transform,
-                        TfLiteContext* context, TfLiteNode* node,
-                        OpData* op_data) {
-  static_assert(std::is_same<DstScalar, float>::value ||
-                    std::is_same<DstScalar, std::int8_t>::value,
-                "");
-  output_transform.clamp_min = op_data->output_transform_clamp_min;
-  output_transform.clamp_max = op_data->output_transform_clamp_max;
-  output_transform.multiplier = op_data->output_transform_multiplier.data();
-  output_transform.bias = op_data->output_transform_bias.data();
-}
-
-// Fill in the OutputTransform values for bitpacked outputs
-void GetOutputTransform(OutputTransform<TBitpacked>& output_transform,
-                        TfLiteContext* context, TfLiteNode* node,
-                        OpData* op_data) {
-  const auto* thresholds = GetInput(context, node, 4);
-  output_transform.thresholds = GetTensorData<std::int32_t>(thresholds);
-}
-
-template <typename AccumScalar, typename DstScalar>
-void EvalOptBGEMM(TfLiteContext* context, TfLiteNode* node, OpData* op_data) {
-  if (!op_data->one_time_setup_complete) {
-    OneTimeSetup(context, node, op_data);
+template <KernelType kernel_type, typename DstScalar>
+TfLiteStatus EvalChooseKernelType(TfLiteContext* context, TfLiteNode* node,
+                                  OpData* op_data) {
+  const TfLiteEvalTensor* input =
+      ::tflite::micro::GetEvalInput(context, node, kInputTensor);
+  const TfLiteEvalTensor* filter =
+      ::tflite::micro::GetEvalInput(context, node, kFilterTensor);
+  TfLiteEvalTensor* output =
+      ::tflite::micro::GetEvalOutput(context, node, kOutputTensor);
+
+  RuntimeShape bitpacked_input_shape;
+  const TBitpacked* bitpacked_input =
+      GetBitpackedInput(context, input, op_data, &bitpacked_input_shape);
+
+#ifdef LCE_INDIRECT_BGEMM
+  if (IsIndirectBGEMM(kernel_type)) {
+    // The output transform and the packed weights were handed to the kernel
+    // in Prepare. The indirection buffer holds pointers into the bitpacked
+    // input, so it is only filled again when the input has moved.
+    auto* kernel = op_data->indirect_bgemm_kernel;
+    if (bitpacked_input != op_data->indirection_input) {
+      kernel->FillIndirectionBuffer(&op_data->params, bitpacked_input_shape,
+                                    ::tflite::micro::GetTensorShape(output),
+                                    bitpacked_input);
+      op_data->indirection_input = bitpacked_input;
+    }
+#ifdef LCE_INDIRECT_BGEMM_THREADED
+    if (kernel_type == KernelType::kOptimizedIndirectBGEMMThreaded) {
+      // The external context is set once by the application and outlives the
+      // interpreter; without one the kernel runs on the calling thread.
+      BConv2DOptimizedIndirectBGEMM<std::int32_t, DstScalar>(
+          kernel, &op_data->params, bitpacked_input_shape,
+          ::tflite::micro::GetTensorShape(output),
+          ::tflite::micro::GetTensorData<DstScalar>(output),
+          op_data->padding_buffer, op_data->params.pad_value,
+          static_cast<core::ThreadPool*>(
+              GetMicroContext(context)->external_context()));
+      return kTfLiteOk;
+    }
+#endif
+    BConv2DOptimizedIndirectBGEMM<std::int32_t, DstScalar>(
+        kernel, &op_data->params, bitpacked_input_shape,
+        ::tflite::micro::GetTensorShape(output),
+        ::tflite::micro::GetTensorData<DstScalar>(output),
+        op_data->padding_buffer, op_data->params.pad_value);
+    return kTfLiteOk;
   }
-
-  auto* bconv2d_params = &op_data->params;
-
-  const auto* input = GetInput(context, node, 0);
-  const auto* filter = GetInput(context, node, 1);
-  auto* output = GetOutput(context, node, 0);
-
-  TfLiteTensor* im2col =
-      op_data->im2col_index >= 0
-          ? GetTemporary(context, node, op_data->im2col_index)
-          : nullptr;
-
-  // Using the standard TF Lite ConvParams struct. This requires extra step of
-  // converting the BConv2DParams but unifies the interface with the default
-  // TFLite API for Conv2D params which is used in internal TFLite im2col
-  // functions.
-  ConvParams conv2d_params;
-  GetConvParamsType(op_data, conv2d_params);
-  conv2d_params.input_offset = input->params.zero_point;
+#endif
 
   OutputTransform<DstScalar> output_transform;
-  GetOutputTransform(output_transform, context, node, op_data);
-
-  // `BConv2D` wants the *unpacked* output shape.
-  auto unpacked_output_shape = GetTensorShape(output);
-  unpacked_output_shape.SetDim(3, bconv2d_params->channels_out);
+  GetOutputTransform(output_transform, context, node, op_data,
+                     kThresholdsTensor);
 
   // We pass the shape of the original unpacked filter, so that all the shape
   // information is correct (number of channels etc), but we pass the packed
   // weights data.
-  //     Likewise, we pass the original output shape even if we are going to
-  // write bitpacked output directly.
-  BConv2DOptimizedBGEMM<AccumScalar, DstScalar>(
-      conv2d_params, GetTensorShape(input), GetTensorData<TBitpacked>(input),
-      GetTensorShape(filter), GetTensorData<TBitpacked>(filter),
-      output_transform, unpacked_output_shape, GetTensorData<DstScalar>(output),
-      GetTensorShape(im2col), GetTensorData<TBitpacked>(im2col),
-      op_data->padding_buffer.data(), bconv2d_params->pad_value,
-      CpuBackendContext::GetFromContext(context));
-}
-
-template <typename DstScalar>
-void EvalOptIndirectBGEMM(TfLiteContext* context, TfLiteNode* node,
-                          OpData* op_data) {
-  if (!op_data->one_time_setup_complete) {
-    OneTimeSetup(context, node, op_data);
-  }
-
-  auto* bconv2d_params = &op_data->params;
-
-  const auto* input = GetInput(context, node, 0);
-  const auto* filter = GetInput(context, node, 1);
-  auto* output = GetOutput(context, node, 0);
-
-  const auto bitpacked_input_shape = GetTensorShape(input);
-  const auto output_shape = GetTensorShape(output);
-
-  if (!op_data->indirect_bgemm_kernel) {
-    OutputTransform<DstScalar> output_transform;
-    GetOutputTransform(output_transform, context, node, op_data);
-    op_data->indirect_bgemm_kernel =
-        std::move(core::indirect_bgemm::SelectRuntimeKernel(
-            &op_data->params, bitpacked_input_shape, output_shape,
-            output_transform));
-    op_data->indirect_bgemm_kernel->PackWeights(
-        GetTensorData<TBitpacked>(filter));
-    op_data->indirect_bgemm_kernel->FillIndirectionBuffer(
-        &op_data->params, bitpacked_input_shape, output_shape,
-        GetTensorData<TBitpacked>(input));
-  }
-
-  BConv2DOptimizedIndirectBGEMM<DstScalar>(
-      op_data->indirect_bgemm_kernel.get(), bconv2d_params,
-      bitpacked_input_shape, output_shape, GetTensorData<DstScalar>(output),
-      op_data->padding_buffer.data(), bconv2d_params->pad_value);
-}
-
-template <typename DstScalar>
-void EvalRef(TfLiteContext* context, TfLiteNode* node, OpData* op_data) {
-  if (!op_data->one_time_setup_complete) {
-    OneTimeSetup(context, node, op_data);
-  }
-
-  const auto* input = GetInput(context, node, 0);
-  const auto* packed_filter = GetInput(context, node, 1);
-  auto* output = GetOutput(context, node, 0);
-
-  OutputTransform<DstScalar> output_transform;
-  GetOutputTransform(output_transform, context, node, op_data);
-
-  BConv2DReference<std::int32_t, DstScalar>(
-      &op_data->params, GetTensorShape(input), GetTensorData<TBitpacked>(input),
-      GetTensorShape(packed_filter), GetTensorData<TBitpacked>(packed_filter),
-      output_transform, GetTensorShape(output),
-      GetTensorData<DstScalar>(output));
-}
-
-template <KernelType kernel_type, typename DstScalar>
-inline TfLiteStatus EvalChooseKernelType(TfLiteContext* context,
-                                         TfLiteNode* node, OpData* op_data) {
   if (kernel_type == KernelType::kOptimizedBGEMM) {
-#if RUY_PLATFORM_ARM_64
-    // On 64 bit Arm only there is an optimised kernel with 16-bit accumulators.
-    // It is safe to use this without risk of overflow as long as the maximum
-    // value of the convolution (filter height * filter width * input channels,
-    // plus some overhead to account for potential padding) is less than 2^16.
-    // We will almost always take this path: for a 3x3 filter there would need
-    // to be > 7000 input channels to present an overflow risk.
-    const int depth = op_data->params.filter_height *
-                      op_data->params.filter_width *
-                      op_data->params.channels_in;
-    if (depth + 512 < 1 << 16) {
-      EvalOptBGEMM<std::int16_t, DstScalar>(context, node, op_data);
-      return kTfLiteOk;
-    }
-#endif
-    // In all other cases, use 32-bit accumulators.
-    EvalOptBGEMM<std::int32_t, DstScalar>(context, node, op_data);
-    return kTfLiteOk;
-  } else if (kernel_type == KernelType::kOptimizedIndirectBGEMM) {
-    EvalOptIndirectBGEMM<DstScalar>(context, node, op_data);
+    TBitpacked* im2col_data =
+        op_data->im2col_scratch_index >= 0
+            ? static_cast<TBitpacked*>(context->GetScratchBuffer(
+                  context, op_data->im2col_scratch_index))
+            : nullptr;
+    BConv2DPortableBGEMM<DstScalar>(
+        &op_data->params, bitpacked_input_shape, bitpacked_input,
+        ::tflite::micro::GetTensorShape(filter),
+        ::tflite::micro::GetTensorData<TBitpacked>(filter), output_transform,
+        ::tflite::micro::GetTensorShape(output),
+        ::tflite::micro::GetTensorData<DstScalar>(output), im2col_data,
+        op_data->padding_buffer);
     return kTfLiteOk;
   } else if (kernel_type == KernelType::kReference) {
-    EvalRef<DstScalar>(context, node, op_data);
+    BConv2DReference<std::int32_t, DstScalar>(
+        &op_data->params, bitpacked_input_shape, bitpacked_input,
+        ::tflite::micro::GetTensorShape(filter),
+        ::tflite::micro::GetTensorData<TBitpacked>(filter), output_transform,
+        ::tflite::micro::GetTensorShape(output),
+        ::tflite::micro::GetTensorData<DstScalar>(output));
     return kTfLiteOk;
   }
   return kTfLiteError;
 }
 
+TfLiteStatus EvalBMaxPool(TfLiteContext* context, TfLiteNode* node,
+                          const OpData* op_data) {
+  const TfLiteEvalTensor* input =
+      ::tflite::micro::GetEvalInput(context, node, kInputTensor);
+  const TfLiteEvalTensor* filter =
+      ::tflite::micro::GetEvalInput(context, node, kFilterTensor);
+  TfLiteEvalTensor* output =
+      ::tflite::micro::GetEvalOutput(context, node, kOutputTensor);
+
+  RuntimeShape bitpacked_input_shape;
+  const TBitpacked* bitpacked_input =
+      GetBitpackedInput(context, input, op_data, &bitpacked_input_shape);
+
+  OutputTransform<TBitpacked> output_transform;
+  GetOutputTransform(output_transform, context, node, op_data,
+                     kThresholdsTensor);
+
+  TBitpacked* im2col_data =
+      op_data->im2col_scratch_index >= 0
+          ? static_cast<TBitpacked*>(context->GetScratchBuffer(
+                context, op_data->im2col_scratch_index))
+          : nullptr;
+  TBitpacked* conv_rows_data = static_cast<TBitpacked*>(
+      context->GetScratchBuffer(context, op_data->conv_rows_scratch_index));
+  BConv2DBMaxPoolPortableBGEMM(
+      &op_data->params, op_data->pool_params, bitpacked_input_shape,
+      bitpacked_input, ::tflite::micro::GetTensorShape(filter),
+      ::tflite::micro::GetTensorData<TBitpacked>(filter), output_transform,
+      op_data->conv_output_height, op_data->conv_output_width,
+      ::tflite::micro::GetTensorShape(output),
+      ::tflite::micro::GetTensorData<TBitpacked>(output), im2col_data,
+      conv_rows_data);
+  return kTfLiteOk;
+}
+
 template <KernelType kernel_type>
 TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
-  const TfLiteType output_type = GetOutput(context, node, 0)->type;
-  auto* op_data = reinterpret_cast<OpData*>(node->user_data);
+  TFLITE_DCHECK(node->user_data != nullptr);
+  auto* op_data = static_cast<OpData*>(node->user_data);
+  if (op_data->fused_bmaxpool) {
+    return EvalBMaxPool(context, node, op_data);
+  }
+  const TfLiteType output_type =
+      ::tflite::micro::GetEvalOutput(context, node, kOutputTensor)->type;
   if (output_type == kTfLiteFloat32) {
     return EvalChooseKernelType<kernel_type, float>(context, node, op_data);
   } else if (output_type == kTfLiteInt8) {
@@ -567,36 +733,50 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
 }  // namespace bconv2d
 
 TfLiteRegistration* Register_BCONV_2D_REF() {
-  static TfLiteRegistration r = {
-      bconv2d::Init, bconv2d::Free,
-      bconv2d::Prepare<bconv2d::KernelType::kReference>,
-      bconv2d::Eval<bconv2d::KernelType::kReference>};
+  static TfLiteRegistration r = ::tflite::micro::RegisterOp(
+      bconv2d::Init, bconv2d::Prepare<bconv2d::KernelType::kReference>,
+      bconv2d::Eval<bconv2d::KernelType::kReference>);
   return &r;
 }
 
 TfLiteRegistration* Register_BCONV_2D_OPT_BGEMM() {
-  static TfLiteRegistration r = {
-      bconv2d::Init, bconv2d::Free,
+  static TfLiteRegistration r = ::tflite::micro::RegisterOp(
+      bconv2d::Init, bconv2d::Prepare<bconv2d::KernelType::kOptimizedBGEMM>,
+      bconv2d::Eval<bconv2d::KernelType::kOptimizedBGEMM>);
+  return &r;
+}
+
+TfLiteRegistration* Register_BCONV_2D_BMAXPOOL_2D() {
+  static TfLiteRegistration r = ::tflite::micro::RegisterOp(
+      bconv2d::InitBMaxPool,
       bconv2d::Prepare<bconv2d::KernelType::kOptimizedBGEMM>,
-      bconv2d::Eval<bconv2d::KernelType::kOptimizedBGEMM>};
+      bconv2d::Eval<bconv2d::KernelType::kOptimizedBGEMM>);
   return &r;
 }
 
+#ifdef LCE_INDIRECT_BGEMM
 TfLiteRegistration* Register_BCONV_2D_OPT_INDIRECT_BGEMM() {
-  static TfLiteRegistration r = {
-      bconv2d::Init, bconv2d::Free,
+  static TfLiteRegistration r = ::tflite::micro::RegisterOp(
+      bconv2d::Init,
       bconv2d::Prepare<bconv2d::KernelType::kOptimizedIndirectBGEMM>,
-      bconv2d::Eval<bconv2d::KernelType::kOptimizedIndirectBGEMM>};
+      bconv2d::Eval<bconv2d::KernelType::kOptimizedIndirectBGEMM>);
+  return &r;
+}
+#endif
+
+#ifdef LCE_INDIRECT_BGEMM_THREADED
+TfLiteRegistration* Register_BCONV_2D_OPT_INDIRECT_BGEMM_THREADED() {
+  static TfLiteRegistration r = ::tflite::micro::RegisterOp(
+      bconv2d::Init,
+      bconv2d::Prepare<bconv2d::KernelType::kOptimizedIndirectBGEMMThreaded>,
+      bconv2d::Eval<bconv2d::KernelType::kOptimizedIndirectBGEMMThreaded>);
   return &r;
 }
+#endif
 
 // Use this registration wrapper to decide which implementation to use.
 TfLiteRegistration* Register_BCONV_2D() {
-#if defined TFLITE_WITH_RUY
   return Register_BCONV_2D_OPT_BGEMM();
-#else
-  return Register_BCONV_2D_REF();
-#endif
 }
 
 }  // namespace tflite
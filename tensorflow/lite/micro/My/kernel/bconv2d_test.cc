@@ -0,0 +1,361 @@
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "flatbuffers/flexbuffers.h"
+#include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/kernels/internal/types.h"
+#include "tensorflow/lite/kernels/padding.h"
+#include "tensorflow/lite/micro/My/core/bmaxpool.h"
+#include "tensorflow/lite/micro/My/kernel/lce_ops_register.h"
+#include "tensorflow/lite/micro/kernels/kernel_runner.h"
+#include "tensorflow/lite/micro/test_helpers.h"
+#include "tensorflow/lite/micro/testing/micro_test.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+
+#ifdef LCE_INDIRECT_BGEMM_THREADED
+#include "tensorflow/lite/micro/My/core/thread_pool.h"
+#endif
+
+namespace tflite {
+namespace testing {
+namespace {
+
+using compute_engine::tflite::Register_BCONV_2D_BMAXPOOL_2D;
+using compute_engine::tflite::Register_BCONV_2D_REF;
+
+// A 3x3 convolution of a bitpacked 1x5x5x64 input to 8 channels, which keeps
+// the persistent allocations within the KernelRunner arena.
+constexpr int kInputSize = 5;
+constexpr int kChannelsIn = 64;
+constexpr int kInputDepth = kChannelsIn / 32;
+constexpr int kFilterSize = 3;
+constexpr int kChannelsOut = 8;
+constexpr int kMaxOutputSize = kInputSize * kInputSize * kChannelsOut;
+
+struct ConvOptions {
+  int stride;
+  Padding padding;
+  int pad_value;
+};
+
+// The options of the binary max-pool fused into LceBconv2dBMaxPool2d.
+struct PoolOptions {
+  int filter_height;
+  int filter_width;
+  int stride_height;
+  int stride_width;
+  Padding padding;
+};
+
+// Builds the custom options of LceBconv2d, or of LceBconv2dBMaxPool2d when
+// `pool_options` is set.
+std::vector<std::uint8_t> BuildOptions(
+    const ConvOptions& conv_options,
+    const PoolOptions* pool_options = nullptr) {
+  flexbuffers::Builder fbb;
+  fbb.Map([&]() {
+    fbb.Int("stride_height", conv_options.stride);
+    fbb.Int("stride_width", conv_options.stride);
+    fbb.Int("dilation_height_factor", 1);
+    fbb.Int("dilation_width_factor", 1);
+    fbb.Int("padding", conv_options.padding);
+    fbb.Int("pad_values", conv_options.pad_value);
+    fbb.Int("channels_in", kChannelsIn);
+    fbb.Int("fused_activation_function", ActivationFunctionType_NONE);
+    if (pool_options != nullptr) {
+      fbb.Int("pool_filter_height", pool_options->filter_height);
+      fbb.Int("pool_filter_width", pool_options->filter_width);
+      fbb.Int("pool_stride_height", pool_options->stride_height);
+      fbb.Int("pool_stride_width", pool_options->stride_width);
+      fbb.Int("pool_padding", pool_options->padding);
+    }
+  });
+  fbb.Finish();
+  return fbb.GetBuffer();
+}
+
+int GetOutputSize(const ConvOptions& conv_options) {
+  if (conv_options.padding == Padding_SAME) {
+    return (kInputSize + conv_options.stride - 1) / conv_options.stride;
+  }
+  return (kInputSize - kFilterSize + conv_options.stride) /
+         conv_options.stride;
+}
+
+// Sets up the op `registration` with `options` on the inputs below and an
+// output of `output_height` x `output_width` pixels, and returns the status of
+// Init and Prepare. If they succeed, the op is invoked and writes its output
+// to `output_data`. The op gets `external_context` if it is set.
+template <typename T>
+TfLiteStatus RunBConv2D(const TfLiteRegistration* registration,
+                        const std::vector<std::uint8_t>& options,
+                        const int output_height, const int output_width,
+                        T* output_data, void* external_context = nullptr) {
+  static std::int32_t input_data[kInputSize * kInputSize * kInputDepth];
+  static std::int32_t filter_data[kChannelsOut * kFilterSize * kFilterSize *
+                                  kInputDepth];
+  static float multiplier_data[kChannelsOut];
+  static float bias_data[kChannelsOut];
+  static std::int32_t thresholds_data[kChannelsOut];
+  std::uint32_t bits = 1234;
+  for (auto& x : input_data) x = bits = bits * 1664525u + 1013904223u;
+  for (auto& x : filter_data) x = bits = bits * 1664525u + 1013904223u;
+  for (int i = 0; i < kChannelsOut; ++i) {
+    multiplier_data[i] = 0.5f - 0.125f * i;
+    bias_data[i] = 0.25f * i - 1.0f;
+    // Close to half the receptive field, so that the output bits are mixed.
+    thresholds_data[i] = kFilterSize * kFilterSize * kChannelsIn / 2 - 4 + i;
+  }
+
+  const int output_depth = std::is_same<T, std::int32_t>::value
+                               ? (kChannelsOut + 31) / 32
+                               : kChannelsOut;
+  int input_dims[] = {4, 1, kInputSize, kInputSize, kInputDepth};
+  int filter_dims[] = {4, kChannelsOut, kFilterSize, kFilterSize, kInputDepth};
+  int channels_out_dims[] = {1, kChannelsOut};
+  int output_dims[] = {4, 1, output_height, output_width, output_depth};
+
+  constexpr int kTensorsSize = 6;
+  TfLiteTensor tensors[kTensorsSize] = {
+      CreateTensor(input_data, IntArrayFromInts(input_dims)),
+      CreateTensor(filter_data, IntArrayFromInts(filter_dims)),
+      CreateTensor(multiplier_data, IntArrayFromInts(channels_out_dims)),
+      CreateTensor(bias_data, IntArrayFromInts(channels_out_dims)),
+      CreateTensor(thresholds_data, IntArrayFromInts(channels_out_dims)),
+      CreateQuantizedTensor(output_data, IntArrayFromInts(output_dims),
+                            /*scale=*/0.25f, /*zero_point=*/-3),
+  };
+  for (int i = 1; i < 5; ++i) {
+    tensors[i].allocation_type = kTfLiteMmapRo;
+  }
+
+  int inputs_array_data[] = {5, 0, 1, 2, 3, 4};
+  int outputs_array_data[] = {1, 5};
+  micro::KernelRunner runner(*registration, tensors, kTensorsSize,
+                             IntArrayFromInts(inputs_array_data),
+                             IntArrayFromInts(outputs_array_data),
+                             /*builtin_data=*/nullptr);
+  if (external_context != nullptr) {
+    TF_LITE_MICRO_EXPECT_EQ(
+        kTfLiteOk,
+        runner.GetFakeMicroContext()->set_external_context(external_context));
+  }
+  TF_LITE_ENSURE_STATUS(runner.InitAndPrepare(
+      reinterpret_cast<const char*>(options.data()), options.size()));
+  TF_LITE_MICRO_EXPECT_EQ(kTfLiteOk, runner.Invoke());
+  // A second Invoke reuses the state that was set up by the first one.
+  TF_LITE_MICRO_EXPECT_EQ(kTfLiteOk, runner.Invoke());
+  return kTfLiteOk;
+}
+
+// Checks the BCONV_2D op `registration` against the reference kernel.
+template <typename T>
+void TestAgainstReference(const TfLiteRegistration* registration,
+                          const ConvOptions& conv_options,
+                          void* external_context = nullptr) {
+  const std::vector<std::uint8_t> options = BuildOptions(conv_options);
+  const int output_size = GetOutputSize(conv_options);
+  T expected[kMaxOutputSize] = {};
+  T actual[kMaxOutputSize] = {};
+  TF_LITE_MICRO_EXPECT_EQ(
+      kTfLiteOk, RunBConv2D(Register_BCONV_2D_REF(), options, output_size,
+                            output_size, expected));
+  TF_LITE_MICRO_EXPECT_EQ(
+      kTfLiteOk, RunBConv2D(registration, options, output_size, output_size,
+                            actual, external_context));
+  for (int i = 0; i < kMaxOutputSize; ++i) {
+    if (std::is_same<T, float>::value) {
+      // The zero-padding correction is applied in float.
+      TF_LITE_MICRO_EXPECT_NEAR(expected[i], actual[i], 1e-3f);
+    } else {
+      TF_LITE_MICRO_EXPECT_EQ(expected[i], actual[i]);
+    }
+  }
+}
+
+// Checks LceBconv2dBMaxPool2d against the reference convolution with
+// bitpacked output followed by a binary max-pool.
+void TestBConv2DBMaxPool(const ConvOptions& conv_options,
+                         const PoolOptions& pool_options) {
+  const int conv_size = GetOutputSize(conv_options);
+  std::int32_t conv_output[kMaxOutputSize] = {};
+  TF_LITE_MICRO_EXPECT_EQ(
+      kTfLiteOk, RunBConv2D(Register_BCONV_2D_REF(), BuildOptions(conv_options),
+                            conv_size, conv_size, conv_output));
+
+  compute_engine::core::BMaxPoolParams pool_params;
+  pool_params.filter_height = pool_options.filter_height;
+  pool_params.filter_width = pool_options.filter_width;
+  pool_params.stride_height = pool_options.stride_height;
+  pool_params.stride_width = pool_options.stride_width;
+  pool_params.padding_type = pool_options.padding == Padding_SAME
+                                 ? kTfLitePaddingSame
+                                 : kTfLitePaddingValid;
+  int pooled_height, pooled_width;
+  pool_params.padding = ComputePaddingHeightWidth(
+      pool_params.stride_height, pool_params.stride_width, 1, 1, conv_size,
+      conv_size, pool_params.filter_height, pool_params.filter_width,
+      pool_params.padding_type, &pooled_height, &pooled_width);
+  const std::int32_t conv_dims[] = {1, conv_size, conv_size, 1};
+  const std::int32_t pooled_dims[] = {1, pooled_height, pooled_width, 1};
+  std::int32_t expected[kMaxOutputSize] = {};
+  compute_engine::core::BMaxPool(pool_params, RuntimeShape(4, conv_dims),
+                                 conv_output, RuntimeShape(4, pooled_dims),
+                                 expected);
+
+  std::int32_t actual[kMaxOutputSize] = {};
+  TF_LITE_MICRO_EXPECT_EQ(
+      kTfLiteOk,
+      RunBConv2D(Register_BCONV_2D_BMAXPOOL_2D(),
+                 BuildOptions(conv_options, &pool_options), pooled_height,
+                 pooled_width, actual));
+  for (int i = 0; i < kMaxOutputSize; ++i) {
+    TF_LITE_MICRO_EXPECT_EQ(expected[i], actual[i]);
+  }
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace tflite
+
+TF_LITE_MICRO_TESTS_BEGIN
+
+TF_LITE_MICRO_TEST(OptimizedBGEMM) {
+  using compute_engine::tflite::Register_BCONV_2D_OPT_BGEMM;
+  using tflite::testing::ConvOptions;
+  using tflite::testing::TestAgainstReference;
+  TestAgainstReference<float>(Register_BCONV_2D_OPT_BGEMM(),
+                              ConvOptions{1, tflite::Padding_SAME, 1});
+  TestAgainstReference<float>(Register_BCONV_2D_OPT_BGEMM(),
+                              ConvOptions{2, tflite::Padding_SAME, 0});
+  TestAgainstReference<std::int8_t>(Register_BCONV_2D_OPT_BGEMM(),
+                                    ConvOptions{2, tflite::Padding_VALID, 1});
+  TestAgainstReference<std::int32_t>(Register_BCONV_2D_OPT_BGEMM(),
+                                     ConvOptions{1, tflite::Padding_SAME, 1});
+}
+
+TF_LITE_MICRO_TEST(BConv2DBMaxPool) {
+  using tflite::testing::ConvOptions;
+  using tflite::testing::PoolOptions;
+  using tflite::testing::TestBConv2DBMaxPool;
+  // A non-square pool window and strides, so that every pool_* option has to
+  // be read into the right field.
+  TestBConv2DBMaxPool(ConvOptions{1, tflite::Padding_SAME, 1},
+                      PoolOptions{3, 2, 2, 1, tflite::Padding_VALID});
+  TestBConv2DBMaxPool(ConvOptions{1, tflite::Padding_VALID, 1},
+                      PoolOptions{2, 2, 2, 2, tflite::Padding_SAME});
+  TestBConv2DBMaxPool(ConvOptions{2, tflite::Padding_SAME, 1},
+                      PoolOptions{2, 3, 1, 2, tflite::Padding_SAME});
+}
+
+TF_LITE_MICRO_TEST(BConv2DBMaxPoolNeedsPoolOptions) {
+  using tflite::testing::ConvOptions;
+  // Without the pool_* options Init fails, and Prepare reports it.
+  const std::vector<std::uint8_t> options =
+      tflite::testing::BuildOptions(ConvOptions{1, tflite::Padding_SAME, 1});
+  std::int32_t output[tflite::testing::kMaxOutputSize];
+  TF_LITE_MICRO_EXPECT_EQ(
+      kTfLiteError, tflite::testing::RunBConv2D(
+                        tflite::testing::Register_BCONV_2D_BMAXPOOL_2D(),
+                        options, 2, 4, output));
+}
+
+TF_LITE_MICRO_TEST(BConv2DBMaxPoolChecksPooledShape) {
+  using tflite::testing::ConvOptions;
+  using tflite::testing::PoolOptions;
+  const ConvOptions conv_options{1, tflite::Padding_SAME, 1};
+  const PoolOptions pool_options{3, 2, 2, 1, tflite::Padding_VALID};
+  const std::vector<std::uint8_t> options =
+      tflite::testing::BuildOptions(conv_options, &pool_options);
+  std::int32_t output[tflite::testing::kMaxOutputSize];
+  // The 5x5 convolution output is pooled to 2x4.
+  TF_LITE_MICRO_EXPECT_EQ(
+      kTfLiteOk, tflite::testing::RunBConv2D(
+                     tflite::testing::Register_BCONV_2D_BMAXPOOL_2D(), options,
+                     2, 4, output));
+  // The unpooled shape, or a transposed one, is rejected.
+  TF_LITE_MICRO_EXPECT_EQ(
+      kTfLiteError, tflite::testing::RunBConv2D(
+                        tflite::testing::Register_BCONV_2D_BMAXPOOL_2D(),
+                        options, 5, 5, output));
+  TF_LITE_MICRO_EXPECT_EQ(
+      kTfLiteError, tflite::testing::RunBConv2D(
+                        tflite::testing::Register_BCONV_2D_BMAXPOOL_2D(),
+                        options, 4, 2, output));
+}
+
+TF_LITE_MICRO_TEST(BConv2DBMaxPoolNeedsBitpackedOutput) {
+  using tflite::testing::ConvOptions;
+  using tflite::testing::PoolOptions;
+  const ConvOptions conv_options{1, tflite::Padding_SAME, 1};
+  const PoolOptions pool_options{3, 2, 2, 1, tflite::Padding_VALID};
+  const std::vector<std::uint8_t> options =
+      tflite::testing::BuildOptions(conv_options, &pool_options);
+  float float_output[tflite::testing::kMaxOutputSize];
+  TF_LITE_MICRO_EXPECT_EQ(
+      kTfLiteError, tflite::testing::RunBConv2D(
+                        tflite::testing::Register_BCONV_2D_BMAXPOOL_2D(),
+                        options, 2, 4, float_output));
+  std::int8_t int8_output[tflite::testing::kMaxOutputSize];
+  TF_LITE_MICRO_EXPECT_EQ(
+      kTfLiteError, tflite::testing::RunBConv2D(
+                        tflite::testing::Register_BCONV_2D_BMAXPOOL_2D(),
+                        options, 2, 4, int8_output));
+}
+
+#ifdef LCE_INDIRECT_BGEMM
+TF_LITE_MICRO_TEST(IndirectBGEMMFloatOutput) {
+  using compute_engine::tflite::Register_BCONV_2D_OPT_INDIRECT_BGEMM;
+  using tflite::testing::ConvOptions;
+  using tflite::testing::TestAgainstReference;
+  TestAgainstReference<float>(Register_BCONV_2D_OPT_INDIRECT_BGEMM(),
+                              ConvOptions{1, tflite::Padding_SAME, 1});
+  TestAgainstReference<float>(Register_BCONV_2D_OPT_INDIRECT_BGEMM(),
+                              ConvOptions{2, tflite::Padding_VALID, 1});
+  TestAgainstReference<float>(Register_BCONV_2D_OPT_INDIRECT_BGEMM(),
+                              ConvOptions{1, tflite::Padding_SAME, 0});
+  TestAgainstReference<float>(Register_BCONV_2D_OPT_INDIRECT_BGEMM(),
+                              ConvOptions{2, tflite::Padding_SAME, 0});
+}
+
+TF_LITE_MICRO_TEST(IndirectBGEMMInt8Output) {
+  using compute_engine::tflite::Register_BCONV_2D_OPT_INDIRECT_BGEMM;
+  using tflite::testing::ConvOptions;
+  using tflite::testing::TestAgainstReference;
+  TestAgainstReference<std::int8_t>(Register_BCONV_2D_OPT_INDIRECT_BGEMM(),
+                                    ConvOptions{1, tflite::Padding_SAME, 1});
+  TestAgainstReference<std::int8_t>(Register_BCONV_2D_OPT_INDIRECT_BGEMM(),
+                                    ConvOptions{2, tflite::Padding_VALID, 1});
+}
+
+TF_LITE_MICRO_TEST(IndirectBGEMMBitpackedOutput) {
+  using compute_engine::tflite::Register_BCONV_2D_OPT_INDIRECT_BGEMM;
+  using tflite::testing::ConvOptions;
+  using tflite::testing::TestAgainstReference;
+  TestAgainstReference<std::int32_t>(Register_BCONV_2D_OPT_INDIRECT_BGEMM(),
+                                     ConvOptions{1, tflite::Padding_SAME, 1});
+  TestAgainstReference<std::int32_t>(Register_BCONV_2D_OPT_INDIRECT_BGEMM(),
+                                     ConvOptions{2, tflite::Padding_VALID, 1});
+}
+#endif
+
+#ifdef LCE_INDIRECT_BGEMM_THREADED
+TF_LITE_MICRO_TEST(IndirectBGEMMThreaded) {
+  using compute_engine::tflite::Register_BCONV_2D_OPT_INDIRECT_BGEMM_THREADED;
+  using tflite::testing::ConvOptions;
+  using tflite::testing::TestAgainstReference;
+  compute_engine::core::ThreadPool thread_pool(3);
+  TestAgainstReference<float>(Register_BCONV_2D_OPT_INDIRECT_BGEMM_THREADED(),
+                              ConvOptions{1, tflite::Padding_SAME, 0},
+                              &thread_pool);
+  TestAgainstReference<std::int32_t>(
+      Register_BCONV_2D_OPT_INDIRECT_BGEMM_THREADED(),
+      ConvOptions{1, tflite::Padding_SAME, 1}, &thread_pool);
+  // Without an external context the op runs on the calling thread.
+  TestAgainstReference<float>(Register_BCONV_2D_OPT_INDIRECT_BGEMM_THREADED(),
+                              ConvOptions{2, tflite::Padding_SAME, 0});
+}
+#endif
+
+TF_LITE_MICRO_TESTS_END
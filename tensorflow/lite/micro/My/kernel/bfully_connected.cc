@@ -0,0 +1,282 @@
+#include <algorithm>
+#include <cstdint>
+
+#include "flatbuffers/flexbuffers.h"
+#include "tensorflow/lite/micro/My/core/bconv2d/output_transform.h"
+#include "tensorflow/lite/micro/My/core/bconv2d/portable_bgemm.h"
+#include "tensorflow/lite/micro/My/core/bitpacking/utils.h"
+#include "tensorflow/lite/micro/My/core/types.h"
+#include "tensorflow/lite/micro/My/kernel/lce_ops_register.h"
+#include "tensorflow/lite/micro/My/kernel/utils.h"
+#include "tensorflow/lite/c/builtin_op_data.h"
+#include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/kernels/internal/tensor_ctypes.h"
+#include "tensorflow/lite/kernels/kernel_util.h"
+#include "tensorflow/lite/micro/kernels/kernel_util.h"
+
+using namespace tflite;
+
+namespace compute_engine {
+namespace tflite {
+namespace bfully_connected {
+
+using core::TBitpacked;
+using namespace core::bconv2d;
+using namespace core::bitpacking;
+
+// The inputs are the same as those of LceBconv2d: the filter is a bitpacked
+// [channels_out, GetBitpackedSize(channels_in)] matrix, and either the
+// multiplier and bias (for float or int8 output) or the thresholds (for
+// bitpacked output) are used to transform the accumulators.
+constexpr int kInputTensor = 0;
+constexpr int kFilterTensor = 1;
+constexpr int kPostActivationMultiplierTensor = 2;
+constexpr int kPostActivationBiasTensor = 3;
+constexpr int kThresholdsTensor = 4;
+constexpr int kOutputTensor = 0;
+
+// Like for LceBconv2d, all of the state lives in the persistent arena and the
+// bitpacked copy of an int8 or float input is a scratch buffer.
+struct OpData {
+  // The number of unpacked input features, from the "channels_in" attribute.
+  std::int32_t channels_in;
+  std::int32_t channels_out;
+
+  TfLiteFusedActivation fused_activation_function;
+
+  // Computed output transform values, used for float/int8 output.
+  std::int32_t output_transform_clamp_min;
+  std::int32_t output_transform_clamp_max;
+  float* output_transform_multiplier;
+  float* output_transform_bias;
+
+  // Zero point used to bitpack an int8 input.
+  std::int32_t input_zero_point;
+
+  // Index of the scratch buffer that holds the bitpacked input, or -1 if the
+  // input is already bitpacked.
+  int bitpacked_input_scratch_index;
+
+  bool successfully_initialized;
+};
+
+void* Init(TfLiteContext* context, const char* buffer, std::size_t length) {
+  TFLITE_DCHECK(context->AllocatePersistentBuffer != nullptr);
+  auto* op_data = static_cast<OpData*>(
+      context->AllocatePersistentBuffer(context, sizeof(OpData)));
+  if (op_data == nullptr) {
+    return nullptr;
+  }
+  op_data->channels_in = 0;
+  op_data->channels_out = 0;
+  op_data->output_transform_multiplier = nullptr;
+  op_data->output_transform_bias = nullptr;
+  op_data->input_zero_point = 0;
+  op_data->bitpacked_input_scratch_index = -1;
+  op_data->successfully_initialized = false;
+
+  const std::uint8_t* buffer_t = reinterpret_cast<const std::uint8_t*>(buffer);
+  const flexbuffers::Map& m = flexbuffers::GetRoot(buffer_t, length).AsMap();
+
+  if (m["channels_in"].IsNull() || m["fused_activation_function"].IsNull()) {
+    TF_LITE_KERNEL_LOG(context,
+                       "Attributes channels_in and fused_activation_function "
+                       "are required.");
+    return op_data;
+  }
+
+  // As for LceBconv2d, the bitpacked input and filter do not tell us the
+  // 'true' number of input features, so it is an explicit attribute.
+  op_data->channels_in = m["channels_in"].AsInt32();
+  op_data->fused_activation_function = ConvertActivation(
+      (ActivationFunctionType)m["fused_activation_function"].AsInt32());
+
+  op_data->successfully_initialized = true;
+  return op_data;
+}
+
+TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
+  TFLITE_DCHECK(node->user_data != nullptr);
+  auto* op_data = static_cast<OpData*>(node->user_data);
+
+  // If an error happened in Init, then return an error code.
+  if (!op_data->successfully_initialized) return kTfLiteError;
+
+  TF_LITE_ENSURE_EQ(context, NumInputs(node), 5);
+  TF_LITE_ENSURE_EQ(context, NumOutputs(node), 1);
+
+  MicroContext* micro_context = GetMicroContext(context);
+  TfLiteTensor* input =
+      micro_context->AllocateTempInputTensor(node, kInputTensor);
+  TF_LITE_ENSURE(context, input != nullptr);
+  TfLiteTensor* filter =
+      micro_context->AllocateTempInputTensor(node, kFilterTensor);
+  TF_LITE_ENSURE(context, filter != nullptr);
+  TfLiteTensor* post_activation_multiplier =
+      micro_context->AllocateTempInputTensor(node,
+                                             kPostActivationMultiplierTensor);
+  TF_LITE_ENSURE(context, post_activation_multiplier != nullptr);
+  TfLiteTensor* post_activation_bias =
+      micro_context->AllocateTempInputTensor(node, kPostActivationBiasTensor);
+  TF_LITE_ENSURE(context, post_activation_bias != nullptr);
+  TfLiteTensor* thresholds =
+      micro_context->AllocateTempInputTensor(node, kThresholdsTensor);
+  TF_LITE_ENSURE(context, thresholds != nullptr);
+  TfLiteTensor* output =
+      micro_context->AllocateTempOutputTensor(node, kOutputTensor);
+  TF_LITE_ENSURE(context, output != nullptr);
+
+  TF_LITE_ENSURE(context, NumDimensions(input) >= 1);
+  TF_LITE_ENSURE_EQ(context, NumDimensions(filter), 2);
+  TF_LITE_ENSURE_MSG(context,
+                     input->type == kTfLiteInt32 ||
+                         input->type == kTfLiteInt8 ||
+                         input->type == kTfLiteFloat32,
+                     "Supported input types are int8, int32, and float32.");
+  TF_LITE_ENSURE_EQ(context, filter->type, kTfLiteInt32);
+  TF_LITE_ENSURE_MSG(context,
+                     output->type == kTfLiteInt32 ||
+                         output->type == kTfLiteInt8 ||
+                         output->type == kTfLiteFloat32,
+                     "Supported output types are int8, int32, and float32.");
+
+  // The input is a batch of vectors along its last dimension, which is
+  // already bitpacked for an int32 input.
+  const int input_depth = SizeOfDimension(input, NumDimensions(input) - 1);
+  if (input->type == kTfLiteInt32) {
+    TF_LITE_ENSURE_EQ(context, input_depth,
+                      GetBitpackedSize(op_data->channels_in));
+  } else {
+    TF_LITE_ENSURE_EQ(context, input_depth, op_data->channels_in);
+  }
+  op_data->input_zero_point =
+      input->type == kTfLiteInt8 ? input->params.zero_point : 0;
+  const int batches = NumElements(input) / input_depth;
+
+  op_data->channels_out = SizeOfDimension(filter, 0);
+  TF_LITE_ENSURE_EQ(context, SizeOfDimension(filter, 1),
+                    GetBitpackedSize(op_data->channels_in));
+
+  // The output shape is fixed by the model, so it is only checked here.
+  const int output_depth = output->type == kTfLiteInt32
+                               ? GetBitpackedSize(op_data->channels_out)
+                               : op_data->channels_out;
+  TF_LITE_ENSURE_EQ(context, SizeOfDimension(output, NumDimensions(output) - 1),
+                    output_depth);
+  TF_LITE_ENSURE_EQ(context, NumElements(output), batches * output_depth);
+
+  if (output->type == kTfLiteInt32) {
+    TF_LITE_ENSURE_EQ(context, NumDimensions(thresholds), 1);
+    TF_LITE_ENSURE_EQ(context, thresholds->type, kTfLiteInt32);
+    TF_LITE_ENSURE_EQ(context, SizeOfDimension(thresholds, 0),
+                      op_data->channels_out);
+  } else {
+    TF_LITE_ENSURE_EQ(context, post_activation_multiplier->type,
+                      kTfLiteFloat32);
+    TF_LITE_ENSURE_EQ(context, post_activation_bias->type, kTfLiteFloat32);
+    TF_LITE_ENSURE_EQ(context, NumDimensions(post_activation_multiplier), 1);
+    TF_LITE_ENSURE_EQ(context, NumDimensions(post_activation_bias), 1);
+    TF_LITE_ENSURE_EQ(context, SizeOfDimension(post_activation_multiplier, 0),
+                      op_data->channels_out);
+    TF_LITE_ENSURE_EQ(context, SizeOfDimension(post_activation_bias, 0),
+                      op_data->channels_out);
+    // The dot product over the unpacked input features is
+    // channels_in - 2 * accumulator.
+    TF_LITE_ENSURE_STATUS(CalculateOutputTransform(
+        context, post_activation_multiplier, post_activation_bias, output,
+        op_data->channels_out, op_data->channels_in, op_data));
+  }
+
+  if (output->type == kTfLiteInt8) {
+    TF_LITE_ENSURE_EQ(context, output->quantization.type,
+                      kTfLiteAffineQuantization);
+  }
+
+  if (input->type != kTfLiteInt32) {
+    TF_LITE_ENSURE_STATUS(context->RequestScratchBufferInArena(
+        context,
+        GetBitpackedMatrixSize(batches, op_data->channels_in) *
+            sizeof(TBitpacked),
+        &op_data->bitpacked_input_scratch_index));
+  } else {
+    op_data->bitpacked_input_scratch_index = -1;
+  }
+
+  micro_context->DeallocateTempTfLiteTensor(input);
+  micro_context->DeallocateTempTfLiteTensor(filter);
+  micro_context->DeallocateTempTfLiteTensor(post_activation_multiplier);
+  micro_context->DeallocateTempTfLiteTensor(post_activation_bias);
+  micro_context->DeallocateTempTfLiteTensor(thresholds);
+  micro_context->DeallocateTempTfLiteTensor(output);
+  return kTfLiteOk;
+}
+
+template <typename DstScalar>
+TfLiteStatus EvalChooseOutputType(TfLiteContext* context, TfLiteNode* node,
+                                  const OpData* op_data) {
+  const TfLiteEvalTensor* input =
+      ::tflite::micro::GetEvalInput(context, node, kInputTensor);
+  const TfLiteEvalTensor* filter =
+      ::tflite::micro::GetEvalInput(context, node, kFilterTensor);
+  TfLiteEvalTensor* output =
+      ::tflite::micro::GetEvalOutput(context, node, kOutputTensor);
+
+  const RuntimeShape input_shape = ::tflite::micro::GetTensorShape(input);
+  const int input_dims = input_shape.DimensionsCount();
+  const int batches = FlatSizeSkipDim(input_shape, input_dims - 1);
+  const int depth = GetBitpackedSize(op_data->channels_in);
+
+  const TBitpacked* bitpacked_input;
+  if (op_data->bitpacked_input_scratch_index < 0) {
+    bitpacked_input = ::tflite::micro::GetTensorData<TBitpacked>(input);
+  } else {
+    TBitpacked* scratch = static_cast<TBitpacked*>(context->GetScratchBuffer(
+        context, op_data->bitpacked_input_scratch_index));
+    if (input->type == kTfLiteInt8) {
+      bitpack_tensor(input_shape,
+                     ::tflite::micro::GetTensorData<std::int8_t>(input),
+                     op_data->input_zero_point, scratch);
+    } else {
+      bitpack_tensor(input_shape, ::tflite::micro::GetTensorData<float>(input),
+                     0, scratch);
+    }
+    bitpacked_input = scratch;
+  }
+
+  OutputTransform<DstScalar> output_transform;
+  GetOutputTransform(output_transform, context, node, op_data,
+                     kThresholdsTensor);
+
+  // Every batch is a 'pixel' of a 1x1 binary convolution.
+  BGemmRow(::tflite::micro::GetTensorData<TBitpacked>(filter),
+           op_data->channels_out, depth, bitpacked_input, batches,
+           output_transform, ::tflite::micro::GetTensorData<DstScalar>(output));
+  return kTfLiteOk;
+}
+
+TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
+  TFLITE_DCHECK(node->user_data != nullptr);
+  const auto* op_data = static_cast<const OpData*>(node->user_data);
+  const TfLiteType output_type =
+      ::tflite::micro::GetEvalOutput(context, node, kOutputTensor)->type;
+  if (output_type == kTfLiteFloat32) {
+    return EvalChooseOutputType<float>(context, node, op_data);
+  } else if (output_type == kTfLiteInt8) {
+    return EvalChooseOutputType<std::int8_t>(context, node, op_data);
+  } else if (output_type == kTfLiteInt32) {
+    return EvalChooseOutputType<TBitpacked>(context, node, op_data);
+  }
+  return kTfLiteError;
+}
+
+}  // namespace bfully_connected
+
+TfLiteRegistration* Register_BFULLY_CONNECTED() {
+  static TfLiteRegistration r = ::tflite::micro::RegisterOp(
+      bfully_connected::Init, bfully_connected::Prepare,
+      bfully_connected::Eval);
+  return &r;
+}
+
+}  // namespace tflite
+}  // namespace compute_engine
@@ -0,0 +1,208 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "flatbuffers/flexbuffers.h"
+#include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/micro/My/kernel/lce_ops_register.h"
+#include "tensorflow/lite/micro/kernels/kernel_runner.h"
+#include "tensorflow/lite/micro/test_helpers.h"
+#include "tensorflow/lite/micro/testing/micro_test.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+
+namespace tflite {
+namespace testing {
+namespace {
+
+using compute_engine::tflite::Register_BFULLY_CONNECTED;
+
+constexpr int kBatches = 3;
+constexpr int kChannelsOut = 10;
+constexpr int kMaxChannelsIn = 96;
+constexpr int kMaxInputDepth = (kMaxChannelsIn + 31) / 32;
+constexpr float kOutputScale = 0.5f;
+constexpr int kOutputZeroPoint = 2;
+
+std::vector<std::uint8_t> BuildOptions(const int channels_in) {
+  flexbuffers::Builder fbb;
+  fbb.Map([&]() {
+    fbb.Int("channels_in", channels_in);
+    fbb.Int("fused_activation_function", ActivationFunctionType_NONE);
+  });
+  fbb.Finish();
+  return fbb.GetBuffer();
+}
+
+// Values in [-1, 1), roughly half of them negative.
+float NextValue(std::uint32_t* state) {
+  *state = *state * 1664525u + 1013904223u;
+  return static_cast<float>(*state >> 8) / (1 << 23) - 1.0f;
+}
+
+// The test case: float input and weights, and the dot products of their signs
+// that every output is computed from.
+struct DenseData {
+  int channels_in;
+  float input[kBatches * kMaxChannelsIn];
+  // The weights, bitpacked along the input channels: a bit is set for a
+  // negative weight, and the padding bits are zero.
+  std::int32_t filter[kChannelsOut * kMaxInputDepth];
+  float multiplier[kChannelsOut];
+  float bias[kChannelsOut];
+  std::int32_t thresholds[kChannelsOut];
+  int dot_products[kBatches * kChannelsOut];
+};
+
+void FillDenseData(const int channels_in, DenseData* data) {
+  const int input_depth = (channels_in + 31) / 32;
+  data->channels_in = channels_in;
+  std::uint32_t state = 1234 + channels_in;
+  for (int i = 0; i < kBatches * channels_in; ++i) {
+    data->input[i] = NextValue(&state);
+  }
+  float weights[kChannelsOut * kMaxChannelsIn];
+  for (int i = 0; i < kChannelsOut * channels_in; ++i) {
+    weights[i] = NextValue(&state);
+  }
+  std::fill(data->filter, data->filter + kChannelsOut * input_depth, 0);
+  for (int o = 0; o < kChannelsOut; ++o) {
+    for (int c = 0; c < channels_in; ++c) {
+      if (weights[o * channels_in + c] < 0) {
+        data->filter[o * input_depth + c / 32] |= std::uint32_t(1) << (c % 32);
+      }
+    }
+    data->multiplier[o] = 0.25f + 0.125f * o;
+    data->bias[o] = 0.5f * o - 2.0f;
+    // Around the expected accumulator value, so that the output bits are
+    // mixed.
+    data->thresholds[o] = channels_in / 2 - 2 + o % 5;
+  }
+  for (int b = 0; b < kBatches; ++b) {
+    for (int o = 0; o < kChannelsOut; ++o) {
+      int dot_product = 0;
+      for (int c = 0; c < channels_in; ++c) {
+        const bool input_negative = data->input[b * channels_in + c] < 0;
+        const bool weight_negative = weights[o * channels_in + c] < 0;
+        dot_product += input_negative == weight_negative ? 1 : -1;
+      }
+      data->dot_products[b * kChannelsOut + o] = dot_product;
+    }
+  }
+}
+
+// Runs LceBFullyConnected on the float input of `data` and writes the output
+// to `output_data`.
+template <typename T>
+void RunBFullyConnected(const DenseData& data, T* output_data) {
+  const int input_depth = (data.channels_in + 31) / 32;
+  const int output_depth = std::is_same<T, std::int32_t>::value
+                               ? (kChannelsOut + 31) / 32
+                               : kChannelsOut;
+  int input_dims[] = {2, kBatches, data.channels_in};
+  int filter_dims[] = {2, kChannelsOut, input_depth};
+  int channels_out_dims[] = {1, kChannelsOut};
+  int output_dims[] = {2, kBatches, output_depth};
+
+  constexpr int kTensorsSize = 6;
+  TfLiteTensor tensors[kTensorsSize] = {
+      CreateTensor(data.input, IntArrayFromInts(input_dims)),
+      CreateTensor(data.filter, IntArrayFromInts(filter_dims)),
+      CreateTensor(data.multiplier, IntArrayFromInts(channels_out_dims)),
+      CreateTensor(data.bias, IntArrayFromInts(channels_out_dims)),
+      CreateTensor(data.thresholds, IntArrayFromInts(channels_out_dims)),
+      CreateQuantizedTensor(output_data, IntArrayFromInts(output_dims),
+                            kOutputScale, kOutputZeroPoint),
+  };
+
+  int inputs_array_data[] = {5, 0, 1, 2, 3, 4};
+  int outputs_array_data[] = {1, 5};
+  micro::KernelRunner runner(*Register_BFULLY_CONNECTED(), tensors,
+                             kTensorsSize,
+                             IntArrayFromInts(inputs_array_data),
+                             IntArrayFromInts(outputs_array_data),
+                             /*builtin_data=*/nullptr);
+  const std::vector<std::uint8_t> options = BuildOptions(data.channels_in);
+  TF_LITE_MICRO_EXPECT_EQ(
+      kTfLiteOk,
+      runner.InitAndPrepare(reinterpret_cast<const char*>(options.data()),
+                            options.size()));
+  TF_LITE_MICRO_EXPECT_EQ(kTfLiteOk, runner.Invoke());
+}
+
+void TestFloatOutput(const int channels_in) {
+  DenseData data;
+  FillDenseData(channels_in, &data);
+  float output[kBatches * kChannelsOut];
+  RunBFullyConnected(data, output);
+  for (int b = 0; b < kBatches; ++b) {
+    for (int o = 0; o < kChannelsOut; ++o) {
+      const float expected =
+          data.multiplier[o] * data.dot_products[b * kChannelsOut + o] +
+          data.bias[o];
+      TF_LITE_MICRO_EXPECT_NEAR(expected, output[b * kChannelsOut + o], 1e-4f);
+    }
+  }
+}
+
+void TestInt8Output(const int channels_in) {
+  DenseData data;
+  FillDenseData(channels_in, &data);
+  std::int8_t output[kBatches * kChannelsOut];
+  RunBFullyConnected(data, output);
+  for (int b = 0; b < kBatches; ++b) {
+    for (int o = 0; o < kChannelsOut; ++o) {
+      const float expected =
+          data.multiplier[o] * data.dot_products[b * kChannelsOut + o] +
+          data.bias[o];
+      const float quantized = std::min(
+          127.0f,
+          std::max(-128.0f, std::round(expected / kOutputScale) +
+                                kOutputZeroPoint));
+      // Allow for a different rounding of values halfway between two steps.
+      TF_LITE_MICRO_EXPECT_NEAR(quantized, output[b * kChannelsOut + o], 1.0f);
+    }
+  }
+}
+
+void TestBitpackedOutput(const int channels_in) {
+  DenseData data;
+  FillDenseData(channels_in, &data);
+  std::int32_t output[kBatches];
+  RunBFullyConnected(data, output);
+  for (int b = 0; b < kBatches; ++b) {
+    for (int o = 0; o < kChannelsOut; ++o) {
+      // The accumulator counts the input channels where the signs differ.
+      const int accumulator =
+          (channels_in - data.dot_products[b * kChannelsOut + o]) / 2;
+      const bool expected = accumulator > data.thresholds[o];
+      TF_LITE_MICRO_EXPECT_EQ(expected, ((output[b] >> o) & 1) != 0);
+    }
+    // The padding bits of the output are zero.
+    TF_LITE_MICRO_EXPECT_EQ(0, output[b] >> kChannelsOut);
+  }
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace tflite
+
+TF_LITE_MICRO_TESTS_BEGIN
+
+TF_LITE_MICRO_TEST(FloatOutput) {
+  tflite::testing::TestFloatOutput(64);
+  tflite::testing::TestFloatOutput(70);
+}
+
+TF_LITE_MICRO_TEST(Int8Output) {
+  tflite::testing::TestInt8Output(64);
+  tflite::testing::TestInt8Output(70);
+}
+
+TF_LITE_MICRO_TEST(BitpackedOutput) {
+  tflite::testing::TestBitpackedOutput(64);
+  tflite::testing::TestBitpackedOutput(70);
+}
+
+TF_LITE_MICRO_TESTS_END
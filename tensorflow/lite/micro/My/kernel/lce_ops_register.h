@@ -1,56 +1,55 @@
 #ifndef COMPUTE_ENGINE_TFLITE_KERNELS_LCE_OPS_REGISTER_H_
 #define COMPUTE_ENGINE_TFLITE_KERNELS_LCE_OPS_REGISTER_H_
 
-#include "tensorflow/lite/micro/My/lite/context.h"
-#include "tensorflow/lite/micro/My/lite/op_resolver.h"
-#include "tensorflow/lite/micro/My/lite/tools/logging.h"
+#include "tensorflow/lite/c/common.h"
 
 // This file contains forward declaration of all custom ops
 // implemented in LCE which can be used to link against LCE library.
+//
+// The BCONV_2D registrations are TFLM-native: all of their state lives in the
+// persistent arena and their temporaries are scratch buffers. Add them to a
+// MicroMutableOpResolver with AddBConv2D(), which registers the custom op
+// "LceBconv2d". Register_BCONV_2D_BMAXPOOL_2D is a binary convolution with
+// bitpacked output fused with the binary max-pool that follows it; add it with
+// AddBConv2DBMaxPool2D(), which registers the custom op "LceBconv2dBMaxPool2d".
+// Register_BFULLY_CONNECTED is a binary dense layer built on the same BGEMM;
+// add it with AddBFullyConnected() as the custom op "LceBFullyConnected".
+//
+// Register_BCONV_2D_OPT_INDIRECT_BGEMM is the indirect BGEMM kernel with the
+// x86 and Aarch64 micro-kernels, and a portable one elsewhere. It is opt-in:
+// it is only built with -DLCE_INDIRECT_BGEMM (LCE_INDIRECT_BGEMM=1 in the
+// Makefile), and a model only uses it if it is passed to AddBConv2D().
+// The selected micro-kernel, its packed weights and its indirection buffer are
+// kept in the persistent arena, and the filter must be a constant tensor.
+// Register_BCONV_2D_OPT_INDIRECT_BGEMM_THREADED is the same kernel split over a
+// compute_engine::core::ThreadPool. It needs std::thread, so it is only built
+// with -DLCE_INDIRECT_BGEMM_THREADED (LCE_INDIRECT_BGEMM_THREADED=1 in the
+// Makefile), which implies LCE_INDIRECT_BGEMM. The application owns the pool
+// and passes it with MicroInterpreter::SetMicroExternalContext(); without one
+// the op runs on the calling thread. The pool must not be shared with another
+// interpreter that may be invoked at the same time.
+
+#if defined(LCE_INDIRECT_BGEMM_THREADED) && !defined(LCE_INDIRECT_BGEMM)
+#define LCE_INDIRECT_BGEMM
+#endif
 
 namespace compute_engine {
 namespace tflite {
 
-using namespace ::tflite;
-
 TfLiteRegistration* Register_QUANTIZE();
 TfLiteRegistration* Register_DEQUANTIZE();
 TfLiteRegistration* Register_BCONV_2D();
 TfLiteRegistration* Register_BCONV_2D_REF();
+TfLiteRegistration* Register_BCONV_2D_OPT_BGEMM();
+#ifdef LCE_INDIRECT_BGEMM
 TfLiteRegistration* Register_BCONV_2D_OPT_INDIRECT_BGEMM();
+#endif
+#ifdef LCE_INDIRECT_BGEMM_THREADED
+TfLiteRegistration* Register_BCONV_2D_OPT_INDIRECT_BGEMM_THREADED();
+#endif
+TfLiteRegistration* Register_BCONV_2D_BMAXPOOL_2D();
 TfLiteRegistration* Register_BMAXPOOL_2D();
-
-// By calling this function on TF lite mutable op resolver, all LCE custom ops
-// will be registerd to the op resolver.
-inline void RegisterLCECustomOps(::tflite::MutableOpResolver* resolver,
-                                 const bool use_reference_bconv = false,
-                                 const bool use_indirect_bgemm = false) {
-  if (use_reference_bconv && use_indirect_bgemm) {
-    TFLITE_LOG(WARN)
-        << "WARNING: 'use_reference_bconv' and `use_indirect_bgemm` "
-           "are both set to true. use_indirect_bgemm==true "
-           "will have no effect.";
-  }
-  resolver->AddCustom("LceQuantize",
-                      compute_engine::tflite::Register_QUANTIZE());
-  resolver->AddCustom("LceDequantize",
-                      compute_engine::tflite::Register_DEQUANTIZE());
-  if (use_reference_bconv) {
-    resolver->AddCustom("LceBconv2d",
-                        compute_engine::tflite::Register_BCONV_2D_REF());
-  } else {
-    if (use_indirect_bgemm) {
-      resolver->AddCustom(
-          "LceBconv2d",
-          compute_engine::tflite::Register_BCONV_2D_OPT_INDIRECT_BGEMM());
-    } else {
-      resolver->AddCustom("LceBconv2d",
-                          compute_engine::tflite::Register_BCONV_2D());
-    }
-  }
-  resolver->AddCustom("LceBMaxPool2d",
-                      compute_engine::tflite::Register_BMAXPOOL_2D());
-};
+TfLiteRegistration* Register_BFULLY_CONNECTED();
 
 }  // namespace tflite
 }  // namespace compute_engine
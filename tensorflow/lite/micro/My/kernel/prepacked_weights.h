@@ -0,0 +1,70 @@
+#ifndef COMPUTE_ENGINE_TFLITE_KERNEL_PREPACKED_WEIGHTS_H
+#define COMPUTE_ENGINE_TFLITE_KERNEL_PREPACKED_WEIGHTS_H
+
+#include <cstdint>
+#include <cstring>
+
+#include "tensorflow/lite/micro/My/core/indirect_bgemm/kernel.h"
+#include "tensorflow/lite/micro/My/core/indirect_bgemm/prepacked_weights.h"
+#include "tensorflow/lite/micro/My/core/types.h"
+#include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+
+namespace compute_engine {
+namespace tflite {
+
+// Returns the index of the model buffer that holds input `input_index` of
+// `node` in subgraph `subgraph_index`, or -1 if it can't be found.
+inline std::int32_t GetInputBuffer(const ::tflite::Model* model,
+                                   const int subgraph_index,
+                                   const TfLiteNode* node,
+                                   const int input_index) {
+  if (model == nullptr || model->subgraphs() == nullptr ||
+      subgraph_index < 0 ||
+      static_cast<std::uint32_t>(subgraph_index) >=
+          model->subgraphs()->size() ||
+      input_index >= node->inputs->size) {
+    return -1;
+  }
+  const auto* tensors = model->subgraphs()->Get(subgraph_index)->tensors();
+  const int tensor_index = node->inputs->data[input_index];
+  if (tensors == nullptr || tensor_index < 0 ||
+      static_cast<std::uint32_t>(tensor_index) >= tensors->size()) {
+    return -1;
+  }
+  return tensors->Get(tensor_index)->buffer();
+}
+
+// Returns the weights in `filter_buffer` as packed by lce_prepack_weights for
+// `layout`, read in place from the model, or nullptr if the model has none.
+// The caller can then pass them to Kernel::UsePackedWeights() instead of
+// calling Kernel::PackWeights().
+inline const core::TBitpacked* FindPrepackedWeights(
+    const ::tflite::Model* model, const std::int32_t filter_buffer,
+    const core::indirect_bgemm::PackedWeightsLayout& layout) {
+  if (model == nullptr || filter_buffer < 0 || model->metadata() == nullptr ||
+      model->buffers() == nullptr) {
+    return nullptr;
+  }
+  for (const auto* metadata : *model->metadata()) {
+    if (metadata->name() == nullptr ||
+        std::strcmp(metadata->name()->c_str(),
+                    core::indirect_bgemm::kPrepackedWeightsMetadataName) !=
+            0 ||
+        metadata->buffer() >= model->buffers()->size()) {
+      continue;
+    }
+    const auto* data = model->buffers()->Get(metadata->buffer())->data();
+    if (data == nullptr) continue;
+    const core::TBitpacked* packed_weights =
+        core::indirect_bgemm::FindPrepackedWeights(layout, filter_buffer,
+                                                   data->data(), data->size());
+    if (packed_weights != nullptr) return packed_weights;
+  }
+  return nullptr;
+}
+
+}  // namespace tflite
+}  // namespace compute_engine
+
+#endif  // COMPUTE_ENGINE_TFLITE_KERNEL_PREPACKED_WEIGHTS_H
@@ -1,7 +1,17 @@
 #ifndef COMPUTE_ENGINE_TFLITE_KERNEL_UTILS_H
 #define COMPUTE_ENGINE_TFLITE_KERNEL_UTILS_H
 
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+
+#include "tensorflow/lite/micro/My/core/bconv2d/output_transform.h"
+#include "tensorflow/lite/micro/My/core/types.h"
 #include "tensorflow/lite/c/builtin_op_data.h"
+#include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/kernels/internal/tensor_ctypes.h"
+#include "tensorflow/lite/kernels/kernel_util.h"
+#include "tensorflow/lite/micro/kernels/kernel_util.h"
 #include "tensorflow/lite/schema/schema_generated.h"
 
 namespace tflite {
@@ -49,4 +59,90 @@ inline PaddingType RuntimePaddingType(TfLitePadding padding) {
 
 }  // namespace tflite
 
+namespace compute_engine {
+namespace tflite {
+
+// Fuses the back-transformation and the int8 scale/zero-point into the output
+// transform multiplier/bias of `op_data`, which are written to the persistent
+// arena. The padding bits are zero in both the input and the filter, so the
+// dot product of the +1/-1 vectors is `backtransform_add - 2 * accumulator`,
+// where `backtransform_add` is the number of unpacked values per output.
+template <typename OpData>
+TfLiteStatus CalculateOutputTransform(TfLiteContext* context,
+                                      const TfLiteTensor* multiplier,
+                                      const TfLiteTensor* bias,
+                                      const TfLiteTensor* output,
+                                      const int channels_out,
+                                      const std::int32_t backtransform_add,
+                                      OpData* op_data) {
+  op_data->output_transform_multiplier =
+      static_cast<float*>(context->AllocatePersistentBuffer(
+          context, channels_out * sizeof(float)));
+  op_data->output_transform_bias =
+      static_cast<float*>(context->AllocatePersistentBuffer(
+          context, channels_out * sizeof(float)));
+  TF_LITE_ENSURE(context, op_data->output_transform_multiplier != nullptr);
+  TF_LITE_ENSURE(context, op_data->output_transform_bias != nullptr);
+
+  const double output_scale =
+      output->type == kTfLiteInt8
+          ? static_cast<double>(output->params.scale)
+          : 1.0;
+  const double output_zero_point =
+      output->type == kTfLiteInt8 ? output->params.zero_point : 0.0;
+
+  const float* multiplier_data = ::tflite::GetTensorData<float>(multiplier);
+  const float* bias_data = ::tflite::GetTensorData<float>(bias);
+  for (int i = 0; i < channels_out; ++i) {
+    const double post_mul = multiplier_data[i];
+    const double post_bias = bias_data[i];
+    op_data->output_transform_multiplier[i] = -1 * post_mul / output_scale;
+    op_data->output_transform_bias[i] =
+        (post_bias + static_cast<double>(backtransform_add) * post_mul) /
+            output_scale +
+        output_zero_point;
+  }
+
+  std::int32_t nominal_clamp_min, nominal_clamp_max;
+  ::tflite::CalculateActivationRange(op_data->fused_activation_function,
+                                     &nominal_clamp_min, &nominal_clamp_max);
+  nominal_clamp_min = std::max(nominal_clamp_min, -1 * backtransform_add);
+  nominal_clamp_max = std::min(nominal_clamp_max, backtransform_add);
+  op_data->output_transform_clamp_min =
+      -1 * nominal_clamp_max + backtransform_add;
+  op_data->output_transform_clamp_max =
+      -1 * nominal_clamp_min + backtransform_add;
+  return kTfLiteOk;
+}
+
+// Fill in the OutputTransform values for float and/or int8 outputs
+template <typename DstScalar, typename OpData>
+void GetOutputTransform(
+    core::bconv2d::OutputTransform<DstScalar>& output_transform,
+    TfLiteContext* context, TfLiteNode* node, const OpData* op_data,
+    const int thresholds_index) {
+  static_assert(std::is_same<DstScalar, float>::value ||
+                    std::is_same<DstScalar, std::int8_t>::value,
+                "");
+  output_transform.clamp_min = op_data->output_transform_clamp_min;
+  output_transform.clamp_max = op_data->output_transform_clamp_max;
+  output_transform.multiplier = op_data->output_transform_multiplier;
+  output_transform.bias = op_data->output_transform_bias;
+}
+
+// Fill in the OutputTransform values for bitpacked outputs
+template <typename OpData>
+void GetOutputTransform(
+    core::bconv2d::OutputTransform<core::TBitpacked>& output_transform,
+    TfLiteContext* context, TfLiteNode* node, const OpData* op_data,
+    const int thresholds_index) {
+  const TfLiteEvalTensor* thresholds =
+      ::tflite::micro::GetEvalInput(context, node, thresholds_index);
+  output_transform.thresholds =
+      ::tflite::micro::GetTensorData<std::int32_t>(thresholds);
+}
+
+}  // namespace tflite
+}  // namespace compute_engine
+
 #endif  // COMPUTE_ENGINE_TFLITE_KERNEL_UTILS_H
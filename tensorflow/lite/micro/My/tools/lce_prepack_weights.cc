@@ -0,0 +1,159 @@
+// Packs the filters of the binary convolutions in a .tflite model into the
+// layout of an indirect BGEMM micro-kernel, so that the kernel can use them in
+// place instead of repacking them every time the model is loaded.
+//
+// usage: lce_prepack_weights <portable|avx2|avx512|aarch64> input output
+//
+// The packed weights are stored next to the original filters, which are left
+// untouched, so the output model still runs on any target. This roughly
+// doubles the size of the binary filters in the model. Only LceBconv2d is
+// packed: LceBconv2dBMaxPool2d always runs the portable BGEMM and would never
+// read its blob.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "flatbuffers/flatbuffers.h"
+#include "flatbuffers/flexbuffers.h"
+#include "flatbuffers/util.h"
+#include "tensorflow/lite/micro/My/core/bitpacking/bitpack.h"
+#include "tensorflow/lite/micro/My/core/indirect_bgemm/kernel.h"
+#include "tensorflow/lite/micro/My/core/indirect_bgemm/prepacked_weights.h"
+#include "tensorflow/lite/micro/My/core/types.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+
+using compute_engine::core::TBitpacked;
+using compute_engine::core::bitpacking::GetBitpackedSize;
+using compute_engine::core::indirect_bgemm::GetPrepackedWeightsBytes;
+using compute_engine::core::indirect_bgemm::kPrepackedWeightsMetadataName;
+using compute_engine::core::indirect_bgemm::PackedWeightsLayout;
+using compute_engine::core::indirect_bgemm::WritePrepackedWeights;
+
+namespace {
+
+// Fills in the tile shape of the kernel that select_kernel.h picks on
+// `target`. Returns false for an unknown target.
+bool SetTileShape(const std::string& target, PackedWeightsLayout* layout) {
+  const int input_depth_per_group = layout->input_depth / layout->groups;
+  if (target == "portable") {
+    layout->block_size_output_channels = 4;
+    layout->block_size_depth = 1;
+  } else if (target == "avx2") {
+    layout->block_size_output_channels = 8;
+    layout->block_size_depth = 1;
+  } else if (target == "avx512") {
+    layout->block_size_output_channels = 16;
+    layout->block_size_depth = 1;
+  } else if (target == "aarch64") {
+    layout->block_size_output_channels = 8;
+    layout->block_size_depth = input_depth_per_group % 4 == 0   ? 4
+                               : input_depth_per_group % 2 == 0 ? 2
+                                                                : 1;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// Only LceBconv2d can run the indirect BGEMM, so only its filters are packed.
+bool IsBConv2D(const tflite::ModelT& model, const tflite::OperatorT& op) {
+  const auto& opcode = model.operator_codes[op.opcode_index];
+  return opcode->custom_code == "LceBconv2d";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 4) {
+    fprintf(stderr,
+            "usage: %s <portable|avx2|avx512|aarch64> input_flatbuffer "
+            "output_flatbuffer\n"
+            "\n"
+            "Packs the filters of every LceBconv2d op for the indirect BGEMM "
+            "kernel of the\n"
+            "given target. The original filters are kept so that the model "
+            "still runs\n"
+            "everywhere, which roughly doubles the size of the binary "
+            "weights.\n",
+            argv[0]);
+    return 1;
+  }
+  const std::string target = argv[1];
+  PackedWeightsLayout unit_layout{};
+  unit_layout.input_depth = unit_layout.groups = 1;
+  if (!SetTileShape(target, &unit_layout)) {
+    fprintf(stderr, "Unknown target: %s\n", target.c_str());
+    return 1;
+  }
+
+  std::string model_file;
+  if (!flatbuffers::LoadFile(argv[2], /*binary*/ true, &model_file)) {
+    fprintf(stderr, "Could not read %s\n", argv[2]);
+    return 1;
+  }
+  std::unique_ptr<tflite::ModelT> model(
+      tflite::GetModel(model_file.data())->UnPack());
+
+  // All blobs go in one buffer, which the kernels search by filter buffer.
+  std::vector<std::uint8_t> blobs;
+  int num_packed = 0;
+  for (const auto& subgraph : model->subgraphs) {
+    for (const auto& op : subgraph->operators) {
+      if (!IsBConv2D(*model, *op) || op->inputs.size() < 2) continue;
+      const auto& filter = subgraph->tensors[op->inputs[1]];
+      const auto& filter_data = model->buffers[filter->buffer]->data;
+      if (filter->type != tflite::TensorType_INT32 || filter_data.empty() ||
+          filter->shape.size() != 4) {
+        continue;
+      }
+
+      const auto m = flexbuffers::GetRoot(op->custom_options.data(),
+                                          op->custom_options.size())
+                         .AsMap();
+      if (m["channels_in"].IsNull()) continue;
+
+      PackedWeightsLayout layout;
+      layout.input_depth = GetBitpackedSize(m["channels_in"].AsInt32());
+      layout.output_channels = filter->shape[0];
+      layout.filter_size = filter->shape[1] * filter->shape[2];
+      layout.groups = layout.input_depth / filter->shape[3];
+      SetTileShape(target, &layout);
+
+      // Keep every blob aligned to TBitpacked.
+      const std::size_t offset = blobs.size();
+      blobs.resize(offset + GetPrepackedWeightsBytes(layout));
+      std::vector<TBitpacked> weights(filter_data.size() / sizeof(TBitpacked));
+      std::memcpy(weights.data(), filter_data.data(),
+                  weights.size() * sizeof(TBitpacked));
+      WritePrepackedWeights(layout, filter->buffer, weights.data(),
+                            blobs.data() + offset);
+      ++num_packed;
+    }
+  }
+
+  if (num_packed > 0) {
+    auto buffer = std::make_unique<tflite::BufferT>();
+    buffer->data = std::move(blobs);
+    model->buffers.push_back(std::move(buffer));
+    auto metadata = std::make_unique<tflite::MetadataT>();
+    metadata->name = kPrepackedWeightsMetadataName;
+    metadata->buffer = model->buffers.size() - 1;
+    model->metadata.push_back(std::move(metadata));
+  }
+
+  flatbuffers::FlatBufferBuilder fbb;
+  fbb.Finish(tflite::Model::Pack(fbb, model.get()), tflite::ModelIdentifier());
+  if (!flatbuffers::SaveFile(argv[3],
+                             reinterpret_cast<char*>(fbb.GetBufferPointer()),
+                             fbb.GetSize(), /*binary*/ true)) {
+    fprintf(stderr, "Could not write %s\n", argv[3]);
+    return 1;
+  }
+  fprintf(stderr, "Packed the weights of %d binary convolutions for %s\n",
+          num_packed, target.c_str());
+  return 0;
+}
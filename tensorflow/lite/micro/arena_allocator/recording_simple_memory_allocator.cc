@@ -27,7 +27,9 @@ RecordingSimpleMemoryAllocator::RecordingSimpleMemoryAllocator(
       requested_head_bytes_(0),
       requested_tail_bytes_(0),
       used_bytes_(0),
-      alloc_count_(0) {}
+      alloc_count_(0),
+      max_used_bytes_(0),
+      remaining_memory_claim_offset_(0) {}
 
 RecordingSimpleMemoryAllocator::~RecordingSimpleMemoryAllocator() {}
 
@@ -57,6 +59,14 @@ size_t RecordingSimpleMemoryAllocator::GetAllocatedCount() const {
   return alloc_count_;
 }
 
+size_t RecordingSimpleMemoryAllocator::GetMaxUsedBytes() const {
+  return max_used_bytes_;
+}
+
+size_t RecordingSimpleMemoryAllocator::GetRemainingMemoryClaimOffset() const {
+  return remaining_memory_claim_offset_;
+}
+
 TfLiteStatus RecordingSimpleMemoryAllocator::ResizeBuffer(
     uint8_t* resizable_buf, size_t size, size_t alignment) {
   const uint8_t* previous_head = head();
@@ -65,6 +75,7 @@ TfLiteStatus RecordingSimpleMemoryAllocator::ResizeBuffer(
   if (status == kTfLiteOk) {
     used_bytes_ += head() - previous_head;
     requested_head_bytes_ = size;
+    UpdateMaxUsedBytes();
   }
   return status;
 }
@@ -78,8 +89,31 @@ uint8_t* RecordingSimpleMemoryAllocator::AllocatePersistentBuffer(
     used_bytes_ += previous_tail - tail();
     requested_tail_bytes_ += size;
     alloc_count_++;
+    UpdateMaxUsedBytes();
+  }
+  return result;
+}
+
+uint8_t* RecordingSimpleMemoryAllocator::AllocateTemp(size_t size,
+                                                      size_t alignment) {
+  const size_t available_memory = GetAvailableMemory(alignment);
+  uint8_t* result = SimpleMemoryAllocator::AllocateTemp(size, alignment);
+  if (result != nullptr) {
+    if (size == available_memory) {
+      remaining_memory_claim_offset_ =
+          SimpleMemoryAllocator::GetUsedBytes() - size;
+    } else {
+      UpdateMaxUsedBytes();
+    }
   }
   return result;
 }
 
+void RecordingSimpleMemoryAllocator::UpdateMaxUsedBytes() {
+  const size_t current_used_bytes = SimpleMemoryAllocator::GetUsedBytes();
+  if (current_used_bytes > max_used_bytes_) {
+    max_used_bytes_ = current_used_bytes;
+  }
+}
+
 }  // namespace tflite
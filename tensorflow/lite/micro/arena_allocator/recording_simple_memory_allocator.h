@@ -47,15 +47,30 @@ class RecordingSimpleMemoryAllocator : public SimpleMemoryAllocator {
   // Returns the number of alloc calls from the head or tail.
   size_t GetAllocatedCount() const;
 
+  // Returns the largest number of bytes that were in use at the same time by
+  // the head (including temp allocations) and the tail. Temp allocations that
+  // claim all of the remaining memory are not counted, since their size
+  // depends on the arena size rather than on the model.
+  size_t GetMaxUsedBytes() const;
+
+  // Returns the number of bytes in use when the most recent temp allocation
+  // claiming all of the remaining memory was made, or 0 if there was none.
+  size_t GetRemainingMemoryClaimOffset() const;
+
   TfLiteStatus ResizeBuffer(uint8_t* resizable_buf, size_t size,
                             size_t alignment) override;
   uint8_t* AllocatePersistentBuffer(size_t size, size_t alignment) override;
+  uint8_t* AllocateTemp(size_t size, size_t alignment) override;
 
  private:
   size_t requested_head_bytes_;
   size_t requested_tail_bytes_;
   size_t used_bytes_;
   size_t alloc_count_;
+  size_t max_used_bytes_;
+  size_t remaining_memory_claim_offset_;
+
+  void UpdateMaxUsedBytes();
 
   TF_LITE_REMOVE_VIRTUAL_DELETE
 };
@@ -150,4 +150,37 @@ TF_LITE_MICRO_TEST(TestDoesNotRecordFailedTailAllocations) {
                           static_cast<size_t>(0));
 }
 
+TF_LITE_MICRO_TEST(TestRecordsMaxUsedBytesAcrossTempAllocations) {
+  constexpr size_t arena_size = 1024;
+  uint8_t arena[arena_size];
+  tflite::RecordingSimpleMemoryAllocator allocator(
+      tflite::GetMicroErrorReporter(), arena, arena_size);
+
+  uint8_t* result =
+      allocator.AllocatePersistentBuffer(/*size=*/100, /*alignment=*/1);
+  TF_LITE_MICRO_EXPECT_NE(result, nullptr);
+  uint8_t* temp = allocator.AllocateTemp(/*size=*/200, /*alignment=*/1);
+  TF_LITE_MICRO_EXPECT_NE(temp, nullptr);
+  allocator.DeallocateTemp(temp);
+  TF_LITE_MICRO_EXPECT_EQ(kTfLiteOk, allocator.ResetTempAllocations());
+
+  // Temp allocations are released but still count towards the peak:
+  TF_LITE_MICRO_EXPECT_EQ(allocator.GetMaxUsedBytes(),
+                          static_cast<size_t>(300));
+  TF_LITE_MICRO_EXPECT_EQ(allocator.GetRemainingMemoryClaimOffset(),
+                          static_cast<size_t>(0));
+
+  // A temp allocation that claims all of the remaining memory only records
+  // where it started:
+  temp = allocator.AllocateTemp(allocator.GetAvailableMemory(/*alignment=*/1),
+                                /*alignment=*/1);
+  TF_LITE_MICRO_EXPECT_NE(temp, nullptr);
+  allocator.DeallocateTemp(temp);
+  TF_LITE_MICRO_EXPECT_EQ(kTfLiteOk, allocator.ResetTempAllocations());
+  TF_LITE_MICRO_EXPECT_EQ(allocator.GetMaxUsedBytes(),
+                          static_cast<size_t>(300));
+  TF_LITE_MICRO_EXPECT_EQ(allocator.GetRemainingMemoryClaimOffset(),
+                          static_cast<size_t>(100));
+}
+
 TF_LITE_MICRO_TESTS_END
@@ -0,0 +1,146 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cstdint>
+#include <cstring>
+
+#include "tensorflow/lite/experimental/microfrontend/lib/bits.h"
+#include "tensorflow/lite/experimental/microfrontend/lib/frontend.h"
+#include "tensorflow/lite/experimental/microfrontend/lib/frontend_util.h"
+#include "tensorflow/lite/micro/micro_error_reporter.h"
+#include "tensorflow/lite/micro/micro_time.h"
+#include "tensorflow/lite/micro/system_setup.h"
+
+/*
+ * Audio frontend benchmark. Times the spectrum stage of the microfrontend
+ * (FFT, energy, filterbank accumulation and square root) for the default
+ * 16kHz / 30ms window configuration used by micro_speech, once through the
+ * original kissfft and two pass filterbank pipeline and once through the
+ * radix-4 FFT and fused filterbank accumulation, and checks that both produce
+ * the same channel values.
+ */
+
+namespace tflite {
+namespace {
+
+constexpr int kSampleRate = 16000;
+constexpr int kNumSamples = kSampleRate;
+constexpr int kMaxChannels = 64;
+
+int16_t audio_samples[kNumSamples];
+
+// A chirp-like deterministic test signal with some broadband noise on top.
+void GenerateAudio() {
+  uint32_t seed = 1;
+  int32_t phase = 0;
+  for (int i = 0; i < kNumSamples; ++i) {
+    seed = seed * 1103515245 + 12345;
+    phase += 64 + i / 16;
+    const int32_t triangle = (phase & 0xFFFF) < 0x8000
+                                 ? (phase & 0x7FFF) - 0x4000
+                                 : 0x4000 - (phase & 0x7FFF);
+    audio_samples[i] =
+        static_cast<int16_t>(triangle + static_cast<int16_t>(seed >> 16) / 8);
+  }
+}
+
+void ReferenceSpectrum(FrontendState* state, int input_shift,
+                       uint32_t* channels) {
+  state->fft.use_radix4 = 0;
+  FftCompute(&state->fft, state->window.output, input_shift);
+  int32_t* energy = reinterpret_cast<int32_t*>(state->fft.output);
+  FilterbankConvertFftComplexToEnergy(&state->filterbank, state->fft.output,
+                                      energy);
+  FilterbankAccumulateChannels(&state->filterbank, energy);
+  std::memcpy(channels, FilterbankSqrt(&state->filterbank, input_shift),
+              state->filterbank.num_channels * sizeof(*channels));
+}
+
+void OptimizedSpectrum(FrontendState* state, int input_shift,
+                       uint32_t* channels) {
+  state->fft.use_radix4 = 1;
+  FftCompute(&state->fft, state->window.output, input_shift);
+  FilterbankAccumulateFftChannels(&state->filterbank, state->fft.output);
+  std::memcpy(channels, FilterbankSqrt(&state->filterbank, input_shift),
+              state->filterbank.num_channels * sizeof(*channels));
+}
+
+}  // namespace
+}  // namespace tflite
+
+int main(int argc, char** argv) {
+  tflite::InitializeTarget();
+  tflite::GenerateAudio();
+
+  FrontendConfig config;
+  FrontendFillConfigWithDefaults(&config);
+  FrontendState state;
+  if (!FrontendPopulateState(&config, &state, tflite::kSampleRate)) {
+    MicroPrintf("Failed to populate frontend state");
+    return 1;
+  }
+  if (!state.fft.use_radix4 ||
+      state.filterbank.num_channels > tflite::kMaxChannels) {
+    MicroPrintf("Unsupported frontend configuration (fft size %d)",
+                static_cast<int>(state.fft.fft_size));
+    FrontendFreeStateContents(&state);
+    return 1;
+  }
+
+  uint32_t reference[tflite::kMaxChannels];
+  uint32_t optimized[tflite::kMaxChannels];
+  int32_t reference_ticks = 0;
+  int32_t optimized_ticks = 0;
+  int frames = 0;
+  int mismatches = 0;
+
+  const int16_t* samples = tflite::audio_samples;
+  size_t remaining = tflite::kNumSamples;
+  while (remaining > 0) {
+    size_t num_samples_read = 0;
+    const bool has_window = WindowProcessSamples(&state.window, samples,
+                                                 remaining, &num_samples_read);
+    samples += num_samples_read;
+    remaining -= num_samples_read;
+    if (!has_window) {
+      continue;
+    }
+    const int input_shift =
+        15 - MostSignificantBit32(state.window.max_abs_output_value);
+
+    uint32_t start = tflite::GetCurrentTimeTicks();
+    tflite::ReferenceSpectrum(&state, input_shift, reference);
+    reference_ticks += tflite::GetCurrentTimeTicks() - start;
+
+    start = tflite::GetCurrentTimeTicks();
+    tflite::OptimizedSpectrum(&state, input_shift, optimized);
+    optimized_ticks += tflite::GetCurrentTimeTicks() - start;
+
+    if (std::memcmp(reference, optimized,
+                    state.filterbank.num_channels * sizeof(*reference)) != 0) {
+      ++mismatches;
+    }
+    ++frames;
+  }
+
+  MicroPrintf("AudioFrontendSpectrum(kissfft) %d frames took %d ticks (%d ms)",
+              frames, reference_ticks, tflite::TicksToMs(reference_ticks));
+  MicroPrintf("AudioFrontendSpectrum(radix4) %d frames took %d ticks (%d ms)",
+              frames, optimized_ticks, tflite::TicksToMs(optimized_ticks));
+  MicroPrintf("%d of %d frames differ", mismatches, frames);
+
+  FrontendFreeStateContents(&state);
+  return mismatches == 0 ? 0 : 1;
+}
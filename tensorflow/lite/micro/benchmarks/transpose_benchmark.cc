@@ -0,0 +1,175 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cstdint>
+#include <cstring>
+
+#include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/kernels/internal/reference/transpose.h"
+#include "tensorflow/lite/micro/kernels/kernel_runner.h"
+#include "tensorflow/lite/micro/kernels/micro_ops.h"
+#include "tensorflow/lite/micro/micro_error_reporter.h"
+#include "tensorflow/lite/micro/micro_time.h"
+#include "tensorflow/lite/micro/system_setup.h"
+#include "tensorflow/lite/micro/test_helpers.h"
+
+/*
+ * Transpose benchmark. Times the TRANSPOSE kernel on the permutations it has
+ * fast paths for (NHWC<->NCHW, 2-D matrix, innermost axis kept) and on a
+ * generic 4-D permutation, next to reference_ops::Transpose and a plain
+ * memcpy of the same number of bytes. Throughput is reported in MB/s so the
+ * kernel can be compared against the memcpy bandwidth of the target.
+ */
+
+namespace tflite {
+namespace {
+
+constexpr int kIterations = 20;
+constexpr int kMaxBytes = 32 * 1024;
+
+alignas(16) int8_t input_buffer[kMaxBytes];
+alignas(16) int8_t output_buffer[kMaxBytes];
+alignas(16) int8_t reference_buffer[kMaxBytes];
+
+struct BenchmarkCase {
+  const char* name;
+  TfLiteType type;
+  int dims[1 + 4];
+  int32_t perm[4];
+};
+
+int MegabytesPerSecond(int bytes, uint32_t ticks) {
+  if (ticks == 0) {
+    return 0;
+  }
+  const double seconds =
+      static_cast<double>(ticks) / static_cast<double>(ticks_per_second());
+  return static_cast<int>(static_cast<double>(bytes) * kIterations / seconds /
+                          1.0e6);
+}
+
+template <typename T>
+bool RunCase(const BenchmarkCase& bench) {
+  const int rank = bench.dims[0];
+  int input_dims_data[1 + 4];
+  int output_dims_data[1 + 4];
+  int perm_dims_data[] = {1, rank};
+  input_dims_data[0] = rank;
+  output_dims_data[0] = rank;
+  for (int i = 0; i < rank; ++i) {
+    input_dims_data[1 + i] = bench.dims[1 + i];
+    output_dims_data[1 + i] = bench.dims[1 + bench.perm[i]];
+  }
+  TfLiteIntArray* input_dims = testing::IntArrayFromInts(input_dims_data);
+  TfLiteIntArray* output_dims = testing::IntArrayFromInts(output_dims_data);
+  TfLiteIntArray* perm_dims = testing::IntArrayFromInts(perm_dims_data);
+  const int size = testing::ElementCount(*input_dims);
+  const int bytes = size * static_cast<int>(sizeof(T));
+
+  T* input = reinterpret_cast<T*>(input_buffer);
+  T* output = reinterpret_cast<T*>(output_buffer);
+  T* reference = reinterpret_cast<T*>(reference_buffer);
+  for (int i = 0; i < size; ++i) {
+    input[i] = static_cast<T>(i * 7 + 3);
+  }
+
+  constexpr int kTensorsSize = 3;
+  TfLiteTensor tensors[kTensorsSize] = {
+      testing::CreateTensor(input, input_dims),
+      testing::CreateTensor(bench.perm, perm_dims),
+      testing::CreateTensor(output, output_dims),
+  };
+  int inputs_array_data[] = {2, 0, 1};
+  TfLiteIntArray* inputs_array = testing::IntArrayFromInts(inputs_array_data);
+  int outputs_array_data[] = {1, 2};
+  TfLiteIntArray* outputs_array = testing::IntArrayFromInts(outputs_array_data);
+
+  const TfLiteRegistration registration = Register_TRANSPOSE();
+  micro::KernelRunner runner(registration, tensors, kTensorsSize, inputs_array,
+                             outputs_array, nullptr);
+  if (runner.InitAndPrepare() != kTfLiteOk) {
+    MicroPrintf("%s: Prepare failed", bench.name);
+    return false;
+  }
+
+  uint32_t start = GetCurrentTimeTicks();
+  for (int i = 0; i < kIterations; ++i) {
+    if (runner.Invoke() != kTfLiteOk) {
+      MicroPrintf("%s: Invoke failed", bench.name);
+      return false;
+    }
+  }
+  const uint32_t kernel_ticks = GetCurrentTimeTicks() - start;
+
+  TransposeParams params;
+  params.perm_count = rank;
+  RuntimeShape input_shape(rank);
+  RuntimeShape output_shape(rank);
+  for (int i = 0; i < rank; ++i) {
+    params.perm[i] = bench.perm[i];
+    input_shape.SetDim(i, input_dims->data[i]);
+    output_shape.SetDim(i, output_dims->data[i]);
+  }
+  start = GetCurrentTimeTicks();
+  for (int i = 0; i < kIterations; ++i) {
+    reference_ops::Transpose(params, input_shape, input, output_shape,
+                             reference);
+  }
+  const uint32_t reference_ticks = GetCurrentTimeTicks() - start;
+
+  start = GetCurrentTimeTicks();
+  for (int i = 0; i < kIterations; ++i) {
+    std::memcpy(reference_buffer, input_buffer, bytes);
+  }
+  const uint32_t memcpy_ticks = GetCurrentTimeTicks() - start;
+
+  // The memcpy above overwrote the reference result.
+  reference_ops::Transpose(params, input_shape, input, output_shape,
+                           reference);
+  const bool matches = std::memcmp(output, reference, bytes) == 0;
+
+  MicroPrintf(
+      "%s (%d bytes): kernel %d MB/s, reference %d MB/s, memcpy %d MB/s%s",
+      bench.name, bytes, MegabytesPerSecond(bytes, kernel_ticks),
+      MegabytesPerSecond(bytes, reference_ticks),
+      MegabytesPerSecond(bytes, memcpy_ticks), matches ? "" : " MISMATCH");
+  return matches;
+}
+
+}  // namespace
+}  // namespace tflite
+
+int main(int argc, char** argv) {
+  tflite::InitializeTarget();
+
+  // The dims arrays reuse the IntArrayFromInts layout: rank, then the dims.
+  const tflite::BenchmarkCase kCases[] = {
+      {"NHWC->NCHW int8", kTfLiteInt8, {4, 1, 32, 32, 32}, {0, 3, 1, 2}},
+      {"NCHW->NHWC int8", kTfLiteInt8, {4, 1, 32, 32, 32}, {0, 2, 3, 1}},
+      {"2-D float", kTfLiteFloat32, {2, 64, 128}, {1, 0}},
+      {"inner axis kept int8", kTfLiteInt8, {3, 32, 32, 32}, {1, 0, 2}},
+      {"generic 4-D int8", kTfLiteInt8, {4, 8, 16, 16, 16}, {3, 1, 0, 2}},
+  };
+
+  bool all_match = true;
+  for (const tflite::BenchmarkCase& bench : kCases) {
+    if (bench.type == kTfLiteFloat32) {
+      all_match &= tflite::RunCase<float>(bench);
+    } else {
+      all_match &= tflite::RunCase<int8_t>(bench);
+    }
+  }
+  return all_match ? 0 : 1;
+}
@@ -0,0 +1,339 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <algorithm>
+#include <cstdint>
+
+#include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/experimental/microfrontend/lib/frontend.h"
+#include "tensorflow/lite/experimental/microfrontend/lib/frontend_util.h"
+#include "tensorflow/lite/kernels/internal/common.h"
+#include "tensorflow/lite/kernels/internal/compatibility.h"
+#include "tensorflow/lite/kernels/internal/quantization_util.h"
+#include "tensorflow/lite/kernels/kernel_util.h"
+#include "tensorflow/lite/micro/flatbuffer_utils.h"
+#include "tensorflow/lite/micro/kernels/kernel_util.h"
+#include "tensorflow/lite/micro/micro_error_reporter.h"
+
+/*
+ * The audio microfrontend custom operator runs the feature generation of
+ * tensorflow/lite/experimental/microfrontend as part of the graph, with the
+ * same options and output layout as the TFLite AudioMicrofrontend op:
+ *
+ * Input: [num_samples] int16 PCM audio.
+ * Output: [num_rows, num_channels * (left_context + 1 + right_context)]
+ *
+ * Every frame_stride-th feature vector produces one output row, made of the
+ * feature vectors from left_context frames before it to right_context frames
+ * after it. Frames outside the audio are either zeros (zero_padding) or
+ * repeat the first/last frame. Each value is the frontend output divided by
+ * out_scale, stored as int32, float32 (out_float) or quantized int8.
+ *
+ * The frontend state is built once in Init and kept in the persistent arena.
+ * The feature vectors of a whole invocation are generated into an arena
+ * scratch buffer, which the memory planner is free to overlap with other
+ * activations, and then written directly into the output tensor.
+ */
+namespace tflite {
+namespace {
+
+constexpr int kInputTensor = 0;
+constexpr int kOutputTensor = 0;
+
+// Indices into the custom options flexbuffer, whose map values
+// FlexbufferWrapper sees in alphabetical order of their keys.
+constexpr int kEnableLogIndex = 0;
+constexpr int kEnablePcanIndex = 1;
+constexpr int kEvenSmoothingIndex = 2;
+constexpr int kFrameStrideIndex = 3;
+constexpr int kGainBitsIndex = 4;
+constexpr int kLeftContextIndex = 5;
+constexpr int kLowerBandLimitIndex = 6;
+constexpr int kMinSignalRemainingIndex = 7;
+constexpr int kNumChannelsIndex = 8;
+constexpr int kOddSmoothingIndex = 9;
+constexpr int kOutFloatIndex = 10;
+constexpr int kOutScaleIndex = 11;
+constexpr int kPcanOffsetIndex = 12;
+constexpr int kPcanStrengthIndex = 13;
+constexpr int kRightContextIndex = 14;
+constexpr int kSampleRateIndex = 15;
+constexpr int kScaleShiftIndex = 16;
+constexpr int kSmoothingBitsIndex = 17;
+constexpr int kUpperBandLimitIndex = 18;
+constexpr int kWindowSizeIndex = 19;
+constexpr int kWindowStepIndex = 20;
+constexpr int kZeroPaddingIndex = 21;
+
+constexpr int kDefaultSampleRate = 16000;
+
+struct OpData {
+  FrontendState state;
+  bool state_valid;
+  int left_context;
+  int right_context;
+  int frame_stride;
+  int out_scale;
+  bool out_float;
+  bool zero_padding;
+  // Number of feature vectors generated from the input per invocation.
+  int num_frames;
+  int frames_scratch_index;
+  // Requantization of the frontend output for int8 outputs.
+  int32_t output_multiplier;
+  int output_shift;
+  int32_t output_zero_point;
+};
+
+void ParseOptions(const char* buffer, size_t length, FrontendConfig* config,
+                  int* sample_rate, OpData* data) {
+  FrontendFillConfigWithDefaults(config);
+  *sample_rate = kDefaultSampleRate;
+  data->left_context = 0;
+  data->right_context = 0;
+  data->frame_stride = 1;
+  data->out_scale = 1;
+  data->out_float = false;
+  data->zero_padding = false;
+  if (buffer == nullptr || length == 0) {
+    return;
+  }
+
+  const uint8_t* buffer_t = reinterpret_cast<const uint8_t*>(buffer);
+  const FlexbufferWrapper wrapper(buffer_t, length);
+  config->window.size_ms = wrapper.ElementAsInt32(kWindowSizeIndex);
+  config->window.step_size_ms = wrapper.ElementAsInt32(kWindowStepIndex);
+  config->filterbank.num_channels = wrapper.ElementAsInt32(kNumChannelsIndex);
+  config->filterbank.upper_band_limit =
+      wrapper.ElementAsFloat(kUpperBandLimitIndex);
+  config->filterbank.lower_band_limit =
+      wrapper.ElementAsFloat(kLowerBandLimitIndex);
+  config->noise_reduction.smoothing_bits =
+      wrapper.ElementAsInt32(kSmoothingBitsIndex);
+  config->noise_reduction.even_smoothing =
+      wrapper.ElementAsFloat(kEvenSmoothingIndex);
+  config->noise_reduction.odd_smoothing =
+      wrapper.ElementAsFloat(kOddSmoothingIndex);
+  config->noise_reduction.min_signal_remaining =
+      wrapper.ElementAsFloat(kMinSignalRemainingIndex);
+  config->pcan_gain_control.enable_pcan =
+      wrapper.ElementAsBool(kEnablePcanIndex);
+  config->pcan_gain_control.strength =
+      wrapper.ElementAsFloat(kPcanStrengthIndex);
+  config->pcan_gain_control.offset = wrapper.ElementAsFloat(kPcanOffsetIndex);
+  config->pcan_gain_control.gain_bits = wrapper.ElementAsInt32(kGainBitsIndex);
+  config->log_scale.enable_log = wrapper.ElementAsBool(kEnableLogIndex);
+  config->log_scale.scale_shift = wrapper.ElementAsInt32(kScaleShiftIndex);
+  *sample_rate = wrapper.ElementAsInt32(kSampleRateIndex);
+  data->left_context = wrapper.ElementAsInt32(kLeftContextIndex);
+  data->right_context = wrapper.ElementAsInt32(kRightContextIndex);
+  data->frame_stride = wrapper.ElementAsInt32(kFrameStrideIndex);
+  data->out_scale = wrapper.ElementAsInt32(kOutScaleIndex);
+  data->out_float = wrapper.ElementAsBool(kOutFloatIndex);
+  data->zero_padding = wrapper.ElementAsBool(kZeroPaddingIndex);
+}
+
+// Hands the frontend its buffers from the persistent arena.
+void* AllocatePersistent(void* context, size_t size) {
+  TfLiteContext* tflite_context = static_cast<TfLiteContext*>(context);
+  return tflite_context->AllocatePersistentBuffer(tflite_context, size);
+}
+
+void* Init(TfLiteContext* context, const char* buffer, size_t length) {
+  TFLITE_DCHECK(context->AllocatePersistentBuffer != nullptr);
+  OpData* data = static_cast<OpData*>(
+      context->AllocatePersistentBuffer(context, sizeof(OpData)));
+  if (data == nullptr) {
+    return nullptr;
+  }
+
+  FrontendConfig config;
+  int sample_rate;
+  ParseOptions(buffer, length, &config, &sample_rate, data);
+
+  FrontendAllocator allocator;
+  allocator.allocate = AllocatePersistent;
+  allocator.context = context;
+  data->state_valid = FrontendPopulateStateWithAllocator(
+                          &config, &data->state, sample_rate, &allocator) != 0;
+  if (!data->state_valid) {
+    MicroPrintf("Failed to populate audio frontend state");
+  }
+  return data;
+}
+
+TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
+  TFLITE_DCHECK(node->user_data != nullptr);
+  OpData* data = static_cast<OpData*>(node->user_data);
+  TF_LITE_ENSURE(context, data->state_valid);
+  TF_LITE_ENSURE(context, data->frame_stride > 0);
+  TF_LITE_ENSURE(context, data->left_context >= 0);
+  TF_LITE_ENSURE(context, data->right_context >= 0);
+  TF_LITE_ENSURE(context, data->out_scale > 0);
+
+  TF_LITE_ENSURE_EQ(context, NumInputs(node), 1);
+  TF_LITE_ENSURE_EQ(context, NumOutputs(node), 1);
+
+  MicroContext* micro_context = GetMicroContext(context);
+  TfLiteTensor* input =
+      micro_context->AllocateTempInputTensor(node, kInputTensor);
+  TF_LITE_ENSURE(context, input != nullptr);
+  TfLiteTensor* output =
+      micro_context->AllocateTempOutputTensor(node, kOutputTensor);
+  TF_LITE_ENSURE(context, output != nullptr);
+
+  TF_LITE_ENSURE_TYPES_EQ(context, input->type, kTfLiteInt16);
+  TF_LITE_ENSURE_EQ(context, NumDimensions(input), 1);
+  TF_LITE_ENSURE_EQ(context, NumDimensions(output), 2);
+
+  const int num_samples = input->dims->data[0];
+  const int window_size = data->state.window.size;
+  const int window_step = data->state.window.step;
+  data->num_frames =
+      num_samples >= window_size ? (num_samples - window_size) / window_step + 1
+                                 : 0;
+  const int num_rows =
+      (data->num_frames + data->frame_stride - 1) / data->frame_stride;
+  const int num_channels = data->state.filterbank.num_channels;
+  TF_LITE_ENSURE_EQ(context, output->dims->data[0], num_rows);
+  TF_LITE_ENSURE_EQ(
+      context, output->dims->data[1],
+      num_channels * (data->left_context + 1 + data->right_context));
+
+  if (data->out_float) {
+    TF_LITE_ENSURE_TYPES_EQ(context, output->type, kTfLiteFloat32);
+  } else if (output->type == kTfLiteInt8) {
+    // value / out_scale, requantized to the output scale.
+    QuantizeMultiplier(
+        1.0 / (static_cast<double>(data->out_scale) * output->params.scale),
+        &data->output_multiplier, &data->output_shift);
+    data->output_zero_point = output->params.zero_point;
+  } else {
+    TF_LITE_ENSURE_TYPES_EQ(context, output->type, kTfLiteInt32);
+  }
+
+  if (data->num_frames > 0) {
+    TF_LITE_ENSURE_STATUS(context->RequestScratchBufferInArena(
+        context, data->num_frames * num_channels * sizeof(uint16_t),
+        &data->frames_scratch_index));
+  }
+
+  micro_context->DeallocateTempTfLiteTensor(input);
+  micro_context->DeallocateTempTfLiteTensor(output);
+  return kTfLiteOk;
+}
+
+// Writes the output rows for the feature vectors in frames, with
+// convert(value) producing each output value and padding standing in for
+// frames beyond the audio when zero_padding is set.
+template <typename T, typename Convert>
+void WriteRows(const OpData& data, const uint16_t* frames, T padding,
+               Convert convert, T* output) {
+  const int num_channels = data.state.filterbank.num_channels;
+  for (int anchor = 0; anchor < data.num_frames; anchor += data.frame_stride) {
+    for (int offset = -data.left_context; offset <= data.right_context;
+         ++offset) {
+      int frame = anchor + offset;
+      if (frame < 0 || frame >= data.num_frames) {
+        if (data.zero_padding) {
+          for (int i = 0; i < num_channels; ++i) {
+            *output++ = padding;
+          }
+          continue;
+        }
+        frame = frame < 0 ? 0 : data.num_frames - 1;
+      }
+      const uint16_t* values = frames + frame * num_channels;
+      for (int i = 0; i < num_channels; ++i) {
+        *output++ = convert(values[i]);
+      }
+    }
+  }
+}
+
+TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
+  TFLITE_DCHECK(node->user_data != nullptr);
+  OpData* data = static_cast<OpData*>(node->user_data);
+
+  const TfLiteEvalTensor* input =
+      tflite::micro::GetEvalInput(context, node, kInputTensor);
+  TfLiteEvalTensor* output =
+      tflite::micro::GetEvalOutput(context, node, kOutputTensor);
+  if (data->num_frames == 0) {
+    return kTfLiteOk;
+  }
+
+  // Each invocation processes a complete, independent piece of audio.
+  FrontendReset(&data->state);
+  uint16_t* frames = static_cast<uint16_t*>(
+      context->GetScratchBuffer(context, data->frames_scratch_index));
+  size_t num_samples_read;
+  const size_t num_frames = FrontendProcessSamplesBatch(
+      &data->state, tflite::micro::GetTensorData<int16_t>(input),
+      input->dims->data[0], frames, data->num_frames, &num_samples_read);
+  TF_LITE_ENSURE_EQ(context, static_cast<int>(num_frames), data->num_frames);
+
+  switch (output->type) {
+    case kTfLiteFloat32: {
+      const float out_scale = data->out_scale;
+      WriteRows(
+          *data, frames, 0.0f,
+          [out_scale](uint16_t value) { return value / out_scale; },
+          tflite::micro::GetTensorData<float>(output));
+      break;
+    }
+    case kTfLiteInt32: {
+      const int32_t out_scale = data->out_scale;
+      WriteRows(
+          *data, frames, int32_t{0},
+          [out_scale](uint16_t value) {
+            return static_cast<int32_t>(value) / out_scale;
+          },
+          tflite::micro::GetTensorData<int32_t>(output));
+      break;
+    }
+    case kTfLiteInt8: {
+      const int32_t multiplier = data->output_multiplier;
+      const int shift = data->output_shift;
+      const int32_t zero_point = data->output_zero_point;
+      WriteRows(
+          *data, frames, static_cast<int8_t>(zero_point),
+          [multiplier, shift, zero_point](uint16_t value) {
+            const int32_t result =
+                MultiplyByQuantizedMultiplier(value, multiplier, shift) +
+                zero_point;
+            return static_cast<int8_t>(
+                std::min<int32_t>(std::max<int32_t>(result, INT8_MIN),
+                                  INT8_MAX));
+          },
+          tflite::micro::GetTensorData<int8_t>(output));
+      break;
+    }
+    default:
+      MicroPrintf("Type %s (%d) not supported.",
+                  TfLiteTypeGetName(output->type), output->type);
+      return kTfLiteError;
+  }
+  return kTfLiteOk;
+}
+
+}  // namespace
+
+TfLiteRegistration* Register_AUDIO_MICROFRONTEND() {
+  static TfLiteRegistration r = tflite::micro::RegisterOp(Init, Prepare, Eval);
+  return &r;
+}
+
+}  // namespace tflite
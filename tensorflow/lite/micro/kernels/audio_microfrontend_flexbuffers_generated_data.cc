@@ -0,0 +1,105 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// This file is generated. See:
+// tensorflow/lite/micro/kernels/test_data_generation/README.md
+
+#include "tensorflow/lite/micro/kernels/audio_microfrontend_flexbuffers_generated_data.h"
+
+const int g_gen_data_size_audio_microfrontend_int32_config = 465;
+const unsigned char g_gen_data_audio_microfrontend_int32_config[] = {
+    0x73, 0x61, 0x6d, 0x70, 0x6c, 0x65, 0x5f, 0x72, 0x61, 0x74, 0x65, 0x00,
+    0x77, 0x69, 0x6e, 0x64, 0x6f, 0x77, 0x5f, 0x73, 0x69, 0x7a, 0x65, 0x00,
+    0x77, 0x69, 0x6e, 0x64, 0x6f, 0x77, 0x5f, 0x73, 0x74, 0x65, 0x70, 0x00,
+    0x6e, 0x75, 0x6d, 0x5f, 0x63, 0x68, 0x61, 0x6e, 0x6e, 0x65, 0x6c, 0x73,
+    0x00, 0x75, 0x70, 0x70, 0x65, 0x72, 0x5f, 0x62, 0x61, 0x6e, 0x64, 0x5f,
+    0x6c, 0x69, 0x6d, 0x69, 0x74, 0x00, 0x6c, 0x6f, 0x77, 0x65, 0x72, 0x5f,
+    0x62, 0x61, 0x6e, 0x64, 0x5f, 0x6c, 0x69, 0x6d, 0x69, 0x74, 0x00, 0x73,
+    0x6d, 0x6f, 0x6f, 0x74, 0x68, 0x69, 0x6e, 0x67, 0x5f, 0x62, 0x69, 0x74,
+    0x73, 0x00, 0x65, 0x76, 0x65, 0x6e, 0x5f, 0x73, 0x6d, 0x6f, 0x6f, 0x74,
+    0x68, 0x69, 0x6e, 0x67, 0x00, 0x6f, 0x64, 0x64, 0x5f, 0x73, 0x6d, 0x6f,
+    0x6f, 0x74, 0x68, 0x69, 0x6e, 0x67, 0x00, 0x6d, 0x69, 0x6e, 0x5f, 0x73,
+    0x69, 0x67, 0x6e, 0x61, 0x6c, 0x5f, 0x72, 0x65, 0x6d, 0x61, 0x69, 0x6e,
+    0x69, 0x6e, 0x67, 0x00, 0x65, 0x6e, 0x61, 0x62, 0x6c, 0x65, 0x5f, 0x70,
+    0x63, 0x61, 0x6e, 0x00, 0x70, 0x63, 0x61, 0x6e, 0x5f, 0x73, 0x74, 0x72,
+    0x65, 0x6e, 0x67, 0x74, 0x68, 0x00, 0x70, 0x63, 0x61, 0x6e, 0x5f, 0x6f,
+    0x66, 0x66, 0x73, 0x65, 0x74, 0x00, 0x67, 0x61, 0x69, 0x6e, 0x5f, 0x62,
+    0x69, 0x74, 0x73, 0x00, 0x65, 0x6e, 0x61, 0x62, 0x6c, 0x65, 0x5f, 0x6c,
+    0x6f, 0x67, 0x00, 0x73, 0x63, 0x61, 0x6c, 0x65, 0x5f, 0x73, 0x68, 0x69,
+    0x66, 0x74, 0x00, 0x6c, 0x65, 0x66, 0x74, 0x5f, 0x63, 0x6f, 0x6e, 0x74,
+    0x65, 0x78, 0x74, 0x00, 0x72, 0x69, 0x67, 0x68, 0x74, 0x5f, 0x63, 0x6f,
+    0x6e, 0x74, 0x65, 0x78, 0x74, 0x00, 0x66, 0x72, 0x61, 0x6d, 0x65, 0x5f,
+    0x73, 0x74, 0x72, 0x69, 0x64, 0x65, 0x00, 0x6f, 0x75, 0x74, 0x5f, 0x73,
+    0x63, 0x61, 0x6c, 0x65, 0x00, 0x6f, 0x75, 0x74, 0x5f, 0x66, 0x6c, 0x6f,
+    0x61, 0x74, 0x00, 0x7a, 0x65, 0x72, 0x6f, 0x5f, 0x70, 0x61, 0x64, 0x64,
+    0x69, 0x6e, 0x67, 0x00, 0x16, 0x00, 0x62, 0x00, 0x94, 0x00, 0xc8, 0x00,
+    0x36, 0x00, 0x74, 0x00, 0x55, 0x00, 0xf0, 0x00, 0xb5, 0x00, 0x12, 0x01,
+    0xc7, 0x00, 0x2d, 0x00, 0x39, 0x00, 0x90, 0x00, 0xa0, 0x00, 0x5a, 0x00,
+    0x44, 0x01, 0x77, 0x00, 0xf5, 0x00, 0x19, 0x01, 0x40, 0x01, 0x36, 0x01,
+    0x39, 0x00, 0x00, 0x00, 0x2e, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00,
+    0x16, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+    0xcd, 0xcc, 0xcc, 0x3c, 0x02, 0x00, 0x00, 0x00, 0x15, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0xfa, 0x42, 0xcd, 0xcc, 0x4c, 0x3d,
+    0x08, 0x00, 0x00, 0x00, 0x8f, 0xc2, 0x75, 0x3d, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0xa0, 0x42, 0x33, 0x33, 0x73, 0x3f,
+    0x01, 0x00, 0x00, 0x00, 0x80, 0x3e, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00,
+    0x0a, 0x00, 0x00, 0x00, 0x00, 0x60, 0xea, 0x45, 0x08, 0x00, 0x00, 0x00,
+    0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x6a, 0x6a, 0x0e, 0x06,
+    0x06, 0x06, 0x0e, 0x0e, 0x06, 0x0e, 0x6a, 0x06, 0x0e, 0x0e, 0x06, 0x06,
+    0x06, 0x06, 0x0e, 0x06, 0x06, 0x6a, 0x6e, 0x26, 0x01,
+};
+
+const int g_gen_data_size_audio_microfrontend_float_config = 465;
+const unsigned char g_gen_data_audio_microfrontend_float_config[] = {
+    0x73, 0x61, 0x6d, 0x70, 0x6c, 0x65, 0x5f, 0x72, 0x61, 0x74, 0x65, 0x00,
+    0x77, 0x69, 0x6e, 0x64, 0x6f, 0x77, 0x5f, 0x73, 0x69, 0x7a, 0x65, 0x00,
+    0x77, 0x69, 0x6e, 0x64, 0x6f, 0x77, 0x5f, 0x73, 0x74, 0x65, 0x70, 0x00,
+    0x6e, 0x75, 0x6d, 0x5f, 0x63, 0x68, 0x61, 0x6e, 0x6e, 0x65, 0x6c, 0x73,
+    0x00, 0x75, 0x70, 0x70, 0x65, 0x72, 0x5f, 0x62, 0x61, 0x6e, 0x64, 0x5f,
+    0x6c, 0x69, 0x6d, 0x69, 0x74, 0x00, 0x6c, 0x6f, 0x77, 0x65, 0x72, 0x5f,
+    0x62, 0x61, 0x6e, 0x64, 0x5f, 0x6c, 0x69, 0x6d, 0x69, 0x74, 0x00, 0x73,
+    0x6d, 0x6f, 0x6f, 0x74, 0x68, 0x69, 0x6e, 0x67, 0x5f, 0x62, 0x69, 0x74,
+    0x73, 0x00, 0x65, 0x76, 0x65, 0x6e, 0x5f, 0x73, 0x6d, 0x6f, 0x6f, 0x74,
+    0x68, 0x69, 0x6e, 0x67, 0x00, 0x6f, 0x64, 0x64, 0x5f, 0x73, 0x6d, 0x6f,
+    0x6f, 0x74, 0x68, 0x69, 0x6e, 0x67, 0x00, 0x6d, 0x69, 0x6e, 0x5f, 0x73,
+    0x69, 0x67, 0x6e, 0x61, 0x6c, 0x5f, 0x72, 0x65, 0x6d, 0x61, 0x69, 0x6e,
+    0x69, 0x6e, 0x67, 0x00, 0x65, 0x6e, 0x61, 0x62, 0x6c, 0x65, 0x5f, 0x70,
+    0x63, 0x61, 0x6e, 0x00, 0x70, 0x63, 0x61, 0x6e, 0x5f, 0x73, 0x74, 0x72,
+    0x65, 0x6e, 0x67, 0x74, 0x68, 0x00, 0x70, 0x63, 0x61, 0x6e, 0x5f, 0x6f,
+    0x66, 0x66, 0x73, 0x65, 0x74, 0x00, 0x67, 0x61, 0x69, 0x6e, 0x5f, 0x62,
+    0x69, 0x74, 0x73, 0x00, 0x65, 0x6e, 0x61, 0x62, 0x6c, 0x65, 0x5f, 0x6c,
+    0x6f, 0x67, 0x00, 0x73, 0x63, 0x61, 0x6c, 0x65, 0x5f, 0x73, 0x68, 0x69,
+    0x66, 0x74, 0x00, 0x6c, 0x65, 0x66, 0x74, 0x5f, 0x63, 0x6f, 0x6e, 0x74,
+    0x65, 0x78, 0x74, 0x00, 0x72, 0x69, 0x67, 0x68, 0x74, 0x5f, 0x63, 0x6f,
+    0x6e, 0x74, 0x65, 0x78, 0x74, 0x00, 0x66, 0x72, 0x61, 0x6d, 0x65, 0x5f,
+    0x73, 0x74, 0x72, 0x69, 0x64, 0x65, 0x00, 0x6f, 0x75, 0x74, 0x5f, 0x73,
+    0x63, 0x61, 0x6c, 0x65, 0x00, 0x6f, 0x75, 0x74, 0x5f, 0x66, 0x6c, 0x6f,
+    0x61, 0x74, 0x00, 0x7a, 0x65, 0x72, 0x6f, 0x5f, 0x70, 0x61, 0x64, 0x64,
+    0x69, 0x6e, 0x67, 0x00, 0x16, 0x00, 0x62, 0x00, 0x94, 0x00, 0xc8, 0x00,
+    0x36, 0x00, 0x74, 0x00, 0x55, 0x00, 0xf0, 0x00, 0xb5, 0x00, 0x12, 0x01,
+    0xc7, 0x00, 0x2d, 0x00, 0x39, 0x00, 0x90, 0x00, 0xa0, 0x00, 0x5a, 0x00,
+    0x44, 0x01, 0x77, 0x00, 0xf5, 0x00, 0x19, 0x01, 0x40, 0x01, 0x36, 0x01,
+    0x39, 0x00, 0x00, 0x00, 0x2e, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00,
+    0x16, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+    0xcd, 0xcc, 0xcc, 0x3c, 0x01, 0x00, 0x00, 0x00, 0x15, 0x00, 0x00, 0x00,
+    0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0xfa, 0x42, 0xcd, 0xcc, 0x4c, 0x3d,
+    0x08, 0x00, 0x00, 0x00, 0x8f, 0xc2, 0x75, 0x3d, 0x01, 0x00, 0x00, 0x00,
+    0x0a, 0x00, 0x00, 0x00, 0x00, 0x00, 0xa0, 0x42, 0x33, 0x33, 0x73, 0x3f,
+    0x00, 0x00, 0x00, 0x00, 0x80, 0x3e, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00,
+    0x0a, 0x00, 0x00, 0x00, 0x00, 0x60, 0xea, 0x45, 0x08, 0x00, 0x00, 0x00,
+    0x04, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x6a, 0x6a, 0x0e, 0x06,
+    0x06, 0x06, 0x0e, 0x0e, 0x06, 0x0e, 0x6a, 0x06, 0x0e, 0x0e, 0x06, 0x06,
+    0x06, 0x06, 0x0e, 0x06, 0x06, 0x6a, 0x6e, 0x26, 0x01,
+};
@@ -0,0 +1,25 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_MICRO_KERNELS_AUDIO_MICROFRONTEND_FLEXBUFFERS_GENERATED_DATA_H
+#define TENSORFLOW_LITE_MICRO_KERNELS_AUDIO_MICROFRONTEND_FLEXBUFFERS_GENERATED_DATA_H
+
+extern const int g_gen_data_size_audio_microfrontend_int32_config;
+extern const unsigned char g_gen_data_audio_microfrontend_int32_config[];
+
+extern const int g_gen_data_size_audio_microfrontend_float_config;
+extern const unsigned char g_gen_data_audio_microfrontend_float_config[];
+
+#endif
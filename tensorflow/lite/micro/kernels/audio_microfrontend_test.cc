@@ -0,0 +1,242 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cstdint>
+
+#include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/experimental/microfrontend/lib/frontend.h"
+#include "tensorflow/lite/experimental/microfrontend/lib/frontend_util.h"
+#include "tensorflow/lite/micro/kernels/audio_microfrontend_flexbuffers_generated_data.h"
+#include "tensorflow/lite/micro/kernels/kernel_runner.h"
+#include "tensorflow/lite/micro/micro_mutable_op_resolver.h"
+#include "tensorflow/lite/micro/test_helpers.h"
+#include "tensorflow/lite/micro/testing/micro_test.h"
+
+namespace tflite {
+namespace testing {
+namespace {
+
+// Matches the configurations in audio_microfrontend_flexbuffers_generated_data:
+// 8ms windows every 4ms at 16kHz, i.e. 128 samples every 64 samples.
+constexpr int kNumSamples = 640;
+constexpr int kNumChannels = 8;
+constexpr int kNumFrames = (kNumSamples - 128) / 64 + 1;
+
+void GenerateAudio(int16_t* samples) {
+  uint32_t seed = 7;
+  for (int i = 0; i < kNumSamples; ++i) {
+    seed = seed * 1103515245 + 12345;
+    const int32_t tone = ((i * 40) & 0x3FF) - 0x200;
+    samples[i] = static_cast<int16_t>(tone * 16 +
+                                      static_cast<int16_t>(seed >> 16) / 64);
+  }
+}
+
+// Feature vectors of samples computed with the frontend library directly.
+void ComputeFrames(const int16_t* samples, uint16_t* frames) {
+  FrontendConfig config;
+  FrontendFillConfigWithDefaults(&config);
+  config.window.size_ms = 8;
+  config.window.step_size_ms = 4;
+  config.filterbank.num_channels = kNumChannels;
+  config.pcan_gain_control.enable_pcan = 1;
+  FrontendState state;
+  TF_LITE_MICRO_EXPECT(FrontendPopulateState(&config, &state, 16000));
+
+  int num_frames = 0;
+  size_t remaining = kNumSamples;
+  while (remaining > 0) {
+    size_t num_samples_read;
+    const FrontendOutput output =
+        FrontendProcessSamples(&state, samples, remaining, &num_samples_read);
+    samples += num_samples_read;
+    remaining -= num_samples_read;
+    for (size_t i = 0; i < output.size; ++i) {
+      frames[num_frames * kNumChannels + i] = output.values[i];
+    }
+    if (output.size > 0) {
+      ++num_frames;
+    }
+  }
+  TF_LITE_MICRO_EXPECT_EQ(kNumFrames, num_frames);
+  FrontendFreeStateContents(&state);
+}
+
+// Returns the frame that provides the given output row and context slot, or
+// -1 for zero padding.
+int ContextFrame(int row, int slot, int left_context, int frame_stride,
+                 bool zero_padding) {
+  int frame = row * frame_stride + slot - left_context;
+  if (frame < 0 || frame >= kNumFrames) {
+    if (zero_padding) {
+      return -1;
+    }
+    frame = frame < 0 ? 0 : kNumFrames - 1;
+  }
+  return frame;
+}
+
+void InvokeAudioMicrofrontend(const unsigned char* options, int options_size,
+                              int16_t* input_data, TfLiteTensor output_tensor,
+                              int num_invocations) {
+  int input_dims_data[] = {1, kNumSamples};
+  TfLiteIntArray* input_dims = IntArrayFromInts(input_dims_data);
+
+  constexpr int tensors_size = 2;
+  TfLiteTensor tensors[tensors_size] = {
+      CreateTensor(input_data, input_dims),
+      output_tensor,
+  };
+  int inputs_array_data[] = {1, 0};
+  TfLiteIntArray* inputs_array = IntArrayFromInts(inputs_array_data);
+  int outputs_array_data[] = {1, 1};
+  TfLiteIntArray* outputs_array = IntArrayFromInts(outputs_array_data);
+
+  const TfLiteRegistration* registration =
+      tflite::Register_AUDIO_MICROFRONTEND();
+  micro::KernelRunner runner(*registration, tensors, tensors_size,
+                             inputs_array, outputs_array,
+                             /*builtin_data=*/nullptr);
+  TF_LITE_MICRO_EXPECT_EQ(
+      kTfLiteOk, runner.InitAndPrepare(reinterpret_cast<const char*>(options),
+                                       options_size));
+  for (int i = 0; i < num_invocations; ++i) {
+    TF_LITE_MICRO_EXPECT_EQ(kTfLiteOk, runner.Invoke());
+  }
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace tflite
+
+TF_LITE_MICRO_TESTS_BEGIN
+
+TF_LITE_MICRO_TEST(Int32OutputMatchesFrontend) {
+  int16_t input[tflite::testing::kNumSamples];
+  uint16_t frames[tflite::testing::kNumFrames * tflite::testing::kNumChannels];
+  tflite::testing::GenerateAudio(input);
+  tflite::testing::ComputeFrames(input, frames);
+
+  // left_context = 1, right_context = 1, frame_stride = 2, out_scale = 1.
+  constexpr int kNumRows = (tflite::testing::kNumFrames + 1) / 2;
+  constexpr int kRowSize = tflite::testing::kNumChannels * 3;
+  int32_t output_data[kNumRows * kRowSize];
+  int output_dims_data[] = {2, kNumRows, kRowSize};
+
+  // Invoking twice checks that every invocation starts from a fresh state.
+  tflite::testing::InvokeAudioMicrofrontend(
+      g_gen_data_audio_microfrontend_int32_config,
+      g_gen_data_size_audio_microfrontend_int32_config, input,
+      tflite::testing::CreateTensor(
+          output_data, tflite::testing::IntArrayFromInts(output_dims_data)),
+      /*num_invocations=*/2);
+
+  for (int row = 0; row < kNumRows; ++row) {
+    for (int slot = 0; slot < 3; ++slot) {
+      const int frame = tflite::testing::ContextFrame(
+          row, slot, /*left_context=*/1, /*frame_stride=*/2,
+          /*zero_padding=*/false);
+      for (int i = 0; i < tflite::testing::kNumChannels; ++i) {
+        TF_LITE_MICRO_EXPECT_EQ(
+            static_cast<int32_t>(
+                frames[frame * tflite::testing::kNumChannels + i]),
+            output_data[row * kRowSize + slot * tflite::testing::kNumChannels +
+                        i]);
+      }
+    }
+  }
+}
+
+TF_LITE_MICRO_TEST(FloatOutputIsScaledAndZeroPadded) {
+  int16_t input[tflite::testing::kNumSamples];
+  uint16_t frames[tflite::testing::kNumFrames * tflite::testing::kNumChannels];
+  tflite::testing::GenerateAudio(input);
+  tflite::testing::ComputeFrames(input, frames);
+
+  // left_context = 2, right_context = 0, frame_stride = 1, out_scale = 10.
+  constexpr int kNumRows = tflite::testing::kNumFrames;
+  constexpr int kRowSize = tflite::testing::kNumChannels * 3;
+  float output_data[kNumRows * kRowSize];
+  int output_dims_data[] = {2, kNumRows, kRowSize};
+
+  tflite::testing::InvokeAudioMicrofrontend(
+      g_gen_data_audio_microfrontend_float_config,
+      g_gen_data_size_audio_microfrontend_float_config, input,
+      tflite::testing::CreateTensor(
+          output_data, tflite::testing::IntArrayFromInts(output_dims_data)),
+      /*num_invocations=*/1);
+
+  for (int row = 0; row < kNumRows; ++row) {
+    for (int slot = 0; slot < 3; ++slot) {
+      const int frame = tflite::testing::ContextFrame(
+          row, slot, /*left_context=*/2, /*frame_stride=*/1,
+          /*zero_padding=*/true);
+      for (int i = 0; i < tflite::testing::kNumChannels; ++i) {
+        const float expected =
+            frame < 0 ? 0.0f
+                      : frames[frame * tflite::testing::kNumChannels + i] /
+                            10.0f;
+        TF_LITE_MICRO_EXPECT_NEAR(
+            expected,
+            output_data[row * kRowSize + slot * tflite::testing::kNumChannels +
+                        i],
+            1e-5f);
+      }
+    }
+  }
+}
+
+TF_LITE_MICRO_TEST(Int8OutputIsRequantized) {
+  int16_t input[tflite::testing::kNumSamples];
+  uint16_t frames[tflite::testing::kNumFrames * tflite::testing::kNumChannels];
+  tflite::testing::GenerateAudio(input);
+  tflite::testing::ComputeFrames(input, frames);
+
+  constexpr int kNumRows = (tflite::testing::kNumFrames + 1) / 2;
+  constexpr int kRowSize = tflite::testing::kNumChannels * 3;
+  constexpr float kScale = 4.0f;
+  constexpr int kZeroPoint = -128;
+  int8_t output_data[kNumRows * kRowSize];
+  int output_dims_data[] = {2, kNumRows, kRowSize};
+
+  tflite::testing::InvokeAudioMicrofrontend(
+      g_gen_data_audio_microfrontend_int32_config,
+      g_gen_data_size_audio_microfrontend_int32_config, input,
+      tflite::testing::CreateQuantizedTensor(
+          output_data, tflite::testing::IntArrayFromInts(output_dims_data),
+          kScale, kZeroPoint),
+      /*num_invocations=*/1);
+
+  for (int row = 0; row < kNumRows; ++row) {
+    for (int slot = 0; slot < 3; ++slot) {
+      const int frame = tflite::testing::ContextFrame(
+          row, slot, /*left_context=*/1, /*frame_stride=*/2,
+          /*zero_padding=*/false);
+      for (int i = 0; i < tflite::testing::kNumChannels; ++i) {
+        float expected =
+            frames[frame * tflite::testing::kNumChannels + i] / kScale +
+            kZeroPoint;
+        expected = expected > 127.0f ? 127.0f : expected;
+        TF_LITE_MICRO_EXPECT_NEAR(
+            expected,
+            output_data[row * kRowSize + slot * tflite::testing::kNumChannels +
+                        i],
+            0.5f);
+      }
+    }
+  }
+}
+
+TF_LITE_MICRO_TESTS_END
@@ -222,6 +222,11 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
   TF_LITE_ENSURE(context, output_tensor != nullptr);
   TfLiteType output_type = output_tensor->type;
 
+  // The memory planner may have made the inputs views of the output already.
+  if (tflite::micro::InputsArePlannedAsSlicesOf(context, node, output_tensor)) {
+    return kTfLiteOk;
+  }
+
   switch (output_type) {  // Already know in/outtypes are same.
     case kTfLiteFloat32:
       EvalUnquantized<float>(context, node);
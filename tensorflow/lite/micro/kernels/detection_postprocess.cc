@@ -252,6 +252,51 @@ T ReInterpretTensor(TfLiteEvalTensor* tensor) {
   return reinterpret_cast<T>(tensor_base);
 }
 
+bool ValidateBoxes(const float* decoded_boxes, const int num_boxes) {
+  for (int i = 0; i < num_boxes; ++i) {
+    // ymax>=ymin, xmax>=xmin
+    auto& box = reinterpret_cast<const BoxCornerEncoding*>(decoded_boxes)[i];
+    if (box.ymin >= box.ymax || box.xmin >= box.xmax) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Decodes one box from center-size encoding relative to its anchor into
+// box-corner encoding.
+BoxCornerEncoding DecodeCenterSizeBox(const CenterSizeEncoding& box_centersize,
+                                      const CenterSizeEncoding& anchor,
+                                      const CenterSizeEncoding& scale_values) {
+  float ycenter = static_cast<float>(static_cast<double>(box_centersize.y) /
+                                         static_cast<double>(scale_values.y) *
+                                         static_cast<double>(anchor.h) +
+                                     static_cast<double>(anchor.y));
+
+  float xcenter = static_cast<float>(static_cast<double>(box_centersize.x) /
+                                         static_cast<double>(scale_values.x) *
+                                         static_cast<double>(anchor.w) +
+                                     static_cast<double>(anchor.x));
+
+  float half_h =
+      static_cast<float>(0.5 *
+                         (std::exp(static_cast<double>(box_centersize.h) /
+                                   static_cast<double>(scale_values.h))) *
+                         static_cast<double>(anchor.h));
+  float half_w =
+      static_cast<float>(0.5 *
+                         (std::exp(static_cast<double>(box_centersize.w) /
+                                   static_cast<double>(scale_values.w))) *
+                         static_cast<double>(anchor.w));
+
+  BoxCornerEncoding box;
+  box.ymin = ycenter - half_h;
+  box.xmin = xcenter - half_w;
+  box.ymax = ycenter + half_h;
+  box.xmax = xcenter + half_w;
+  return box;
+}
+
 TfLiteStatus DecodeCenterSizeBoxes(TfLiteContext* context, TfLiteNode* node,
                                    OpData* op_data) {
   // Parse input tensor boxencodings
@@ -285,38 +330,61 @@ TfLiteStatus DecodeCenterSizeBoxes(TfLiteContext* context, TfLiteNode* node,
         return kTfLiteError;
     }
 
-    float ycenter = static_cast<float>(static_cast<double>(box_centersize.y) /
-                                           static_cast<double>(scale_values.y) *
-                                           static_cast<double>(anchor.h) +
-                                       static_cast<double>(anchor.y));
-
-    float xcenter = static_cast<float>(static_cast<double>(box_centersize.x) /
-                                           static_cast<double>(scale_values.x) *
-                                           static_cast<double>(anchor.w) +
-                                       static_cast<double>(anchor.x));
-
-    float half_h =
-        static_cast<float>(0.5 *
-                           (std::exp(static_cast<double>(box_centersize.h) /
-                                     static_cast<double>(scale_values.h))) *
-                           static_cast<double>(anchor.h));
-    float half_w =
-        static_cast<float>(0.5 *
-                           (std::exp(static_cast<double>(box_centersize.w) /
-                                     static_cast<double>(scale_values.w))) *
-                           static_cast<double>(anchor.w));
-
     float* decoded_boxes = reinterpret_cast<float*>(
         context->GetScratchBuffer(context, op_data->decoded_boxes_idx));
-    auto& box = reinterpret_cast<BoxCornerEncoding*>(decoded_boxes)[idx];
-    box.ymin = ycenter - half_h;
-    box.xmin = xcenter - half_w;
-    box.ymax = ycenter + half_h;
-    box.xmax = xcenter + half_w;
+    reinterpret_cast<BoxCornerEncoding*>(decoded_boxes)[idx] =
+        DecodeCenterSizeBox(box_centersize, anchor, scale_values);
   }
   return kTfLiteOk;
 }
 
+// Decodes boxes into the decoded_boxes scratch buffer the first time they are
+// needed, so that anchors whose scores never pass the score threshold are not
+// decoded at all. The active_candidate scratch buffer is reused to flag the
+// boxes that have been decoded.
+class LazyBoxDecoder {
+ public:
+  LazyBoxDecoder(TfLiteContext* context, const OpData* op_data,
+                 const TfLiteEvalTensor* input_box_encodings,
+                 const TfLiteEvalTensor* input_anchors)
+      : box_encodings_(
+            tflite::micro::GetTensorData<float>(input_box_encodings)),
+        box_encoding_stride_(input_box_encodings->dims->data[2]),
+        anchors_(ReInterpretTensor<const CenterSizeEncoding*>(input_anchors)),
+        scale_values_(op_data->scale_values),
+        decoded_boxes_(reinterpret_cast<float*>(
+            context->GetScratchBuffer(context, op_data->decoded_boxes_idx))),
+        is_decoded_(reinterpret_cast<uint8_t*>(context->GetScratchBuffer(
+            context, op_data->active_candidate_idx))) {
+    memset(is_decoded_, 0, input_box_encodings->dims->data[1]);
+  }
+
+  // Decodes box idx if it has not been decoded yet. Returns false if the box is
+  // invalid, i.e. ymin >= ymax or xmin >= xmax.
+  bool Decode(int idx) {
+    auto* boxes = reinterpret_cast<BoxCornerEncoding*>(decoded_boxes_);
+    if (!is_decoded_[idx]) {
+      const CenterSizeEncoding& box_centersize =
+          *reinterpret_cast<const CenterSizeEncoding*>(
+              &box_encodings_[idx * box_encoding_stride_]);
+      boxes[idx] =
+          DecodeCenterSizeBox(box_centersize, anchors_[idx], scale_values_);
+      is_decoded_[idx] = 1;
+    }
+    return ValidateBoxes(decoded_boxes_ + idx * kNumCoordBox, 1);
+  }
+
+  const float* decoded_boxes() const { return decoded_boxes_; }
+
+ private:
+  const float* box_encodings_;
+  const int box_encoding_stride_;
+  const CenterSizeEncoding* anchors_;
+  const CenterSizeEncoding scale_values_;
+  float* decoded_boxes_;
+  uint8_t* is_decoded_;
+};
+
 void DecreasingPartialArgSort(const float* values, int num_values,
                               int num_to_sort, int* indices) {
   std::iota(indices, indices + num_values, 0);
@@ -391,17 +459,6 @@ int SelectDetectionsAboveScoreThreshold(const float* values, int size,
   return counter;
 }
 
-bool ValidateBoxes(const float* decoded_boxes, const int num_boxes) {
-  for (int i = 0; i < num_boxes; ++i) {
-    // ymax>=ymin, xmax>=xmin
-    auto& box = reinterpret_cast<const BoxCornerEncoding*>(decoded_boxes)[i];
-    if (box.ymin >= box.ymax || box.xmin >= box.xmax) {
-      return false;
-    }
-  }
-  return true;
-}
-
 float ComputeIntersectionOverUnion(const float* decoded_boxes, const int i,
                                    const int j) {
   auto& box_i = reinterpret_cast<const BoxCornerEncoding*>(decoded_boxes)[i];
@@ -507,6 +564,68 @@ TfLiteStatus NonMaxSuppressionSingleClassHelper(
   return kTfLiteOk;
 }
 
+// Produces the same selection as NonMaxSuppressionSingleClassHelper() without
+// its O(N^2) pairwise comparisons:
+// 1) scores are thresholded before any box is decoded,
+// 2) the surviving candidates are put in a max-heap and popped in the order of
+//    the stable decreasing sort of the reference, ties going to the lower box
+//    index, so only as many candidates as NMS consumes are ever ordered,
+// 3) each popped candidate is decoded and compared only against the boxes
+//    selected so far, since a box suppressed by a selected box can not
+//    suppress anything itself, and
+// 4) the search stops as soon as max_detections boxes are selected.
+// Worst case is O(N log N + N * max_detections). Only decoded boxes are
+// validated.
+TfLiteStatus FastNonMaxSuppressionSingleClassHelper(
+    TfLiteContext* context, OpData* op_data, LazyBoxDecoder* decoder,
+    const float* scores, int num_boxes, int* selected, int* selected_size,
+    int max_detections) {
+  const float non_max_suppression_score_threshold =
+      op_data->non_max_suppression_score_threshold;
+  const float intersection_over_union_threshold =
+      op_data->intersection_over_union_threshold;
+  // Maximum detections should be positive.
+  TF_LITE_ENSURE(context, (max_detections >= 0));
+  // intersection_over_union_threshold should be positive
+  // and should be less than 1.
+  TF_LITE_ENSURE(context, (intersection_over_union_threshold > 0.0f) &&
+                              (intersection_over_union_threshold <= 1.0f));
+
+  int* candidates = reinterpret_cast<int*>(
+      context->GetScratchBuffer(context, op_data->keep_indices_idx));
+  int num_candidates = 0;
+  for (int i = 0; i < num_boxes; i++) {
+    if (scores[i] >= non_max_suppression_score_threshold) {
+      candidates[num_candidates++] = i;
+    }
+  }
+
+  auto lower_priority = [scores](const int i, const int j) {
+    return scores[i] < scores[j] || (scores[i] == scores[j] && i > j);
+  };
+  std::make_heap(candidates, candidates + num_candidates, lower_priority);
+
+  *selected_size = 0;
+  while (num_candidates > 0 && *selected_size < max_detections) {
+    std::pop_heap(candidates, candidates + num_candidates, lower_priority);
+    const int candidate = candidates[--num_candidates];
+    TF_LITE_ENSURE(context, decoder->Decode(candidate));
+
+    bool suppressed = false;
+    for (int i = 0; i < *selected_size && !suppressed; ++i) {
+      suppressed =
+          ComputeIntersectionOverUnion(decoder->decoded_boxes(), selected[i],
+                                       candidate) >
+          intersection_over_union_threshold;
+    }
+    if (!suppressed) {
+      selected[(*selected_size)++] = candidate;
+    }
+  }
+
+  return kTfLiteOk;
+}
+
 // This function implements a regular version of Non Maximal Suppression (NMS)
 // for multiple classes where
 // 1) we do NMS separately for each class across all anchors and
@@ -514,9 +633,13 @@ TfLiteStatus NonMaxSuppressionSingleClassHelper(
 // 3) The worst runtime of the regular NMS is O(K*N^2)
 // where N is the number of anchors and K the number of
 // classes.
+//
+// Boxes are decoded up front by the caller when decoder is nullptr, and on
+// demand by the fast single class NMS otherwise.
 TfLiteStatus NonMaxSuppressionMultiClassRegularHelper(TfLiteContext* context,
                                                       TfLiteNode* node,
                                                       OpData* op_data,
+                                                      LazyBoxDecoder* decoder,
                                                       const float* scores) {
   const TfLiteEvalTensor* input_box_encodings =
       tflite::micro::GetEvalInput(context, node, kInputTensorBoxEncodings);
@@ -566,9 +689,15 @@ TfLiteStatus NonMaxSuppressionMultiClassRegularHelper(TfLiteContext* context,
     int selected_size = 0;
     int* selected = reinterpret_cast<int*>(
         context->GetScratchBuffer(context, op_data->selected_idx));
-    TF_LITE_ENSURE_STATUS(NonMaxSuppressionSingleClassHelper(
-        context, node, op_data, class_scores, selected, &selected_size,
-        num_detections_per_class));
+    if (decoder == nullptr) {
+      TF_LITE_ENSURE_STATUS(NonMaxSuppressionSingleClassHelper(
+          context, node, op_data, class_scores, selected, &selected_size,
+          num_detections_per_class));
+    } else {
+      TF_LITE_ENSURE_STATUS(FastNonMaxSuppressionSingleClassHelper(
+          context, op_data, decoder, class_scores, num_boxes, selected,
+          &selected_size, num_detections_per_class));
+    }
     // Add selected indices from non-max suppression of boxes in this class
     int output_index = size_of_sorted_indices;
     for (int i = 0; i < selected_size; i++) {
@@ -647,9 +776,13 @@ TfLiteStatus NonMaxSuppressionMultiClassRegularHelper(TfLiteContext* context,
 // 3) Compared to standard NMS, the worst runtime of this version is O(N^2)
 // instead of O(KN^2) where N is the number of anchors and K the number of
 // classes.
+//
+// When decoder is not nullptr, boxes are decoded on demand and the classes of
+// an anchor are only sorted once the anchor has been selected.
 TfLiteStatus NonMaxSuppressionMultiClassFastHelper(TfLiteContext* context,
                                                    TfLiteNode* node,
                                                    OpData* op_data,
+                                                   LazyBoxDecoder* decoder,
                                                    const float* scores) {
   const TfLiteEvalTensor* input_box_encodings =
       tflite::micro::GetEvalInput(context, node, kInputTensorBoxEncodings);
@@ -684,19 +817,40 @@ TfLiteStatus NonMaxSuppressionMultiClassFastHelper(TfLiteContext* context,
   for (int row = 0; row < num_boxes; row++) {
     const float* box_scores =
         scores + row * num_classes_with_background + label_offset;
-    int* class_indices = sorted_class_indices + row * num_classes;
-    DecreasingPartialArgSort(box_scores, num_classes, num_categories_per_anchor,
-                             class_indices);
-    max_scores[row] = box_scores[class_indices[0]];
+    if (decoder == nullptr) {
+      int* class_indices = sorted_class_indices + row * num_classes;
+      DecreasingPartialArgSort(box_scores, num_classes,
+                               num_categories_per_anchor, class_indices);
+      max_scores[row] = box_scores[class_indices[0]];
+    } else {
+      float max_score = box_scores[0];
+      for (int col = 1; col < num_classes; ++col) {
+        max_score = std::max(max_score, box_scores[col]);
+      }
+      max_scores[row] = max_score;
+    }
   }
 
   // Perform non-maximal suppression on max scores
   int selected_size = 0;
   int* selected = reinterpret_cast<int*>(
       context->GetScratchBuffer(context, op_data->selected_idx));
-  TF_LITE_ENSURE_STATUS(NonMaxSuppressionSingleClassHelper(
-      context, node, op_data, max_scores, selected, &selected_size,
-      op_data->max_detections));
+  if (decoder == nullptr) {
+    TF_LITE_ENSURE_STATUS(NonMaxSuppressionSingleClassHelper(
+        context, node, op_data, max_scores, selected, &selected_size,
+        op_data->max_detections));
+  } else {
+    TF_LITE_ENSURE_STATUS(FastNonMaxSuppressionSingleClassHelper(
+        context, op_data, decoder, max_scores, num_boxes, selected,
+        &selected_size, op_data->max_detections));
+    for (int i = 0; i < selected_size; i++) {
+      const int row = selected[i];
+      DecreasingPartialArgSort(
+          scores + row * num_classes_with_background + label_offset,
+          num_classes, num_categories_per_anchor,
+          sorted_class_indices + row * num_classes);
+    }
+  }
 
   // Allocate output tensors
   int output_box_index = 0;
@@ -735,7 +889,8 @@ TfLiteStatus NonMaxSuppressionMultiClassFastHelper(TfLiteContext* context,
 }
 
 TfLiteStatus NonMaxSuppressionMultiClass(TfLiteContext* context,
-                                         TfLiteNode* node, OpData* op_data) {
+                                         TfLiteNode* node, OpData* op_data,
+                                         LazyBoxDecoder* decoder) {
   // Get the input tensors
   const TfLiteEvalTensor* input_box_encodings =
       tflite::micro::GetEvalInput(context, node, kInputTensorBoxEncodings);
@@ -765,16 +920,19 @@ TfLiteStatus NonMaxSuppressionMultiClass(TfLiteContext* context,
 
   if (op_data->use_regular_non_max_suppression) {
     TF_LITE_ENSURE_STATUS(NonMaxSuppressionMultiClassRegularHelper(
-        context, node, op_data, scores));
+        context, node, op_data, decoder, scores));
   } else {
-    TF_LITE_ENSURE_STATUS(
-        NonMaxSuppressionMultiClassFastHelper(context, node, op_data, scores));
+    TF_LITE_ENSURE_STATUS(NonMaxSuppressionMultiClassFastHelper(
+        context, node, op_data, decoder, scores));
   }
 
   return kTfLiteOk;
 }
 
-TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
+// Reference implementation: decodes every box, then runs NMS with a full sort
+// of the candidates and O(N^2) pairwise IoU checks. Kept for bit-exact
+// comparison with Eval().
+TfLiteStatus EvalReference(TfLiteContext* context, TfLiteNode* node) {
   TF_LITE_ENSURE(context, (kBatchSize == 1));
   auto* op_data = static_cast<OpData*>(node->user_data);
 
@@ -793,7 +951,30 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
   // by choosing effective set of decoded boxes
   // based on Non Maximal Suppression, i.e. selecting
   // highest scoring non-overlapping boxes.
-  TF_LITE_ENSURE_STATUS(NonMaxSuppressionMultiClass(context, node, op_data));
+  TF_LITE_ENSURE_STATUS(
+      NonMaxSuppressionMultiClass(context, node, op_data, nullptr));
+
+  return kTfLiteOk;
+}
+
+// Produces the same outputs as EvalReference(), but only decodes the boxes
+// that NMS actually looks at, see FastNonMaxSuppressionSingleClassHelper().
+TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
+  TF_LITE_ENSURE(context, (kBatchSize == 1));
+  auto* op_data = static_cast<OpData*>(node->user_data);
+
+  const TfLiteEvalTensor* input_box_encodings =
+      tflite::micro::GetEvalInput(context, node, kInputTensorBoxEncodings);
+  const TfLiteEvalTensor* input_anchors =
+      tflite::micro::GetEvalInput(context, node, kInputTensorAnchors);
+  TF_LITE_ENSURE_EQ(context, input_box_encodings->dims->data[0], kBatchSize);
+  TF_LITE_ENSURE(context, input_box_encodings->dims->data[2] >= kNumCoordBox);
+  // Please see DequantizeBoxEncodings function for the support detail.
+  TF_LITE_ENSURE_TYPES_EQ(context, input_box_encodings->type, kTfLiteFloat32);
+
+  LazyBoxDecoder decoder(context, op_data, input_box_encodings, input_anchors);
+  TF_LITE_ENSURE_STATUS(
+      NonMaxSuppressionMultiClass(context, node, op_data, &decoder));
 
   return kTfLiteOk;
 }
@@ -804,4 +985,10 @@ TfLiteRegistration* Register_DETECTION_POSTPROCESS() {
   return &r;
 }
 
+TfLiteRegistration* Register_DETECTION_POSTPROCESS_REFERENCE() {
+  static TfLiteRegistration r =
+      tflite::micro::RegisterOp(Init, Prepare, EvalReference);
+  return &r;
+}
+
 }  // namespace tflite
@@ -17,6 +17,7 @@ limitations under the License.
 #include "tensorflow/lite/c/builtin_op_data.h"
 #include "tensorflow/lite/c/common.h"
 #include "tensorflow/lite/micro/kernels/kernel_runner.h"
+#include "tensorflow/lite/micro/micro_mutable_op_resolver.h"
 #include "tensorflow/lite/micro/test_helpers.h"
 #include "tensorflow/lite/micro/testing/micro_test.h"
 
@@ -157,6 +158,66 @@ void TestDetectionPostprocess(int* input_dims_data1, const float* input_data1,
     TF_LITE_MICRO_EXPECT_NEAR(golden4[i], output_data4[i], tolerance);
   }
 }
+
+// Runs Register_DETECTION_POSTPROCESS() and
+// Register_DETECTION_POSTPROCESS_REFERENCE() on the same inputs and expects
+// bit-exact outputs.
+void TestDetectionPostprocessMatchesReference(
+    int* input_dims_data1, const float* input_data1, int* input_dims_data2,
+    const float* input_data2, int* input_dims_data3, const float* input_data3,
+    bool use_regular_nms) {
+  constexpr int kMaxDetections = 3;
+  int output_dims_data1[] = {3, 1, kMaxDetections, 4};
+  int output_dims_data2[] = {2, 1, kMaxDetections};
+  int output_dims_data4[] = {1, 1};
+  float outputs[2][kMaxDetections * 4 + kMaxDetections * 2 + 1];
+
+  const TfLiteRegistration* registrations[] = {
+      Register_DETECTION_POSTPROCESS(),
+      Register_DETECTION_POSTPROCESS_REFERENCE()};
+  for (int r = 0; r < 2; ++r) {
+    float* output_data1 = outputs[r];
+    float* output_data2 = output_data1 + kMaxDetections * 4;
+    float* output_data3 = output_data2 + kMaxDetections;
+    float* output_data4 = output_data3 + kMaxDetections;
+
+    constexpr int tensors_size = 7;
+    TfLiteTensor tensors[tensors_size];
+    tensors[0] = CreateTensor(input_data1, IntArrayFromInts(input_dims_data1));
+    tensors[1] = CreateTensor(input_data2, IntArrayFromInts(input_dims_data2));
+    tensors[2] = CreateTensor(input_data3, IntArrayFromInts(input_dims_data3));
+    tensors[3] =
+        CreateTensor(output_data1, IntArrayFromInts(output_dims_data1));
+    tensors[4] =
+        CreateTensor(output_data2, IntArrayFromInts(output_dims_data2));
+    tensors[5] =
+        CreateTensor(output_data3, IntArrayFromInts(output_dims_data2));
+    tensors[6] =
+        CreateTensor(output_data4, IntArrayFromInts(output_dims_data4));
+
+    int inputs_array_data[] = {3, 0, 1, 2};
+    TfLiteIntArray* inputs_array = IntArrayFromInts(inputs_array_data);
+    int outputs_array_data[] = {4, 3, 4, 5, 6};
+    TfLiteIntArray* outputs_array = IntArrayFromInts(outputs_array_data);
+
+    micro::KernelRunner runner(*registrations[r], tensors, tensors_size,
+                               inputs_array, outputs_array, nullptr);
+
+    const unsigned char* init_data =
+        use_regular_nms ? g_gen_data_regular_nms : g_gen_data_none_regular_nms;
+    const int data_size = use_regular_nms ? g_gen_data_size_regular_nms
+                                          : g_gen_data_size_none_regular_nms;
+    TF_LITE_MICRO_EXPECT_EQ(
+        kTfLiteOk,
+        runner.InitAndPrepare(reinterpret_cast<const char*>(init_data),
+                              data_size));
+    TF_LITE_MICRO_EXPECT_EQ(kTfLiteOk, runner.Invoke());
+  }
+
+  for (int i = 0; i < kMaxDetections * 6 + 1; ++i) {
+    TF_LITE_MICRO_EXPECT_EQ(outputs[1][i], outputs[0][i]);
+  }
+}
 }  // namespace
 }  // namespace testing
 }  // namespace tflite
@@ -338,4 +399,38 @@ TF_LITE_MICRO_TEST(
       /* tolerance */ 3e-1, /* Use regular NMS: */ false);
 }
 
+TF_LITE_MICRO_TEST(DetectionPostprocessFloatMatchesReference) {
+  // Many overlapping anchors with tied scores, so that NMS has to suppress
+  // boxes and break ties the same way as the reference.
+  constexpr int kNumBoxes = 64;
+  constexpr int kNumClassesWithBackground = 3;
+  int input_shape1[] = {3, 1, kNumBoxes, 4};
+  int input_shape2[] = {3, 1, kNumBoxes, kNumClassesWithBackground};
+  int input_shape3[] = {2, kNumBoxes, 4};
+  float box_encodings[kNumBoxes * 4];
+  float class_predictions[kNumBoxes * kNumClassesWithBackground];
+  float anchors[kNumBoxes * 4];
+  for (int i = 0; i < kNumBoxes; ++i) {
+    box_encodings[i * 4 + 0] = 0.1f * (i % 3);
+    box_encodings[i * 4 + 1] = -0.1f * (i % 5);
+    box_encodings[i * 4 + 2] = 0.05f * (i % 4);
+    box_encodings[i * 4 + 3] = 0.0f;
+    anchors[i * 4 + 0] = 0.5f + 0.25f * (i % 4);
+    anchors[i * 4 + 1] = 0.5f + 0.25f * (i % 7);
+    anchors[i * 4 + 2] = 1.0f;
+    anchors[i * 4 + 3] = 1.0f;
+    class_predictions[i * kNumClassesWithBackground] = 0.0f;
+    for (int c = 1; c < kNumClassesWithBackground; ++c) {
+      class_predictions[i * kNumClassesWithBackground + c] =
+          static_cast<float>((i * 7 + c * 13) % 20) / 20.0f;
+    }
+  }
+
+  for (bool use_regular_nms : {false, true}) {
+    tflite::testing::TestDetectionPostprocessMatchesReference(
+        input_shape1, box_encodings, input_shape2, class_predictions,
+        input_shape3, anchors, use_regular_nms);
+  }
+}
+
 TF_LITE_MICRO_TESTS_END
@@ -25,7 +25,7 @@ limitations under the License.
 #include "tensorflow/lite/kernels/internal/types.h"
 #include "tensorflow/lite/kernels/kernel_util.h"
 #include "tensorflow/lite/micro/kernels/kernel_util.h"
-#include "tensorflow/lite/micro/micro_error_reporter.h"
+#include "tensorflow/lite/micro/kernels/lut_activation.h"
 
 namespace tflite {
 namespace {
@@ -38,45 +38,36 @@ constexpr int kOutputTensor = 0;
 // of the activation ops below.
 
 struct OpData {
-  int8_t table[256];
+  const int8_t* table;
 };
 
 using TransformFunc = float (*)(float);
 
-template <typename T>
-void PopulateLookupTable(const TfLiteTensor* input, const TfLiteTensor* output,
-                         const TransformFunc transform, OpData* data) {
-  if (sizeof(T) != 1) {
-    MicroPrintf("Lookup table valid only for 8bit");
-    TFLITE_ABORT;
-  }
-
+TfLiteStatus PopulateLookupTable(TfLiteContext* context,
+                                 const TfLiteTensor* input,
+                                 const TfLiteTensor* output,
+                                 const TransformFunc transform, OpData* data) {
+  const float input_scale = input->params.scale;
+  const int32_t input_zero_point = input->params.zero_point;
   const float inverse_scale = 1 / output->params.scale;
-  int32_t maxval = std::numeric_limits<T>::max();
-  int32_t minval = std::numeric_limits<T>::min();
-  for (int32_t val = minval; val <= maxval; ++val) {
-    const float dequantized =
-        input->params.scale * (val - input->params.zero_point);
-    const float transformed = transform(dequantized);
-    const float rescaled = TfLiteRound(transformed * inverse_scale);
-    const int32_t quantized =
-        static_cast<int32_t>(rescaled + output->params.zero_point);
-    data->table[static_cast<uint8_t>(static_cast<T>(val))] =
-        static_cast<T>(std::max(std::min(maxval, quantized), minval));
-  }
-}
-
-// OLD-TODO(b/143696793): move this to optimized_ops.
-void EvalUsingLookupTable(const OpData* data, const TfLiteEvalTensor* input,
-                          TfLiteEvalTensor* output) {
-  const int size = MatchingFlatSize(tflite::micro::GetTensorShape(input),
-                                    tflite::micro::GetTensorShape(output));
-  int8_t* output_data = tflite::micro::GetTensorData<int8_t>(output);
-  const int8_t* input_data = tflite::micro::GetTensorData<int8_t>(input);
-
-  for (int i = 0; i < size; ++i) {
-    output_data[i] = data->table[static_cast<uint8_t>(input_data[i])];
-  }
+  const int32_t output_zero_point = output->params.zero_point;
+  data->table = PopulateInt8Lut(
+      context, [=](const int8_t* input_data, int8_t* output_data, int size) {
+        const int32_t maxval = std::numeric_limits<int8_t>::max();
+        const int32_t minval = std::numeric_limits<int8_t>::min();
+        for (int i = 0; i < size; ++i) {
+          const float dequantized =
+              input_scale * (input_data[i] - input_zero_point);
+          const float transformed = transform(dequantized);
+          const float rescaled = TfLiteRound(transformed * inverse_scale);
+          const int32_t quantized =
+              static_cast<int32_t>(rescaled + output_zero_point);
+          output_data[i] = static_cast<int8_t>(
+              std::max(std::min(maxval, quantized), minval));
+        }
+      });
+  TF_LITE_ENSURE(context, data->table != nullptr);
+  return kTfLiteOk;
 }
 
 TfLiteStatus CalculateOpData(TfLiteContext* context, TfLiteNode* node) {
@@ -98,7 +89,8 @@ TfLiteStatus CalculateOpData(TfLiteContext* context, TfLiteNode* node) {
     TransformFunc transform = [](float value) {
       return value < 0.0f ? std::exp(value) - 1.0f : value;
     };
-    PopulateLookupTable<int8_t>(input, output, transform, data);
+    TF_LITE_ENSURE_OK(context, PopulateLookupTable(context, input, output,
+                                                   transform, data));
   }
   micro_context->DeallocateTempTfLiteTensor(input);
   micro_context->DeallocateTempTfLiteTensor(output);
@@ -132,7 +124,7 @@ TfLiteStatus EluEval(TfLiteContext* context, TfLiteNode* node) {
     }
     case kTfLiteInt8: {
       const OpData* data = static_cast<OpData*>(node->user_data);
-      EvalUsingLookupTable(data, input, output);
+      EvalInt8Lut(data->table, input, output);
       return kTfLiteOk;
     }
     default:
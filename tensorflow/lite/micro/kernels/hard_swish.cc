@@ -25,6 +25,7 @@ limitations under the License.
 #include "tensorflow/lite/kernels/op_macros.h"
 #include "tensorflow/lite/micro/kernels/hard_swish.h"
 #include "tensorflow/lite/micro/kernels/kernel_util.h"
+#include "tensorflow/lite/micro/kernels/lut_activation.h"
 #include "tensorflow/lite/micro/micro_error_reporter.h"
 #include "tensorflow/lite/micro/micro_utils.h"
 
@@ -32,7 +33,7 @@ namespace tflite {
 namespace {
 void* HardSwishInit(TfLiteContext* context, const char* buffer, size_t length) {
   TFLITE_DCHECK(context->AllocatePersistentBuffer != nullptr);
-  return context->AllocatePersistentBuffer(context, sizeof(HardSwishParams));
+  return context->AllocatePersistentBuffer(context, sizeof(OpDataHardSwish));
 }
 
 TfLiteStatus HardSwishEval(TfLiteContext* context, TfLiteNode* node) {
@@ -40,7 +41,9 @@ TfLiteStatus HardSwishEval(TfLiteContext* context, TfLiteNode* node) {
       tflite::micro::GetEvalInput(context, node, kHardSwishInputTensor);
   TfLiteEvalTensor* output =
       tflite::micro::GetEvalOutput(context, node, kHardSwishOutputTensor);
-  HardSwishParams* params = static_cast<HardSwishParams*>(node->user_data);
+  TFLITE_DCHECK(node->user_data != nullptr);
+  const OpDataHardSwish* data =
+      static_cast<const OpDataHardSwish*>(node->user_data);
 
   switch (input->type) {
     case kTfLiteFloat32: {
@@ -51,11 +54,7 @@ TfLiteStatus HardSwishEval(TfLiteContext* context, TfLiteNode* node) {
           tflite::micro::GetTensorData<float>(output));
     } break;
     case kTfLiteInt8: {
-      tflite::reference_ops::HardSwish<int8_t>(
-          *params, tflite::micro::GetTensorShape(input),
-          tflite::micro::GetTensorData<int8_t>(input),
-          tflite::micro::GetTensorShape(output),
-          tflite::micro::GetTensorData<int8_t>(output));
+      EvalInt8Lut(data->int8_lut, input, output);
     } break;
     default: {
       MicroPrintf("Unsupported type %s", TfLiteTypeGetName(input->type));
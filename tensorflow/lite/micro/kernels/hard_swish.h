@@ -18,12 +18,19 @@ limitations under the License.
 
 #include "tensorflow/lite/c/builtin_op_data.h"
 #include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/kernels/internal/types.h"
 
 namespace tflite {
 
 extern const int kHardSwishInputTensor;
 extern const int kHardSwishOutputTensor;
 
+struct OpDataHardSwish {
+  HardSwishParams params;
+  // Table of all int8 outputs, only set for int8 inputs.
+  const int8_t* int8_lut;
+};
+
 TfLiteStatus HardSwishPrepare(TfLiteContext* context, TfLiteNode* node);
 }  // namespace tflite
 
@@ -24,6 +24,7 @@ limitations under the License.
 #include "tensorflow/lite/kernels/op_macros.h"
 #include "tensorflow/lite/micro/kernels/hard_swish.h"
 #include "tensorflow/lite/micro/kernels/kernel_util.h"
+#include "tensorflow/lite/micro/kernels/lut_activation.h"
 #include "tensorflow/lite/micro/micro_utils.h"
 
 namespace tflite {
@@ -35,6 +36,9 @@ TfLiteStatus HardSwishPrepare(TfLiteContext* context, TfLiteNode* node) {
   MicroContext* micro_context = GetMicroContext(context);
 
   TFLITE_DCHECK(node->user_data != nullptr);
+  OpDataHardSwish* data = static_cast<OpDataHardSwish*>(node->user_data);
+  data->int8_lut = nullptr;
+
   TF_LITE_ENSURE_EQ(context, NumInputs(node), 1);
   TF_LITE_ENSURE_EQ(context, NumOutputs(node), 1);
 
@@ -46,7 +50,7 @@ TfLiteStatus HardSwishPrepare(TfLiteContext* context, TfLiteNode* node) {
   TF_LITE_ENSURE(context, output != nullptr);
 
   if (input->type == kTfLiteInt8) {
-    HardSwishParams* params = static_cast<HardSwishParams*>(node->user_data);
+    HardSwishParams* params = &data->params;
 
     params->input_zero_point = input->params.zero_point;
     params->output_zero_point = output->params.zero_point;
@@ -75,6 +79,16 @@ TfLiteStatus HardSwishPrepare(TfLiteContext* context, TfLiteNode* node) {
     DownScaleInt32ToInt16Multiplier(
         reluish_multiplier_fixedpoint_int32,
         &params->reluish_multiplier_fixedpoint_int16);
+
+    // Cache the reference output for every int8 input; Eval only indexes it.
+    data->int8_lut = PopulateInt8Lut(
+        context,
+        [params](const int8_t* input_data, int8_t* output_data, int size) {
+          const RuntimeShape shape(1, size);
+          reference_ops::HardSwish<int8_t>(*params, shape, input_data, shape,
+                                           output_data);
+        });
+    TF_LITE_ENSURE(context, data->int8_lut != nullptr);
   }
 
   micro_context->DeallocateTempTfLiteTensor(input);
@@ -17,6 +17,8 @@ limitations under the License.
 
 #include "tensorflow/lite/c/builtin_op_data.h"
 #include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/kernels/internal/quantization_util.h"
+#include "tensorflow/lite/kernels/internal/reference/hard_swish.h"
 #include "tensorflow/lite/micro/all_ops_resolver.h"
 #include "tensorflow/lite/micro/kernels/kernel_runner.h"
 #include "tensorflow/lite/micro/test_helpers.h"
@@ -247,6 +249,72 @@ void TestHardSwishFloat(const int size, float* output_data,
   }
 }
 
+// Checks every int8 input against reference_ops::HardSwish<int8_t>, using the
+// same fixed-point parameters that HardSwishPrepare computes.
+void TestHardSwishInt8MatchesReference(float input_min, float input_max,
+                                       float output_min, float output_max) {
+  constexpr int kSize = 256;
+  int8_t input_data[kSize];
+  int8_t output_data[kSize];
+  int8_t expected_data[kSize];
+  for (int i = 0; i < kSize; ++i) {
+    input_data[i] = static_cast<int8_t>(i - 128);
+  }
+
+  const float input_scale = ScaleFromMinMax<int8_t>(input_min, input_max);
+  const int input_zero_point =
+      ZeroPointFromMinMax<int8_t>(input_min, input_max);
+  const float output_scale = ScaleFromMinMax<int8_t>(output_min, output_max);
+  const int output_zero_point =
+      ZeroPointFromMinMax<int8_t>(output_min, output_max);
+
+  int dims_data[] = {1, kSize};
+  TfLiteIntArray* dims = IntArrayFromInts(dims_data);
+  constexpr int tensors_size = 2;
+  TfLiteTensor tensors[tensors_size] = {
+      CreateQuantizedTensor(input_data, dims, input_scale, input_zero_point),
+      CreateQuantizedTensor(output_data, dims, output_scale,
+                            output_zero_point),
+  };
+
+  int inputs_array_data[] = {1, 0};
+  TfLiteIntArray* inputs_array = IntArrayFromInts(inputs_array_data);
+  int outputs_array_data[] = {1, 1};
+  TfLiteIntArray* outputs_array = IntArrayFromInts(outputs_array_data);
+
+  const TfLiteRegistration registration = tflite::Register_HARD_SWISH();
+  micro::KernelRunner runner(registration, tensors, tensors_size, inputs_array,
+                             outputs_array, /*builtin_data=*/nullptr);
+
+  TF_LITE_MICRO_EXPECT_EQ(kTfLiteOk, runner.InitAndPrepare());
+  TF_LITE_MICRO_EXPECT_EQ(kTfLiteOk, runner.Invoke());
+
+  HardSwishParams params;
+  params.input_zero_point = input_zero_point;
+  params.output_zero_point = output_zero_point;
+  const float hires_input_scale = (1.0f / 128.0f) * input_scale;
+  const float reluish_scale = 3.0f / 32768.0f;
+  int32_t output_multiplier_fixedpoint_int32;
+  QuantizeMultiplier(static_cast<double>(hires_input_scale / output_scale),
+                     &output_multiplier_fixedpoint_int32,
+                     &params.output_multiplier_exponent);
+  DownScaleInt32ToInt16Multiplier(output_multiplier_fixedpoint_int32,
+                                  &params.output_multiplier_fixedpoint_int16);
+  int32_t reluish_multiplier_fixedpoint_int32;
+  QuantizeMultiplier(static_cast<double>(hires_input_scale / reluish_scale),
+                     &reluish_multiplier_fixedpoint_int32,
+                     &params.reluish_multiplier_exponent);
+  DownScaleInt32ToInt16Multiplier(reluish_multiplier_fixedpoint_int32,
+                                  &params.reluish_multiplier_fixedpoint_int16);
+  const RuntimeShape shape(1, kSize);
+  reference_ops::HardSwish<int8_t>(params, shape, input_data, shape,
+                                   expected_data);
+
+  for (int i = 0; i < kSize; ++i) {
+    TF_LITE_MICRO_EXPECT_EQ(expected_data[i], output_data[i]);
+  }
+}
+
 }  // namespace
 }  // namespace testing
 }  // namespace tflite
@@ -291,4 +359,10 @@ TF_LITE_MICRO_TEST(SimpleHardSwishTestInt8) {
   }
 }
 
+TF_LITE_MICRO_TEST(HardSwishInt8AllInputsMatchReference) {
+  tflite::testing::TestHardSwishInt8MatchesReference(-5.f, 10.f, -2.f, 1.f);
+  tflite::testing::TestHardSwishInt8MatchesReference(-40.f, 60.f, 0.f, 1.f);
+  tflite::testing::TestHardSwishInt8MatchesReference(-2.f, 1.f, -5.f, 10.f);
+}
+
 TF_LITE_MICRO_TESTS_END
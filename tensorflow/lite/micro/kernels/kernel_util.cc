@@ -34,6 +34,26 @@ int ValidateTensorIndexing(const TfLiteContext* context, int index,
   return -1;
 }
 
+bool ArePlannedAsSlicesOf(const TfLiteContext* context,
+                          const TfLiteIntArray* tensor_indices,
+                          const TfLiteEvalTensor* whole) {
+  const uint8_t* expected_data = whole->data.raw;
+  for (int i = 0; i < tensor_indices->size; ++i) {
+    if (tensor_indices->data[i] == kTfLiteOptionalTensor) {
+      return false;
+    }
+    const TfLiteEvalTensor* part =
+        context->GetEvalTensor(context, tensor_indices->data[i]);
+    size_t part_bytes = 0;
+    if (part->data.raw != expected_data ||
+        TfLiteEvalTensorByteLength(part, &part_bytes) != kTfLiteOk) {
+      return false;
+    }
+    expected_data += part_bytes;
+  }
+  return true;
+}
+
 }  // namespace
 
 TfLiteRegistration RegisterOp(
@@ -110,6 +130,22 @@ PaddingType RuntimePaddingType(TfLitePadding padding) {
   }
 }
 
+bool InputsArePlannedAsSlicesOf(const TfLiteContext* context,
+                                const TfLiteNode* node,
+                                const TfLiteEvalTensor* whole) {
+  TFLITE_DCHECK(context != nullptr);
+  TFLITE_DCHECK(node != nullptr);
+  return ArePlannedAsSlicesOf(context, node->inputs, whole);
+}
+
+bool OutputsArePlannedAsSlicesOf(const TfLiteContext* context,
+                                 const TfLiteNode* node,
+                                 const TfLiteEvalTensor* whole) {
+  TFLITE_DCHECK(context != nullptr);
+  TFLITE_DCHECK(node != nullptr);
+  return ArePlannedAsSlicesOf(context, node->outputs, whole);
+}
+
 // Relocate tensor dims from FlatBuffer to the persistent storage arena.
 // The old dims data is copied to the new storage area.
 // The tensor and eval_tensor must be the same tensor.
@@ -81,6 +81,17 @@ bool HaveSameShapes(const TfLiteEvalTensor* input1,
 
 PaddingType RuntimePaddingType(TfLitePadding padding);
 
+// Returns true if the memory planner laid out the tensors of the node's inputs
+// (or outputs) back to back, in order, over the data of `whole`. This is how
+// CONCATENATION, SPLIT, SPLIT_V and UNPACK are planned when they work along
+// the outermost non-unit axis, and leaves those operators nothing to copy.
+bool InputsArePlannedAsSlicesOf(const TfLiteContext* context,
+                                const TfLiteNode* node,
+                                const TfLiteEvalTensor* whole);
+bool OutputsArePlannedAsSlicesOf(const TfLiteContext* context,
+                                 const TfLiteNode* node,
+                                 const TfLiteEvalTensor* whole);
+
 // Relocate tensor dims from FlatBuffer to the persistent storage arena.
 // The old dims data is copied to the new storage area.
 // The tensor and eval_tensor must be the same tensor.
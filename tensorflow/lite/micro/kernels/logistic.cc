@@ -25,6 +25,7 @@ limitations under the License.
 #include "tensorflow/lite/kernels/op_macros.h"
 #include "tensorflow/lite/micro/kernels/kernel_util.h"
 #include "tensorflow/lite/micro/kernels/logistic.h"
+#include "tensorflow/lite/micro/kernels/lut_activation.h"
 #include "tensorflow/lite/micro/micro_error_reporter.h"
 
 namespace tflite {
@@ -35,6 +36,35 @@ void* LogisticInit(TfLiteContext* context, const char* buffer, size_t length) {
   return context->AllocatePersistentBuffer(context, sizeof(OpDataLogistic));
 }
 
+TfLiteStatus LogisticLutPrepare(TfLiteContext* context, TfLiteNode* node) {
+  TF_LITE_ENSURE_OK(context, LogisticPrepare(context, node));
+
+  OpDataLogistic* data = static_cast<OpDataLogistic*>(node->user_data);
+  data->int8_lut = nullptr;
+
+  MicroContext* micro_context = GetMicroContext(context);
+  TfLiteTensor* input =
+      micro_context->AllocateTempInputTensor(node, kLogisticInputTensor);
+  TF_LITE_ENSURE(context, input != nullptr);
+  const TfLiteType input_type = input->type;
+  micro_context->DeallocateTempTfLiteTensor(input);
+
+  if (input_type == kTfLiteInt8) {
+    // int8 has only 256 possible inputs, so evaluate the reference kernel on
+    // all of them once and turn Eval into a table lookup.
+    data->int8_lut = PopulateInt8Lut(
+        context,
+        [data](const int8_t* input_data, int8_t* output_data, int size) {
+          reference_integer_ops::Logistic(
+              data->input_zero_point, data->input_range_radius,
+              data->input_multiplier, data->input_left_shift, size,
+              input_data, output_data);
+        });
+    TF_LITE_ENSURE(context, data->int8_lut != nullptr);
+  }
+  return kTfLiteOk;
+}
+
 TfLiteStatus LogisticEval(TfLiteContext* context, TfLiteNode* node) {
   const TfLiteEvalTensor* input =
       tflite::micro::GetEvalInput(context, node, kLogisticInputTensor);
@@ -78,12 +108,7 @@ TfLiteStatus LogisticEval(TfLiteContext* context, TfLiteNode* node) {
   } else if (input->type == kTfLiteInt8) {
     switch (output->type) {
       case kTfLiteInt8: {
-        reference_integer_ops::Logistic(
-            data->input_zero_point, data->input_range_radius,
-            data->input_multiplier, data->input_left_shift,
-            NumElements(input->dims),
-            tflite::micro::GetTensorData<int8_t>(input),
-            tflite::micro::GetTensorData<int8_t>(output));
+        EvalInt8Lut(data->int8_lut, input, output);
         return kTfLiteOk;
       }
       default:
@@ -106,6 +131,7 @@ TfLiteStatus LogisticEval(TfLiteContext* context, TfLiteNode* node) {
 }  // namespace
 
 TfLiteRegistration Register_LOGISTIC() {
-  return tflite::micro::RegisterOp(LogisticInit, LogisticPrepare, LogisticEval);
+  return tflite::micro::RegisterOp(LogisticInit, LogisticLutPrepare,
+                                   LogisticEval);
 }
 }  // namespace tflite
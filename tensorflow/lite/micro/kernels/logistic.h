@@ -30,6 +30,9 @@ struct OpDataLogistic {
   int32_t input_range_radius;
   int32_t input_multiplier;
   int input_left_shift;
+  // Table of all int8 outputs, built in Prepare by kernels that evaluate
+  // through it. nullptr otherwise.
+  const int8_t* int8_lut;
 };
 
 TfLiteStatus CalculateArithmeticOpDataLogistic(TfLiteContext* context,
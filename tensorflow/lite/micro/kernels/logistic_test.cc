@@ -15,6 +15,8 @@ limitations under the License.
 
 #include "tensorflow/lite/c/builtin_op_data.h"
 #include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/kernels/internal/quantization_util.h"
+#include "tensorflow/lite/kernels/internal/reference/integer_ops/logistic.h"
 #include "tensorflow/lite/micro/all_ops_resolver.h"
 #include "tensorflow/lite/micro/kernels/kernel_runner.h"
 #include "tensorflow/lite/micro/test_helpers.h"
@@ -205,6 +207,59 @@ void TestLogisticQuantized(int* input_dims_data, const float* input_data,
                           output_elements_count, tolerance);
 }
 
+// Runs the int8 kernel on every representable input and checks that the
+// table built in Prepare matches the reference implementation bit for bit.
+void TestLogisticInt8MatchesReference(const float input_scale,
+                                      const int input_zero_point) {
+  constexpr int kSize = 256;
+  int8_t input_data[kSize];
+  int8_t output_data[kSize];
+  int8_t expected_data[kSize];
+  for (int i = 0; i < kSize; ++i) {
+    input_data[i] = static_cast<int8_t>(i - 128);
+  }
+
+  int dims_data[] = {1, kSize};
+  TfLiteIntArray* dims = IntArrayFromInts(dims_data);
+  constexpr int tensors_size = 2;
+  TfLiteTensor tensors[tensors_size] = {
+      CreateQuantizedTensor(input_data, dims, input_scale, input_zero_point),
+      CreateQuantizedTensor(output_data, dims, quantized_output_scale_int8,
+                            quantized_output_zero_point_int8),
+  };
+
+  int inputs_array_data[] = {1, 0};
+  TfLiteIntArray* inputs_array = IntArrayFromInts(inputs_array_data);
+  int outputs_array_data[] = {1, 1};
+  TfLiteIntArray* outputs_array = IntArrayFromInts(outputs_array_data);
+
+  const TfLiteRegistration registration = tflite::Register_LOGISTIC();
+  micro::KernelRunner runner(registration, tensors, tensors_size, inputs_array,
+                             outputs_array, nullptr);
+
+  TF_LITE_MICRO_EXPECT_EQ(kTfLiteOk, runner.InitAndPrepare());
+  TF_LITE_MICRO_EXPECT_EQ(kTfLiteOk, runner.Invoke());
+
+  // Same parameters as CalculateArithmeticOpDataLogistic.
+  constexpr int kInputIntegerBits = 4;
+  const double input_real_multiplier =
+      static_cast<double>(input_scale) *
+      static_cast<double>(1 << (31 - kInputIntegerBits));
+  int input_left_shift;
+  const double q = std::frexp(input_real_multiplier, &input_left_shift);
+  const int32_t input_multiplier =
+      static_cast<int32_t>(TfLiteRound(q * (1ll << 31)));
+  const int32_t input_range_radius =
+      CalculateInputRadius(kInputIntegerBits, input_left_shift, 31);
+  reference_integer_ops::Logistic(input_zero_point, input_range_radius,
+                                  input_multiplier, input_left_shift, kSize,
+                                  input_data, expected_data);
+
+  for (int i = 0; i < kSize; ++i) {
+    TF_LITE_MICRO_EXPECT_EQ(expected_data[i], output_data[i]);
+  }
+}
+
 }  // namespace
 }  // namespace testing
 }  // namespace tflite
@@ -275,4 +330,10 @@ TF_LITE_MICRO_TEST(LogisticQuantizedInt16ShouldMatchGolden) {
       output_data, 16.0f);
 }
 
+TF_LITE_MICRO_TEST(LogisticQuantizedInt8AllInputsMatchReference) {
+  tflite::testing::TestLogisticInt8MatchesReference(0.1f, 0);
+  tflite::testing::TestLogisticInt8MatchesReference(0.0625f, -17);
+  tflite::testing::TestLogisticInt8MatchesReference(0.5f, 40);
+}
+
 TF_LITE_MICRO_TESTS_END
@@ -101,6 +101,33 @@ void ComputeRowSums(
   }
 }
 
+// Initializes an LSTM gate with its bias (or zero for layer norm LSTM) and
+// adds W_input * input, for n_batch rows of input. This is the part of
+// CalculateLstmGateFloat that does not depend on the recurrent state, so it can
+// also be computed for a whole sequence at once.
+inline void CalculateLstmGateInputFloat(const float* input,
+                                        const float* input_to_gate_weights,
+                                        const float* layer_norm_coefficients,
+                                        const float* gate_bias,
+                                        const int n_batch, const int n_input,
+                                        const int n_cell, float* gate,
+                                        const bool is_input_all_zeros) {
+  // Initialize scratch buffers with bias for regular lstm or initialize with
+  // zero for layer norm lstm.
+  if (layer_norm_coefficients != nullptr) {
+    memset(gate, 0, n_cell * n_batch * sizeof(float));
+  } else {
+    micro_tensor_utils::VectorBatchVectorAssign(gate_bias, n_cell, n_batch,
+                                                gate);
+  }
+  // For each batch and cell: compute input_weight * input.
+  // Skip if input is all zeros.
+  if (!is_input_all_zeros) {
+    micro_tensor_utils::MatrixBatchVectorMultiplyAccumulate(
+        input_to_gate_weights, n_cell, n_input, input, n_batch, gate);
+  }
+}
+
 // Calculates a single LSTM gate.
 //
 // Implements the following formula: (* is matrix multiply)
@@ -125,6 +152,7 @@ void ComputeRowSums(
 //   cell_to_gate_weights      | n_cell               | y (peephole)
 //   gate_bias                 | n_cell               |
 //   layer_norm_coefficients   | n_cell               | y (layer norm)
+//   precomputed_gate          | n_cell               | y (bias + W_input*input)
 // Output vector:
 //   gate                      | n_cell               |
 // Scalar parameters:
@@ -142,23 +170,17 @@ inline void CalculateLstmGateFloat(
     const int n_batch, const int n_input, const int n_aux_input,
     const int n_output, const int n_cell,
     const TfLiteFusedActivation activation, float* gate,
-    const bool is_input_all_zeros, const bool is_aux_input_all_zeros) {
+    const bool is_input_all_zeros, const bool is_aux_input_all_zeros,
+    const float* precomputed_gate) {
   const bool use_peephole = (cell_to_gate_weights != nullptr);
   const bool use_layer_norm = (layer_norm_coefficients != nullptr);
 
-  // Initialize scratch buffers with bias for regular lstm or initialize with
-  // zero for layer norm lstm.
-  if (use_layer_norm) {
-    memset(gate, 0, n_cell * n_batch * sizeof(float));
+  if (precomputed_gate != nullptr) {
+    std::memcpy(gate, precomputed_gate, n_cell * n_batch * sizeof(float));
   } else {
-    micro_tensor_utils::VectorBatchVectorAssign(gate_bias, n_cell, n_batch,
-                                                gate);
-  }
-  // For each batch and cell: compute input_weight * input.
-  // Skip if input is all zeros.
-  if (!is_input_all_zeros) {
-    micro_tensor_utils::MatrixBatchVectorMultiplyAccumulate(
-        input_to_gate_weights, n_cell, n_input, input, n_batch, gate);
+    CalculateLstmGateInputFloat(input, input_to_gate_weights,
+                                layer_norm_coefficients, gate_bias, n_batch,
+                                n_input, n_cell, gate, is_input_all_zeros);
   }
   // For each batch and cell: compute aux_input_weight * aux_input.
   // Skip if auxiliary input is not available or all zeros.
@@ -279,6 +301,48 @@ void CalculateLstmOutputFloat(int n_batch, int n_cell, int n_output,
   }
 }
 
+// Hybrid version of CalculateLstmGateInputFloat, on an already quantized input.
+void CalculateLstmGateInputHybrid(
+    const int8_t* input, const float* input_sf, const int32_t* input_zp,
+    const int8_t* input_to_gate_weights,
+    const uint8_t* input_to_gate_weights_ledger,
+    const float input_to_gate_weights_scale, int32_t* input_to_gate_row_sums,
+    const float* layer_norm_coefficients, const float* gate_bias,
+    const int n_batch, const int n_input, const int n_cell, float* gate,
+    const bool is_input_all_zeros, bool* compute_row_sums,
+    float* scratch0,        // size: n_batch
+    float* scales,          // size: n_batch
+    int32_t* accum_scratch  // For MatrixBatchVectorMultiplyAccumulate
+) {
+  // Initialize scratch buffers with bias for regular lstm or initialize with
+  // zero for layer norm lstm.
+  if (layer_norm_coefficients != nullptr) {
+    memset(gate, 0, n_cell * n_batch * sizeof(float));
+  } else {
+    micro_tensor_utils::VectorBatchVectorAssign(gate_bias, n_cell, n_batch,
+                                                gate);
+  }
+  // For each batch and cell: compute input_weight * input.
+  // Skip if input is all zeros.
+  if (!is_input_all_zeros) {
+    if (input_to_gate_weights_ledger != nullptr) {
+      for (int i = 0; i < n_batch; i++) {
+        scales[i] = input_to_gate_weights_scale * input_sf[i];
+      }
+      micro_tensor_utils::SparseMatrixBatchVectorMultiplyAccumulate(
+          input_to_gate_weights, input_to_gate_weights_ledger, n_cell, n_input,
+          input, scales, n_batch, gate);
+
+    } else {
+      micro_tensor_utils::MatrixBatchVectorMultiplyAccumulate(
+          input_to_gate_weights, n_cell, n_input, input,
+          input_to_gate_weights_scale, input_sf, n_batch, gate,
+          /*per_channel_scale=*/nullptr, input_zp, accum_scratch,
+          input_to_gate_row_sums, compute_row_sums, scratch0, nullptr);
+    }
+  }
+}
+
 // Calculates a single LSTM gate, hybrid version.
 // Implements the same functionality as CalculateLstmGateFloat.
 void CalculateLstmGateHybrid(
@@ -315,38 +379,22 @@ void CalculateLstmGateHybrid(
     // Scratch arrays
     float* scratch0,        // size: n_batch
     float* scratch1,        // size: n_cell, only used if peephole LSTM
-    float* scales,          // size: n_batch
-    int32_t* accum_scratch  // For MatrixBatchVectorMultiplyAccumulate
-) {
+    float* scales,           // size: n_batch
+    int32_t* accum_scratch,  // For MatrixBatchVectorMultiplyAccumulate
+    // Bias and input contribution computed ahead of time (optional)
+    const float* precomputed_gate) {
   const bool use_peephole = (cell_to_gate_weights != nullptr);
   const bool use_layer_norm = (layer_norm_coefficients != nullptr);
 
-  // Initialize scratch buffers with bias for regular lstm or initialize with
-  // zero for layer norm lstm.
-  if (use_layer_norm) {
-    memset(gate, 0, n_cell * n_batch * sizeof(float));
+  if (precomputed_gate != nullptr) {
+    std::memcpy(gate, precomputed_gate, n_cell * n_batch * sizeof(float));
   } else {
-    micro_tensor_utils::VectorBatchVectorAssign(gate_bias, n_cell, n_batch,
-                                                gate);
-  }
-  // For each batch and cell: compute input_weight * input.
-  // Skip if input is all zeros.
-  if (!is_input_all_zeros) {
-    if (input_to_gate_weights_ledger != nullptr) {
-      for (int i = 0; i < n_batch; i++) {
-        scales[i] = input_to_gate_weights_scale * input_sf[i];
-      }
-      micro_tensor_utils::SparseMatrixBatchVectorMultiplyAccumulate(
-          input_to_gate_weights, input_to_gate_weights_ledger, n_cell, n_input,
-          input, scales, n_batch, gate);
-
-    } else {
-      micro_tensor_utils::MatrixBatchVectorMultiplyAccumulate(
-          input_to_gate_weights, n_cell, n_input, input,
-          input_to_gate_weights_scale, input_sf, n_batch, gate,
-          /*per_channel_scale=*/nullptr, input_zp, accum_scratch,
-          input_to_gate_row_sums, compute_row_sums, scratch0, nullptr);
-    }
+    CalculateLstmGateInputHybrid(
+        input, input_sf, input_zp, input_to_gate_weights,
+        input_to_gate_weights_ledger, input_to_gate_weights_scale,
+        input_to_gate_row_sums, layer_norm_coefficients, gate_bias, n_batch,
+        n_input, n_cell, gate, is_input_all_zeros, compute_row_sums, scratch0,
+        scales, accum_scratch);
   }
   // For each batch and cell: compute aux_input_weight * aux_input.
   // Skip if auxiliary input is not available or all zeros.
@@ -468,6 +516,23 @@ void CalculateLstmOutputHybrid(
   }
 }
 
+// Int8x8_16 version of CalculateLstmGateInputFloat. The zero point of the input
+// is folded into input_to_gate_bias.
+void CalculateLstmGateInputInteger8x8_16(
+    const int8_t* input, const int8_t* input_to_gate_weights,
+    const int32_t* input_to_gate_bias, const int32_t input_to_gate_scale_a,
+    const int32_t input_to_gate_scale_b, const int n_batch, const int n_input,
+    const int n_cell, int16_t* gate, int32_t* scratch5) {
+  // Initialize scratch buffers with zeros. Note that unlike float and hybrid
+  // versions, bias is only used in layer normalization.
+  memset(gate, 0, n_batch * n_cell * sizeof(int16_t));
+  // For each batch and cell: compute input_weight * input.
+  micro_tensor_utils::MatrixBatchVectorMultiplyAccumulate(
+      input, input_to_gate_bias, input_to_gate_weights, input_to_gate_scale_a,
+      input_to_gate_scale_b, n_batch, n_input, n_cell, 0, scratch5, gate,
+      nullptr);
+}
+
 // Calculates a single LSTM gate, int8x8_16 version.
 // Implements the same functionality as CalculateLstmGateFloat.
 void CalculateLstmGateInteger8x8_16(
@@ -495,18 +560,19 @@ void CalculateLstmGateInteger8x8_16(
     int16_t* gate,
     // Parameters for performance optimizations
     // Scratch arrays
-    int32_t* scratch5) {
+    int32_t* scratch5,
+    // Input contribution computed ahead of time (optional)
+    const int16_t* precomputed_gate) {
   const bool use_peephole = (cell_to_gate_weights != nullptr);
   const bool use_layer_norm = (layer_norm_coefficients != nullptr);
 
-  // Initialize scratch buffers with zeros. Note that unlike float and hybrid
-  // versions, bias is only used in layer normalization.
-  memset(gate, 0, n_batch * n_cell * sizeof(int16_t));
-  // For each batch and cell: compute input_weight * input.
-  micro_tensor_utils::MatrixBatchVectorMultiplyAccumulate(
-      input, input_to_gate_bias, input_to_gate_weights, input_to_gate_scale_a,
-      input_to_gate_scale_b, n_batch, n_input, n_cell, 0, scratch5, gate,
-      nullptr);
+  if (precomputed_gate != nullptr) {
+    std::memcpy(gate, precomputed_gate, n_batch * n_cell * sizeof(int16_t));
+  } else {
+    CalculateLstmGateInputInteger8x8_16(
+        input, input_to_gate_weights, input_to_gate_bias, input_to_gate_scale_a,
+        input_to_gate_scale_b, n_batch, n_input, n_cell, gate, scratch5);
+  }
   // Note: no aux_input.
 
   // For each batch and cell: compute recurrent_weight * output_state.
@@ -726,6 +792,30 @@ void CalculateLstmOutputInteger8x8_8(
   }
 }
 
+// Splits a buffer of gate inputs precomputed for a whole sequence into the
+// blocks of the individual gates. The blocks are `gate_stride` elements apart
+// and ordered forget, cell, output and, unless CIFG, input. All pointers are
+// null if there is no such buffer.
+template <typename T>
+void GetPrecomputedInputGates(const T* precomputed_input_gates,
+                              int gate_stride, bool use_cifg,
+                              const T** input_gate, const T** forget_gate,
+                              const T** cell_gate, const T** output_gate) {
+  *input_gate = nullptr;
+  *forget_gate = nullptr;
+  *cell_gate = nullptr;
+  *output_gate = nullptr;
+  if (precomputed_input_gates == nullptr) {
+    return;
+  }
+  *forget_gate = precomputed_input_gates;
+  *cell_gate = precomputed_input_gates + gate_stride;
+  *output_gate = precomputed_input_gates + 2 * gate_stride;
+  if (!use_cifg) {
+    *input_gate = precomputed_input_gates + 3 * gate_stride;
+  }
+}
+
 // Performs an LSTM batch inference step for input specified by input_ptr.
 // The LSTM cell is specified by the pointers to its weights (*_weights_ptr) and
 // biases (*_bias_ptr), and buffers (*_scratch), along with additional
@@ -815,7 +905,8 @@ inline void LstmStepFloat(
     const TfLiteLSTMParams* params, int n_batch, int n_cell, int n_input,
     int n_aux_input, int n_output, int output_batch_leading_dim,
     float* output_state_ptr, float* cell_state_ptr, float* scratch0,
-    float* scratch1, float* scratch2, float* scratch3, float* output_ptr) {
+    float* scratch1, float* scratch2, float* scratch3, float* output_ptr,
+    const float* precomputed_input_gates, int precomputed_gate_stride) {
   // Since we have already checked that weights are all there or none, we can
   // check the existence of only one to the get the condition.
   const bool use_cifg = (input_to_input_weights_ptr == nullptr);
@@ -826,6 +917,15 @@ inline void LstmStepFloat(
   float* cell_gate_scratch = scratch2;
   float* output_gate_scratch = scratch3;
 
+  const float* precomputed_input_gate;
+  const float* precomputed_forget_gate;
+  const float* precomputed_cell_gate;
+  const float* precomputed_output_gate;
+  GetPrecomputedInputGates(precomputed_input_gates, precomputed_gate_stride,
+                           use_cifg, &precomputed_input_gate,
+                           &precomputed_forget_gate, &precomputed_cell_gate,
+                           &precomputed_output_gate);
+
   // Check if inputs are all zeros so we can skip some computations.
   const bool is_input_all_zeros =
       micro_tensor_utils::IsZeroVector(input_ptr, n_batch * n_input);
@@ -841,7 +941,7 @@ inline void LstmStepFloat(
         cell_to_input_weights_ptr, input_layer_norm_coefficients_ptr,
         input_gate_bias_ptr, n_batch, n_input, n_aux_input, n_output, n_cell,
         /*activation=*/kTfLiteActSigmoid, input_gate_scratch,
-        is_input_all_zeros, is_aux_input_all_zeros);
+        is_input_all_zeros, is_aux_input_all_zeros, precomputed_input_gate);
   }
   // Calculate the forget gate.
   CalculateLstmGateFloat(
@@ -851,7 +951,7 @@ inline void LstmStepFloat(
       cell_to_forget_weights_ptr, forget_layer_norm_coefficients_ptr,
       forget_gate_bias_ptr, n_batch, n_input, n_aux_input, n_output, n_cell,
       /*activation=*/kTfLiteActSigmoid, forget_gate_scratch, is_input_all_zeros,
-      is_aux_input_all_zeros);
+      is_aux_input_all_zeros, precomputed_forget_gate);
   // Calculate the cell update gate.
   CalculateLstmGateFloat(input_ptr, input_to_cell_weights_ptr, aux_input_ptr,
                          aux_input_to_cell_weights_ptr, output_state_ptr,
@@ -860,7 +960,8 @@ inline void LstmStepFloat(
                          cell_layer_norm_coefficients_ptr, cell_gate_bias_ptr,
                          n_batch, n_input, n_aux_input, n_output, n_cell,
                          params->activation, cell_gate_scratch,
-                         is_input_all_zeros, is_aux_input_all_zeros);
+                         is_input_all_zeros, is_aux_input_all_zeros,
+                         precomputed_cell_gate);
   // Update the cell state.
   UpdateLstmCellFloat(n_batch, n_cell, cell_state_ptr, input_gate_scratch,
                       forget_gate_scratch, cell_gate_scratch, use_cifg,
@@ -873,7 +974,7 @@ inline void LstmStepFloat(
       cell_to_output_weights_ptr, output_layer_norm_coefficients_ptr,
       output_gate_bias_ptr, n_batch, n_input, n_aux_input, n_output, n_cell,
       /*activation=*/kTfLiteActSigmoid, output_gate_scratch, is_input_all_zeros,
-      is_aux_input_all_zeros);
+      is_aux_input_all_zeros, precomputed_output_gate);
   // Update the output state.
   CalculateLstmOutputFloat(n_batch, n_cell, n_output, cell_state_ptr,
                            output_gate_scratch, params->activation,
@@ -1012,7 +1113,8 @@ inline void LstmStepHybrid(
     float* output_state_ptr, float* cell_state_ptr, int32_t* accum_scratch_ptr,
     float* output_ptr, int32_t* input_zp, int32_t* aux_input_zp,
     int32_t* output_state_zp, int32_t* row_sums, int row_sums_size,
-    bool* compute_row_sums, bool asymmetric_quantize_inputs) {
+    bool* compute_row_sums, bool asymmetric_quantize_inputs,
+    const float* precomputed_input_gates, int precomputed_gate_stride) {
   // Since we have already checked that weights are all there or none, we
   // can check the existence of only one to the get the condition.
   const bool use_cifg = (input_to_input_weights_ptr == nullptr);
@@ -1022,6 +1124,15 @@ inline void LstmStepHybrid(
   float* cell_gate_scratch = scratch2;
   float* output_gate_scratch = scratch3;
 
+  const float* precomputed_input_gate;
+  const float* precomputed_forget_gate;
+  const float* precomputed_cell_gate;
+  const float* precomputed_output_gate;
+  GetPrecomputedInputGates(precomputed_input_gates, precomputed_gate_stride,
+                           use_cifg, &precomputed_input_gate,
+                           &precomputed_forget_gate, &precomputed_cell_gate,
+                           &precomputed_output_gate);
+
   int32_t* input_to_input_row_sums = nullptr;
   int32_t* input_to_forget_row_sums = nullptr;
   int32_t* input_to_cell_row_sums = nullptr;
@@ -1097,8 +1208,9 @@ inline void LstmStepHybrid(
        micro_tensor_utils::IsZeroVector(aux_input_ptr, n_batch * n_aux_input));
   const bool is_output_state_all_zeros =
       micro_tensor_utils::IsZeroVector(output_state_ptr, n_batch * n_output);
-  // Quantize inputs.
-  if (!is_input_all_zeros) {
+  // Quantize inputs. The input is not needed if its contribution to the gates
+  // has already been computed.
+  if (!is_input_all_zeros && precomputed_input_gates == nullptr) {
     micro_tensor_utils::BatchQuantizeFloats(
         input_ptr, n_batch, n_input, quantized_input_ptr, input_sf, input_zp,
         asymmetric_quantize_inputs);
@@ -1129,7 +1241,8 @@ inline void LstmStepHybrid(
         n_input, n_aux_input, n_output, n_cell, kTfLiteActSigmoid,
         input_gate_scratch, is_input_all_zeros, is_aux_input_all_zeros,
         is_output_state_all_zeros, compute_row_sums, scaling_factors_scratch,
-        recovered_cell_weights, scales, accum_scratch_ptr);
+        recovered_cell_weights, scales, accum_scratch_ptr,
+        precomputed_input_gate);
   }
   // Calculate the forget gate.
   CalculateLstmGateHybrid(
@@ -1146,7 +1259,8 @@ inline void LstmStepHybrid(
       n_input, n_aux_input, n_output, n_cell, kTfLiteActSigmoid,
       forget_gate_scratch, is_input_all_zeros, is_aux_input_all_zeros,
       is_output_state_all_zeros, compute_row_sums, scaling_factors_scratch,
-      recovered_cell_weights, scales, accum_scratch_ptr);
+      recovered_cell_weights, scales, accum_scratch_ptr,
+      precomputed_forget_gate);
   // Calculate the cell update gate.
   CalculateLstmGateHybrid(
       quantized_input_ptr, input_sf, input_zp, input_to_cell_weights_ptr,
@@ -1163,7 +1277,7 @@ inline void LstmStepHybrid(
       params->activation, cell_gate_scratch, is_input_all_zeros,
       is_aux_input_all_zeros, is_output_state_all_zeros, compute_row_sums,
       scaling_factors_scratch, recovered_cell_weights, scales,
-      accum_scratch_ptr);
+      accum_scratch_ptr, precomputed_cell_gate);
   // Update the cell state.
   UpdateLstmCellFloat(n_batch, n_cell, cell_state_ptr, input_gate_scratch,
                       forget_gate_scratch, cell_gate_scratch, use_cifg,
@@ -1183,7 +1297,8 @@ inline void LstmStepHybrid(
       n_input, n_aux_input, n_output, n_cell, kTfLiteActSigmoid,
       output_gate_scratch, is_input_all_zeros, is_aux_input_all_zeros,
       is_output_state_all_zeros, compute_row_sums, scaling_factors_scratch,
-      recovered_cell_weights, scales, accum_scratch_ptr);
+      recovered_cell_weights, scales, accum_scratch_ptr,
+      precomputed_output_gate);
   // Update the output state.
   CalculateLstmOutputHybrid(
       n_batch, n_cell, n_output, cell_state_ptr, output_gate_scratch,
@@ -1355,7 +1470,8 @@ inline void LstmStepInteger8x8_16(
     int n_input, int n_output, int8_t* output_state_ptr,
     int32_t output_state_zp, int16_t* cell_state_ptr, int8_t* output_ptr,
     int16_t* scratch0, int16_t* scratch1, int16_t* scratch2, int16_t* scratch3,
-    int8_t* scratch4, int32_t* scratch5) {
+    int8_t* scratch4, int32_t* scratch5,
+    const int16_t* precomputed_input_gates, int precomputed_gate_stride) {
   // Make named scratch buffers for the different gates.
   int16_t* input_gate_scratch = scratch0;
   int16_t* forget_gate_scratch = scratch1;
@@ -1381,6 +1497,14 @@ inline void LstmStepInteger8x8_16(
   if (use_projection) {
     TFLITE_DCHECK(projection_effective_bias);
   }
+  const int16_t* precomputed_input_gate;
+  const int16_t* precomputed_forget_gate;
+  const int16_t* precomputed_cell_gate;
+  const int16_t* precomputed_output_gate;
+  GetPrecomputedInputGates(precomputed_input_gates, precomputed_gate_stride,
+                           use_cifg, &precomputed_input_gate,
+                           &precomputed_forget_gate, &precomputed_cell_gate,
+                           &precomputed_output_gate);
   if (!use_cifg) {
     // Calculate the input gate. (If not CIFG.)
     CalculateLstmGateInteger8x8_16(
@@ -1393,7 +1517,8 @@ inline void LstmStepInteger8x8_16(
         effective_cell_to_input_scale_b, layer_norm_input_weight_ptr,
         input_gate_bias_ptr, layer_norm_input_scale_a, layer_norm_input_scale_b,
         input_variance_guard, n_batch, n_input, n_output, n_cell,
-        kTfLiteActSigmoid, input_gate_scratch, scratch5);
+        kTfLiteActSigmoid, input_gate_scratch, scratch5,
+        precomputed_input_gate);
   }
   // Calculate the forget gate.
   CalculateLstmGateInteger8x8_16(
@@ -1406,7 +1531,8 @@ inline void LstmStepInteger8x8_16(
       effective_cell_to_forget_scale_b, layer_norm_forget_weight_ptr,
       forget_gate_bias_ptr, layer_norm_forget_scale_a,
       layer_norm_forget_scale_b, forget_variance_guard, n_batch, n_input,
-      n_output, n_cell, kTfLiteActSigmoid, forget_gate_scratch, scratch5);
+      n_output, n_cell, kTfLiteActSigmoid, forget_gate_scratch, scratch5,
+      precomputed_forget_gate);
   // Calculate the cell update gate.
   CalculateLstmGateInteger8x8_16(
       input_ptr, input_to_cell_weight_ptr, input_to_cell_effective_bias,
@@ -1418,7 +1544,7 @@ inline void LstmStepInteger8x8_16(
       /*cell_to_gate_scale_b=*/0, layer_norm_cell_weight_ptr,
       cell_gate_bias_ptr, layer_norm_cell_scale_a, layer_norm_cell_scale_b,
       cell_variance_guard, n_batch, n_input, n_output, n_cell, kTfLiteActTanh,
-      cell_gate_scratch, scratch5);
+      cell_gate_scratch, scratch5, precomputed_cell_gate);
   // Update the cell state.
   UpdateLstmCellInteger(n_batch, n_cell, cell_state_ptr, cell_state_scale,
                         input_gate_scratch, forget_gate_scratch,
@@ -1434,7 +1560,8 @@ inline void LstmStepInteger8x8_16(
       effective_cell_to_output_scale_b, layer_norm_output_weight_ptr,
       output_gate_bias_ptr, layer_norm_output_scale_a,
       layer_norm_output_scale_b, output_variance_guard, n_batch, n_input,
-      n_output, n_cell, kTfLiteActSigmoid, output_gate_scratch, scratch5);
+      n_output, n_cell, kTfLiteActSigmoid, output_gate_scratch, scratch5,
+      precomputed_output_gate);
   // Update the output state.
   CalculateLstmOutputInteger8x8_16(
       n_batch, n_cell, n_output, cell_state_ptr, cell_state_scale,
@@ -1691,7 +1818,8 @@ TfLiteStatus EvalFloatLstm(
     const TfLiteEvalTensor* projection_bias, const TfLiteLSTMParams* params,
     bool forward_sequence, bool time_major, int output_offset,
     float* scratch_buffer, TfLiteEvalTensor* output_state,
-    TfLiteEvalTensor* cell_state, TfLiteEvalTensor* output) {
+    TfLiteEvalTensor* cell_state, TfLiteEvalTensor* output,
+    float* precomputed_input_gates) {
   TFLITE_DCHECK(input->dims->size >= 2 && input->dims->size <= 3);
   int max_time, n_batch;
   if (input->dims->size == 3) {
@@ -1731,6 +1859,52 @@ TfLiteStatus EvalFloatLstm(
 
   const int output_batch_leading_dim =
       output->dims->data[output->dims->size - 1];
+
+  // The bias and input contributions to the gates do not depend on the
+  // recurrent state, so they can be computed for all max_time * n_batch input
+  // rows at once, in the row order of the input tensor.
+  if (aux_input != nullptr) {
+    precomputed_input_gates = nullptr;
+  }
+  const int precomputed_gate_stride = max_time * n_batch * n_cell;
+  if (precomputed_input_gates != nullptr) {
+    const float* input_data = tflite::micro::GetTensorData<float>(input);
+    const int n_rows = max_time * n_batch;
+    CalculateLstmGateInputFloat(
+        input_data,
+        tflite::micro::GetTensorData<float>(input_to_forget_weights),
+        tflite::micro::GetOptionalTensorData<float>(
+            forget_layer_norm_coefficients),
+        tflite::micro::GetTensorData<float>(forget_gate_bias), n_rows, n_input,
+        n_cell, precomputed_input_gates, /*is_input_all_zeros=*/false);
+    CalculateLstmGateInputFloat(
+        input_data, tflite::micro::GetTensorData<float>(input_to_cell_weights),
+        tflite::micro::GetOptionalTensorData<float>(
+            cell_layer_norm_coefficients),
+        tflite::micro::GetTensorData<float>(cell_gate_bias), n_rows, n_input,
+        n_cell, precomputed_input_gates + precomputed_gate_stride,
+        /*is_input_all_zeros=*/false);
+    CalculateLstmGateInputFloat(
+        input_data,
+        tflite::micro::GetTensorData<float>(input_to_output_weights),
+        tflite::micro::GetOptionalTensorData<float>(
+            output_layer_norm_coefficients),
+        tflite::micro::GetTensorData<float>(output_gate_bias), n_rows, n_input,
+        n_cell, precomputed_input_gates + 2 * precomputed_gate_stride,
+        /*is_input_all_zeros=*/false);
+    if (!use_cifg) {
+      CalculateLstmGateInputFloat(
+          input_data,
+          tflite::micro::GetTensorData<float>(input_to_input_weights),
+          tflite::micro::GetOptionalTensorData<float>(
+              input_layer_norm_coefficients),
+          tflite::micro::GetTensorData<float>(input_gate_bias), n_rows,
+          n_input, n_cell,
+          precomputed_input_gates + 3 * precomputed_gate_stride,
+          /*is_input_all_zeros=*/false);
+    }
+  }
+
   if (time_major) {
     // Loop through the sequence.
     const int input_step = n_batch * n_input;
@@ -1748,6 +1922,10 @@ TfLiteStatus EvalFloatLstm(
       }
       float* output_ptr = tflite::micro::GetTensorData<float>(output) +
                           t_rel * output_step + output_offset;
+      const float* precomputed_input_gates_ptr =
+          precomputed_input_gates == nullptr
+              ? nullptr
+              : precomputed_input_gates + t_rel * n_batch * n_cell;
 
       LstmStepFloat(
           input_ptr,
@@ -1840,7 +2018,7 @@ TfLiteStatus EvalFloatLstm(
           tflite::micro::GetTensorData<float>(output_state),
           tflite::micro::GetTensorData<float>(cell_state), input_gate_scratch,
           forget_gate_scratch, cell_gate_scratch, output_gate_scratch,
-          output_ptr);
+          output_ptr, precomputed_input_gates_ptr, precomputed_gate_stride);
     }
   } else {
     for (int b = 0; b < n_batch; b++) {
@@ -1860,6 +2038,10 @@ TfLiteStatus EvalFloatLstm(
         }
         float* output_ptr = tflite::micro::GetTensorData<float>(output) +
                             time_offset * output_step + output_offset;
+        const float* precomputed_input_gates_ptr =
+            precomputed_input_gates == nullptr
+                ? nullptr
+                : precomputed_input_gates + time_offset * n_cell;
 
         // Offset the {output,cell}_state pointers to the right batch.
         float* output_state_ptr =
@@ -1968,7 +2150,8 @@ TfLiteStatus EvalFloatLstm(
             /*n_batch=*/1, n_cell, n_input, aux_input_size, n_output,
             output_batch_leading_dim, output_state_ptr, cell_state_ptr,
             input_gate_scratch_ptr, forget_gate_scratch_ptr,
-            cell_gate_scratch_ptr, output_gate_scratch_ptr, output_ptr);
+            cell_gate_scratch_ptr, output_gate_scratch_ptr, output_ptr,
+            precomputed_input_gates_ptr, precomputed_gate_stride);
       }
     }
   }
@@ -2021,7 +2204,7 @@ TfLiteStatus EvalHybridLstm(
     TfLiteEvalTensor* cell_state, int32_t* output_scratch_buffer,
     TfLiteEvalTensor* output, int32_t* input_zp, int32_t* aux_input_zp,
     int32_t* output_state_zp, int32_t* row_sums, int row_sums_size,
-    bool* compute_row_sums) {
+    bool* compute_row_sums, float* precomputed_input_gates) {
   TFLITE_DCHECK(input->dims->size >= 2 && input->dims->size <= 3);
   const int n_input = input->dims->data[input->dims->size - 1];
   int max_time, n_batch;
@@ -2071,6 +2254,92 @@ TfLiteStatus EvalHybridLstm(
     row_sums_ptr = row_sums;
   }
 
+  // Same as in EvalFloatLstm, on the input quantized once for all rows.
+  if (aux_input != nullptr) {
+    precomputed_input_gates = nullptr;
+  }
+  const int precomputed_gate_stride = max_time * n_batch * n_cell;
+  if (precomputed_input_gates != nullptr) {
+    const float* input_data = tflite::micro::GetTensorData<float>(input);
+    const int n_rows = max_time * n_batch;
+    const bool is_input_all_zeros =
+        micro_tensor_utils::IsZeroVector(input_data, n_rows * n_input);
+    if (!is_input_all_zeros) {
+      micro_tensor_utils::BatchQuantizeFloats(
+          input_data, n_rows, n_input, input_quantized, input_sf, input_zp_ptr,
+          params->asymmetric_quantize_inputs);
+    }
+    // Use the row sums layout of LstmStepHybrid. The row sums of the input
+    // weights are always recomputed here, as LstmStepHybrid may not have run
+    // yet.
+    int32_t* input_to_input_row_sums = nullptr;
+    int32_t* input_to_forget_row_sums = nullptr;
+    int32_t* input_to_cell_row_sums = nullptr;
+    int32_t* input_to_output_row_sums = nullptr;
+    if (row_sums_ptr != nullptr) {
+      input_to_input_row_sums = row_sums_ptr;
+      input_to_forget_row_sums =
+          use_cifg ? input_to_input_row_sums : input_to_input_row_sums + n_cell;
+      input_to_cell_row_sums = input_to_forget_row_sums + n_cell;
+      input_to_output_row_sums = input_to_cell_row_sums + n_cell;
+    }
+    CalculateLstmGateInputHybrid(
+        input_quantized, input_sf, input_zp_ptr,
+        tflite::micro::GetTensorData<int8_t>(input_to_forget_weights),
+        tflite::micro::GetOptionalTensorData<uint8_t>(
+            input_to_forget_weights_ledger),
+        hybrid_lstm_scales->input_to_forget_weights_scale,
+        input_to_forget_row_sums,
+        tflite::micro::GetOptionalTensorData<float>(
+            forget_layer_norm_coefficients),
+        tflite::micro::GetTensorData<float>(forget_gate_bias), n_rows, n_input,
+        n_cell, precomputed_input_gates, is_input_all_zeros,
+        /*compute_row_sums=*/nullptr, prod_scaling_factors,
+        prod_scaling_factors, output_scratch_buffer);
+    CalculateLstmGateInputHybrid(
+        input_quantized, input_sf, input_zp_ptr,
+        tflite::micro::GetTensorData<int8_t>(input_to_cell_weights),
+        tflite::micro::GetOptionalTensorData<uint8_t>(
+            input_to_cell_weights_ledger),
+        hybrid_lstm_scales->input_to_cell_weights_scale,
+        input_to_cell_row_sums,
+        tflite::micro::GetOptionalTensorData<float>(
+            cell_layer_norm_coefficients),
+        tflite::micro::GetTensorData<float>(cell_gate_bias), n_rows, n_input,
+        n_cell, precomputed_input_gates + precomputed_gate_stride,
+        is_input_all_zeros, /*compute_row_sums=*/nullptr, prod_scaling_factors,
+        prod_scaling_factors, output_scratch_buffer);
+    CalculateLstmGateInputHybrid(
+        input_quantized, input_sf, input_zp_ptr,
+        tflite::micro::GetTensorData<int8_t>(input_to_output_weights),
+        tflite::micro::GetOptionalTensorData<uint8_t>(
+            input_to_output_weights_ledger),
+        hybrid_lstm_scales->input_to_output_weights_scale,
+        input_to_output_row_sums,
+        tflite::micro::GetOptionalTensorData<float>(
+            output_layer_norm_coefficients),
+        tflite::micro::GetTensorData<float>(output_gate_bias), n_rows, n_input,
+        n_cell, precomputed_input_gates + 2 * precomputed_gate_stride,
+        is_input_all_zeros, /*compute_row_sums=*/nullptr, prod_scaling_factors,
+        prod_scaling_factors, output_scratch_buffer);
+    if (!use_cifg) {
+      CalculateLstmGateInputHybrid(
+          input_quantized, input_sf, input_zp_ptr,
+          tflite::micro::GetTensorData<int8_t>(input_to_input_weights),
+          tflite::micro::GetOptionalTensorData<uint8_t>(
+              input_to_input_weights_ledger),
+          hybrid_lstm_scales->input_to_input_weights_scale,
+          input_to_input_row_sums,
+          tflite::micro::GetOptionalTensorData<float>(
+              input_layer_norm_coefficients),
+          tflite::micro::GetTensorData<float>(input_gate_bias), n_rows,
+          n_input, n_cell,
+          precomputed_input_gates + 3 * precomputed_gate_stride,
+          is_input_all_zeros, /*compute_row_sums=*/nullptr,
+          prod_scaling_factors, prod_scaling_factors, output_scratch_buffer);
+    }
+  }
+
   if (time_major) {
     // Feed the sequence into the LSTM step-by-step.
     const int input_step = n_batch * n_input;
@@ -2088,6 +2357,10 @@ TfLiteStatus EvalHybridLstm(
       }
       float* output_ptr = tflite::micro::GetTensorData<float>(output) +
                           t_rel * output_step + output_offset;
+      const float* precomputed_input_gates_ptr =
+          precomputed_input_gates == nullptr
+              ? nullptr
+              : precomputed_input_gates + t_rel * n_batch * n_cell;
       LstmStepHybrid(
           input_ptr,
           input_to_input_weights == nullptr
@@ -2237,7 +2510,8 @@ TfLiteStatus EvalHybridLstm(
           tflite::micro::GetTensorData<float>(cell_state),
           output_scratch_buffer, output_ptr, input_zp_ptr, aux_input_zp_ptr,
           output_state_zp_ptr, row_sums_ptr, row_sums_size, compute_row_sums,
-          params->asymmetric_quantize_inputs);
+          params->asymmetric_quantize_inputs, precomputed_input_gates_ptr,
+          precomputed_gate_stride);
     }
   } else {
     for (int b = 0; b < n_batch; b++) {
@@ -2257,6 +2531,10 @@ TfLiteStatus EvalHybridLstm(
         }
         float* output_ptr = tflite::micro::GetTensorData<float>(output) +
                             time_offset * output_step + output_offset;
+        const float* precomputed_input_gates_ptr =
+            precomputed_input_gates == nullptr
+                ? nullptr
+                : precomputed_input_gates + time_offset * n_cell;
 
         // Offset the {output,cell}_state pointers to the right batch.
         float* output_state_ptr =
@@ -2422,7 +2700,8 @@ TfLiteStatus EvalHybridLstm(
             cell_state_quantized, output_state_ptr, cell_state_ptr,
             output_scratch_buffer, output_ptr, input_zp_ptr, aux_input_zp_ptr,
             output_state_zp_ptr, row_sums_ptr, row_sums_size, compute_row_sums,
-            params->asymmetric_quantize_inputs);
+            params->asymmetric_quantize_inputs, precomputed_input_gates_ptr,
+            precomputed_gate_stride);
       }
     }
   }
@@ -2457,7 +2736,8 @@ TfLiteStatus EvalInteger8x8_16Lstm(
     const IntegerLstmParameter* integer_lstm_param, int32_t output_state_zp,
     TfLiteEvalTensor* output_state, TfLiteEvalTensor* cell_state,
     TfLiteEvalTensor* output, int16_t* scratch0, int16_t* scratch1,
-    int16_t* scratch2, int16_t* scratch3, int8_t* scratch4, int32_t* scratch5) {
+    int16_t* scratch2, int16_t* scratch3, int8_t* scratch4, int32_t* scratch5,
+    int16_t* precomputed_input_gates) {
   TFLITE_DCHECK(input->dims->size >= 2 && input->dims->size <= 3);
   const int n_input = input->dims->data[input->dims->size - 1];
   int max_time, n_batch;
@@ -2477,6 +2757,46 @@ TfLiteStatus EvalInteger8x8_16Lstm(
   const int output_batch_leading_dim =
       output->dims->data[output->dims->size - 1];
 
+  // Same as in EvalFloatLstm. The input zero point is folded into the
+  // effective biases, so the result is identical to computing it per step.
+  const int precomputed_gate_stride = max_time * n_batch * n_cell;
+  if (precomputed_input_gates != nullptr) {
+    const int8_t* input_data = tflite::micro::GetTensorData<int8_t>(input);
+    const int n_rows = max_time * n_batch;
+    CalculateLstmGateInputInteger8x8_16(
+        input_data,
+        tflite::micro::GetTensorData<int8_t>(input_to_forget_weights),
+        integer_lstm_param->input_to_forget_effective_bias,
+        integer_lstm_param->effective_input_to_forget_scale_a,
+        integer_lstm_param->effective_input_to_forget_scale_b, n_rows, n_input,
+        n_cell, precomputed_input_gates, scratch5);
+    CalculateLstmGateInputInteger8x8_16(
+        input_data, tflite::micro::GetTensorData<int8_t>(input_to_cell_weights),
+        integer_lstm_param->input_to_cell_effective_bias,
+        integer_lstm_param->effective_input_to_cell_scale_a,
+        integer_lstm_param->effective_input_to_cell_scale_b, n_rows, n_input,
+        n_cell, precomputed_input_gates + precomputed_gate_stride, scratch5);
+    CalculateLstmGateInputInteger8x8_16(
+        input_data,
+        tflite::micro::GetTensorData<int8_t>(input_to_output_weights),
+        integer_lstm_param->input_to_output_effective_bias,
+        integer_lstm_param->effective_input_to_output_scale_a,
+        integer_lstm_param->effective_input_to_output_scale_b, n_rows, n_input,
+        n_cell, precomputed_input_gates + 2 * precomputed_gate_stride,
+        scratch5);
+    if (input_to_input_weights != nullptr) {
+      CalculateLstmGateInputInteger8x8_16(
+          input_data,
+          tflite::micro::GetTensorData<int8_t>(input_to_input_weights),
+          integer_lstm_param->input_to_input_effective_bias,
+          integer_lstm_param->effective_input_to_input_scale_a,
+          integer_lstm_param->effective_input_to_input_scale_b, n_rows,
+          n_input, n_cell,
+          precomputed_input_gates + 3 * precomputed_gate_stride,
+          scratch5);
+    }
+  }
+
   if (time_major) {
     const int input_step = n_batch * n_input;
     const int output_step = n_batch * output_batch_leading_dim;
@@ -2486,6 +2806,10 @@ TfLiteStatus EvalInteger8x8_16Lstm(
           tflite::micro::GetTensorData<int8_t>(output) + t_rel * output_step;
       const int8_t* input_ptr =
           tflite::micro::GetTensorData<int8_t>(input) + t_rel * input_step;
+      const int16_t* precomputed_input_gates_ptr =
+          precomputed_input_gates == nullptr
+              ? nullptr
+              : precomputed_input_gates + t_rel * n_batch * n_cell;
       LstmStepInteger8x8_16(
           input_ptr,
           input_to_input_weights == nullptr
@@ -2609,7 +2933,7 @@ TfLiteStatus EvalInteger8x8_16Lstm(
           n_input, n_output, tflite::micro::GetTensorData<int8_t>(output_state),
           output_state_zp, tflite::micro::GetTensorData<int16_t>(cell_state),
           output_ptr, scratch0, scratch1, scratch2, scratch3, scratch4,
-          scratch5);
+          scratch5, precomputed_input_gates_ptr, precomputed_gate_stride);
     }
   } else {
     for (int b = 0; b < n_batch; b++) {
@@ -2624,6 +2948,10 @@ TfLiteStatus EvalInteger8x8_16Lstm(
                                   time_offset * input_step;
         int8_t* output_ptr = tflite::micro::GetTensorData<int8_t>(output) +
                              time_offset * output_step;
+        const int16_t* precomputed_input_gates_ptr =
+            precomputed_input_gates == nullptr
+                ? nullptr
+                : precomputed_input_gates + time_offset * n_cell;
 
         // Offset the {output,cell}_state pointers to the right batch.
         int8_t* output_state_ptr =
@@ -2755,7 +3083,8 @@ TfLiteStatus EvalInteger8x8_16Lstm(
             integer_lstm_param->projection_effective_bias, /*n_batch=*/1,
             n_cell, n_input, n_output, output_state_ptr, output_state_zp,
             cell_state_ptr, output_ptr, scratch0, scratch1, scratch2, scratch3,
-            scratch4, scratch5);
+            scratch4, scratch5, precomputed_input_gates_ptr,
+            precomputed_gate_stride);
       }
     }
   }
@@ -139,7 +139,11 @@ TfLiteStatus EvalFloatLstm(
     const TfLiteEvalTensor* projection_bias, const TfLiteLSTMParams* params,
     bool forward_sequence, bool time_major, int output_offset,
     float* scratch_buffer, TfLiteEvalTensor* output_state,
-    TfLiteEvalTensor* cell_state, TfLiteEvalTensor* output);
+    TfLiteEvalTensor* cell_state, TfLiteEvalTensor* output,
+    // Optional buffer of max_time * n_batch * n_cell values per gate. When
+    // set, the bias and input contributions to all gates are computed for the
+    // whole sequence ahead of the recurrent loop. Ignored with aux_input.
+    float* precomputed_input_gates = nullptr);
 
 TfLiteStatus EvalHybridLstm(
     const HybridLstmScales* hybrid_lstm_scales, const TfLiteEvalTensor* input,
@@ -187,7 +191,10 @@ TfLiteStatus EvalHybridLstm(
     TfLiteEvalTensor* cell_state, int32_t* output_scratch_buffer,
     TfLiteEvalTensor* output, int32_t* input_zp, int32_t* aux_input_zp,
     int32_t* output_state_zp, int32_t* row_sums, int row_sums_size,
-    bool* compute_row_sums);
+    bool* compute_row_sums,
+    // Same as in EvalFloatLstm. input_sf, input_zp, prod_scaling_factors and
+    // output_scratch_buffer must then be sized for max_time * n_batch rows.
+    float* precomputed_input_gates = nullptr);
 
 TfLiteStatus EvalInteger8x8_16Lstm(
     const TfLiteEvalTensor* input,
@@ -216,7 +223,9 @@ TfLiteStatus EvalInteger8x8_16Lstm(
     const IntegerLstmParameter* integer_lstm_param, int32_t output_state_zp,
     TfLiteEvalTensor* output_state, TfLiteEvalTensor* cell_state,
     TfLiteEvalTensor* output, int16_t* scratch0, int16_t* scratch1,
-    int16_t* scratch2, int16_t* scratch3, int8_t* scratch4, int32_t* scratch5);
+    int16_t* scratch2, int16_t* scratch3, int8_t* scratch4, int32_t* scratch5,
+    // Same as in EvalFloatLstm.
+    int16_t* precomputed_input_gates = nullptr);
 
 TfLiteStatus EvalInteger8x8_8Lstm(
     const TfLiteEvalTensor* input,
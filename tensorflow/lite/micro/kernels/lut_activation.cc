@@ -0,0 +1,53 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/micro/kernels/lut_activation.h"
+
+#include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/kernels/internal/common.h"
+#include "tensorflow/lite/kernels/internal/tensor_ctypes.h"
+#include "tensorflow/lite/micro/kernels/kernel_util.h"
+
+namespace tflite {
+
+int16_t* PopulateInt16Lut(TfLiteContext* context, float (*func)(float),
+                          float input_min, float input_max, float output_min,
+                          float output_max) {
+  TFLITE_DCHECK(context->AllocatePersistentBuffer != nullptr);
+  int16_t* lut = static_cast<int16_t*>(context->AllocatePersistentBuffer(
+      context, sizeof(int16_t) * kInt16LutSize));
+  if (lut == nullptr) {
+    return nullptr;
+  }
+
+  gen_lut<float, int16_t, int16_t>(func, input_min, input_max, output_min,
+                                   output_max, lut);
+  return lut;
+}
+
+void EvalInt8Lut(const int8_t* lut, const TfLiteEvalTensor* input,
+                 TfLiteEvalTensor* output) {
+  TFLITE_DCHECK(lut != nullptr);
+  const int size = MatchingFlatSize(tflite::micro::GetTensorShape(input),
+                                    tflite::micro::GetTensorShape(output));
+  const int8_t* input_data = tflite::micro::GetTensorData<int8_t>(input);
+  int8_t* output_data = tflite::micro::GetTensorData<int8_t>(output);
+
+  for (int i = 0; i < size; ++i) {
+    output_data[i] = lut_lookup(input_data[i], lut);
+  }
+}
+
+}  // namespace tflite
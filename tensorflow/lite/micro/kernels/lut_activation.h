@@ -0,0 +1,71 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_MICRO_KERNELS_LUT_ACTIVATION_H_
+#define TENSORFLOW_LITE_MICRO_KERNELS_LUT_ACTIVATION_H_
+
+#include <cstdint>
+
+#include "tensorflow/lite/c/common.h"
+
+namespace tflite {
+
+// Number of entries in a table indexed directly by an int8 value.
+constexpr int kInt8LutSize = 256;
+
+// Number of entries in an interpolated table for int16 values, see
+// lut_lookup_with_interpolation() in kernels/internal/common.h.
+constexpr int kInt16LutSize = 513;
+
+// Allocates a kInt8LutSize entry table from the persistent arena and fills it
+// with the activation of every int8 value, in the order expected by
+// lut_lookup(int8_t, const int8_t*). The table is built with a single call to
+// activation(input_data, output_data, kInt8LutSize), so a kernel can pass its
+// reference routine and the lookup stays bit-exact with it.
+//
+// Must be called from Prepare. Returns nullptr if the allocation fails.
+template <typename ActivationFn>
+int8_t* PopulateInt8Lut(TfLiteContext* context, ActivationFn activation) {
+  int8_t* lut = static_cast<int8_t*>(
+      context->AllocatePersistentBuffer(context, kInt8LutSize));
+  if (lut == nullptr) {
+    return nullptr;
+  }
+
+  int8_t input_data[kInt8LutSize];
+  for (int i = 0; i < kInt8LutSize; ++i) {
+    input_data[i] = static_cast<int8_t>(i - 128);
+  }
+  activation(input_data, lut, kInt8LutSize);
+  return lut;
+}
+
+// Allocates a kInt16LutSize entry table from the persistent arena and samples
+// func over [input_min, input_max] into it with gen_lut(). The table is meant
+// for lut_lookup_with_interpolation().
+//
+// Must be called from Prepare. Returns nullptr if the allocation fails.
+int16_t* PopulateInt16Lut(TfLiteContext* context, float (*func)(float),
+                          float input_min, float input_max, float output_min,
+                          float output_max);
+
+// Maps every element of an int8 input through a table built by
+// PopulateInt8Lut.
+void EvalInt8Lut(const int8_t* lut, const TfLiteEvalTensor* input,
+                 TfLiteEvalTensor* output);
+
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_MICRO_KERNELS_LUT_ACTIVATION_H_
@@ -84,6 +84,11 @@ TfLiteRegistration Register_TRANSPOSE();
 TfLiteRegistration Register_TRANSPOSE_CONV();
 // TODO(b/230666079): resolve conflict with xtensa implementation
 TfLiteRegistration Register_UNIDIRECTIONAL_SEQUENCE_LSTM();
+// Same as Register_UNIDIRECTIONAL_SEQUENCE_LSTM, but computes the input
+// contributions to the gates for the whole sequence before the recurrent loop.
+// Needs an extra arena buffer of up to 4 * max_time * n_batch * n_cell gate
+// values. Not available on Xtensa.
+TfLiteRegistration Register_UNIDIRECTIONAL_SEQUENCE_LSTM_TIME_BATCHED();
 TfLiteRegistration Register_VAR_HANDLE();
 TfLiteRegistration Register_WHILE();
 TfLiteRegistration Register_ZEROS_LIKE();
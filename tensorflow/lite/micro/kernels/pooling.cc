@@ -42,6 +42,7 @@ TfLiteStatus AverageEval(TfLiteContext* context, TfLiteNode* node) {
       AveragePoolingEvalFloat(context, node, params, data, input, output);
       break;
     case kTfLiteInt8:
+    case kTfLiteInt16:
       AveragePoolingEvalQuantized(context, node, params, data, input, output);
       break;
     default:
@@ -70,6 +71,7 @@ TfLiteStatus MaxEval(TfLiteContext* context, TfLiteNode* node) {
       MaxPoolingEvalFloat(context, node, params, data, input, output);
       break;
     case kTfLiteInt8:
+    case kTfLiteInt16:
       MaxPoolingEvalQuantized(context, node, params, data, input, output);
       break;
     default:
@@ -13,6 +13,9 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
+#include <limits>
+
 #include "tensorflow/lite/c/builtin_op_data.h"
 #include "tensorflow/lite/kernels/internal/reference/integer_ops/pooling.h"
 #include "tensorflow/lite/kernels/internal/reference/pooling.h"
@@ -27,6 +30,136 @@ namespace tflite {
 const int kPoolingInputTensor = 0;
 const int kPoolingOutputTensor = 0;
 
+namespace {
+
+// Number of channels accumulated at once by AveragePoolChannelsInner(). The
+// accumulators live on the stack.
+constexpr int kAveragePoolChannelBlock = 64;
+
+// Same results as reference_integer_ops::AveragePool, but each window is
+// summed as whole rows of contiguous channels, so that the inner loop runs
+// over channels instead of over filter taps. Returns false for an empty
+// window, like the reference.
+template <typename T>
+bool AveragePoolChannelsInner(const PoolParams& params,
+                              const RuntimeShape& input_shape,
+                              const T* input_data,
+                              const RuntimeShape& output_shape,
+                              T* output_data) {
+  const int batches = MatchingDim(input_shape, 0, output_shape, 0);
+  const int depth = MatchingDim(input_shape, 3, output_shape, 3);
+  const int input_height = input_shape.Dims(1);
+  const int input_width = input_shape.Dims(2);
+  const int output_height = output_shape.Dims(1);
+  const int output_width = output_shape.Dims(2);
+  int32_t acc[kAveragePoolChannelBlock];
+
+  for (int batch = 0; batch < batches; ++batch) {
+    for (int out_y = 0; out_y < output_height; ++out_y) {
+      for (int out_x = 0; out_x < output_width; ++out_x) {
+        const int in_x_origin =
+            (out_x * params.stride_width) - params.padding_values.width;
+        const int in_y_origin =
+            (out_y * params.stride_height) - params.padding_values.height;
+        const int filter_x_start = std::max(0, -in_x_origin);
+        const int filter_x_end =
+            std::min(params.filter_width, input_width - in_x_origin);
+        const int filter_y_start = std::max(0, -in_y_origin);
+        const int filter_y_end =
+            std::min(params.filter_height, input_height - in_y_origin);
+        const int filter_count = (filter_x_end - filter_x_start) *
+                                 (filter_y_end - filter_y_start);
+        if (filter_x_end <= filter_x_start || filter_y_end <= filter_y_start) {
+          return false;
+        }
+        T* output = &output_data[Offset(output_shape, batch, out_y, out_x, 0)];
+
+        for (int channel_start = 0; channel_start < depth;
+             channel_start += kAveragePoolChannelBlock) {
+          const int channels =
+              std::min(kAveragePoolChannelBlock, depth - channel_start);
+          std::fill(acc, acc + channels, 0);
+          for (int filter_y = filter_y_start; filter_y < filter_y_end;
+               ++filter_y) {
+            for (int filter_x = filter_x_start; filter_x < filter_x_end;
+                 ++filter_x) {
+              const T* input = &input_data[Offset(
+                  input_shape, batch, in_y_origin + filter_y,
+                  in_x_origin + filter_x, channel_start)];
+              for (int c = 0; c < channels; ++c) {
+                acc[c] += input[c];
+              }
+            }
+          }
+          for (int c = 0; c < channels; ++c) {
+            int32_t average =
+                acc[c] > 0 ? (acc[c] + filter_count / 2) / filter_count
+                           : (acc[c] - filter_count / 2) / filter_count;
+            average = std::max(average, params.quantized_activation_min);
+            average = std::min(average, params.quantized_activation_max);
+            output[channel_start + c] = static_cast<T>(average);
+          }
+        }
+      }
+    }
+  }
+  return true;
+}
+
+// Same results as reference_integer_ops::MaxPool. The running maximum of all
+// channels of a window is kept directly in the output row.
+template <typename T>
+void MaxPoolChannelsInner(const PoolParams& params,
+                          const RuntimeShape& input_shape, const T* input_data,
+                          const RuntimeShape& output_shape, T* output_data) {
+  const int batches = MatchingDim(input_shape, 0, output_shape, 0);
+  const int depth = MatchingDim(input_shape, 3, output_shape, 3);
+  const int input_height = input_shape.Dims(1);
+  const int input_width = input_shape.Dims(2);
+  const int output_height = output_shape.Dims(1);
+  const int output_width = output_shape.Dims(2);
+  const T activation_min = static_cast<T>(params.quantized_activation_min);
+  const T activation_max = static_cast<T>(params.quantized_activation_max);
+
+  for (int batch = 0; batch < batches; ++batch) {
+    for (int out_y = 0; out_y < output_height; ++out_y) {
+      for (int out_x = 0; out_x < output_width; ++out_x) {
+        const int in_x_origin =
+            (out_x * params.stride_width) - params.padding_values.width;
+        const int in_y_origin =
+            (out_y * params.stride_height) - params.padding_values.height;
+        const int filter_x_start = std::max(0, -in_x_origin);
+        const int filter_x_end =
+            std::min(params.filter_width, input_width - in_x_origin);
+        const int filter_y_start = std::max(0, -in_y_origin);
+        const int filter_y_end =
+            std::min(params.filter_height, input_height - in_y_origin);
+        T* output = &output_data[Offset(output_shape, batch, out_y, out_x, 0)];
+
+        std::fill(output, output + depth, std::numeric_limits<T>::lowest());
+        for (int filter_y = filter_y_start; filter_y < filter_y_end;
+             ++filter_y) {
+          for (int filter_x = filter_x_start; filter_x < filter_x_end;
+               ++filter_x) {
+            const T* input =
+                &input_data[Offset(input_shape, batch, in_y_origin + filter_y,
+                                   in_x_origin + filter_x, 0)];
+            for (int c = 0; c < depth; ++c) {
+              output[c] = std::max(output[c], input[c]);
+            }
+          }
+        }
+        for (int c = 0; c < depth; ++c) {
+          output[c] = std::min(std::max(output[c], activation_min),
+                               activation_max);
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+
 TfLiteStatus CalculateOpDataPooling(const TfLiteContext* context,
                                     const TfLitePoolParams* params,
                                     const TfLiteTensor* input,
@@ -69,7 +202,7 @@ TfLiteStatus PoolingPrepare(TfLiteContext* context, TfLiteNode* node) {
   if (input->type == kTfLiteFloat32) {
     CalculateActivationRange(params->activation, &data->activation_min_f32,
                              &data->activation_max_f32);
-  } else if (input->type == kTfLiteInt8) {
+  } else if (input->type == kTfLiteInt8 || input->type == kTfLiteInt16) {
     CalculateActivationRangeQuantized(context, params->activation, output,
                                       &data->activation_min,
                                       &data->activation_max);
@@ -107,7 +240,7 @@ void AveragePoolingEvalQuantized(TfLiteContext* context, const TfLiteNode* node,
                                  const OpDataPooling* data,
                                  const TfLiteEvalTensor* input,
                                  TfLiteEvalTensor* output) {
-  TFLITE_DCHECK(input->type == kTfLiteInt8);
+  TFLITE_DCHECK(input->type == kTfLiteInt8 || input->type == kTfLiteInt16);
 
   PoolParams op_params;
   op_params.stride_height = params->stride_height;
@@ -119,11 +252,17 @@ void AveragePoolingEvalQuantized(TfLiteContext* context, const TfLiteNode* node,
   op_params.quantized_activation_min = data->activation_min;
   op_params.quantized_activation_max = data->activation_max;
 
-  reference_integer_ops::AveragePool(
-      op_params, tflite::micro::GetTensorShape(input),
-      tflite::micro::GetTensorData<int8_t>(input),
-      tflite::micro::GetTensorShape(output),
-      tflite::micro::GetTensorData<int8_t>(output));
+  if (input->type == kTfLiteInt8) {
+    AveragePoolChannelsInner(op_params, tflite::micro::GetTensorShape(input),
+                             tflite::micro::GetTensorData<int8_t>(input),
+                             tflite::micro::GetTensorShape(output),
+                             tflite::micro::GetTensorData<int8_t>(output));
+  } else {
+    AveragePoolChannelsInner(op_params, tflite::micro::GetTensorShape(input),
+                             tflite::micro::GetTensorData<int16_t>(input),
+                             tflite::micro::GetTensorShape(output),
+                             tflite::micro::GetTensorData<int16_t>(output));
+  }
 }
 
 void MaxPoolingEvalFloat(TfLiteContext* context, TfLiteNode* node,
@@ -160,11 +299,17 @@ void MaxPoolingEvalQuantized(TfLiteContext* context, TfLiteNode* node,
   op_params.quantized_activation_min = data->activation_min;
   op_params.quantized_activation_max = data->activation_max;
 
-  reference_integer_ops::MaxPool(op_params,
-                                 tflite::micro::GetTensorShape(input),
-                                 tflite::micro::GetTensorData<int8_t>(input),
-                                 tflite::micro::GetTensorShape(output),
-                                 tflite::micro::GetTensorData<int8_t>(output));
+  if (input->type == kTfLiteInt8) {
+    MaxPoolChannelsInner(op_params, tflite::micro::GetTensorShape(input),
+                         tflite::micro::GetTensorData<int8_t>(input),
+                         tflite::micro::GetTensorShape(output),
+                         tflite::micro::GetTensorData<int8_t>(output));
+  } else {
+    MaxPoolChannelsInner(op_params, tflite::micro::GetTensorShape(input),
+                         tflite::micro::GetTensorData<int16_t>(input),
+                         tflite::micro::GetTensorShape(output),
+                         tflite::micro::GetTensorData<int16_t>(output));
+  }
 }
 
 }  // namespace tflite
@@ -17,6 +17,7 @@ limitations under the License.
 
 #include "tensorflow/lite/c/builtin_op_data.h"
 #include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/kernels/internal/reference/integer_ops/pooling.h"
 #include "tensorflow/lite/micro/kernels/kernel_runner.h"
 #include "tensorflow/lite/micro/test_helpers.h"
 #include "tensorflow/lite/micro/testing/micro_test.h"
@@ -93,7 +94,7 @@ void TestAveragePoolQuantized(
     const T* expected_output_data, int* output_dims_data,
     const float output_scale, const int output_zero_point,
     TfLitePadding padding, TfLiteFusedActivation activation, T* output_data) {
-  static_assert(sizeof(T) == 1, "Only int8_t/uint8_t data types allowed.");
+  static_assert(sizeof(T) <= 2, "Only int8_t/int16_t data types allowed.");
 
   TfLiteIntArray* input_dims = IntArrayFromInts(input_dims_data);
   TfLiteIntArray* output_dims = IntArrayFromInts(output_dims_data);
@@ -304,6 +305,63 @@ TF_LITE_MICRO_TEST(SimpleAveragePoolTestInt8PaddingSameStride1ActNone) {
       output_data);
 }
 
+TF_LITE_MICRO_TEST(SimpleAveragePoolTestInt16PaddingValidStride2ActNone) {
+  int input_shape[] = {4, 1, 2, 4, 1};
+  const int16_t input_values[] = {0, -2400, 800, 1600, 1200, 800, -4000, 2800};
+  const int filter_width = 2;
+  const int filter_height = 2;
+  const int stride_width = 2;
+  const int stride_height = 2;
+  const int16_t golden[] = {-100, 300};
+  int output_shape[] = {4, 1, 1, 2, 1};
+  int16_t output_data[2];
+
+  const float input_scale = .0025;
+  const int input_zero_point = 0;
+  const float output_scale = .0025;
+  const int output_zero_point = 0;
+  tflite::testing::TestAveragePoolQuantized(
+      input_shape, input_values, input_scale, input_zero_point, filter_height,
+      filter_width, stride_height, stride_width, golden, output_shape,
+      output_scale, output_zero_point, kTfLitePaddingValid, kTfLiteActNone,
+      output_data);
+}
+
+TF_LITE_MICRO_TEST(AveragePoolTestInt8ManyChannelsPaddingSame) {
+  // More channels than the kernel accumulates at once, and windows clipped by
+  // the padding.
+  constexpr int kDepth = 70;
+  constexpr int kInputElements = 3 * 3 * kDepth;
+  int input_shape[] = {4, 1, 3, 3, kDepth};
+  int output_shape[] = {4, 1, 2, 2, kDepth};
+  int8_t input_values[kInputElements];
+  for (int i = 0; i < kInputElements; ++i) {
+    input_values[i] = static_cast<int8_t>((i * 37) % 255 - 127);
+  }
+
+  tflite::PoolParams op_params;
+  op_params.stride_height = 2;
+  op_params.stride_width = 2;
+  op_params.filter_height = 2;
+  op_params.filter_width = 2;
+  op_params.padding_values.height = 0;
+  op_params.padding_values.width = 0;
+  op_params.quantized_activation_min = -128;
+  op_params.quantized_activation_max = 127;
+  int8_t golden[2 * 2 * kDepth];
+  tflite::reference_integer_ops::AveragePool(
+      op_params, tflite::RuntimeShape(4, input_shape + 1), input_values,
+      tflite::RuntimeShape(4, output_shape + 1), golden);
+
+  int8_t output_data[2 * 2 * kDepth];
+  tflite::testing::TestAveragePoolQuantized(
+      input_shape, input_values, /*input_scale=*/1.0f,
+      /*input_zero_point=*/0, op_params.filter_height, op_params.filter_width,
+      op_params.stride_height, op_params.stride_width, golden, output_shape,
+      /*output_scale=*/1.0f, /*output_zero_point=*/0, kTfLitePaddingSame,
+      kTfLiteActNone, output_data);
+}
+
 TF_LITE_MICRO_TEST(SimpleMaxPoolTestFloat) {
   int input_shape[] = {4, 1, 2, 4, 1};
   const float input_values[] = {0, 6, 2, 4, 3, 2, 10, 7};
@@ -502,4 +560,28 @@ TF_LITE_MICRO_TEST(MaxPoolTestInt8ActRelu6) {
       output_data);
 }
 
+TF_LITE_MICRO_TEST(MaxPoolTestInt16ActRelu) {
+  int input_shape[] = {4, 1, 2, 4, 2};
+  const int16_t input_values[] = {-3000, 1200, 600,  -800, 200,  400,
+                                  -100,  900,  300,  -200, 1000, -700,
+                                  -500,  2500, 1100, 1300};
+  const int filter_width = 2;
+  const int filter_height = 2;
+  const int stride_width = 2;
+  const int stride_height = 2;
+  const int16_t golden[] = {1000, 1200, 1100, 2500};
+  int output_shape[] = {4, 1, 1, 2, 2};
+  int16_t output_data[4];
+
+  const float input_scale = 1.0;
+  const int input_zero_point = 0;
+  const float output_scale = 1.0;
+  const int output_zero_point = 0;
+  tflite::testing::TestMaxPoolQuantized(
+      input_shape, input_values, input_scale, input_zero_point, filter_height,
+      filter_width, stride_height, stride_width, golden, output_shape,
+      output_scale, output_zero_point, kTfLitePaddingValid, kTfLiteActRelu,
+      output_data);
+}
+
 TF_LITE_MICRO_TESTS_END
@@ -13,6 +13,9 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
+#include <limits>
+
 #include "tensorflow/lite/c/builtin_op_data.h"
 #include "tensorflow/lite/c/common.h"
 #include "tensorflow/lite/kernels/internal/quantization_util.h"
@@ -120,6 +123,50 @@ TfLiteStatus PrepareMeanOrSumHelper(TfLiteContext* context, TfLiteNode* node,
   return kTfLiteOk;
 }
 
+namespace {
+
+// Mean of a 4D NHWC tensor over its height and width, the global average
+// pool at the end of most classifiers. Gives the same results as
+// reference_integer_ops::Mean, but adds whole pixels of contiguous channels
+// into per-channel int32 accumulators and requantizes each channel once at
+// the end, instead of walking the input one channel at a time.
+// accumulators must hold one value per channel.
+template <typename T>
+void MeanOverHeightAndWidth(int32_t multiplier, int32_t shift,
+                            const RuntimeShape& input_shape,
+                            const T* input_data, int32_t input_zero_point,
+                            T* output_data, int32_t output_zero_point,
+                            int32_t* accumulators) {
+  const int batches = input_shape.Dims(0);
+  const int num_elements_in_axis = input_shape.Dims(1) * input_shape.Dims(2);
+  const int depth = input_shape.Dims(3);
+  constexpr int32_t kMinValue = std::numeric_limits<T>::min();
+  constexpr int32_t kMaxValue = std::numeric_limits<T>::max();
+
+  for (int batch = 0; batch < batches; ++batch) {
+    std::fill(accumulators, accumulators + depth, 0);
+    for (int i = 0; i < num_elements_in_axis; ++i) {
+      for (int c = 0; c < depth; ++c) {
+        accumulators[c] += input_data[c];
+      }
+      input_data += depth;
+    }
+
+    for (int c = 0; c < depth; ++c) {
+      int32_t acc = accumulators[c] - num_elements_in_axis * input_zero_point;
+      acc = MultiplyByQuantizedMultiplier(acc, multiplier, shift);
+      acc = acc > 0 ? (acc + num_elements_in_axis / 2) / num_elements_in_axis
+                    : (acc - num_elements_in_axis / 2) / num_elements_in_axis;
+      acc += output_zero_point;
+      acc = std::min(std::max(acc, kMinValue), kMaxValue);
+      output_data[c] = static_cast<T>(acc);
+    }
+    output_data += depth;
+  }
+}
+
+}  // namespace
+
 void ResolveAxis(const int* axis_data, int axis_count,
                  tflite::MeanParams* op_params) {
   int i = 0;
@@ -176,12 +223,14 @@ TfLiteStatus EvalMeanHelper(TfLiteContext* context, TfLiteNode* node,
     case kTfLiteInt8: {
       // Defer to specialized implementation for 4D Mean across axes 1 & 2.
       if (params->keep_dims && special_case_4d_axes_1_and_2) {
-        reference_integer_ops::Mean(
-            op_params, op_data->multiplier, op_data->shift,
+        int32_t* temp_buffer = static_cast<int32_t*>(
+            context->GetScratchBuffer(context, op_data->temp_buffer_idx));
+        MeanOverHeightAndWidth(
+            op_data->multiplier, op_data->shift,
             tflite::micro::GetTensorShape(input),
             tflite::micro::GetTensorData<int8_t>(input), op_data->input_zp,
-            tflite::micro::GetTensorShape(output),
-            tflite::micro::GetTensorData<int8_t>(output), op_data->output_zp);
+            tflite::micro::GetTensorData<int8_t>(output), op_data->output_zp,
+            temp_buffer);
       } else if (op_data->input_zp == op_data->output_zp &&
                  op_data->input_scale == op_data->output_scale) {
         int32_t* temp_buffer = static_cast<int32_t*>(
@@ -212,12 +261,14 @@ TfLiteStatus EvalMeanHelper(TfLiteContext* context, TfLiteNode* node,
     case kTfLiteInt16: {
       // Defer to specialized implementation for 4D Mean across axes 1 & 2.
       if (params->keep_dims && special_case_4d_axes_1_and_2) {
-        reference_integer_ops::Mean(
-            op_params, op_data->multiplier, op_data->shift,
+        int32_t* temp_buffer = static_cast<int32_t*>(
+            context->GetScratchBuffer(context, op_data->temp_buffer_idx));
+        MeanOverHeightAndWidth(
+            op_data->multiplier, op_data->shift,
             tflite::micro::GetTensorShape(input),
             tflite::micro::GetTensorData<int16_t>(input), op_data->input_zp,
-            tflite::micro::GetTensorShape(output),
-            tflite::micro::GetTensorData<int16_t>(output), op_data->output_zp);
+            tflite::micro::GetTensorData<int16_t>(output), op_data->output_zp,
+            temp_buffer);
       } else if (op_data->input_zp == op_data->output_zp &&
                  op_data->input_scale == op_data->output_scale) {
         int32_t* temp_buffer = static_cast<int32_t*>(
@@ -614,4 +614,34 @@ TF_LITE_MICRO_TEST(MeanInt84DWithoutKeepDimsWithPrecision) {
       output_zero_point, &params);
 }
 
+TF_LITE_MICRO_TEST(MeanInt8GlobalAveragePoolManyChannels) {
+  constexpr int kHeight = 5;
+  constexpr int kWidth = 5;
+  constexpr int kDepth = 20;
+  constexpr int kInputElements = kHeight * kWidth * kDepth;
+  int input_shape[] = {4, 1, kHeight, kWidth, kDepth};
+  int output_shape[] = {4, 1, 1, 1, kDepth};
+  float input_data[kInputElements];
+  for (int i = 0; i < kInputElements; ++i) {
+    input_data[i] = static_cast<float>((i * 13) % 41 - 20) * 0.25f;
+  }
+  float expected_output_data[kDepth] = {};
+  for (int i = 0; i < kInputElements; ++i) {
+    expected_output_data[i % kDepth] += input_data[i] / (kHeight * kWidth);
+  }
+  TfLiteReducerParams params = {
+      true  // keep_dims
+  };
+
+  int8_t input_data_quant[kInputElements];
+  int8_t output_data_quant[kDepth];
+  int8_t expected_output_data_quant[kDepth];
+  tflite::testing::TestMeanOpQuantized<int8_t>(
+      input_shape, input_data, input_data_quant, /*input_scale=*/0.25f,
+      /*input_zero_point=*/-3, tflite::testing::kAxisShape4D,
+      tflite::testing::kAxisData4D, output_shape, expected_output_data,
+      output_data_quant, expected_output_data_quant, /*output_scale=*/0.1f,
+      /*output_zero_point=*/5, &params);
+}
+
 TF_LITE_MICRO_TESTS_END
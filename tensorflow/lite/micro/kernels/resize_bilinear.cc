@@ -14,6 +14,8 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/lite/kernels/internal/reference/resize_bilinear.h"
 
+#include <cstdint>
+
 #include "tensorflow/lite/c/builtin_op_data.h"
 #include "tensorflow/lite/c/common.h"
 #include "tensorflow/lite/kernels/internal/tensor_ctypes.h"
@@ -29,6 +31,141 @@ constexpr int kInputTensor = 0;
 constexpr int kSizeTensor = 1;
 constexpr int kOutputTensor = 0;
 
+// Source indices and weight of one output row or column of the integer
+// kernel. The weight of the upper index is in 1/1024ths and the lower index
+// gets 1024 - weight. With half pixel centers the first weight can be
+// negative, which matches reference_ops::ResizeBilinearInteger.
+struct InterpolationPoint {
+  int32_t lower;
+  int32_t upper;
+  int32_t weight;
+};
+
+struct OpData {
+  // Computed in Prepare for the integer kernels, nullptr for float.
+  InterpolationPoint* rows;
+  InterpolationPoint* columns;
+  // Two horizontally interpolated input rows.
+  int row_cache_index;
+};
+
+// Same scale as reference_ops::ResizeBilinearInteger, in 1/1024ths.
+int32_t IntegerScale(int32_t input_size, int32_t output_size,
+                     bool align_corners) {
+  if (align_corners && output_size > 1) {
+    return ((1 << 10) * (input_size - 1) + (output_size - 1) / 2) /
+           (output_size - 1);
+  }
+  return ((1 << 10) * input_size + output_size / 2) / output_size;
+}
+
+InterpolationPoint* PopulateInterpolationPoints(TfLiteContext* context,
+                                                int32_t input_size,
+                                                int32_t output_size,
+                                                bool align_corners,
+                                                bool half_pixel_centers) {
+  auto* points =
+      static_cast<InterpolationPoint*>(context->AllocatePersistentBuffer(
+          context, output_size * sizeof(InterpolationPoint)));
+  if (points == nullptr) {
+    return nullptr;
+  }
+  const int32_t scale_10 =
+      IntegerScale(input_size, output_size, align_corners);
+  for (int i = 0; i < output_size; ++i) {
+    int32_t scaled_value;
+    reference_ops::ComputeInterpolationValuesInteger(
+        i, scale_10, half_pixel_centers, input_size, &scaled_value,
+        &points[i].lower, &points[i].upper);
+    points[i].weight = scaled_value - (1 << 10) * points[i].lower;
+  }
+  return points;
+}
+
+// Horizontal pass: interpolates one input row to the output width, keeping
+// the 1/1024ths of the column weights.
+template <typename T>
+void InterpolateRow(const T* input_row, const InterpolationPoint* columns,
+                    int output_width, int depth, int32_t* row) {
+  for (int x = 0; x < output_width; ++x) {
+    const T* left = input_row + columns[x].lower * depth;
+    const T* right = input_row + columns[x].upper * depth;
+    const int32_t right_weight = columns[x].weight;
+    const int32_t left_weight = (1 << 10) - right_weight;
+    for (int c = 0; c < depth; ++c) {
+      row[c] = left[c] * left_weight + right[c] * right_weight;
+    }
+    row += depth;
+  }
+}
+
+// Separable integer resize: each output row is the vertical interpolation of
+// two horizontally interpolated input rows, and consecutive output rows
+// usually share their input rows, so the two most recent ones are cached in
+// row_cache. The integer sums are the same as in
+// reference_ops::ResizeBilinearInteger, so the outputs are bit-exact.
+//
+// AccT must hold the vertical sum, which needs 29 bits for int8 and 42 bits
+// for int16.
+template <typename T, typename AccT>
+void ResizeBilinearSeparable(const OpData& data,
+                             const RuntimeShape& input_shape,
+                             const T* input_data,
+                             const RuntimeShape& output_shape, T* output_data,
+                             int32_t* row_cache) {
+  const int batches = MatchingDim(input_shape, 0, output_shape, 0);
+  const int input_height = input_shape.Dims(1);
+  const int input_width = input_shape.Dims(2);
+  const int depth = MatchingDim(input_shape, 3, output_shape, 3);
+  const int output_height = output_shape.Dims(1);
+  const int output_width = output_shape.Dims(2);
+  const int input_row_size = input_width * depth;
+  const int output_row_size = output_width * depth;
+
+  int32_t* cached_rows[2] = {row_cache, row_cache + output_row_size};
+  for (int b = 0; b < batches; ++b) {
+    const T* input_batch = input_data + b * input_height * input_row_size;
+    int cached_y[2] = {-1, -1};
+
+    for (int y = 0; y < output_height; ++y) {
+      const InterpolationPoint& row = data.rows[y];
+      int slots[2];
+      const int32_t source_y[2] = {row.lower, row.upper};
+      for (int i = 0; i < 2; ++i) {
+        if (cached_y[0] == source_y[i]) {
+          slots[i] = 0;
+        } else if (cached_y[1] == source_y[i]) {
+          slots[i] = 1;
+        } else {
+          // Never evict the row the lower index was just resolved to.
+          slots[i] = (i == 1) ? 1 - slots[0] : (cached_y[0] == row.upper);
+          InterpolateRow(input_batch + source_y[i] * input_row_size,
+                         data.columns, output_width, depth,
+                         cached_rows[slots[i]]);
+          cached_y[slots[i]] = source_y[i];
+        }
+      }
+
+      // Vertical pass.
+      const int32_t* top = cached_rows[slots[0]];
+      const int32_t* bottom = cached_rows[slots[1]];
+      const AccT bottom_weight = row.weight;
+      const AccT top_weight = (1 << 10) - bottom_weight;
+      T* output_row = output_data + (b * output_height + y) * output_row_size;
+      for (int i = 0; i < output_row_size; ++i) {
+        const AccT output_20 = top[i] * top_weight + bottom[i] * bottom_weight;
+        const AccT round = (output_20 > 0) ? (1 << 19) : -(1 << 19);
+        output_row[i] = static_cast<T>((output_20 + round) / (1 << 20));
+      }
+    }
+  }
+}
+
+void* Init(TfLiteContext* context, const char* buffer, size_t length) {
+  TFLITE_DCHECK(context->AllocatePersistentBuffer != nullptr);
+  return context->AllocatePersistentBuffer(context, sizeof(OpData));
+}
+
 TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
   MicroContext* micro_context = GetMicroContext(context);
 
@@ -60,6 +197,31 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
     return kTfLiteError;
   }
 
+  OpData* data = static_cast<OpData*>(node->user_data);
+  data->rows = nullptr;
+  data->columns = nullptr;
+  if (input->type == kTfLiteInt8 || input->type == kTfLiteInt16) {
+    TF_LITE_ENSURE_EQ(context, NumElements(size), 2);
+    const int32_t* size_data = GetTensorData<int32_t>(size);
+    const int output_height = size_data[0];
+    const int output_width = size_data[1];
+    TF_LITE_ENSURE_EQ(context, SizeOfDimension(output, 1), output_height);
+    TF_LITE_ENSURE_EQ(context, SizeOfDimension(output, 2), output_width);
+
+    data->rows = PopulateInterpolationPoints(
+        context, SizeOfDimension(input, 1), output_height,
+        params->align_corners, params->half_pixel_centers);
+    data->columns = PopulateInterpolationPoints(
+        context, SizeOfDimension(input, 2), output_width,
+        params->align_corners, params->half_pixel_centers);
+    TF_LITE_ENSURE(context, data->rows != nullptr && data->columns != nullptr);
+
+    TF_LITE_ENSURE_STATUS(context->RequestScratchBufferInArena(
+        context,
+        2 * output_width * SizeOfDimension(input, 3) * sizeof(int32_t),
+        &data->row_cache_index));
+  }
+
   micro_context->DeallocateTempTfLiteTensor(input);
   micro_context->DeallocateTempTfLiteTensor(size);
   micro_context->DeallocateTempTfLiteTensor(output);
@@ -76,6 +238,13 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
       tflite::micro::GetEvalInput(context, node, kSizeTensor);
   TfLiteEvalTensor* output =
       tflite::micro::GetEvalOutput(context, node, kOutputTensor);
+  TFLITE_DCHECK(node->user_data != nullptr);
+  const OpData& data = *static_cast<const OpData*>(node->user_data);
+  int32_t* row_cache = nullptr;
+  if (data.rows != nullptr) {
+    row_cache = static_cast<int32_t*>(
+        context->GetScratchBuffer(context, data.row_cache_index));
+  }
 
   if (output->type == kTfLiteFloat32) {
     tflite::ResizeBilinearParams op_params;
@@ -89,18 +258,20 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
                                   tflite::micro::GetTensorShape(output),
                                   tflite::micro::GetTensorData<float>(output));
   } else if (output->type == kTfLiteInt8) {
-    tflite::ResizeBilinearParams op_params;
-    op_params.align_corners = params->align_corners;
-    op_params.half_pixel_centers = params->half_pixel_centers;
-    reference_ops::ResizeBilinearInteger(
-        op_params, tflite::micro::GetTensorShape(input),
+    ResizeBilinearSeparable<int8_t, int32_t>(
+        data, tflite::micro::GetTensorShape(input),
         tflite::micro::GetTensorData<int8_t>(input),
-        tflite::micro::GetTensorShape(size),
-        tflite::micro::GetTensorData<int32_t>(size),
         tflite::micro::GetTensorShape(output),
-        tflite::micro::GetTensorData<int8_t>(output));
+        tflite::micro::GetTensorData<int8_t>(output), row_cache);
+  } else if (output->type == kTfLiteInt16) {
+    ResizeBilinearSeparable<int16_t, int64_t>(
+        data, tflite::micro::GetTensorShape(input),
+        tflite::micro::GetTensorData<int16_t>(input),
+        tflite::micro::GetTensorShape(output),
+        tflite::micro::GetTensorData<int16_t>(output), row_cache);
   } else {
-    TF_LITE_KERNEL_LOG(context, "Output type is %d, requires float or int8.",
+    TF_LITE_KERNEL_LOG(context,
+                       "Output type is %d, requires float, int8 or int16.",
                        output->type);
     return kTfLiteError;
   }
@@ -111,7 +282,7 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
 }  // namespace
 
 TfLiteRegistration Register_RESIZE_BILINEAR() {
-  return tflite::micro::RegisterOp(nullptr, Prepare, Eval);
+  return tflite::micro::RegisterOp(Init, Prepare, Eval);
 }
 
 }  // namespace tflite
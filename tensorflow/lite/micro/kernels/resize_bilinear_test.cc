@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 
 #include "tensorflow/lite/c/builtin_op_data.h"
+#include "tensorflow/lite/kernels/internal/reference/resize_bilinear.h"
 #include "tensorflow/lite/micro/all_ops_resolver.h"
 #include "tensorflow/lite/micro/kernels/kernel_runner.h"
 #include "tensorflow/lite/micro/test_helpers.h"
@@ -31,6 +32,10 @@ TfLiteTensor TestCreateTensor(const int8_t* data, TfLiteIntArray* dims) {
   return CreateQuantizedTensor(data, dims, -128, 127);
 }
 
+TfLiteTensor TestCreateTensor(const int16_t* data, TfLiteIntArray* dims) {
+  return CreateQuantizedTensor(data, dims, 1.0f, 0);
+}
+
 template <typename T>
 TfLiteStatus ValidateGoldens(TfLiteTensor* tensors, int tensors_size,
                              const T* expected_output_data, T* output_data,
@@ -88,6 +93,38 @@ void TestResizeBilinear(int* input_dims_data, const T* input_data,
                       output_dims_count, params, tolerance));
 }
 
+// Upsamples a 2x5x4x3 input by 3 in both directions and expects the same
+// outputs as reference_ops::ResizeBilinearInteger.
+template <typename T>
+void TestResizeBilinearIntegerMatchesReference(
+    TfLiteResizeBilinearParams* params) {
+  constexpr int kInputElements = 2 * 5 * 4 * 3;
+  constexpr int kOutputElements = 2 * 15 * 12 * 3;
+  int input_dims[] = {4, 2, 5, 4, 3};
+  int output_dims[] = {4, 2, 15, 12, 3};
+  const int32_t size_data[] = {15, 12};
+
+  T input_data[kInputElements];
+  for (int i = 0; i < kInputElements; ++i) {
+    input_data[i] = static_cast<T>((i * 73) % 251 - 125);
+  }
+
+  ResizeBilinearParams op_params;
+  op_params.align_corners = params->align_corners;
+  op_params.half_pixel_centers = params->half_pixel_centers;
+  int32_t size_shape_data = 2;
+  T expected_output_data[kOutputElements];
+  reference_ops::ResizeBilinearInteger(
+      op_params, RuntimeShape(4, input_dims + 1), input_data,
+      RuntimeShape(1, &size_shape_data), size_data,
+      RuntimeShape(4, output_dims + 1), expected_output_data);
+
+  T output_data[kOutputElements];
+  TestResizeBilinear<T>(input_dims, input_data, size_data,
+                        expected_output_data, output_dims, output_data, params,
+                        /*tolerance=*/0);
+}
+
 }  // namespace
 }  // namespace testing
 }  // namespace tflite
@@ -327,4 +364,22 @@ TF_LITE_MICRO_TEST(ThreeDimensionalResizeInt8) {
       output_dims, output_data, &params, /*tolerance=*/1);
 }
 
+TF_LITE_MICRO_TEST(UpsampleInt8MatchesReference) {
+  TfLiteResizeBilinearParams params = {false, false};
+  tflite::testing::TestResizeBilinearIntegerMatchesReference<int8_t>(&params);
+  params = {true, false};
+  tflite::testing::TestResizeBilinearIntegerMatchesReference<int8_t>(&params);
+  params = {false, true};
+  tflite::testing::TestResizeBilinearIntegerMatchesReference<int8_t>(&params);
+}
+
+TF_LITE_MICRO_TEST(UpsampleInt16MatchesReference) {
+  TfLiteResizeBilinearParams params = {false, false};
+  tflite::testing::TestResizeBilinearIntegerMatchesReference<int16_t>(&params);
+  params = {true, false};
+  tflite::testing::TestResizeBilinearIntegerMatchesReference<int16_t>(&params);
+  params = {false, true};
+  tflite::testing::TestResizeBilinearIntegerMatchesReference<int16_t>(&params);
+}
+
 TF_LITE_MICRO_TESTS_END
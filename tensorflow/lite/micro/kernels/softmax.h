@@ -32,6 +32,18 @@ TfLiteStatus CalculateSoftmaxParams(TfLiteContext* context,
 
 TfLiteStatus SoftmaxPrepare(TfLiteContext* context, TfLiteNode* node);
 
+// Builds the exp table for int8 input from params computed by
+// CalculateSoftmaxParams. Entry d covers an input d steps below the row max
+// and is computed exactly as in reference_ops::Softmax, so SoftmaxInt8ExpLut
+// is bit-exact with it. Returns nullptr if the allocation fails.
+int32_t* PopulateSoftmaxInt8ExpLut(TfLiteContext* context,
+                                   const SoftmaxParams& op_data);
+
+// int8 to int8 or int16 softmax that reads exp values from a table built by
+// PopulateSoftmaxInt8ExpLut instead of evaluating them per element.
+void SoftmaxInt8ExpLut(const int32_t* exp_lut, const TfLiteEvalTensor* input,
+                       TfLiteEvalTensor* output);
+
 // This is the most generic TfLiteRegistration. The actual supported types may
 // still be target dependent. The only requirement is that every implementation
 // (reference or optimized) must define this function.
@@ -13,38 +13,32 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
+#include <limits>
+
 #include "tensorflow/lite/c/builtin_op_data.h"
 #include "tensorflow/lite/c/common.h"
 #include "tensorflow/lite/kernels/internal/common.h"
 #include "tensorflow/lite/kernels/internal/quantization_util.h"
+#include "tensorflow/lite/kernels/internal/tensor_ctypes.h"
 #include "tensorflow/lite/kernels/kernel_util.h"
 #include "tensorflow/lite/kernels/op_macros.h"
+#include "tensorflow/lite/micro/kernels/kernel_util.h"
+#include "tensorflow/lite/micro/kernels/lut_activation.h"
 #include "tensorflow/lite/micro/kernels/softmax.h"
 #include "tensorflow/lite/micro/micro_context.h"
 
 namespace tflite {
 
 namespace {
-// Softmax parameter data that persists in user_data
-const int kInt16LUTArraySize = 513;
+// Fixed-point formats of reference_ops::Softmax for 8-bit inputs.
+constexpr int kScaledDiffIntegerBits = 5;
+constexpr int kAccumulationIntegerBits = 12;
 
 TfLiteStatus InitializeLutForInt16(TfLiteContext* context,
                                    const TfLiteTensor* input,
                                    TfLiteTensor* output,
                                    SoftmaxParams* op_data) {
-  // Only allocate LUTs for KTfLiteInt16 data type
-  if (input->type == kTfLiteInt16) {
-    void* raw_exp_lut = context->AllocatePersistentBuffer(
-        context, sizeof(int16_t) * kInt16LUTArraySize);
-    TF_LITE_ENSURE(context, raw_exp_lut != nullptr);
-    op_data->exp_lut = reinterpret_cast<int16_t*>(raw_exp_lut);
-    void* one_over_one_plus_x_lut = context->AllocatePersistentBuffer(
-        context, sizeof(int16_t) * kInt16LUTArraySize);
-    TF_LITE_ENSURE(context, one_over_one_plus_x_lut != nullptr);
-    op_data->one_over_one_plus_x_lut =
-        reinterpret_cast<int16_t*>(one_over_one_plus_x_lut);
-  }
-
   if (output->type == kTfLiteInt16) {
     TF_LITE_ENSURE(context,
                    input->type == kTfLiteInt8 || input->type == kTfLiteInt16);
@@ -57,12 +51,14 @@ TfLiteStatus InitializeLutForInt16(TfLiteContext* context,
     TF_LITE_ENSURE_EQ(context, output->params.zero_point, 0);
     // exp LUT only used on negative values
     // we consider exp(-10.0) is insignificant to accumulation
-    gen_lut<float, int16_t, int16_t>(
-        [](float value) { return std::exp(value); }, -10.0f, 0.0f, -1.0f, 1.0f,
-        op_data->exp_lut);
-    gen_lut<float, int16_t, int16_t>(
-        [](float value) { return 1.0f / (1.0f + value); }, 0.0f, 1.0f, -1.0f,
-        1.0f, op_data->one_over_one_plus_x_lut);
+    op_data->exp_lut = PopulateInt16Lut(
+        context, [](float value) { return std::exp(value); }, -10.0f, 0.0f,
+        -1.0f, 1.0f);
+    TF_LITE_ENSURE(context, op_data->exp_lut != nullptr);
+    op_data->one_over_one_plus_x_lut = PopulateInt16Lut(
+        context, [](float value) { return 1.0f / (1.0f + value); }, 0.0f,
+        1.0f, -1.0f, 1.0f);
+    TF_LITE_ENSURE(context, op_data->one_over_one_plus_x_lut != nullptr);
     op_data->zero_point = output->params.zero_point;
     op_data->scale = output->params.scale;
   }
@@ -70,6 +66,82 @@ TfLiteStatus InitializeLutForInt16(TfLiteContext* context,
   return kTfLiteOk;
 }
 
+// Each row reads exp_lut[max - x], so the reduction over the row is the only
+// work left that depends on the input values. The max and sum use four
+// independent accumulators to break the dependency chain on long rows.
+template <typename OutputT>
+void SoftmaxInt8ExpLutImpl(const int32_t* exp_lut,
+                           const RuntimeShape& input_shape,
+                           const int8_t* input_data,
+                           const RuntimeShape& output_shape,
+                           OutputT* output_data) {
+  using FixedPoint0 = gemmlowp::FixedPoint<int32_t, 0>;
+  const int32_t* accum_lut = exp_lut + kInt8LutSize;
+
+  const int trailing_dim = input_shape.DimensionsCount() - 1;
+  const int outer_size =
+      MatchingFlatSizeSkipDim(input_shape, trailing_dim, output_shape);
+  const int depth =
+      MatchingDim(input_shape, trailing_dim, output_shape, trailing_dim);
+  constexpr int32_t kOutputMin = std::numeric_limits<OutputT>::min();
+  constexpr int32_t kOutputMax = std::numeric_limits<OutputT>::max();
+
+  for (int i = 0; i < outer_size; ++i) {
+    const int8_t* input_row = input_data + i * depth;
+    OutputT* output_row = output_data + i * depth;
+
+    int32_t max0 = std::numeric_limits<int8_t>::min();
+    int32_t max1 = max0;
+    int32_t max2 = max0;
+    int32_t max3 = max0;
+    int c = 0;
+    for (; c <= depth - 4; c += 4) {
+      max0 = std::max(max0, static_cast<int32_t>(input_row[c]));
+      max1 = std::max(max1, static_cast<int32_t>(input_row[c + 1]));
+      max2 = std::max(max2, static_cast<int32_t>(input_row[c + 2]));
+      max3 = std::max(max3, static_cast<int32_t>(input_row[c + 3]));
+    }
+    for (; c < depth; ++c) {
+      max0 = std::max(max0, static_cast<int32_t>(input_row[c]));
+    }
+    const int32_t max_in_row =
+        std::max(std::max(max0, max1), std::max(max2, max3));
+
+    // Plain int32 addition is what FixedPointAccum::operator+ does, so the
+    // partial sums reassociate without changing the result.
+    int32_t sum0 = 0;
+    int32_t sum1 = 0;
+    int32_t sum2 = 0;
+    int32_t sum3 = 0;
+    c = 0;
+    for (; c <= depth - 4; c += 4) {
+      sum0 += accum_lut[max_in_row - input_row[c]];
+      sum1 += accum_lut[max_in_row - input_row[c + 1]];
+      sum2 += accum_lut[max_in_row - input_row[c + 2]];
+      sum3 += accum_lut[max_in_row - input_row[c + 3]];
+    }
+    for (; c < depth; ++c) {
+      sum0 += accum_lut[max_in_row - input_row[c]];
+    }
+    const int32_t sum_of_exps = sum0 + sum1 + sum2 + sum3;
+
+    int num_bits_over_unit;
+    const FixedPoint0 shifted_scale = FixedPoint0::FromRaw(GetReciprocal(
+        sum_of_exps, kAccumulationIntegerBits, &num_bits_over_unit));
+    const int output_shift =
+        num_bits_over_unit + 31 - static_cast<int>(sizeof(OutputT) * 8);
+
+    for (c = 0; c < depth; ++c) {
+      const FixedPoint0 exp_in_0 =
+          FixedPoint0::FromRaw(exp_lut[max_in_row - input_row[c]]);
+      const int32_t unsat_output = gemmlowp::RoundingDivideByPOT(
+          (shifted_scale * exp_in_0).raw(), output_shift);
+      output_row[c] = static_cast<OutputT>(std::max(
+          std::min(unsat_output + kOutputMin, kOutputMax), kOutputMin));
+    }
+  }
+}
+
 }  // namespace
 
 TfLiteStatus CalculateSoftmaxParams(TfLiteContext* context,
@@ -99,8 +171,6 @@ TfLiteStatus CalculateSoftmaxParams(TfLiteContext* context,
       }
     }
 
-    static const int kScaledDiffIntegerBits = 5;
-
     // Calculate input_multiplier and input_left_shift
     if (input->type == kTfLiteInt16) {
       int input_left_shift;
@@ -159,4 +229,54 @@ TfLiteStatus SoftmaxPrepare(TfLiteContext* context, TfLiteNode* node) {
   return ret_val;
 }
 
+int32_t* PopulateSoftmaxInt8ExpLut(TfLiteContext* context,
+                                   const SoftmaxParams& op_data) {
+  using FixedPointScaledDiff =
+      gemmlowp::FixedPoint<int32_t, kScaledDiffIntegerBits>;
+
+  TFLITE_DCHECK(context->AllocatePersistentBuffer != nullptr);
+  int32_t* exp_lut = static_cast<int32_t*>(context->AllocatePersistentBuffer(
+      context, sizeof(int32_t) * 2 * kInt8LutSize));
+  if (exp_lut == nullptr) {
+    return nullptr;
+  }
+  int32_t* accum_lut = exp_lut + kInt8LutSize;
+
+  // Entries below diff_min are skipped by the reference kernel. Storing zero
+  // for them leaves the sum unchanged and clamps their output to the minimum,
+  // which is what the reference writes.
+  for (int diff = 0; diff < kInt8LutSize; ++diff) {
+    if (-diff >= op_data.diff_min) {
+      const int32_t input_diff_rescaled =
+          MultiplyByQuantizedMultiplierGreaterThanOne(
+              -diff, op_data.input_multiplier, op_data.input_left_shift);
+      const auto exp_in_0 = gemmlowp::exp_on_negative_values(
+          FixedPointScaledDiff::FromRaw(input_diff_rescaled));
+      exp_lut[diff] = exp_in_0.raw();
+      accum_lut[diff] =
+          gemmlowp::Rescale<kAccumulationIntegerBits>(exp_in_0).raw();
+    } else {
+      exp_lut[diff] = 0;
+      accum_lut[diff] = 0;
+    }
+  }
+  return exp_lut;
+}
+
+void SoftmaxInt8ExpLut(const int32_t* exp_lut, const TfLiteEvalTensor* input,
+                       TfLiteEvalTensor* output) {
+  TFLITE_DCHECK(exp_lut != nullptr);
+  if (output->type == kTfLiteInt16) {
+    SoftmaxInt8ExpLutImpl(exp_lut, tflite::micro::GetTensorShape(input),
+                          tflite::micro::GetTensorData<int8_t>(input),
+                          tflite::micro::GetTensorShape(output),
+                          tflite::micro::GetTensorData<int16_t>(output));
+  } else {
+    SoftmaxInt8ExpLutImpl(exp_lut, tflite::micro::GetTensorShape(input),
+                          tflite::micro::GetTensorData<int8_t>(input),
+                          tflite::micro::GetTensorShape(output),
+                          tflite::micro::GetTensorData<int8_t>(output));
+  }
+}
+
 }  // namespace tflite
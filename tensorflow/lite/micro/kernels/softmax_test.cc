@@ -15,6 +15,8 @@ limitations under the License.
 
 #include "tensorflow/lite/c/builtin_op_data.h"
 #include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/kernels/internal/quantization_util.h"
+#include "tensorflow/lite/kernels/internal/reference/softmax.h"
 #include "tensorflow/lite/micro/all_ops_resolver.h"
 #include "tensorflow/lite/micro/kernels/kernel_runner.h"
 #include "tensorflow/lite/micro/test_helpers.h"
@@ -314,6 +316,63 @@ void TestSoftmaxQuantized(int* input_dims_data, const float* input_data,
                          output_dims_count, tolerance);
 }
 
+// Runs a wide int8 softmax through the kernel and checks it against
+// reference_ops::Softmax bit for bit, with params derived as in Prepare.
+template <typename outputT>
+void TestSoftmaxInt8MatchesReference(float input_scale, int input_zero_point,
+                                     float beta, float output_scale,
+                                     int output_zero_point) {
+  constexpr int kRows = 2;
+  constexpr int kDepth = 1000;
+  constexpr int kSize = kRows * kDepth;
+  int8_t input_data[kSize];
+  outputT output_data[kSize];
+  outputT expected_data[kSize];
+  for (int i = 0; i < kSize; ++i) {
+    input_data[i] = static_cast<int8_t>((i * 37 + (i >> 3)) % 256 - 128);
+  }
+
+  int dims_data[] = {2, kRows, kDepth};
+  TfLiteIntArray* dims = IntArrayFromInts(dims_data);
+  constexpr int tensors_size = 2;
+  TfLiteTensor tensors[tensors_size] = {
+      CreateQuantizedTensor(input_data, dims, input_scale, input_zero_point),
+      CreateQuantizedTensor(output_data, dims, output_scale,
+                            output_zero_point),
+  };
+
+  TfLiteSoftmaxParams builtin_data = {beta};
+  int inputs_array_data[] = {1, 0};
+  TfLiteIntArray* inputs_array = IntArrayFromInts(inputs_array_data);
+  int outputs_array_data[] = {1, 1};
+  TfLiteIntArray* outputs_array = IntArrayFromInts(outputs_array_data);
+
+  const TfLiteRegistration registration = Register_SOFTMAX();
+  micro::KernelRunner runner(registration, tensors, tensors_size, inputs_array,
+                             outputs_array, &builtin_data);
+
+  TF_LITE_MICRO_EXPECT_EQ(kTfLiteOk, runner.InitAndPrepare());
+  TF_LITE_MICRO_EXPECT_EQ(kTfLiteOk, runner.Invoke());
+
+  constexpr int kScaledDiffIntegerBits = 5;
+  SoftmaxParams op_data;
+  int input_left_shift;
+  PreprocessSoftmaxScaling(static_cast<double>(beta),
+                           static_cast<double>(input_scale),
+                           kScaledDiffIntegerBits, &op_data.input_multiplier,
+                           &input_left_shift);
+  op_data.input_left_shift = input_left_shift;
+  op_data.diff_min =
+      -1.0 * CalculateInputRadius(kScaledDiffIntegerBits, input_left_shift);
+  const int32_t shape_data[] = {kRows, kDepth};
+  const RuntimeShape shape(2, shape_data);
+  reference_ops::Softmax(op_data, shape, input_data, shape, expected_data);
+
+  for (int i = 0; i < kSize; ++i) {
+    TF_LITE_MICRO_EXPECT_EQ(expected_data[i], output_data[i]);
+  }
+}
+
 }  // namespace
 }  // namespace testing
 }  // namespace tflite
@@ -486,4 +545,24 @@ TF_LITE_MICRO_TEST(Softmax2DQuantizedInt8InputInt16OutputShouldMatchGolden) {
       output_zero_point, output_data);
 }
 
+TF_LITE_MICRO_TEST(SoftmaxWideInt8MatchesReference) {
+  tflite::testing::TestSoftmaxInt8MatchesReference<int8_t>(
+      0.1f, 0, 1.0f, tflite::testing::output_scale_int8,
+      tflite::testing::output_zero_point_int8);
+  tflite::testing::TestSoftmaxInt8MatchesReference<int8_t>(
+      0.05f, -20, 0.5f, tflite::testing::output_scale_int8,
+      tflite::testing::output_zero_point_int8);
+  // Large enough input scale that part of each row falls below diff_min.
+  tflite::testing::TestSoftmaxInt8MatchesReference<int8_t>(
+      0.4f, 10, 1.0f, tflite::testing::output_scale_int8,
+      tflite::testing::output_zero_point_int8);
+}
+
+TF_LITE_MICRO_TEST(SoftmaxWideInt8InputInt16OutputMatchesReference) {
+  tflite::testing::TestSoftmaxInt8MatchesReference<int16_t>(
+      0.1f, 0, 1.0f, 1.0f / 65536.0f, -32768);
+  tflite::testing::TestSoftmaxInt8MatchesReference<int16_t>(
+      0.4f, 10, 2.0f, 1.0f / 65536.0f, -32768);
+}
+
 TF_LITE_MICRO_TESTS_END
@@ -97,6 +97,11 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
   TF_LITE_ENSURE(context, axis_value >= 0);
   TF_LITE_ENSURE(context, axis_value < input->dims->size);
 
+  // The memory planner may have made the outputs views of the input already.
+  if (tflite::micro::OutputsArePlannedAsSlicesOf(context, node, input)) {
+    return kTfLiteOk;
+  }
+
   switch (input->type) {
     case kTfLiteFloat32: {
       return SplitImpl<float>(context, node, input, axis_value);
@@ -24,6 +24,7 @@ limitations under the License.
 #include "tensorflow/lite/kernels/kernel_util.h"
 #include "tensorflow/lite/kernels/op_macros.h"
 #include "tensorflow/lite/micro/kernels/kernel_util.h"
+#include "tensorflow/lite/micro/kernels/lut_activation.h"
 #include "tensorflow/lite/micro/micro_utils.h"
 
 namespace tflite {
@@ -39,6 +40,8 @@ struct OpData {
   int32_t input_range_radius;
   int32_t input_multiplier;
   int input_left_shift;
+  // Table of all int8 outputs, only set for int8 inputs.
+  const int8_t* int8_lut;
 };
 
 void* TanhInit(TfLiteContext* context, const char* buffer, size_t length) {
@@ -143,6 +146,22 @@ TfLiteStatus TanhPrepare(TfLiteContext* context, TfLiteNode* node) {
   data->input_zero_point = input->params.zero_point;
   TF_LITE_ENSURE_OK(context, CalculateArithmeticOpData(context, node, data));
 
+  data->int8_lut = nullptr;
+  if (input->type == kTfLiteInt8) {
+    // Precompute the reference result for each of the 256 int8 inputs so that
+    // Eval is a single gather.
+    data->int8_lut = PopulateInt8Lut(
+        context,
+        [data](const int8_t* input_data, int8_t* output_data, int size) {
+          const RuntimeShape shape(1, size);
+          reference_integer_ops::Tanh(
+              data->input_zero_point, data->input_range_radius,
+              data->input_multiplier, data->input_left_shift, shape,
+              input_data, shape, output_data);
+        });
+    TF_LITE_ENSURE(context, data->int8_lut != nullptr);
+  }
+
   micro_context->DeallocateTempTfLiteTensor(input);
   return kTfLiteOk;
 }
@@ -176,12 +195,7 @@ TfLiteStatus TanhEval(TfLiteContext* context, TfLiteNode* node) {
       return kTfLiteOk;
     } break;
     case kTfLiteInt8: {
-      reference_integer_ops::Tanh(
-          data.input_zero_point, data.input_range_radius, data.input_multiplier,
-          data.input_left_shift, tflite::micro::GetTensorShape(input),
-          tflite::micro::GetTensorData<int8_t>(input),
-          tflite::micro::GetTensorShape(output),
-          tflite::micro::GetTensorData<int8_t>(output));
+      EvalInt8Lut(data.int8_lut, input, output);
       return kTfLiteOk;
     } break;
     default:
@@ -15,6 +15,8 @@ limitations under the License.
 
 #include "tensorflow/lite/c/builtin_op_data.h"
 #include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/kernels/internal/quantization_util.h"
+#include "tensorflow/lite/kernels/internal/reference/integer_ops/tanh.h"
 #include "tensorflow/lite/micro/kernels/kernel_runner.h"
 #include "tensorflow/lite/micro/test_helpers.h"
 #include "tensorflow/lite/micro/testing/micro_test.h"
@@ -228,6 +230,59 @@ void TestTanhQuantized(int input_dims_data[], const float* input_data,
   }
 }
 
+// Feeds all 256 int8 values through the kernel and compares against
+// reference_integer_ops::Tanh with the parameters Prepare derives.
+void TestTanhInt8MatchesReference(float input_scale, int input_zero_point) {
+  constexpr int kSize = 256;
+  int8_t input_data[kSize];
+  int8_t output_data[kSize];
+  int8_t expected_data[kSize];
+  for (int i = 0; i < kSize; ++i) {
+    input_data[i] = static_cast<int8_t>(i - 128);
+  }
+
+  const float output_scale = 1.0f / 128.0f;
+  const int output_zero_point = 0;
+  int dims_data[] = {1, kSize};
+  TfLiteIntArray* dims = IntArrayFromInts(dims_data);
+  constexpr int tensors_size = 2;
+  TfLiteTensor tensors[tensors_size] = {
+      CreateQuantizedTensor(input_data, dims, input_scale, input_zero_point),
+      CreateQuantizedTensor(output_data, dims, output_scale,
+                            output_zero_point)};
+
+  int inputs_array_data[] = {1, 0};
+  TfLiteIntArray* inputs_array = IntArrayFromInts(inputs_array_data);
+  int outputs_array_data[] = {1, 1};
+  TfLiteIntArray* outputs_array = IntArrayFromInts(outputs_array_data);
+
+  const TfLiteRegistration registration = tflite::ops::micro::Register_TANH();
+  micro::KernelRunner runner(registration, tensors, tensors_size, inputs_array,
+                             outputs_array, /*builtin_data=*/nullptr);
+
+  TF_LITE_MICRO_EXPECT_EQ(kTfLiteOk, runner.InitAndPrepare());
+  TF_LITE_MICRO_EXPECT_EQ(kTfLiteOk, runner.Invoke());
+
+  constexpr int kInputIntegerBits = 4;
+  const double input_real_multiplier =
+      static_cast<double>(input_scale) *
+      static_cast<double>(1 << (31 - kInputIntegerBits));
+  int input_left_shift;
+  const double q = std::frexp(input_real_multiplier, &input_left_shift);
+  const int32_t input_multiplier =
+      static_cast<int32_t>(TfLiteRound(q * (1ll << 31)));
+  const int32_t input_range_radius =
+      CalculateInputRadius(kInputIntegerBits, input_left_shift, 31);
+  const RuntimeShape shape(1, kSize);
+  reference_integer_ops::Tanh(input_zero_point, input_range_radius,
+                              input_multiplier, input_left_shift, shape,
+                              input_data, shape, expected_data);
+
+  for (int i = 0; i < kSize; ++i) {
+    TF_LITE_MICRO_EXPECT_EQ(expected_data[i], output_data[i]);
+  }
+}
+
 }  // namespace
 }  // namespace testing
 }  // namespace tflite
@@ -309,4 +364,10 @@ TF_LITE_MICRO_TEST(TestTanhInt16WideRange) {
   );
 }
 
+TF_LITE_MICRO_TEST(TestTanhInt8AllInputsMatchReference) {
+  tflite::testing::TestTanhInt8MatchesReference(16 / 256.f, 0);
+  tflite::testing::TestTanhInt8MatchesReference(0.03f, -5);
+  tflite::testing::TestTanhInt8MatchesReference(0.2f, 31);
+}
+
 TF_LITE_MICRO_TESTS_END
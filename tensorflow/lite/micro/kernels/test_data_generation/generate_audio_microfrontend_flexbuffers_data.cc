@@ -0,0 +1,95 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "flatbuffers/flexbuffers.h"
+
+const char* license =
+    "/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.\n"
+    "Licensed under the Apache License, Version 2.0 (the \"License\");\n"
+    "you may not use this file except in compliance with the License.\n"
+    "You may obtain a copy of the License at\n\n"
+    "    http://www.apache.org/licenses/LICENSE-2.0\n\n"
+    "Unless required by applicable law or agreed to in writing, software\n"
+    "distributed under the License is distributed on an \"AS IS\" BASIS,\n"
+    "WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.\n"
+    "See the License for the specific language governing permissions and\n"
+    "limitations under the License.\n"
+    "======================================================================="
+    "=======*/\n";
+
+// A small frontend configuration (8ms windows, 8 channels) so that the kernel
+// state fits in the KernelRunner arena.
+void generate(const char* name, bool out_float, int out_scale,
+              bool zero_padding, int left_context, int right_context,
+              int frame_stride) {
+  flexbuffers::Builder fbb;
+  fbb.Map([&]() {
+    fbb.Int("sample_rate", 16000);
+    fbb.Int("window_size", 8);
+    fbb.Int("window_step", 4);
+    fbb.Int("num_channels", 8);
+    fbb.Float("upper_band_limit", 7500.0);
+    fbb.Float("lower_band_limit", 125.0);
+    fbb.Int("smoothing_bits", 10);
+    fbb.Float("even_smoothing", 0.025);
+    fbb.Float("odd_smoothing", 0.06);
+    fbb.Float("min_signal_remaining", 0.05);
+    fbb.Bool("enable_pcan", true);
+    fbb.Float("pcan_strength", 0.95);
+    fbb.Float("pcan_offset", 80.0);
+    fbb.Int("gain_bits", 21);
+    fbb.Bool("enable_log", true);
+    fbb.Int("scale_shift", 6);
+    fbb.Int("left_context", left_context);
+    fbb.Int("right_context", right_context);
+    fbb.Int("frame_stride", frame_stride);
+    fbb.Int("out_scale", out_scale);
+    fbb.Bool("out_float", out_float);
+    fbb.Bool("zero_padding", zero_padding);
+  });
+  fbb.Finish();
+
+  // fbb.GetBuffer returns std::Vector<uint8_t> but TfLite passes char arrays
+  // for the raw data, and so we reinterpret_cast.
+  const uint8_t* init_data =
+      reinterpret_cast<const uint8_t*>(fbb.GetBuffer().data());
+  int fbb_size = fbb.GetBuffer().size();
+
+  printf("const int g_gen_data_size_%s = %d;\n", name, fbb_size);
+  printf("const unsigned char g_gen_data_%s[] = { ", name);
+  for (size_t i = 0; i < fbb_size; i++) {
+    printf("0x%02x, ", init_data[i]);
+  }
+  printf("};\n");
+}
+
+int main() {
+  printf("%s\n", license);
+  printf("// This file is generated. See:\n");
+  printf("// tensorflow/lite/micro/kernels/test_data_generation/");
+  printf("README.md\n");
+  printf("\n");
+  printf(
+      "#include "
+      "\"tensorflow/lite/micro/kernels/"
+      "audio_microfrontend_flexbuffers_generated_data.h\"");
+  printf("\n\n");
+  generate("audio_microfrontend_int32_config", /*out_float=*/false,
+           /*out_scale=*/1, /*zero_padding=*/false, /*left_context=*/1,
+           /*right_context=*/1, /*frame_stride=*/2);
+  printf("\n");
+  generate("audio_microfrontend_float_config", /*out_float=*/true,
+           /*out_scale=*/10, /*zero_padding=*/true, /*left_context=*/2,
+           /*right_context=*/0, /*frame_stride=*/1);
+}
@@ -12,7 +12,8 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
-#include "tensorflow/lite/kernels/internal/reference/transpose.h"
+#include <algorithm>
+#include <cstring>
 
 #include "tensorflow/lite/c/common.h"
 #include "tensorflow/lite/kernels/internal/tensor_ctypes.h"
@@ -26,6 +27,12 @@ namespace {
 constexpr int kInputTensor = 0;
 constexpr int kPermTensor = 1;
 constexpr int kOutputTensor = 0;
+constexpr int kMaxDims = 5;
+
+// Square tile edge, in elements, for the 2-D transpose. A tile of the widest
+// supported type is 1KiB, so the rows being read and the rows being written
+// stay cached while the tile is transposed.
+constexpr int kTileSize = 16;
 
 struct TransposeContext {
   TransposeContext(TfLiteContext* context, TfLiteNode* node) {
@@ -45,6 +52,163 @@ struct TransposeContext {
   TfLiteTensor* output;
 };
 
+// Transpose with size-1 axes dropped and runs of input axes that stay
+// adjacent and in order in the output merged into single axes. Most real
+// permutations collapse to rank 3 or less, e.g. NHWC->NCHW becomes
+// [N, HW, C] with perm {0, 2, 1}.
+struct CollapsedTranspose {
+  int rank;
+  int32_t dims[kMaxDims];
+  int perm[kMaxDims];
+};
+
+void CollapseTranspose(const TransposeParams& params,
+                       const RuntimeShape& input_shape,
+                       CollapsedTranspose* collapsed) {
+  const int rank = input_shape.DimensionsCount();
+
+  // Drop size-1 axes, renumbering the remaining ones.
+  int squeezed_index[kMaxDims];
+  int32_t squeezed_dims[kMaxDims];
+  int squeezed_rank = 0;
+  for (int i = 0; i < rank; ++i) {
+    if (input_shape.Dims(i) == 1) {
+      squeezed_index[i] = -1;
+    } else {
+      squeezed_index[i] = squeezed_rank;
+      squeezed_dims[squeezed_rank++] = input_shape.Dims(i);
+    }
+  }
+  int squeezed_perm[kMaxDims];
+  int squeezed_perm_count = 0;
+  for (int k = 0; k < params.perm_count; ++k) {
+    const int axis = squeezed_index[params.perm[k]];
+    if (axis >= 0) {
+      squeezed_perm[squeezed_perm_count++] = axis;
+    }
+  }
+
+  // An input axis is merged into its predecessor when the output also reads
+  // it right after that predecessor.
+  int output_position[kMaxDims];
+  for (int k = 0; k < squeezed_rank; ++k) {
+    output_position[squeezed_perm[k]] = k;
+  }
+  int group[kMaxDims];
+  collapsed->rank = 0;
+  for (int i = 0; i < squeezed_rank; ++i) {
+    if (i > 0 && output_position[i] == output_position[i - 1] + 1) {
+      group[i] = group[i - 1];
+      collapsed->dims[group[i]] *= squeezed_dims[i];
+    } else {
+      group[i] = collapsed->rank++;
+      collapsed->dims[group[i]] = squeezed_dims[i];
+    }
+  }
+  int perm_count = 0;
+  for (int k = 0; k < squeezed_rank; ++k) {
+    if (k == 0 || squeezed_perm[k] != squeezed_perm[k - 1] + 1) {
+      collapsed->perm[perm_count++] = group[squeezed_perm[k]];
+    }
+  }
+  TFLITE_DCHECK_EQ(perm_count, collapsed->rank);
+}
+
+// Transposes a rows x cols row-major matrix in square tiles.
+template <typename T>
+void Transpose2D(int rows, int cols, const T* input_data, T* output_data) {
+  for (int row0 = 0; row0 < rows; row0 += kTileSize) {
+    const int row_end = std::min(row0 + kTileSize, rows);
+    for (int col0 = 0; col0 < cols; col0 += kTileSize) {
+      const int col_end = std::min(col0 + kTileSize, cols);
+      for (int col = col0; col < col_end; ++col) {
+        T* output_row = output_data + col * rows;
+        for (int row = row0; row < row_end; ++row) {
+          output_row[row] = input_data[row * cols + col];
+        }
+      }
+    }
+  }
+}
+
+// Walks the output in order. When the innermost input axis stays innermost,
+// each step copies a whole contiguous run of it; otherwise the innermost
+// output axis is gathered with a fixed input stride.
+template <typename T>
+void TransposeStrided(const CollapsedTranspose& op, const T* input_data,
+                      T* output_data) {
+  const int rank = op.rank;
+  int32_t input_strides[kMaxDims];
+  input_strides[rank - 1] = 1;
+  for (int i = rank - 2; i >= 0; --i) {
+    input_strides[i] = input_strides[i + 1] * op.dims[i + 1];
+  }
+
+  int32_t output_dims[kMaxDims];
+  int32_t strides[kMaxDims];
+  for (int k = 0; k < rank; ++k) {
+    output_dims[k] = op.dims[op.perm[k]];
+    strides[k] = input_strides[op.perm[k]];
+  }
+
+  const bool keeps_inner_axis = op.perm[rank - 1] == rank - 1;
+  const int32_t inner_size = output_dims[rank - 1];
+  const int32_t inner_stride = strides[rank - 1];
+  int32_t outer_size = 1;
+  for (int k = 0; k < rank - 1; ++k) {
+    outer_size *= output_dims[k];
+  }
+
+  int32_t index[kMaxDims] = {};
+  int32_t input_offset = 0;
+  for (int32_t outer = 0; outer < outer_size; ++outer) {
+    if (keeps_inner_axis) {
+      std::memcpy(output_data, input_data + input_offset,
+                  inner_size * sizeof(T));
+    } else {
+      const T* input = input_data + input_offset;
+      for (int32_t i = 0; i < inner_size; ++i) {
+        output_data[i] = input[i * inner_stride];
+      }
+    }
+    output_data += inner_size;
+
+    for (int k = rank - 2; k >= 0; --k) {
+      input_offset += strides[k];
+      if (++index[k] < output_dims[k]) {
+        break;
+      }
+      input_offset -= strides[k] * output_dims[k];
+      index[k] = 0;
+    }
+  }
+}
+
+template <typename T>
+void TransposeImpl(const TransposeParams& params,
+                   const RuntimeShape& input_shape, const T* input_data,
+                   T* output_data) {
+  CollapsedTranspose op;
+  CollapseTranspose(params, input_shape, &op);
+
+  if (op.rank <= 1) {
+    // Only the order of size-1 axes changes.
+    std::memcpy(output_data, input_data,
+                input_shape.FlatSize() * sizeof(T));
+  } else if (op.rank == 2) {
+    Transpose2D(op.dims[0], op.dims[1], input_data, output_data);
+  } else if (op.rank == 3 && op.perm[0] == 0 && op.perm[1] == 2) {
+    // A batch of matrix transposes, e.g. NHWC<->NCHW.
+    const int32_t matrix_size = op.dims[1] * op.dims[2];
+    for (int32_t b = 0; b < op.dims[0]; ++b) {
+      Transpose2D(op.dims[1], op.dims[2], input_data + b * matrix_size,
+                  output_data + b * matrix_size);
+    }
+  } else {
+    TransposeStrided(op, input_data, output_data);
+  }
+}
+
 TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
   TF_LITE_ENSURE_EQ(context, NumInputs(node), 2);
   TF_LITE_ENSURE_EQ(context, NumOutputs(node), 1);
@@ -52,7 +216,7 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
   TransposeContext op_context(context, node);
 
   // Ensure validity of input tensor.
-  TF_LITE_ENSURE_MSG(context, NumDimensions(op_context.input) <= 5,
+  TF_LITE_ENSURE_MSG(context, NumDimensions(op_context.input) <= kMaxDims,
                      "Transpose op only supports 1D-5D input arrays.");
   TF_LITE_ENSURE_TYPES_EQ(context, op_context.input->type,
                           op_context.output->type);
@@ -91,16 +255,15 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
       tflite::micro::GetEvalOutput(context, node, kOutputTensor);
   switch (input->type) {
     case kTfLiteFloat32:
-      reference_ops::Transpose(params, tflite::micro::GetTensorShape(input),
-                               tflite::micro::GetTensorData<float>(input),
-                               tflite::micro::GetTensorShape(output),
-                               tflite::micro::GetTensorData<float>(output));
+      TransposeImpl(
+          params, tflite::micro::GetTensorShape(input),
+          reinterpret_cast<const int32_t*>(input->data.data),
+          reinterpret_cast<int32_t*>(output->data.data));
       break;
     case kTfLiteInt8:
-      reference_ops::Transpose(params, tflite::micro::GetTensorShape(input),
-                               tflite::micro::GetTensorData<int8_t>(input),
-                               tflite::micro::GetTensorShape(output),
-                               tflite::micro::GetTensorData<int8_t>(output));
+      TransposeImpl(params, tflite::micro::GetTensorShape(input),
+                    tflite::micro::GetTensorData<int8_t>(input),
+                    tflite::micro::GetTensorData<int8_t>(output));
       break;
     default:
       TF_LITE_KERNEL_LOG(context,
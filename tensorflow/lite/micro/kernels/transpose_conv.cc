@@ -15,6 +15,10 @@ limitations under the License.
 
 #include "tensorflow/lite/kernels/internal/reference/transpose_conv.h"
 
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
 #include "tensorflow/lite/c/builtin_op_data.h"
 #include "tensorflow/lite/c/common.h"
 #include "tensorflow/lite/kernels/internal/common.h"
@@ -44,7 +48,8 @@ constexpr int kConvQuantizedDimension = 0;
 struct OpData {
   ConvParams params;
 
-  // A scratch buffer is required for quantized implementations.
+  // Quantized implementations accumulate one output row at a time into a
+  // scratch buffer of output_width * output_depth accumulators.
   int scratch_buffer_index;
 
   // TODO(b/192090531): Remove this once all 8x16 transpose conv models use
@@ -68,6 +73,110 @@ inline PaddingType RuntimePaddingType(TfLitePadding padding) {
   }
 }
 
+// Quantized transpose convolution that produces the output one row at a time.
+// Output row out_y only receives contributions from the input rows in_y with
+// in_y * stride_height - pad_height + filter_y == out_y, so each row is
+// gathered from at most filter_height input rows into a single-row
+// accumulator, then requantized and written out. The per-tap inner loop is a
+// dot product over input channels, which are contiguous in both the input and
+// the filter.
+//
+// Accumulation is exact integer arithmetic, so the result is bit-exact with
+// reference_integer_ops::TransposeConv, which scatters into an accumulator
+// covering the whole output instead.
+template <typename InputT, typename AccT>
+void TransposeConvByRow(const ConvParams& params,
+                        const int32_t* output_multiplier,
+                        const int32_t* output_shift, int32_t input_offset,
+                        int32_t output_offset, const RuntimeShape& input_shape,
+                        const InputT* input_data,
+                        const RuntimeShape& filter_shape,
+                        const int8_t* filter_data, const AccT* bias_data,
+                        const RuntimeShape& output_shape, InputT* output_data,
+                        AccT* row_accumulators) {
+  const int stride_width = params.stride_width;
+  const int stride_height = params.stride_height;
+  const int pad_width = params.padding_values.width;
+  const int pad_height = params.padding_values.height;
+
+  const int batches = MatchingDim(input_shape, 0, output_shape, 0);
+  const int input_depth = MatchingDim(input_shape, 3, filter_shape, 3);
+  const int output_depth = MatchingDim(filter_shape, 0, output_shape, 3);
+  const int input_height = input_shape.Dims(1);
+  const int input_width = input_shape.Dims(2);
+  const int filter_height = filter_shape.Dims(1);
+  const int filter_width = filter_shape.Dims(2);
+  const int output_height = output_shape.Dims(1);
+  const int output_width = output_shape.Dims(2);
+  const int filter_channel_stride = filter_height * filter_width * input_depth;
+  const int row_size = output_width * output_depth;
+  constexpr int32_t kOutputMin = std::numeric_limits<InputT>::min();
+  constexpr int32_t kOutputMax = std::numeric_limits<InputT>::max();
+
+  for (int batch = 0; batch < batches; ++batch) {
+    for (int out_y = 0; out_y < output_height; ++out_y) {
+      std::memset(row_accumulators, 0, row_size * sizeof(AccT));
+
+      for (int filter_y = 0; filter_y < filter_height; ++filter_y) {
+        const int in_y_scaled = out_y + pad_height - filter_y;
+        if (in_y_scaled < 0 || in_y_scaled % stride_height != 0) {
+          continue;
+        }
+        const int in_y = in_y_scaled / stride_height;
+        if (in_y >= input_height) {
+          continue;
+        }
+
+        for (int in_x = 0; in_x < input_width; ++in_x) {
+          const InputT* input_pixel =
+              &input_data[Offset(input_shape, batch, in_y, in_x, 0)];
+          const int out_x_origin = in_x * stride_width - pad_width;
+          const int filter_x_start = std::max(0, -out_x_origin);
+          const int filter_x_end =
+              std::min(filter_width, output_width - out_x_origin);
+          for (int filter_x = filter_x_start; filter_x < filter_x_end;
+               ++filter_x) {
+            AccT* acc = &row_accumulators[(out_x_origin + filter_x) *
+                                          output_depth];
+            const int8_t* filter_tap =
+                &filter_data[Offset(filter_shape, 0, filter_y, filter_x, 0)];
+            for (int out_channel = 0; out_channel < output_depth;
+                 ++out_channel) {
+              const int8_t* filter_row =
+                  filter_tap + out_channel * filter_channel_stride;
+              AccT sum = 0;
+              for (int in_channel = 0; in_channel < input_depth;
+                   ++in_channel) {
+                sum += (input_pixel[in_channel] + input_offset) *
+                       filter_row[in_channel];
+              }
+              acc[out_channel] += sum;
+            }
+          }
+        }
+      }
+
+      InputT* output_row =
+          &output_data[Offset(output_shape, batch, out_y, 0, 0)];
+      for (int out_x = 0; out_x < output_width; ++out_x) {
+        for (int out_channel = 0; out_channel < output_depth; ++out_channel) {
+          AccT acc = row_accumulators[out_x * output_depth + out_channel];
+          if (bias_data) {
+            acc += bias_data[out_channel];
+          }
+          int32_t scaled_acc = MultiplyByQuantizedMultiplier(
+              acc, output_multiplier[out_channel], output_shift[out_channel]);
+          scaled_acc += output_offset;
+          scaled_acc = std::max(scaled_acc, kOutputMin);
+          scaled_acc = std::min(scaled_acc, kOutputMax);
+          output_row[out_x * output_depth + out_channel] =
+              static_cast<InputT>(scaled_acc);
+        }
+      }
+    }
+  }
+}
+
 TfLiteStatus CalculateOpData(TfLiteContext* context, TfLiteNode* node,
                              const TfLiteTransposeConvParams* params, int width,
                              int height, int filter_width, int filter_height,
@@ -180,21 +289,20 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
       static_cast<int32_t*>(context->AllocatePersistentBuffer(
           context, num_channels * sizeof(int32_t)));
 
-  // Quantized kernels use an int32 scratch buffer.
+  // Quantized kernels accumulate a single output row, in int32 for int8 and
+  // in int64 for 16x8.
+  const int row_accumulators = width * SizeOfDimension(output, 3);
   if (input->type == kTfLiteInt8) {
     TFLITE_DCHECK(context->RequestScratchBufferInArena != nullptr);
     TFLITE_DCHECK(context->RequestScratchBufferInArena(
-                      context,
-                      GetTensorShape(output).FlatSize() * sizeof(int32_t),
+                      context, row_accumulators * sizeof(int32_t),
                       &(data->scratch_buffer_index)) == kTfLiteOk);
   }
 
-  // Quantized 16x8 kernels use an int64 scratch buffer.
   if (input->type == kTfLiteInt16) {
     TFLITE_DCHECK(context->RequestScratchBufferInArena != nullptr);
     TFLITE_DCHECK(context->RequestScratchBufferInArena(
-                      context,
-                      GetTensorShape(output).FlatSize() * sizeof(std::int64_t),
+                      context, row_accumulators * sizeof(std::int64_t),
                       &(data->scratch_buffer_index)) == kTfLiteOk);
   }
 
@@ -275,17 +383,17 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
     case kTfLiteInt8: {
       int32_t* scratch_buffer = static_cast<int32_t*>(
           context->GetScratchBuffer(context, data.scratch_buffer_index));
-      reference_integer_ops::TransposeConv(
-          data.params, data.per_channel_output_multiplier,
-          data.per_channel_output_shift, tflite::micro::GetTensorShape(input),
-          tflite::micro::GetTensorData<int8_t>(input),
-          tflite::micro::GetTensorShape(filter),
-          tflite::micro::GetTensorData<int8_t>(filter),
-          tflite::micro::GetTensorShape(bias),
-          tflite::micro::GetOptionalTensorData<int32_t>(bias),
-          tflite::micro::GetTensorShape(output),
-          tflite::micro::GetTensorData<int8_t>(output),
-          tflite::micro::GetTensorShape(nullptr), nullptr, scratch_buffer);
+      TransposeConvByRow(data.params, data.per_channel_output_multiplier,
+                         data.per_channel_output_shift,
+                         data.params.input_offset, data.params.output_offset,
+                         tflite::micro::GetTensorShape(input),
+                         tflite::micro::GetTensorData<int8_t>(input),
+                         tflite::micro::GetTensorShape(filter),
+                         tflite::micro::GetTensorData<int8_t>(filter),
+                         tflite::micro::GetOptionalTensorData<int32_t>(bias),
+                         tflite::micro::GetTensorShape(output),
+                         tflite::micro::GetTensorData<int8_t>(output),
+                         scratch_buffer);
       break;
     }
     case kTfLiteInt16: {
@@ -301,28 +409,27 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
              i++) {
           bias_converted_buffer[i] = bias->data.i16[i];
         }
-        reference_integer_ops::TransposeConv(
+        TransposeConvByRow(
             data.params, data.per_channel_output_multiplier,
-            data.per_channel_output_shift, tflite::micro::GetTensorShape(input),
+            data.per_channel_output_shift, /*input_offset=*/0,
+            /*output_offset=*/0, tflite::micro::GetTensorShape(input),
             tflite::micro::GetTensorData<int16_t>(input),
             tflite::micro::GetTensorShape(filter),
             tflite::micro::GetTensorData<int8_t>(filter),
-            tflite::micro::GetTensorShape(bias), bias_converted_buffer,
+            static_cast<const std::int64_t*>(bias_converted_buffer),
             tflite::micro::GetTensorShape(output),
-            tflite::micro::GetTensorData<int16_t>(output),
-            tflite::micro::GetTensorShape(nullptr), nullptr, scratch_buffer);
+            tflite::micro::GetTensorData<int16_t>(output), scratch_buffer);
       } else {
-        reference_integer_ops::TransposeConv(
+        TransposeConvByRow(
             data.params, data.per_channel_output_multiplier,
-            data.per_channel_output_shift, tflite::micro::GetTensorShape(input),
+            data.per_channel_output_shift, /*input_offset=*/0,
+            /*output_offset=*/0, tflite::micro::GetTensorShape(input),
             tflite::micro::GetTensorData<int16_t>(input),
             tflite::micro::GetTensorShape(filter),
             tflite::micro::GetTensorData<int8_t>(filter),
-            tflite::micro::GetTensorShape(bias),
             tflite::micro::GetOptionalTensorData<std::int64_t>(bias),
             tflite::micro::GetTensorShape(output),
-            tflite::micro::GetTensorData<int16_t>(output),
-            tflite::micro::GetTensorShape(nullptr), nullptr, scratch_buffer);
+            tflite::micro::GetTensorData<int16_t>(output), scratch_buffer);
       }
       break;
     }
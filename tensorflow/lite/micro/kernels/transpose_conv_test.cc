@@ -326,6 +326,81 @@ TF_LITE_MICRO_TEST(SimpleTestQuantized16x8PerChannelWithInt16Bias) {
           &tflite::testing::common_conv_params, output_data));
 }
 
+TF_LITE_MICRO_TEST(StridedMultiChannelQuantizedMatchesFloat) {
+  using tflite::testing::CreateTensor;
+  using tflite::testing::IntArrayFromInts;
+
+  // Stride 2 with SAME padding and odd input sizes, so that output rows and
+  // columns receive contributions from differing numbers of filter taps.
+  constexpr int kInputElements = 1 * 3 * 5 * 2;
+  constexpr int kFilterElements = 3 * 3 * 3 * 2;
+  constexpr int kBiasElements = 3;
+  constexpr int kOutputElements = 1 * 6 * 10 * 3;
+  int input_shape[] = {4, 1, 3, 5, 2};
+  int filter_shape[] = {4, 3, 3, 3, 2};
+  int bias_shape[] = {1, 3};
+  int output_shape[] = {4, 1, 6, 10, 3};
+  TfLiteConvParams conv_params = {kTfLitePaddingSame, 2, 2, kTfLiteActNone,
+                                  1, 1};
+
+  float input_data[kInputElements];
+  for (int i = 0; i < kInputElements; ++i) {
+    input_data[i] = static_cast<float>(i % 11 - 5);
+  }
+  float filter_data[kFilterElements];
+  for (int i = 0; i < kFilterElements; ++i) {
+    filter_data[i] = static_cast<float>(i % 7 - 3);
+  }
+  const float bias_data[kBiasElements] = {0, 0, 0};
+
+  // The float kernel is the reference for the quantized ones.
+  float golden[kOutputElements];
+  int output_shape_dims_data[] = {1, 0};
+  int32_t* output_shape_data = nullptr;
+  TfLiteTensor float_tensors[] = {
+      CreateTensor(output_shape_data, IntArrayFromInts(output_shape_dims_data)),
+      CreateTensor(filter_data, IntArrayFromInts(filter_shape)),
+      CreateTensor(input_data, IntArrayFromInts(input_shape)),
+      CreateTensor(bias_data, IntArrayFromInts(bias_shape)),
+      CreateTensor(golden, IntArrayFromInts(output_shape)),
+  };
+  TF_LITE_MICRO_EXPECT_EQ(
+      kTfLiteOk, tflite::testing::InvokeTransposeConv(
+                     float_tensors, 5, kOutputElements, &conv_params, golden));
+
+  int zero_points[kBiasElements + 1];
+  float scales[kBiasElements + 1];
+  int8_t filter_quantized[kFilterElements];
+
+  int8_t input_quantized[kInputElements];
+  int32_t bias_quantized[kBiasElements];
+  int8_t golden_quantized[kOutputElements];
+  int8_t output_data[kOutputElements];
+  TF_LITE_MICRO_EXPECT_EQ(
+      kTfLiteOk,
+      tflite::testing::TestTransposeConvQuantized(
+          input_shape, input_data, input_quantized, /*input_scale=*/1.0f,
+          /*input_zero_point=*/3, filter_shape, filter_data, filter_quantized,
+          /*filter_scale=*/1.0f, bias_shape, bias_data, bias_quantized,
+          scales, zero_points, output_shape, golden, golden_quantized,
+          /*output_scale=*/1.0f, /*output_zero_point=*/0, &conv_params,
+          output_data));
+
+  int16_t input_quantized_16[kInputElements];
+  std::int64_t bias_quantized_16[kBiasElements];
+  int16_t golden_quantized_16[kOutputElements];
+  int16_t output_data_16[kOutputElements];
+  TF_LITE_MICRO_EXPECT_EQ(
+      kTfLiteOk,
+      tflite::testing::TestTransposeConvQuantized(
+          input_shape, input_data, input_quantized_16, /*input_scale=*/1.0f,
+          /*input_zero_point=*/0, filter_shape, filter_data, filter_quantized,
+          /*filter_scale=*/1.0f, bias_shape, bias_data, bias_quantized_16,
+          scales, zero_points, output_shape, golden, golden_quantized_16,
+          /*output_scale=*/1.0f, /*output_zero_point=*/0, &conv_params,
+          output_data_16));
+}
+
 TF_LITE_MICRO_TEST(InputOutputDifferentTypeIsError) {
   using tflite::testing::CreateQuantizedTensor;
   using tflite::testing::CreateTensor;
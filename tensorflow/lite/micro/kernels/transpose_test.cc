@@ -611,4 +611,76 @@ TF_LITE_MICRO_TEST(Complex5DTestWithReorder) {
                                  expected_output_data, output_data, &params);
 }
 
+TF_LITE_MICRO_TEST(2DTiledWithPartialTiles) {
+  int32_t shape[] = {37, 53};
+  int32_t perms[] = {1, 0};
+  float input_data[37 * 53];
+  float expected_output_data[37 * 53];
+  tflite::testing::RunTestPermutation(2, shape, perms, input_data,
+                                      expected_output_data);
+  int input_dims_data[] = {2, 37, 53};
+  int output_dims_data[] = {2, 37, 53};
+
+  float output_data[37 * 53];
+
+  tflite::TransposeParams params = {2, {1, 0}};
+
+  tflite::testing::TestTranspose(input_dims_data, input_data, output_dims_data,
+                                 expected_output_data, output_data, &params);
+}
+
+TF_LITE_MICRO_TEST(4DNhwcToNchw) {
+  int32_t shape[] = {2, 9, 11, 19};
+  int32_t perms[] = {0, 3, 1, 2};
+  int8_t input_data[2 * 9 * 11 * 19];
+  int8_t expected_output_data[2 * 9 * 11 * 19];
+  tflite::testing::RunTestPermutation(4, shape, perms, input_data,
+                                      expected_output_data);
+  int input_dims_data[] = {4, 2, 9, 11, 19};
+  int output_dims_data[] = {4, 2, 9, 11, 19};
+
+  int8_t output_data[2 * 9 * 11 * 19];
+
+  tflite::TransposeParams params = {4, {0, 3, 1, 2}};
+
+  tflite::testing::TestTranspose(input_dims_data, input_data, output_dims_data,
+                                 expected_output_data, output_data, &params);
+}
+
+TF_LITE_MICRO_TEST(4DNchwToNhwc) {
+  int32_t shape[] = {2, 19, 9, 11};
+  int32_t perms[] = {0, 2, 3, 1};
+  float input_data[2 * 19 * 9 * 11];
+  float expected_output_data[2 * 19 * 9 * 11];
+  tflite::testing::RunTestPermutation(4, shape, perms, input_data,
+                                      expected_output_data);
+  int input_dims_data[] = {4, 2, 19, 9, 11};
+  int output_dims_data[] = {4, 2, 19, 9, 11};
+
+  float output_data[2 * 19 * 9 * 11];
+
+  tflite::TransposeParams params = {4, {0, 2, 3, 1}};
+
+  tflite::testing::TestTranspose(input_dims_data, input_data, output_dims_data,
+                                 expected_output_data, output_data, &params);
+}
+
+TF_LITE_MICRO_TEST(4DInnermostAxisKept) {
+  int32_t shape[] = {3, 5, 7, 4};
+  int32_t perms[] = {2, 0, 1, 3};
+  int8_t input_data[3 * 5 * 7 * 4];
+  int8_t expected_output_data[3 * 5 * 7 * 4];
+  tflite::testing::RunTestPermutation(4, shape, perms, input_data,
+                                      expected_output_data);
+  int input_dims_data[] = {4, 3, 5, 7, 4};
+  int output_dims_data[] = {4, 3, 5, 7, 4};
+
+  int8_t output_data[3 * 5 * 7 * 4];
+
+  tflite::TransposeParams params = {4, {2, 0, 1, 3}};
+
+  tflite::testing::TestTranspose(input_dims_data, input_data, output_dims_data,
+                                 expected_output_data, output_data, &params);
+}
+
 TF_LITE_MICRO_TESTS_END
@@ -49,6 +49,12 @@ struct UnidirectionalSequenceLstmOpData {
 
   IntegerLstmParameter integer_lstm_param;
   HybridLstmScales hybrid_lstm_scales;
+
+  // If the bias and input contributions to the gates are computed for the
+  // whole sequence before the recurrent loop, into the scratch buffer at
+  // precomputed_input_gates_index.
+  bool precompute_input_gates;
+  int precomputed_input_gates_index;
 };
 
 TfLiteStatus PopulateQuantizedLstmParams8x8_16(
@@ -498,11 +504,38 @@ enum HybridTempBuffer {
   kNumHybridTempBuffers = 12,
 };
 
-void* UnidirectionalSequenceLstmInit(TfLiteContext* context, const char* buffer,
-                                     size_t length) {
+void* InitOpData(TfLiteContext* context, bool precompute_input_gates) {
   TFLITE_DCHECK(context->AllocatePersistentBuffer != nullptr);
-  return context->AllocatePersistentBuffer(
+  void* data = context->AllocatePersistentBuffer(
       context, sizeof(UnidirectionalSequenceLstmOpData));
+  if (data != nullptr) {
+    static_cast<UnidirectionalSequenceLstmOpData*>(data)
+        ->precompute_input_gates = precompute_input_gates;
+  }
+  return data;
+}
+
+void* UnidirectionalSequenceLstmInit(TfLiteContext* context, const char* buffer,
+                                     size_t length) {
+  return InitOpData(context, /*precompute_input_gates=*/false);
+}
+
+void* UnidirectionalSequenceLstmTimeBatchedInit(TfLiteContext* context,
+                                                const char* buffer,
+                                                size_t length) {
+  return InitOpData(context, /*precompute_input_gates=*/true);
+}
+
+// Returns the buffer for the precomputed gate inputs, or nullptr if the op does
+// not precompute them.
+template <typename T>
+T* GetPrecomputedInputGatesBuffer(
+    TfLiteContext* context, const UnidirectionalSequenceLstmOpData* op_data) {
+  if (!op_data->precompute_input_gates) {
+    return nullptr;
+  }
+  return reinterpret_cast<T*>(context->GetScratchBuffer(
+      context, op_data->precomputed_input_gates_index));
 }
 
 // Check that input tensor dimensions matches with each other.
@@ -1225,6 +1258,8 @@ TfLiteStatus UnidirectionalSequenceLstmPrepare(TfLiteContext* context,
   const bool time_major = params->time_major;
   const int n_batch = time_major ? input->dims->data[1] : input->dims->data[0];
   const int n_input = input->dims->data[2];
+  const int max_time =
+      time_major ? input->dims->data[0] : input->dims->data[1];
 
   TfLiteTensor* input_to_output_weights =
       micro_context->AllocateTempInputTensor(node,
@@ -1311,6 +1346,11 @@ TfLiteStatus UnidirectionalSequenceLstmPrepare(TfLiteContext* context,
 
     op_data->compute_row_sums = true;
 
+    // With precomputed gate inputs, the whole input is quantized at once and
+    // the per-row buffers below cover all of its rows.
+    const int n_quantized_rows =
+        op_data->precompute_input_gates ? max_time * n_batch : n_batch;
+
     // Allocate temporary tensors to store quantized values of input,
     // output_state and cell_state tensors.
 
@@ -1346,20 +1386,22 @@ TfLiteStatus UnidirectionalSequenceLstmPrepare(TfLiteContext* context,
     // different matrices (which requires multiplying the scaling factors with
     // the scaling factor of the matrix).
 
-    TF_LITE_ENSURE_OK(context,
-                      context->RequestScratchBufferInArena(
-                          context, n_batch * TfLiteTypeGetSize(kTfLiteFloat32),
-                          &(op_data->scratch_index[kInputScalingFactors])));
+    TF_LITE_ENSURE_OK(
+        context, context->RequestScratchBufferInArena(
+                     context,
+                     n_quantized_rows * TfLiteTypeGetSize(kTfLiteFloat32),
+                     &(op_data->scratch_index[kInputScalingFactors])));
 
     TF_LITE_ENSURE_OK(
         context, context->RequestScratchBufferInArena(
                      context, n_batch * TfLiteTypeGetSize(kTfLiteFloat32),
                      &(op_data->scratch_index[kOutputStateScalingFactors])));
 
-    TF_LITE_ENSURE_OK(context,
-                      context->RequestScratchBufferInArena(
-                          context, n_batch * TfLiteTypeGetSize(kTfLiteFloat32),
-                          &(op_data->scratch_index[kProductScalingFactors])));
+    TF_LITE_ENSURE_OK(
+        context, context->RequestScratchBufferInArena(
+                     context,
+                     n_quantized_rows * TfLiteTypeGetSize(kTfLiteFloat32),
+                     &(op_data->scratch_index[kProductScalingFactors])));
 
     // Allocate a temporary buffer to store the recovered cell weights. Since
     // this is used for diagonal matrices, only need to store n_cell values.
@@ -1372,13 +1414,15 @@ TfLiteStatus UnidirectionalSequenceLstmPrepare(TfLiteContext* context,
     TF_LITE_ENSURE_OK(
         context,
         context->RequestScratchBufferInArena(
-            context, n_cell * n_batch * TfLiteTypeGetSize(kTfLiteInt32),
+            context,
+            n_cell * n_quantized_rows * TfLiteTypeGetSize(kTfLiteInt32),
             &(op_data->scratch_index[kAccumScratch])));
 
-    TF_LITE_ENSURE_OK(context,
-                      context->RequestScratchBufferInArena(
-                          context, n_batch * TfLiteTypeGetSize(kTfLiteFloat32),
-                          &(op_data->scratch_index[kInputZeroPoints])));
+    TF_LITE_ENSURE_OK(
+        context, context->RequestScratchBufferInArena(
+                     context,
+                     n_quantized_rows * TfLiteTypeGetSize(kTfLiteFloat32),
+                     &(op_data->scratch_index[kInputZeroPoints])));
 
     TF_LITE_ENSURE_OK(context,
                       context->RequestScratchBufferInArena(
@@ -1428,6 +1472,20 @@ TfLiteStatus UnidirectionalSequenceLstmPrepare(TfLiteContext* context,
                                    context, op_data, node));
   }
 
+  if (op_data->precompute_input_gates) {
+    // One block of max_time * n_batch * n_cell gate values for each of the
+    // forget, cell, output and (unless CIFG) input gates. The integer kernel
+    // keeps its gates in 16 bits.
+    const int n_gates = use_cifg ? 3 : 4;
+    const TfLiteType gate_type = is_integer ? kTfLiteInt16 : kTfLiteFloat32;
+    TF_LITE_ENSURE_OK(context,
+                      context->RequestScratchBufferInArena(
+                          context,
+                          n_gates * max_time * n_batch * n_cell *
+                              TfLiteTypeGetSize(gate_type),
+                          &(op_data->precomputed_input_gates_index)));
+  }
+
   if (input != nullptr) {
     micro_context->DeallocateTempTfLiteTensor(input);
   }
@@ -1582,7 +1640,8 @@ TfLiteStatus UnidirectionalSequenceLstmEval(TfLiteContext* context,
           /*output_offset=*/0,
           reinterpret_cast<float*>(context->GetScratchBuffer(
               context, op_data->scratch_index[kPrimaryScratchBuffer])),
-          output_state, cell_state, output);
+          output_state, cell_state, output,
+          GetPrecomputedInputGatesBuffer<float>(context, op_data));
     } break;
     case kTfLiteUInt8:
     case kTfLiteInt8: {
@@ -1650,7 +1709,8 @@ TfLiteStatus UnidirectionalSequenceLstmEval(TfLiteContext* context,
             reinterpret_cast<int32_t*>(context->GetScratchBuffer(
                 context, op_data->scratch_index[kOutputStateZeroPoints])),
             op_data_rw->row_sums, op_data_rw->row_sums_size,
-            &op_data_rw->compute_row_sums);
+            &op_data_rw->compute_row_sums,
+            GetPrecomputedInputGatesBuffer<float>(context, op_data));
       } else {
         return EvalInteger8x8_16Lstm(
             input, input_to_input_weights, input_to_forget_weights,
@@ -1675,7 +1735,8 @@ TfLiteStatus UnidirectionalSequenceLstmEval(TfLiteContext* context,
                 context->GetScratchBuffer(context, op_data->scratch_index[3])),
             reinterpret_cast<int8_t*>(
                 context->GetScratchBuffer(context, op_data->scratch_index[4])),
-            nullptr);
+            nullptr,
+            GetPrecomputedInputGatesBuffer<int16_t>(context, op_data));
       }
     } break;
     default:
@@ -1693,4 +1754,10 @@ TfLiteRegistration Register_UNIDIRECTIONAL_SEQUENCE_LSTM() {
                                    UnidirectionalSequenceLstmEval);
 }
 
+TfLiteRegistration Register_UNIDIRECTIONAL_SEQUENCE_LSTM_TIME_BATCHED() {
+  return tflite::micro::RegisterOp(UnidirectionalSequenceLstmTimeBatchedInit,
+                                   UnidirectionalSequenceLstmPrepare,
+                                   UnidirectionalSequenceLstmEval);
+}
+
 }  // namespace tflite
@@ -168,7 +168,9 @@ void TestUnidirectionalSequenceLstmHybrid(
 
     TfLiteType weight_type,
 
-    bool asymmetric_quantize_inputs = false) {
+    bool asymmetric_quantize_inputs = false,
+    const TfLiteRegistration& registration =
+        Register_UNIDIRECTIONAL_SEQUENCE_LSTM()) {
   int inputs_array_data[25];
   int outputs_array_data[2] = {1, kLstmOutputTensorIndex};
 
@@ -639,8 +641,6 @@ void TestUnidirectionalSequenceLstmHybrid(
   params.time_major = config->time_major;
   params.asymmetric_quantize_inputs = asymmetric_quantize_inputs;
 
-  const TfLiteRegistration registration =
-      Register_UNIDIRECTIONAL_SEQUENCE_LSTM();
   micro::KernelRunner runner(registration, tensors, kLstmMaxNumInputTensors + 1,
                              IntArrayFromInts(inputs_array_data),
                              IntArrayFromInts(outputs_array_data),
@@ -656,7 +656,9 @@ void TestUnidirectionalSequenceLstmHybrid(
 
 void TestUnidirectionalSequenceLstmFloat(
     LstmFloatTestConfig* config, float tolerance, bool input_output_batch_major,
-    bool asymmetric_quantize_inputs = false) {
+    bool asymmetric_quantize_inputs = false,
+    const TfLiteRegistration& registration =
+        Register_UNIDIRECTIONAL_SEQUENCE_LSTM()) {
   int inputs_array_data[25];
   int outputs_array_data[2] = {1, kLstmOutputTensorIndex};
 
@@ -888,8 +890,6 @@ void TestUnidirectionalSequenceLstmFloat(
   params.time_major = config->time_major;
   params.asymmetric_quantize_inputs = asymmetric_quantize_inputs;
 
-  const TfLiteRegistration registration =
-      Register_UNIDIRECTIONAL_SEQUENCE_LSTM();
   micro::KernelRunner runner(registration, tensors, kLstmMaxNumInputTensors + 1,
                              IntArrayFromInts(inputs_array_data),
                              IntArrayFromInts(outputs_array_data),
@@ -903,7 +903,10 @@ void TestUnidirectionalSequenceLstmFloat(
   }
 }
 
-void TestUnidirectionalSequenceLstmInteger(LstmIntegerTestConfig* config) {
+void TestUnidirectionalSequenceLstmInteger(
+    LstmIntegerTestConfig* config,
+    const TfLiteRegistration& registration =
+        Register_UNIDIRECTIONAL_SEQUENCE_LSTM()) {
   int inputs_array_data[25];
   int outputs_array_data[2] = {1, kLstmOutputTensorIndex};
   int intermediate_array_data[6] = {5,
@@ -1253,8 +1256,6 @@ void TestUnidirectionalSequenceLstmInteger(LstmIntegerTestConfig* config) {
   params.time_major = config->time_major;
   params.asymmetric_quantize_inputs = config->asymmetric_quantize_inputs;
 
-  const TfLiteRegistration registration =
-      Register_UNIDIRECTIONAL_SEQUENCE_LSTM();
   micro::KernelRunner runner(
       registration, tensors, kLstmMaxNumInputTensors + 1 + 5,
       IntArrayFromInts(inputs_array_data), IntArrayFromInts(outputs_array_data),
@@ -1428,6 +1429,61 @@ TF_LITE_MICRO_TEST(UndrctnlSqncLstmFloatCifgPphlNoPrjLayerNormTest) {
       /*input_output_batch_major=*/false);
 }
 
+TF_LITE_MICRO_TEST(UnidirectionalSequenceLstmIntegerPeepholeTimeBatchedTest) {
+  tflite::testing::TestUnidirectionalSequenceLstmInteger(
+      &tflite::testing::lstm_integer_peephole_config,
+      tflite::Register_UNIDIRECTIONAL_SEQUENCE_LSTM_TIME_BATCHED());
+}
+
+TF_LITE_MICRO_TEST(UndrctnlSqncLstmFloatNoCifgNoPphlNoPrjTimeBatchedTest) {
+  tflite::testing::TestUnidirectionalSequenceLstmFloat(
+      &tflite::testing::lstm_no_cifg_no_peephole_no_proj_config,
+      /*tolerance=*/1e-5,
+      /*input_output_batch_major=*/false,
+      /*asymmetric_quantize_inputs=*/false,
+      tflite::Register_UNIDIRECTIONAL_SEQUENCE_LSTM_TIME_BATCHED());
+}
+
+TF_LITE_MICRO_TEST(UndrctnlSqncLstmFloatNoCifgNoPphlNoPrjBatchMajorTBTest) {
+  tflite::testing::TestUnidirectionalSequenceLstmFloat(
+      &tflite::testing::lstm_no_cifg_no_peephole_no_proj_config,
+      /*tolerance=*/1e-5,
+      /*input_output_batch_major=*/true,
+      /*asymmetric_quantize_inputs=*/false,
+      tflite::Register_UNIDIRECTIONAL_SEQUENCE_LSTM_TIME_BATCHED());
+}
+
+TF_LITE_MICRO_TEST(UndrctnlSqncLstmFloatCifgPphlNoPrjLayerNormTimeBatchedTest) {
+  tflite::testing::TestUnidirectionalSequenceLstmFloat(
+      &tflite::testing::cifg_peephole_no_proj_config_layer_norm,
+      /*tolerance=*/1e-5,
+      /*input_output_batch_major=*/false,
+      /*asymmetric_quantize_inputs=*/false,
+      tflite::Register_UNIDIRECTIONAL_SEQUENCE_LSTM_TIME_BATCHED());
+}
+
+TF_LITE_MICRO_TEST(UndrctnlSqncLstmHybridInt8CifgPphlNoPrjTimeBatchedTest) {
+  tflite::testing::TestUnidirectionalSequenceLstmHybrid(
+      &tflite::testing::lstm_cifg_peephole_no_proj_config,
+      &tflite::testing::lstm_cifg_peephole_no_proj_buffers,
+      /*tolerance=*/0.03573,
+      /*input_output_batch_major=*/false,
+      /*weight_type=*/kTfLiteInt8,
+      /*asymmetric_quantize_inputs=*/false,
+      tflite::Register_UNIDIRECTIONAL_SEQUENCE_LSTM_TIME_BATCHED());
+}
+
+TF_LITE_MICRO_TEST(UndrctnlSqncLstmHybridInt8NoCifgNoPphlNoPrjAsymTBTest) {
+  tflite::testing::TestUnidirectionalSequenceLstmHybrid(
+      &tflite::testing::lstm_no_cifg_no_peephole_no_proj_config,
+      &tflite::testing::lstm_no_cifg_no_peephole_no_proj_buffers,
+      /*tolerance=*/0.0157651,
+      /*input_output_batch_major=*/false,
+      /*weight_type=*/kTfLiteInt8,
+      /*asymmetric_quantize_inputs=*/true,
+      tflite::Register_UNIDIRECTIONAL_SEQUENCE_LSTM_TIME_BATCHED());
+}
+
 #endif  // !defined(XTENSA)
 
 TF_LITE_MICRO_TESTS_END
@@ -80,6 +80,11 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
   const TfLiteEvalTensor* input =
       tflite::micro::GetEvalInput(context, node, kInputTensor);
 
+  // The memory planner may have made the outputs views of the input already.
+  if (tflite::micro::OutputsArePlannedAsSlicesOf(context, node, input)) {
+    return kTfLiteOk;
+  }
+
   switch (input->type) {
     case kTfLiteFloat32: {
       return UnpackImpl<float>(context, node, input, data->num, data->axis);
@@ -20,12 +20,54 @@ limitations under the License.
 #include "tensorflow/lite/micro/memory_helpers.h"
 #include "tensorflow/lite/micro/memory_planner/greedy_memory_planner.h"
 #include "tensorflow/lite/micro/micro_error_reporter.h"
+#include "tensorflow/lite/schema/schema_utils.h"
 
 namespace tflite {
 
 namespace {
 constexpr char kOfflineMemAllocMetadata[] = "OfflineMemoryAllocation";
 constexpr int kUninitializedLifetime = -1;
+
+bool IsSubgraphInputOrOutput(const SubGraph* subgraph, int tensor_index) {
+  for (size_t i = 0;
+       subgraph->inputs() != nullptr && i < subgraph->inputs()->size(); ++i) {
+    if (subgraph->inputs()->Get(i) == tensor_index) {
+      return true;
+    }
+  }
+  for (size_t i = 0;
+       subgraph->outputs() != nullptr && i < subgraph->outputs()->size(); ++i) {
+    if (subgraph->outputs()->Get(i) == tensor_index) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Returns the number of operators in the subgraph that write the tensor.
+int CountProducers(const SubGraph* subgraph, int tensor_index) {
+  int producer_count = 0;
+  uint32_t operators_size = NumSubgraphOperators(subgraph);
+  for (uint32_t i = 0; i < operators_size; i++) {
+    const auto* op = subgraph->operators()->Get(i);
+    for (size_t n = 0; op->outputs() != nullptr && n < op->outputs()->size();
+         ++n) {
+      if (op->outputs()->Get(n) == tensor_index) {
+        producer_count++;
+      }
+    }
+  }
+  return producer_count;
+}
+
+// Reads the axis of SPLIT and SPLIT_V, which is held in a constant tensor.
+bool GetConstantAxis(const TfLiteEvalTensor* axis_tensor, int* axis) {
+  if (axis_tensor->data.data == nullptr || axis_tensor->type != kTfLiteInt32) {
+    return false;
+  }
+  *axis = axis_tensor->data.i32[0];
+  return true;
+}
 }  // namespace
 
 // Mark the given Allocation info as first created at the specified allocation
@@ -206,6 +248,8 @@ TfLiteStatus AllocationInfoBuilder::InitializeAllocationInfo(
       } else {
         current->offline_offset = kOnlinePlannedBuffer;
       }
+      current->view_of = kNotAView;
+      current->view_offset = 0;
     }
   }
   // Initialize allocation info for every scratch buffer.
@@ -217,6 +261,8 @@ TfLiteStatus AllocationInfoBuilder::InitializeAllocationInfo(
     current->last_used = kUninitializedLifetime;
     current->needs_allocating = true;
     current->offline_offset = kOnlinePlannedBuffer;
+    current->view_of = kNotAView;
+    current->view_offset = 0;
   }
   return kTfLiteOk;
 }
@@ -316,6 +362,171 @@ TfLiteStatus AllocationInfoBuilder::MarkAllocationLifetimes(
   return kTfLiteOk;
 }
 
+void AllocationInfoBuilder::MarkViewsIfPossible(
+    int subgraph_idx, int parent, const flatbuffers::Vector<int32_t>* views,
+    int first_view, int axis, TfLiteEvalTensor* eval_tensors) {
+  const SubGraph* subgraph = model_->subgraphs()->Get(subgraph_idx);
+  AllocationInfo* allocation_info = info_.allocation_info;
+  const int subgraph_offset =
+      static_cast<int>(info_.subgraph_offsets[subgraph_idx]);
+  AllocationInfo* subgraph_allocation_info = &allocation_info[subgraph_offset];
+
+  if (views == nullptr || parent < 0) {
+    return;
+  }
+  AllocationInfo* parent_info = &subgraph_allocation_info[parent];
+  // The parent must end up in the online plan, either directly or through the
+  // buffer it is itself a view of.
+  if ((!parent_info->needs_allocating && parent_info->view_of == kNotAView) ||
+      parent_info->offline_offset != kOnlinePlannedBuffer) {
+    return;
+  }
+
+  // Slices are only contiguous when every dimension outside of the axis is 1.
+  const TfLiteIntArray* dims = eval_tensors[parent].dims;
+  if (axis < 0) {
+    axis += dims->size;
+  }
+  if (axis < 0 || axis >= dims->size) {
+    return;
+  }
+  for (int i = 0; i < axis; ++i) {
+    if (dims->data[i] != 1) {
+      return;
+    }
+  }
+
+  size_t total_bytes = 0;
+  for (int n = first_view; n < static_cast<int>(views->size()); ++n) {
+    const int tensor_index = views->Get(n);
+    if (tensor_index < 0) {
+      return;
+    }
+    const AllocationInfo* current = &subgraph_allocation_info[tensor_index];
+    // Weights, variables and tensors that are already views are left alone.
+    if (!current->needs_allocating ||
+        current->offline_offset != kOnlinePlannedBuffer ||
+        eval_tensors[tensor_index].type != eval_tensors[parent].type ||
+        IsSubgraphInputOrOutput(subgraph, tensor_index) ||
+        CountProducers(subgraph, tensor_index) != 1) {
+      return;
+    }
+    for (int m = first_view; m < n; ++m) {
+      if (views->Get(m) == tensor_index) {
+        return;
+      }
+    }
+    // A view can not contain the buffer it lives in.
+    for (int ancestor = subgraph_offset + parent; ancestor != kNotAView;
+         ancestor = allocation_info[ancestor].view_of) {
+      if (ancestor == subgraph_offset + tensor_index) {
+        return;
+      }
+    }
+    total_bytes += current->bytes;
+  }
+  if (total_bytes != parent_info->bytes) {
+    return;
+  }
+
+  size_t view_offset = 0;
+  for (int n = first_view; n < static_cast<int>(views->size()); ++n) {
+    AllocationInfo* current = &subgraph_allocation_info[views->Get(n)];
+    current->needs_allocating = false;
+    current->view_of = subgraph_offset + parent;
+    current->view_offset = view_offset;
+    view_offset += current->bytes;
+  }
+}
+
+TfLiteStatus AllocationInfoBuilder::MarkViewTensors(
+    SubgraphAllocations* allocations) {
+  for (size_t subgraph_idx = 0; subgraph_idx < model_->subgraphs()->size();
+       subgraph_idx++) {
+    const SubGraph* subgraph = model_->subgraphs()->Get(subgraph_idx);
+    TfLiteEvalTensor* eval_tensors = allocations[subgraph_idx].tensors;
+    uint32_t operators_size = NumSubgraphOperators(subgraph);
+    for (uint32_t i = 0; i < operators_size; i++) {
+      const auto* op = subgraph->operators()->Get(i);
+      if (op->inputs() == nullptr || op->outputs() == nullptr ||
+          op->inputs()->size() == 0 || op->outputs()->size() == 0) {
+        continue;
+      }
+      const OperatorCode* opcode =
+          model_->operator_codes()->Get(op->opcode_index());
+      int axis = 0;
+      switch (GetBuiltinCode(opcode)) {
+        case BuiltinOperator_CONCATENATION: {
+          const auto* options = op->builtin_options_as_ConcatenationOptions();
+          if (options != nullptr) {
+            MarkViewsIfPossible(subgraph_idx, op->outputs()->Get(0),
+                                op->inputs(), 0, options->axis(),
+                                eval_tensors);
+          }
+          break;
+        }
+        case BuiltinOperator_SPLIT: {
+          if (op->inputs()->size() == 2 &&
+              GetConstantAxis(&eval_tensors[op->inputs()->Get(0)], &axis)) {
+            MarkViewsIfPossible(subgraph_idx, op->inputs()->Get(1),
+                                op->outputs(), 0, axis, eval_tensors);
+          }
+          break;
+        }
+        case BuiltinOperator_SPLIT_V: {
+          if (op->inputs()->size() == 3 &&
+              GetConstantAxis(&eval_tensors[op->inputs()->Get(2)], &axis)) {
+            MarkViewsIfPossible(subgraph_idx, op->inputs()->Get(0),
+                                op->outputs(), 0, axis, eval_tensors);
+          }
+          break;
+        }
+        case BuiltinOperator_UNPACK: {
+          const auto* options = op->builtin_options_as_UnpackOptions();
+          if (options != nullptr) {
+            MarkViewsIfPossible(subgraph_idx, op->inputs()->Get(0),
+                                op->outputs(), 0, options->axis(),
+                                eval_tensors);
+          }
+          break;
+        }
+        default: {
+          break;
+        }
+      }
+    }
+  }
+
+  // Point every view directly at the planned buffer at the root of its chain,
+  // and keep that buffer alive for as long as any of its views.
+  AllocationInfo* allocation_info = info_.allocation_info;
+  for (size_t i = 0; i < info_.tensor_count; ++i) {
+    AllocationInfo* current = &allocation_info[i];
+    if (current->view_of == kNotAView) {
+      continue;
+    }
+    int root = current->view_of;
+    size_t view_offset = current->view_offset;
+    while (allocation_info[root].view_of != kNotAView) {
+      view_offset += allocation_info[root].view_offset;
+      root = allocation_info[root].view_of;
+    }
+    current->view_of = root;
+    current->view_offset = view_offset;
+
+    AllocationInfo* root_info = &allocation_info[root];
+    TFLITE_DCHECK(root_info->needs_allocating);
+    if (current->first_created != kUninitializedLifetime &&
+        current->first_created < root_info->first_created) {
+      root_info->first_created = current->first_created;
+    }
+    if (current->last_used > root_info->last_used) {
+      root_info->last_used = current->last_used;
+    }
+  }
+  return kTfLiteOk;
+}
+
 // Get offline tensors allocation plan. See
 // micro/docs/memory_management.md for more info.
 TfLiteStatus AllocationInfoBuilder::GetOfflinePlannedOffsets(
@@ -25,6 +25,9 @@ limitations under the License.
 
 namespace tflite {
 
+// Value of AllocationInfo::view_of for buffers that own their memory.
+constexpr int kNotAView = -1;
+
 // Used to hold information used during allocation calculations.
 struct AllocationInfo {
   size_t bytes;
@@ -33,6 +36,11 @@ struct AllocationInfo {
   int last_used;
   int32_t offline_offset;
   bool needs_allocating;
+  // A view is not planned on its own, its data lives view_offset bytes into
+  // the buffer of the AllocationInfo at index view_of (which may itself be a
+  // view).
+  int view_of;
+  size_t view_offset;
 };
 
 // Used to hold the allocation info list and related metadata for the entire
@@ -114,6 +122,15 @@ class AllocationInfoBuilder {
       ScratchBufferHandle* scratch_buffer_handles,
       SubgraphAllocations* allocations);
 
+  // Turn the tensors that CONCATENATION, SPLIT, SPLIT_V and UNPACK copy from or
+  // into into views of the buffer on the other side of the operator, so that
+  // those operators have nothing left to copy. Only applies when the operator
+  // works along the outermost non-unit axis, where every slice is contiguous,
+  // and each view has a single producer and no other role in the plan.
+  // Must be called after MarkAllocationLifetimes, since the lifetime of each
+  // parent buffer is extended to cover its views.
+  TfLiteStatus MarkViewTensors(SubgraphAllocations* allocations);
+
   // Returns the number of allocations.
   int AllocationCount() const { return info_.allocation_info_count; }
 
@@ -133,6 +150,13 @@ class AllocationInfoBuilder {
   // count monotonically increases through the lifetime marking process.
   void UpdateLastUsed(AllocationInfo* current, int allocation_scope_count);
 
+  // Make each tensor in `views` a slice of `parent`, back to back in order, if
+  // all of them qualify. Otherwise leave the plan untouched.
+  void MarkViewsIfPossible(int subgraph_idx, int parent,
+                           const flatbuffers::Vector<int32_t>* views,
+                           int first_view, int axis,
+                           TfLiteEvalTensor* eval_tensors);
+
   // Validate if a subgraph satisfies assumptions.
   TfLiteStatus ValidateSubgraph(const SubGraph* subgraph,
                                 TfLiteEvalTensor* eval_tensors);
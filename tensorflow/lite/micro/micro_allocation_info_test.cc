@@ -80,6 +80,97 @@ TF_LITE_MICRO_TEST(TestSingleSubgraphWithIntermediates) {
   TF_LITE_MICRO_EXPECT_EQ(allocation_info[3].needs_allocating, false);
 }
 
+TF_LITE_MICRO_TEST(TestConcatenationInputsAreViews) {
+  constexpr int kArenaSize = 1024;
+  uint8_t arena[kArenaSize];
+  const tflite::Model* model =
+      tflite::testing::GetSimpleModelWithConcatenation();
+  tflite::SimpleMemoryAllocator allocator(tflite::GetMicroErrorReporter(),
+                                          arena, kArenaSize);
+  tflite::AllocationInfoBuilder builder(model, &allocator,
+                                        tflite::GetMicroErrorReporter());
+  builder.CreateAllocationInfo(0);
+  tflite::MicroAllocator* micro_allocator = tflite::MicroAllocator::Create(
+      arena, kArenaSize, tflite::GetMicroErrorReporter());
+  tflite::SubgraphAllocations* subgraph_allocations =
+      micro_allocator->StartModelAllocation(model);
+  builder.InitializeAllocationInfo(nullptr, subgraph_allocations);
+  builder.MarkAllocationLifetimes(0, nullptr, nullptr, subgraph_allocations);
+  builder.MarkViewTensors(subgraph_allocations);
+  TF_LITE_MICRO_EXPECT_EQ(builder.AllocationCount(), 4);
+  tflite::AllocationInfo* allocation_info = builder.Finish();
+  TF_LITE_MICRO_EXPECT_EQ(allocation_info[0].view_of, tflite::kNotAView);
+  TF_LITE_MICRO_EXPECT_EQ(allocation_info[1].view_of, 3);
+  TF_LITE_MICRO_EXPECT_EQ(allocation_info[1].view_offset, 0u);
+  TF_LITE_MICRO_EXPECT_EQ(allocation_info[1].needs_allocating, false);
+  TF_LITE_MICRO_EXPECT_EQ(allocation_info[2].view_of, 3);
+  TF_LITE_MICRO_EXPECT_EQ(allocation_info[2].view_offset, 8u);
+  TF_LITE_MICRO_EXPECT_EQ(allocation_info[2].needs_allocating, false);
+  // The output is planned from the creation of the first branch.
+  TF_LITE_MICRO_EXPECT_EQ(allocation_info[3].view_of, tflite::kNotAView);
+  TF_LITE_MICRO_EXPECT_EQ(allocation_info[3].needs_allocating, true);
+  TF_LITE_MICRO_EXPECT_EQ(allocation_info[3].first_created, 1);
+  TF_LITE_MICRO_EXPECT_EQ(allocation_info[3].last_used, 3);
+}
+
+TF_LITE_MICRO_TEST(TestSplitOutputsAreViews) {
+  constexpr int kArenaSize = 4096;
+  uint8_t arena[kArenaSize];
+  const tflite::Model* model = tflite::testing::GetSimpleModelWithSplits();
+  tflite::SimpleMemoryAllocator allocator(tflite::GetMicroErrorReporter(),
+                                          arena, kArenaSize);
+  tflite::AllocationInfoBuilder builder(model, &allocator,
+                                        tflite::GetMicroErrorReporter());
+  builder.CreateAllocationInfo(0);
+  tflite::MicroAllocator* micro_allocator = tflite::MicroAllocator::Create(
+      arena, kArenaSize, tflite::GetMicroErrorReporter());
+  tflite::SubgraphAllocations* subgraph_allocations =
+      micro_allocator->StartModelAllocation(model);
+  builder.InitializeAllocationInfo(nullptr, subgraph_allocations);
+  builder.MarkAllocationLifetimes(0, nullptr, nullptr, subgraph_allocations);
+  builder.MarkViewTensors(subgraph_allocations);
+  TF_LITE_MICRO_EXPECT_EQ(builder.AllocationCount(), 17);
+  tflite::AllocationInfo* allocation_info = builder.Finish();
+
+  // SPLIT: both halves of the [1, 4] input.
+  TF_LITE_MICRO_EXPECT_EQ(allocation_info[0].view_of, tflite::kNotAView);
+  TF_LITE_MICRO_EXPECT_EQ(allocation_info[0].needs_allocating, true);
+  TF_LITE_MICRO_EXPECT_EQ(allocation_info[2].view_of, 0);
+  TF_LITE_MICRO_EXPECT_EQ(allocation_info[2].view_offset, 0u);
+  TF_LITE_MICRO_EXPECT_EQ(allocation_info[2].needs_allocating, false);
+  TF_LITE_MICRO_EXPECT_EQ(allocation_info[3].view_of, 0);
+  TF_LITE_MICRO_EXPECT_EQ(allocation_info[3].view_offset, 8u);
+  TF_LITE_MICRO_EXPECT_EQ(allocation_info[3].needs_allocating, false);
+
+  // SPLIT_V: slices of 2 and 4 elements of the [1, 6] input.
+  TF_LITE_MICRO_EXPECT_EQ(allocation_info[6].view_of, 4);
+  TF_LITE_MICRO_EXPECT_EQ(allocation_info[6].view_offset, 0u);
+  TF_LITE_MICRO_EXPECT_EQ(allocation_info[7].view_of, 4);
+  TF_LITE_MICRO_EXPECT_EQ(allocation_info[7].view_offset, 8u);
+  TF_LITE_MICRO_EXPECT_EQ(allocation_info[7].needs_allocating, false);
+
+  // UNPACK: the rows of the [2, 3] input.
+  TF_LITE_MICRO_EXPECT_EQ(allocation_info[9].view_of, 8);
+  TF_LITE_MICRO_EXPECT_EQ(allocation_info[9].view_offset, 0u);
+  TF_LITE_MICRO_EXPECT_EQ(allocation_info[10].view_of, 8);
+  TF_LITE_MICRO_EXPECT_EQ(allocation_info[10].view_offset, 12u);
+  TF_LITE_MICRO_EXPECT_EQ(allocation_info[10].needs_allocating, false);
+
+  // SPLIT along axis 1 of a [2, 4] input: the slices are strided, so they
+  // keep their own buffers.
+  TF_LITE_MICRO_EXPECT_EQ(allocation_info[12].view_of, tflite::kNotAView);
+  TF_LITE_MICRO_EXPECT_EQ(allocation_info[12].needs_allocating, true);
+  TF_LITE_MICRO_EXPECT_EQ(allocation_info[13].view_of, tflite::kNotAView);
+  TF_LITE_MICRO_EXPECT_EQ(allocation_info[13].needs_allocating, true);
+
+  // UNPACK with a slice that is a subgraph output: none of the slices become
+  // views.
+  TF_LITE_MICRO_EXPECT_EQ(allocation_info[15].view_of, tflite::kNotAView);
+  TF_LITE_MICRO_EXPECT_EQ(allocation_info[15].needs_allocating, true);
+  TF_LITE_MICRO_EXPECT_EQ(allocation_info[16].view_of, tflite::kNotAView);
+  TF_LITE_MICRO_EXPECT_EQ(allocation_info[16].needs_allocating, true);
+}
+
 TF_LITE_MICRO_TEST(TestMultiSubgraphWithIf) {
   constexpr int kArenaSize = 1024;
   uint8_t arena[kArenaSize];
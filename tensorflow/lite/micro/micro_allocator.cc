@@ -113,6 +113,16 @@ TfLiteStatus CommitPlan(ErrorReporter* error_reporter,
       ++planner_index;
     }
   }
+  // Views are not in the plan, they point into the buffer they are part of.
+  for (size_t i = 0; i < allocation_info_size; ++i) {
+    const AllocationInfo* current = &allocation_info[i];
+    if (current->view_of != kNotAView) {
+      uint8_t* parent_data = reinterpret_cast<uint8_t*>(
+          *allocation_info[current->view_of].output_ptr);
+      *current->output_ptr =
+          reinterpret_cast<void*>(parent_data + current->view_offset);
+    }
+  }
   return kTfLiteOk;
 }
 
@@ -773,6 +783,7 @@ TfLiteStatus MicroAllocator::CommitStaticMemoryPlan(
       GetScratchBufferRequests();
   TF_LITE_ENSURE_STATUS(builder.MarkAllocationLifetimes(
       0, scratch_buffer_requests, scratch_buffer_handles, allocations));
+  TF_LITE_ENSURE_STATUS(builder.MarkViewTensors(allocations));
   int allocation_info_count = builder.AllocationCount();
   AllocationInfo* allocation_info = builder.Finish();
 
@@ -97,6 +97,11 @@ class MicroContext {
 
   MicroGraph& graph() { return graph_; }
 
+  // Returns the model that is being run, or nullptr in kernel tests. Kernels
+  // can use it to read parts of the model that TFLM does not expose otherwise,
+  // like the buffers referenced by its metadata.
+  const Model* model() const { return model_; }
+
   // Sets the pointer to a list of ScratchBufferHandle instances.
   // Not API between TFLM and kernels. Primarily used by the framework for
   // housekeeping in MicroContext.
@@ -15,6 +15,10 @@ limitations under the License.
 
 #include "tensorflow/lite/micro/micro_graph.h"
 
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
 #include "flatbuffers/flatbuffers.h"  // from @flatbuffers
 #include "tensorflow/lite/c/common.h"
 #include "tensorflow/lite/kernels/internal/compatibility.h"
@@ -22,6 +26,7 @@ limitations under the License.
 #include "tensorflow/lite/micro/memory_helpers.h"
 #include "tensorflow/lite/micro/micro_error_reporter.h"
 #include "tensorflow/lite/micro/micro_profiler.h"
+#include "tensorflow/lite/micro/micro_utils.h"
 #include "tensorflow/lite/schema/schema_generated.h"
 
 namespace tflite {
@@ -35,6 +40,21 @@ const char* OpNameFromRegistration(const TfLiteRegistration* registration) {
   }
 }
 
+// The largest element reaches threshold exactly when any element does.
+template <typename T, typename ThresholdT>
+bool ReachesThreshold(const T* data, int num_elements, int class_idx,
+                      ThresholdT threshold) {
+  if (class_idx >= 0) {
+    return data[class_idx] >= threshold;
+  }
+  for (int i = 0; i < num_elements; ++i) {
+    if (data[i] >= threshold) {
+      return true;
+    }
+  }
+  return false;
+}
+
 }  // namespace
 
 MicroGraph::MicroGraph(TfLiteContext* context, const Model* model,
@@ -143,6 +163,23 @@ TfLiteStatus MicroGraph::FreeSubgraphs() {
 }
 
 TfLiteStatus MicroGraph::InvokeSubgraph(int subgraph_idx) {
+  // Only the outermost call starts out with no fired early exit. A nested
+  // call, e.g. from an IF or WHILE kernel, keeps the state of the call that
+  // contains it, unless one of its own early exits fires and so ends that call
+  // as well.
+  const int outer_fired_early_exit =
+      invoke_depth_ > 0 ? fired_early_exit_ : -1;
+  fired_early_exit_ = -1;
+  ++invoke_depth_;
+  const TfLiteStatus status = InvokeSubgraphOperators(subgraph_idx);
+  --invoke_depth_;
+  if (status != kTfLiteEarlyExit) {
+    fired_early_exit_ = outer_fired_early_exit;
+  }
+  return status;
+}
+
+TfLiteStatus MicroGraph::InvokeSubgraphOperators(int subgraph_idx) {
   int previous_subgraph_idx = current_subgraph_index_;
   current_subgraph_index_ = subgraph_idx;
 
@@ -184,11 +221,149 @@ TfLiteStatus MicroGraph::InvokeSubgraph(int subgraph_idx) {
     } else if (invoke_status != kTfLiteOk) {
       return invoke_status;
     }
+
+    for (int exit_idx = 0; exit_idx < num_early_exits_; ++exit_idx) {
+      const EarlyExit& early_exit = early_exits_[exit_idx];
+      if (early_exit.subgraph_idx == subgraph_idx &&
+          early_exit.node_idx == static_cast<int>(i) &&
+          EarlyExitFired(early_exit)) {
+        fired_early_exit_ = exit_idx;
+        current_subgraph_index_ = previous_subgraph_idx;
+        return kTfLiteEarlyExit;
+      }
+    }
   }
   current_subgraph_index_ = previous_subgraph_idx;
   return kTfLiteOk;
 }
 
+TfLiteStatus MicroGraph::AddEarlyExit(int subgraph_idx, int node_idx,
+                                      int output_idx, int class_idx,
+                                      float threshold) {
+  if (num_early_exits_ >= kMaxEarlyExits) {
+    MicroPrintf("Only %d early exits are supported", kMaxEarlyExits);
+    return kTfLiteError;
+  }
+  if (subgraph_idx < 0 ||
+      static_cast<size_t>(subgraph_idx) >= subgraphs_->size()) {
+    MicroPrintf("Early exit on subgraph %d but only %d subgraphs found",
+                subgraph_idx, subgraphs_->size());
+    return kTfLiteError;
+  }
+  const SubGraph* subgraph = (*subgraphs_)[subgraph_idx];
+  const uint32_t operators_size = NumSubgraphOperators(subgraph);
+  if (node_idx < 0 || static_cast<uint32_t>(node_idx) >= operators_size) {
+    MicroPrintf("Early exit on node %d but subgraph %d has %d operators",
+                node_idx, subgraph_idx, operators_size);
+    return kTfLiteError;
+  }
+  const Operator* op = subgraph->operators()->Get(node_idx);
+  if (op->outputs() == nullptr || output_idx < 0 ||
+      static_cast<size_t>(output_idx) >= op->outputs()->size()) {
+    MicroPrintf("Early exit on output %d of node %d which does not exist",
+                output_idx, node_idx);
+    return kTfLiteError;
+  }
+  const Tensor* tensor =
+      subgraph->tensors()->Get(op->outputs()->Get(output_idx));
+
+  if (class_idx >= 0) {
+    int num_elements = 1;
+    if (tensor->shape() != nullptr) {
+      for (size_t i = 0; i < tensor->shape()->size(); ++i) {
+        num_elements *= tensor->shape()->Get(i);
+      }
+    }
+    if (class_idx >= num_elements) {
+      MicroPrintf("Early exit on element %d of a tensor with %d elements",
+                  class_idx, num_elements);
+      return kTfLiteError;
+    }
+  }
+
+  EarlyExit& early_exit = early_exits_[num_early_exits_];
+  early_exit.subgraph_idx = subgraph_idx;
+  early_exit.node_idx = node_idx;
+  early_exit.output_idx = output_idx;
+  early_exit.class_idx = class_idx;
+  early_exit.threshold = threshold;
+  early_exit.quantized_threshold = 0;
+
+  switch (tensor->type()) {
+    case TensorType_FLOAT32:
+      break;
+    case TensorType_INT8:
+    case TensorType_UINT8:
+    case TensorType_INT16:
+    case TensorType_INT32: {
+      // Outputs without quantization parameters are compared as is.
+      double scale = 1.0;
+      int64_t zero_point = 0;
+      const QuantizationParameters* quantization = tensor->quantization();
+      if (quantization != nullptr && quantization->scale() != nullptr &&
+          quantization->scale()->size() > 0) {
+        scale = quantization->scale()->Get(0);
+        if (quantization->zero_point() != nullptr &&
+            quantization->zero_point()->size() > 0) {
+          zero_point = quantization->zero_point()->Get(0);
+        }
+      }
+      // q >= threshold / scale + zero_point, rounded up to the next integer.
+      const double quantized_threshold =
+          std::ceil(static_cast<double>(threshold) / scale + zero_point);
+      if (quantized_threshold <= std::numeric_limits<int32_t>::min()) {
+        early_exit.quantized_threshold = std::numeric_limits<int32_t>::min();
+      } else if (quantized_threshold >= std::numeric_limits<int32_t>::max()) {
+        early_exit.quantized_threshold = std::numeric_limits<int32_t>::max();
+      } else {
+        early_exit.quantized_threshold =
+            static_cast<int32_t>(quantized_threshold);
+      }
+      break;
+    }
+    default:
+      MicroPrintf("Early exit on output of type %s is not supported",
+                  EnumNameTensorType(tensor->type()));
+      return kTfLiteError;
+  }
+
+  ++num_early_exits_;
+  return kTfLiteOk;
+}
+
+bool MicroGraph::EarlyExitFired(const EarlyExit& early_exit) {
+  const SubgraphAllocations& allocations =
+      subgraph_allocations_[early_exit.subgraph_idx];
+  const TfLiteNode& node =
+      allocations.node_and_registrations[early_exit.node_idx].node;
+  const TfLiteEvalTensor& output =
+      allocations.tensors[node.outputs->data[early_exit.output_idx]];
+  const int num_elements = ElementCount(*output.dims);
+  switch (output.type) {
+    case kTfLiteFloat32:
+      return ReachesThreshold(output.data.f, num_elements,
+                              early_exit.class_idx, early_exit.threshold);
+    case kTfLiteInt8:
+      return ReachesThreshold(output.data.int8, num_elements,
+                              early_exit.class_idx,
+                              early_exit.quantized_threshold);
+    case kTfLiteUInt8:
+      return ReachesThreshold(output.data.uint8, num_elements,
+                              early_exit.class_idx,
+                              early_exit.quantized_threshold);
+    case kTfLiteInt16:
+      return ReachesThreshold(output.data.i16, num_elements,
+                              early_exit.class_idx,
+                              early_exit.quantized_threshold);
+    case kTfLiteInt32:
+      return ReachesThreshold(output.data.i32, num_elements,
+                              early_exit.class_idx,
+                              early_exit.quantized_threshold);
+    default:
+      return false;
+  }
+}
+
 TfLiteStatus MicroGraph::ResetVariableTensors() {
   for (size_t subgraph_idx = 0; subgraph_idx < subgraphs_->size();
        subgraph_idx++) {
@@ -23,6 +23,11 @@ limitations under the License.
 
 namespace tflite {
 
+// Returned by MicroGraph::InvokeSubgraph() and MicroInterpreter::Invoke() when
+// an early exit fired and the remaining operators of the subgraph were skipped.
+// TODO(b/149795762): Add this to the TfLiteStatus enum.
+constexpr TfLiteStatus kTfLiteEarlyExit = static_cast<TfLiteStatus>(-10);
+
 // Abstracts the details of interacting with the tflite::Model.
 //
 // Provides methods to access, initialize, prepare, invoke and free any
@@ -87,7 +92,45 @@ class MicroGraph {
   // Get the resource variables for this TFLM graph.
   MicroResourceVariables* GetResourceVariables() { return resource_variables_; }
 
+  // Maximum number of early exits that can be added to a graph.
+  static constexpr int kMaxEarlyExits = 4;
+
+  // Adds an early exit to a subgraph: each time the operator at node_idx has
+  // been invoked, InvokeSubgraph() checks its output output_idx, either the
+  // element at class_idx or, if class_idx is negative, the largest element.
+  // If that value reaches threshold (in real, dequantized units) the remaining
+  // operators of the subgraph are skipped and InvokeSubgraph() returns
+  // kTfLiteEarlyExit. Supports float32, int8, uint8, int16 and int32 outputs.
+  // Early exits are checked in the order they were added.
+  TfLiteStatus AddEarlyExit(int subgraph_idx, int node_idx, int output_idx,
+                            int class_idx, float threshold);
+
+  // Number of early exits added to the graph.
+  int NumEarlyExits() const { return num_early_exits_; }
+
+  // Index, in the order they were added, of the early exit that made the last
+  // InvokeSubgraph() call return kTfLiteEarlyExit, or -1 if it did not. The
+  // exit may belong to a subgraph that call invoked through IF or WHILE.
+  int GetFiredEarlyExit() const { return fired_early_exit_; }
+
  private:
+  struct EarlyExit {
+    int subgraph_idx;
+    int node_idx;
+    int output_idx;
+    int class_idx;
+    // Threshold for float32 outputs.
+    float threshold;
+    // Threshold in the quantized domain of integer outputs.
+    int32_t quantized_threshold;
+  };
+
+  // Returns true if the output checked by early_exit reaches its threshold.
+  bool EarlyExitFired(const EarlyExit& early_exit);
+
+  // Invokes the operators of a subgraph, for InvokeSubgraph().
+  TfLiteStatus InvokeSubgraphOperators(int subgraph_idx);
+
   TfLiteContext* context_;
   const Model* model_;
   MicroAllocator* allocator_;
@@ -95,6 +138,12 @@ class MicroGraph {
   int current_subgraph_index_;
   MicroResourceVariables* resource_variables_;
   const flatbuffers::Vector<flatbuffers::Offset<SubGraph>>* subgraphs_;
+  EarlyExit early_exits_[kMaxEarlyExits];
+  int num_early_exits_ = 0;
+  int fired_early_exit_ = -1;
+  // Number of InvokeSubgraph() calls in progress, more than 1 while a kernel
+  // such as IF or WHILE invokes a subgraph of its own.
+  int invoke_depth_ = 0;
 
   TF_LITE_REMOVE_VIRTUAL_DELETE
 };
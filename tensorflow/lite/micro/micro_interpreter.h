@@ -74,6 +74,22 @@ class MicroInterpreter {
   // TODO(b/149795762): Add this to the TfLiteStatus enum.
   TfLiteStatus Invoke();
 
+  // Adds an early exit to the model's main subgraph, see
+  // MicroGraph::AddEarlyExit(). Once the operator at node_index has run, if
+  // the checked element of its output output_index (the largest one when
+  // class_index is negative) is at least threshold, Invoke() skips the rest
+  // of the graph and returns kTfLiteEarlyExit. This lets a cheap intermediate
+  // classifier head end the inference when it is already confident.
+  TfLiteStatus AddEarlyExit(int node_index, int output_index, int class_index,
+                            float threshold) {
+    return graph_.AddEarlyExit(/*subgraph_idx=*/0, node_index, output_index,
+                               class_index, threshold);
+  }
+
+  // Index, in the order they were added, of the early exit that fired during
+  // the last Invoke(), or -1 if that Invoke() ran the whole graph.
+  int early_exit_index() const { return graph_.GetFiredEarlyExit(); }
+
   // This is the recommended API for an application to pass an external payload
   // pointer as an external context to kernels. The life time of the payload
   // pointer should be at least as long as this interpreter. TFLM supports only
@@ -21,10 +21,12 @@ limitations under the License.
 #include "tensorflow/lite/micro/all_ops_resolver.h"
 #include "tensorflow/lite/micro/arena_allocator/recording_simple_memory_allocator.h"
 #include "tensorflow/lite/micro/compatibility.h"
+#include "tensorflow/lite/micro/memory_helpers.h"
 #include "tensorflow/lite/micro/micro_arena_constants.h"
 #include "tensorflow/lite/micro/micro_error_reporter.h"
 #include "tensorflow/lite/micro/micro_profiler.h"
 #include "tensorflow/lite/micro/recording_micro_allocator.h"
+#include "tensorflow/lite/micro/recording_micro_interpreter.h"
 #include "tensorflow/lite/micro/test_helpers.h"
 #include "tensorflow/lite/micro/testing/micro_test.h"
 
@@ -270,6 +272,74 @@ TF_LITE_MICRO_TEST(TestIncompleteInitialization) {
                                        tflite::GetMicroErrorReporter());
 }
 
+// Test that an early exit stops Invoke() after the operator it watches once
+// the threshold is reached, and that the remaining operators are skipped.
+TF_LITE_MICRO_TEST(TestInterpreterEarlyExit) {
+  // Each of the three operators of the complex mock model copies its int32
+  // input through to its output.
+  const tflite::Model* model = tflite::testing::GetComplexMockModel();
+  TF_LITE_MICRO_EXPECT_NE(nullptr, model);
+
+  tflite::AllOpsResolver op_resolver = tflite::testing::GetOpResolver();
+
+  constexpr size_t allocator_buffer_size = 2048;
+  uint8_t allocator_buffer[allocator_buffer_size];
+  tflite::MockProfiler profiler;
+  tflite::MicroInterpreter interpreter(
+      model, op_resolver, allocator_buffer, allocator_buffer_size,
+      tflite::GetMicroErrorReporter(), nullptr, &profiler);
+  TF_LITE_MICRO_EXPECT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+
+  TF_LITE_MICRO_EXPECT_EQ(interpreter.AddEarlyExit(/*node_index=*/0,
+                                                   /*output_index=*/0,
+                                                   /*class_index=*/-1, 50.0f),
+                          kTfLiteOk);
+  TF_LITE_MICRO_EXPECT_EQ(interpreter.AddEarlyExit(/*node_index=*/1,
+                                                   /*output_index=*/0,
+                                                   /*class_index=*/0, 21.0f),
+                          kTfLiteOk);
+  // Nodes, outputs and elements that do not exist are rejected.
+  TF_LITE_MICRO_EXPECT_EQ(interpreter.AddEarlyExit(3, 0, -1, 0.0f),
+                          kTfLiteError);
+  TF_LITE_MICRO_EXPECT_EQ(interpreter.AddEarlyExit(0, 1, -1, 0.0f),
+                          kTfLiteError);
+  TF_LITE_MICRO_EXPECT_EQ(interpreter.AddEarlyExit(0, 0, 1, 0.0f),
+                          kTfLiteError);
+
+  TfLiteTensor* input = interpreter.input(0);
+  TfLiteTensor* output = interpreter.output(0);
+
+  // Neither exit fires: the whole graph runs.
+  input->data.i32[0] = 10;
+  TF_LITE_MICRO_EXPECT_EQ(interpreter.Invoke(), kTfLiteOk);
+  TF_LITE_MICRO_EXPECT_EQ(10, output->data.i32[0]);
+#ifndef TF_LITE_STRIP_ERROR_STRINGS
+  TF_LITE_MICRO_EXPECT_EQ(profiler.event_starts(), 3);
+#endif
+
+  // Only the second exit fires, after the second operator.
+  input->data.i32[0] = 21;
+  TF_LITE_MICRO_EXPECT_EQ(interpreter.Invoke(), tflite::kTfLiteEarlyExit);
+  TF_LITE_MICRO_EXPECT_EQ(interpreter.early_exit_index(), 1);
+#ifndef TF_LITE_STRIP_ERROR_STRINGS
+  TF_LITE_MICRO_EXPECT_EQ(profiler.event_starts(), 5);
+#endif
+
+  // The first exit fires right after the first operator.
+  input->data.i32[0] = 60;
+  TF_LITE_MICRO_EXPECT_EQ(interpreter.Invoke(), tflite::kTfLiteEarlyExit);
+  TF_LITE_MICRO_EXPECT_EQ(interpreter.early_exit_index(), 0);
+#ifndef TF_LITE_STRIP_ERROR_STRINGS
+  TF_LITE_MICRO_EXPECT_EQ(profiler.event_starts(), 6);
+  TF_LITE_MICRO_EXPECT_EQ(profiler.event_ends(), 6);
+#endif
+
+  // A later Invoke() that runs the whole graph clears the fired exit.
+  input->data.i32[0] = 10;
+  TF_LITE_MICRO_EXPECT_EQ(interpreter.Invoke(), kTfLiteOk);
+  TF_LITE_MICRO_EXPECT_EQ(interpreter.early_exit_index(), -1);
+}
+
 // Test that an interpreter with a supplied profiler correctly calls the
 // profiler each time an operator is invoked.
 TF_LITE_MICRO_TEST(InterpreterWithProfilerShouldProfileOps) {
@@ -519,6 +589,50 @@ TF_LITE_MICRO_TEST(TestInterpreterNullInputsAndOutputs) {
 
 // This test is disabled from Bluepill platform because it requires more SRAM
 // than what our Bluepill simulation platform specifies.
+// Test that SPLIT outputs and CONCATENATION inputs planned as views of a single
+// buffer still produce the right values.
+TF_LITE_MICRO_TEST(TestInterpreterWithViewTensors) {
+  const tflite::Model* model =
+      tflite::testing::GetSimpleModelWithSplitAndConcatenation();
+  TF_LITE_MICRO_EXPECT_NE(nullptr, model);
+
+  tflite::AllOpsResolver op_resolver = tflite::testing::GetOpResolver();
+
+  constexpr size_t allocator_buffer_size = 4096;
+  uint8_t allocator_buffer[allocator_buffer_size];
+  tflite::MicroInterpreter interpreter(model, op_resolver, allocator_buffer,
+                                       allocator_buffer_size,
+                                       tflite::GetMicroErrorReporter());
+  TF_LITE_MICRO_EXPECT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+
+  // The SPLIT outputs live in its input and the CONCATENATION inputs in its
+  // output; the output takes the second half first.
+  const TfLiteContext& context = interpreter.context();
+  const uint8_t* input_data = context.GetEvalTensor(&context, 0)->data.uint8;
+  const uint8_t* output_data = context.GetEvalTensor(&context, 6)->data.uint8;
+  TF_LITE_MICRO_EXPECT(context.GetEvalTensor(&context, 2)->data.uint8 ==
+                       input_data);
+  TF_LITE_MICRO_EXPECT(context.GetEvalTensor(&context, 3)->data.uint8 ==
+                       input_data + 2 * sizeof(float));
+  TF_LITE_MICRO_EXPECT(context.GetEvalTensor(&context, 5)->data.uint8 ==
+                       output_data);
+  TF_LITE_MICRO_EXPECT(context.GetEvalTensor(&context, 4)->data.uint8 ==
+                       output_data + 2 * sizeof(float));
+
+  TfLiteTensor* input = interpreter.input(0);
+  const float input_values[] = {1.0f, 2.0f, 3.0f, 4.0f};
+  for (int i = 0; i < 4; ++i) {
+    input->data.f[i] = input_values[i];
+  }
+  TF_LITE_MICRO_EXPECT_EQ(interpreter.Invoke(), kTfLiteOk);
+
+  const float expected_output[] = {-3.0f, -4.0f, -1.0f, -2.0f};
+  TfLiteTensor* output = interpreter.output(0);
+  for (int i = 0; i < 4; ++i) {
+    TF_LITE_MICRO_EXPECT_EQ(expected_output[i], output->data.f[i]);
+  }
+}
+
 TF_LITE_MICRO_TEST(TestArenaUsedBytes) {
   const tflite::Model* model = tflite::testing::GetModelWith256x256Tensor();
   TF_LITE_MICRO_EXPECT_NE(nullptr, model);
@@ -548,4 +662,53 @@ TF_LITE_MICRO_TEST(TestArenaUsedBytes) {
   TF_LITE_MICRO_EXPECT_EQ(interpreter2.Invoke(), kTfLiteOk);
 }
 
+TF_LITE_MICRO_TEST(TestArenaRequirements) {
+  const tflite::Model* model = tflite::testing::GetModelWith256x256Tensor();
+  TF_LITE_MICRO_EXPECT_NE(nullptr, model);
+
+  tflite::AllOpsResolver op_resolver = tflite::testing::GetOpResolver();
+  tflite::ArenaRequirements requirements = {};
+  TF_LITE_MICRO_EXPECT_EQ(
+      tflite::RecordingMicroInterpreter::GetArenaRequirements(
+          model, op_resolver, tflite::arena_buffer, tflite::buffer_arena_size,
+          tflite::GetMicroErrorReporter(), &requirements),
+      kTfLiteOk);
+
+  TF_LITE_MICRO_EXPECT_GT(requirements.non_persistent_bytes,
+                          static_cast<size_t>(0));
+  TF_LITE_MICRO_EXPECT_GT(requirements.persistent_bytes,
+                          static_cast<size_t>(0));
+  TF_LITE_MICRO_EXPECT_LE(
+      requirements.non_persistent_bytes + requirements.persistent_bytes,
+      requirements.arena_size);
+  TF_LITE_MICRO_EXPECT_EQ(static_cast<size_t>(0),
+                          requirements.arena_size %
+                              tflite::MicroArenaBufferAlignment());
+
+  // arena_buffer is not guaranteed to be aligned, so add the alignment padding
+  // on top of the reported size.
+  tflite::MicroInterpreter interpreter(
+      model, op_resolver, tflite::arena_buffer,
+      requirements.arena_size + tflite::MicroArenaBufferAlignment(),
+      tflite::GetMicroErrorReporter());
+  TF_LITE_MICRO_EXPECT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+  TF_LITE_MICRO_EXPECT_EQ(interpreter.Invoke(), kTfLiteOk);
+  TF_LITE_MICRO_EXPECT_LE(interpreter.arena_used_bytes(),
+                          requirements.arena_size);
+
+  // The reported size is the minimum: an aligned arena one alignment unit
+  // smaller is not enough.
+  uint8_t* aligned_arena = tflite::AlignPointerUp(
+      tflite::arena_buffer, tflite::MicroArenaBufferAlignment());
+  tflite::MicroInterpreter exact_interpreter(model, op_resolver, aligned_arena,
+                                             requirements.arena_size,
+                                             tflite::GetMicroErrorReporter());
+  TF_LITE_MICRO_EXPECT_EQ(exact_interpreter.AllocateTensors(), kTfLiteOk);
+  tflite::MicroInterpreter tight_interpreter(
+      model, op_resolver, aligned_arena,
+      requirements.arena_size - tflite::MicroArenaBufferAlignment(),
+      tflite::GetMicroErrorReporter());
+  TF_LITE_MICRO_EXPECT_EQ(tight_interpreter.AllocateTensors(), kTfLiteError);
+}
+
 TF_LITE_MICRO_TESTS_END
@@ -37,7 +37,11 @@ limitations under the License.
 #include "tensorflow/lite/micro/My/kernel/lce_ops_register.h"
 
 namespace tflite {
+TfLiteRegistration* Register_AUDIO_MICROFRONTEND();
 TfLiteRegistration* Register_DETECTION_POSTPROCESS();
+// Decodes every box and runs the O(N^2) NMS; produces the same outputs as
+// Register_DETECTION_POSTPROCESS() and is kept for comparison.
+TfLiteRegistration* Register_DETECTION_POSTPROCESS_REFERENCE();
 
 template <unsigned int tOpCount>
 class MicroMutableOpResolver : public MicroOpResolver {
@@ -147,6 +151,14 @@ class MicroMutableOpResolver : public MicroOpResolver {
                       tflite::Register_ASSIGN_VARIABLE(), ParseAssignVariable);
   }
 
+  // The kernel is not part of the default op set: link against the
+  // kernels:audio_microfrontend library (AUDIO_MICROFRONTEND_KERNEL_SRCS in
+  // the Makefile) to use it.
+  TfLiteStatus AddAudioMicrofrontend() {
+    return AddCustom("AudioMicrofrontend",
+                     tflite::Register_AUDIO_MICROFRONTEND());
+  }
+
   TfLiteStatus AddAveragePool2D() {
     return AddBuiltin(BuiltinOperator_AVERAGE_POOL_2D,
                       tflite::Register_AVERAGE_POOL_2D(), ParsePool);
@@ -557,10 +569,11 @@ class MicroMutableOpResolver : public MicroOpResolver {
                       tflite::ops::micro::Register_UNPACK(), ParseUnpack);
   }
 
-  TfLiteStatus AddUnidirectionalSequenceLSTM() {
+  TfLiteStatus AddUnidirectionalSequenceLSTM(
+      const TfLiteRegistration& registration =
+          Register_UNIDIRECTIONAL_SEQUENCE_LSTM()) {
     return AddBuiltin(BuiltinOperator_UNIDIRECTIONAL_SEQUENCE_LSTM,
-                      Register_UNIDIRECTIONAL_SEQUENCE_LSTM(),
-                      ParseUnidirectionalSequenceLSTM);
+                      registration, ParseUnidirectionalSequenceLSTM);
   }
 
   TfLiteStatus AddVarHandle() {
@@ -577,9 +590,26 @@ class MicroMutableOpResolver : public MicroOpResolver {
                       ParseZerosLike);
   }
 
-  TfLiteStatus AddBConv2D() {
-    return AddBuiltin(MyOperator_BConv, *::compute_engine::tflite::Register_BCONV_2D(),
-                     ParseBConv);
+  // Larq binary convolutions are custom ops named "LceBconv2d" whose options
+  // are a flexbuffer map.
+  TfLiteStatus AddBConv2D(TfLiteRegistration* registration =
+                              ::compute_engine::tflite::Register_BCONV_2D()) {
+    return AddCustom("LceBconv2d", registration);
+  }
+
+  // A binary convolution with bitpacked output fused with the binary max-pool
+  // that consumes it. The options are those of "LceBconv2d" plus the
+  // "LceBMaxPool2d" options with a "pool_" prefix.
+  TfLiteStatus AddBConv2DBMaxPool2D() {
+    return AddCustom("LceBconv2dBMaxPool2d",
+                     ::compute_engine::tflite::Register_BCONV_2D_BMAXPOOL_2D());
+  }
+
+  // A binary fully-connected layer with bitpacked weights. Its inputs are
+  // those of "LceBconv2d", with a [channels_out, bitpacked channels_in] filter.
+  TfLiteStatus AddBFullyConnected() {
+    return AddCustom("LceBFullyConnected",
+                     ::compute_engine::tflite::Register_BFULLY_CONNECTED());
   }
 
   unsigned int GetRegistrationLength() { return registrations_len_; }
@@ -0,0 +1,119 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/micro/python/interpreter/src/interpreter_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "tensorflow/lite/micro/micro_arena_constants.h"
+
+namespace tflite {
+
+InterpreterPool::InterpreterPool(const Model* model,
+                                 const MicroOpResolver& op_resolver,
+                                 size_t arena_size, int num_interpreters,
+                                 ErrorReporter* error_reporter)
+    : error_reporter_(error_reporter) {
+  if (num_interpreters < 1) {
+    TF_LITE_REPORT_ERROR(error_reporter,
+                         "An interpreter pool needs at least 1 interpreter, "
+                         "got %d.",
+                         num_interpreters);
+    return;
+  }
+
+  if (AddInterpreter(model, op_resolver, arena_size, error_reporter) !=
+      kTfLiteOk) {
+    return;
+  }
+  // The arena may not be aligned, see MicroInterpreter::arena_used_bytes().
+  interpreter_arena_size_ =
+      std::min(arena_size, entries_[0].interpreter->arena_used_bytes() +
+                               MicroArenaBufferAlignment());
+
+  for (int i = 1; i < num_interpreters; ++i) {
+    if (AddInterpreter(model, op_resolver, interpreter_arena_size_,
+                       error_reporter) != kTfLiteOk) {
+      return;
+    }
+  }
+
+  for (const Entry& entry : entries_) {
+    idle_.push_back(entry.interpreter.get());
+  }
+  initialization_status_ = kTfLiteOk;
+}
+
+TfLiteStatus InterpreterPool::AddInterpreter(const Model* model,
+                                             const MicroOpResolver& op_resolver,
+                                             size_t arena_size,
+                                             ErrorReporter* error_reporter) {
+  Entry entry;
+  entry.arena = std::unique_ptr<uint8_t[]>(new uint8_t[arena_size]);
+  entry.interpreter = std::unique_ptr<MicroInterpreter>(
+      new MicroInterpreter(model, op_resolver, entry.arena.get(), arena_size,
+                           error_reporter));
+  TF_LITE_ENSURE_STATUS(entry.interpreter->initialization_status());
+  TF_LITE_ENSURE_STATUS(entry.interpreter->AllocateTensors());
+  entries_.push_back(std::move(entry));
+  return kTfLiteOk;
+}
+
+MicroInterpreter* InterpreterPool::Acquire() {
+  if (initialization_status_ != kTfLiteOk) {
+    return nullptr;
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  released_cv_.wait(lock, [this] { return !idle_.empty(); });
+  MicroInterpreter* interpreter = idle_.back();
+  idle_.pop_back();
+  return interpreter;
+}
+
+MicroInterpreter* InterpreterPool::TryAcquire() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (idle_.empty()) {
+    return nullptr;
+  }
+  MicroInterpreter* interpreter = idle_.back();
+  idle_.pop_back();
+  return interpreter;
+}
+
+TfLiteStatus InterpreterPool::Release(MicroInterpreter* interpreter) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Handing the same interpreter, and so the same arena, to two threads
+    // would corrupt both of their results.
+    const bool from_pool =
+        std::any_of(entries_.begin(), entries_.end(),
+                    [interpreter](const Entry& entry) {
+                      return entry.interpreter.get() == interpreter;
+                    });
+    if (!from_pool ||
+        std::find(idle_.begin(), idle_.end(), interpreter) != idle_.end()) {
+      TF_LITE_REPORT_ERROR(error_reporter_,
+                           "Released an interpreter that was not acquired "
+                           "from this pool.");
+      return kTfLiteError;
+    }
+    idle_.push_back(interpreter);
+  }
+  released_cv_.notify_one();
+  return kTfLiteOk;
+}
+
+}  // namespace tflite
@@ -0,0 +1,101 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_MICRO_TOOLS_PYTHON_INTERPRETER_POOL_H_
+#define TENSORFLOW_LITE_MICRO_TOOLS_PYTHON_INTERPRETER_POOL_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/core/api/error_reporter.h"
+#include "tensorflow/lite/micro/micro_interpreter.h"
+#include "tensorflow/lite/micro/micro_op_resolver.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+
+namespace tflite {
+
+// A fixed set of interpreters for one model, for hosts that serve concurrent
+// requests. Each interpreter has its own tensor arena, and a thread acquires
+// one for as long as it needs it, e.g. for one set of inputs, Invoke() and
+// outputs, and then releases it for other threads.
+//
+// The model and op resolver are shared. The first interpreter is allocated in
+// an arena of `arena_size` bytes, and the others in arenas that are only as
+// large as what it actually used, so the pool doesn't pay for a generous
+// `arena_size` more than once.
+//
+// This is a host utility: it uses the C++ standard library threading
+// primitives and heap allocation, unlike the rest of TFLM.
+class InterpreterPool {
+ public:
+  // The lifetime of the model, op resolver and error reporter must be at least
+  // as long as that of the pool.
+  InterpreterPool(const Model* model, const MicroOpResolver& op_resolver,
+                  size_t arena_size, int num_interpreters,
+                  ErrorReporter* error_reporter);
+
+  InterpreterPool(const InterpreterPool&) = delete;
+  InterpreterPool& operator=(const InterpreterPool&) = delete;
+
+  // kTfLiteOk if all interpreters were created and allocated their tensors.
+  TfLiteStatus initialization_status() const { return initialization_status_; }
+
+  size_t size() const { return entries_.size(); }
+
+  // Arena size of each interpreter, after the first one has been allocated.
+  size_t arena_size_per_interpreter() const { return interpreter_arena_size_; }
+
+  // Returns an idle interpreter, waiting for one to be released if all of them
+  // are in use. Returns nullptr if the pool failed to initialize.
+  MicroInterpreter* Acquire();
+
+  // Returns an idle interpreter, or nullptr without waiting if all of them are
+  // in use.
+  MicroInterpreter* TryAcquire();
+
+  // Returns an interpreter obtained from Acquire() or TryAcquire() to the pool.
+  // Its tensors keep their contents until the next thread acquires it.
+  // Returns kTfLiteError, and leaves the pool unchanged, if `interpreter` is
+  // not from this pool or is already idle.
+  TfLiteStatus Release(MicroInterpreter* interpreter);
+
+ private:
+  struct Entry {
+    std::unique_ptr<uint8_t[]> arena;
+    std::unique_ptr<MicroInterpreter> interpreter;
+  };
+
+  TfLiteStatus AddInterpreter(const Model* model,
+                              const MicroOpResolver& op_resolver,
+                              size_t arena_size, ErrorReporter* error_reporter);
+
+  ErrorReporter* error_reporter_;
+  std::vector<Entry> entries_;
+  size_t interpreter_arena_size_ = 0;
+  TfLiteStatus initialization_status_ = kTfLiteError;
+
+  std::mutex mutex_;
+  std::condition_variable released_cv_;
+  // The interpreters that are not acquired.
+  std::vector<MicroInterpreter*> idle_;
+};
+
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_MICRO_TOOLS_PYTHON_INTERPRETER_POOL_H_
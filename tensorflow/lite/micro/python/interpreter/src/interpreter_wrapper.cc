@@ -15,6 +15,10 @@ limitations under the License.
 
 #include "tensorflow/lite/micro/python/interpreter/src/interpreter_wrapper.h"
 
+#include <algorithm>
+#include <thread>
+#include <vector>
+
 // Disallow Numpy 1.7 deprecated symbols.
 #define NPY_NO_DEPRECATED_API NPY_1_7_API_VERSION
 // See https://numpy.org/doc/1.16/reference/c-api.array.html#importing-the-api
@@ -29,18 +33,119 @@ limitations under the License.
 #include "tensorflow/lite/micro/all_ops_resolver.h"
 #include "tensorflow/lite/micro/micro_error_reporter.h"
 #include "tensorflow/lite/micro/micro_interpreter.h"
+#include "tensorflow/lite/micro/python/interpreter/src/interpreter_pool.h"
 #include "tensorflow/lite/micro/python/interpreter/src/numpy_utils.h"
 #include "tensorflow/lite/micro/python/interpreter/src/python_utils.h"
 
 namespace tflite {
+namespace {
+
+// Checks that `tensor` can be returned to Python as a numpy array and returns
+// its numpy type, or sets a Python error and returns NPY_NOTYPE.
+int GetNumpyType(const TfLiteTensor* tensor) {
+  if (tensor->type == kTfLiteString || tensor->type == kTfLiteResource ||
+      tensor->type == kTfLiteVariant) {
+    PyErr_SetString(PyExc_ValueError,
+                    "TFLM doesn't support strings, resource variables, or "
+                    "variants as outputs.");
+    return NPY_NOTYPE;
+  }
+
+  if (tensor->sparsity != nullptr) {
+    PyErr_SetString(PyExc_ValueError, "TFLM doesn't support sparse tensors");
+    return NPY_NOTYPE;
+  }
+
+  int py_type_num = TfLiteTypeToPyArrayType(tensor->type);
+  if (py_type_num == NPY_NOTYPE) {
+    PyErr_SetString(PyExc_ValueError, "Unknown tensor type.");
+    return NPY_NOTYPE;
+  }
+
+  if (tensor->bytes == 0 && tensor->data.data != nullptr) {
+    PyErr_SetString(PyExc_ValueError, "Invalid tensor size of 0.");
+    return NPY_NOTYPE;
+  }
+
+  if (tensor->bytes > 0 && tensor->data.data == nullptr) {
+    PyErr_SetString(PyExc_ValueError, "Null tensor pointer.");
+    return NPY_NOTYPE;
+  }
+
+  return py_type_num;
+}
+
+// Wraps the arena buffer of `tensor` in a numpy array without copying it. The
+// arena is owned by the interpreter, so the array holds a reference to
+// `owner` instead of owning its data.
+PyObject* GetTensorView(TfLiteTensor* tensor, PyObject* owner, bool writeable) {
+  int py_type_num = GetNumpyType(tensor);
+  if (py_type_num == NPY_NOTYPE) {
+    return nullptr;
+  }
+
+  std::vector<npy_intp> dims(tensor->dims->data,
+                             tensor->dims->data + tensor->dims->size);
+  PyObject* np_array = PyArray_New(
+      &PyArray_Type, dims.size(), dims.data(), py_type_num, /*strides=*/nullptr,
+      tensor->data.data, /*itemsize=*/0,
+      writeable ? NPY_ARRAY_CARRAY : NPY_ARRAY_CARRAY_RO, /*obj=*/nullptr);
+  if (np_array == nullptr) {
+    return nullptr;
+  }
+
+  // PyArray_SetBaseObject steals the reference, even on failure.
+  Py_INCREF(owner);
+  if (PyArray_SetBaseObject(reinterpret_cast<PyArrayObject*>(np_array),
+                            owner) != 0) {
+    Py_DECREF(np_array);
+    return nullptr;
+  }
+  return np_array;
+}
+
+// The raw buffers of a batch, shared by the threads that evaluate it.
+struct BatchBuffers {
+  std::vector<const uint8_t*> inputs;
+  std::vector<size_t> input_bytes;
+  std::vector<uint8_t*> outputs;
+  std::vector<size_t> output_bytes;
+};
+
+// Runs samples [start, end) of `batch` through `interpreter`. Doesn't touch
+// any Python objects, so it can run without the GIL.
+TfLiteStatus EvaluateSamples(MicroInterpreter* interpreter,
+                             const BatchBuffers& batch, npy_intp start,
+                             npy_intp end) {
+  for (npy_intp i = start; i < end; ++i) {
+    for (size_t j = 0; j < batch.inputs.size(); ++j) {
+      memcpy(interpreter->input(j)->data.data,
+             batch.inputs[j] + i * batch.input_bytes[j], batch.input_bytes[j]);
+    }
+    TfLiteStatus status = interpreter->Invoke();
+    if (status != kTfLiteOk) {
+      return status;
+    }
+    for (size_t j = 0; j < batch.outputs.size(); ++j) {
+      memcpy(batch.outputs[j] + i * batch.output_bytes[j],
+             interpreter->output(j)->data.data, batch.output_bytes[j]);
+    }
+  }
+  return kTfLiteOk;
+}
+
+}  // namespace
 
 InterpreterWrapper::~InterpreterWrapper() {
+  Release();
   // Undo any references incremented
+  Py_XDECREF(pool_owner_);
   Py_DECREF(model_);
 }
 
 InterpreterWrapper::InterpreterWrapper(PyObject* model_data,
-                                       size_t arena_size) {
+                                       size_t arena_size)
+    : arena_size_(arena_size) {
   // `model_data` is used as a raw pointer beyond the scope of this
   // constructor, so we need to increment the reference count so that Python
   // doesn't destroy it during the lifetime of this interpreter.
@@ -59,10 +164,13 @@ InterpreterWrapper::InterpreterWrapper(PyObject* model_data,
   const Model* model = GetModel(buf);
   model_ = model_data;
   error_reporter_ = std::unique_ptr<ErrorReporter>(new MicroErrorReporter());
+  all_ops_resolver_ =
+      std::unique_ptr<const AllOpsResolver>(new AllOpsResolver());
   memory_arena_ = std::unique_ptr<uint8_t[]>(new uint8_t[arena_size]);
-  interpreter_ = std::unique_ptr<MicroInterpreter>(
-      new MicroInterpreter(model, all_ops_resolver_, memory_arena_.get(),
+  owned_interpreter_ = std::unique_ptr<MicroInterpreter>(
+      new MicroInterpreter(model, *all_ops_resolver_, memory_arena_.get(),
                            arena_size, error_reporter_.get()));
+  interpreter_ = owned_interpreter_.get();
 
   TfLiteStatus status = interpreter_->AllocateTensors();
   if (status != kTfLiteOk) {
@@ -75,8 +183,52 @@ InterpreterWrapper::InterpreterWrapper(PyObject* model_data,
   ImportNumpy();
 }
 
+InterpreterWrapper::InterpreterWrapper(InterpreterPoolWrapper* pool,
+                                       MicroInterpreter* interpreter,
+                                       PyObject* pool_owner)
+    : model_(pool->model_),
+      arena_size_(pool->arena_size_),
+      interpreter_(interpreter),
+      pool_(pool),
+      pool_owner_(pool_owner) {
+  Py_INCREF(model_);
+  Py_INCREF(pool_owner_);
+}
+
+void InterpreterWrapper::Release() {
+  if (pool_ == nullptr) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (interpreter_ != nullptr) {
+    pool_->pool_->Release(interpreter_);
+    interpreter_ = nullptr;
+  }
+}
+
+bool InterpreterWrapper::CheckNotReleased() {
+  if (interpreter_ == nullptr) {
+    PyErr_SetString(PyExc_RuntimeError,
+                    "The interpreter was released to its pool.");
+    return false;
+  }
+  return true;
+}
+
 int InterpreterWrapper::Invoke() {
-  TfLiteStatus status = interpreter_->Invoke();
+  if (!CheckNotReleased()) {
+    return kTfLiteError;
+  }
+  TfLiteStatus status;
+  // The inference doesn't touch any Python objects. The lock is released
+  // before the GIL is taken back, so that a thread that holds the GIL and
+  // waits for the lock can't deadlock with this one.
+  Py_BEGIN_ALLOW_THREADS
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    status = interpreter_->Invoke();
+  }
+  Py_END_ALLOW_THREADS
   if (status != kTfLiteOk) {
     PyErr_Format(PyExc_RuntimeError, "TFLM failed to invoke. Error: %d",
                  status);
@@ -104,6 +256,10 @@ void InterpreterWrapper::SetInputTensor(PyObject* data, size_t index) {
 
   PyArrayObject* array = reinterpret_cast<PyArrayObject*>(array_safe.get());
 
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!CheckNotReleased()) {
+    return;
+  }
   TfLiteTensor* tensor = interpreter_->input(index);
   if (tensor == nullptr) {
     PyErr_SetString(PyExc_IndexError,
@@ -164,38 +320,18 @@ void InterpreterWrapper::SetInputTensor(PyObject* data, size_t index) {
 // 2. Allocate a buffer and copy output tensor data into it
 // 3. Set PyArray metadata and transfer ownership to caller
 PyObject* InterpreterWrapper::GetOutputTensor(size_t index) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!CheckNotReleased()) {
+    return nullptr;
+  }
   TfLiteTensor* tensor = interpreter_->output(index);
   if (tensor == nullptr) {
     PyErr_SetString(PyExc_IndexError, "Tensor is out of bound.");
     return nullptr;
   }
 
-  if (tensor->type == kTfLiteString || tensor->type == kTfLiteResource ||
-      tensor->type == kTfLiteVariant) {
-    PyErr_SetString(PyExc_ValueError,
-                    "TFLM doesn't support strings, resource variables, or "
-                    "variants as outputs.");
-    return nullptr;
-  }
-
-  if (tensor->sparsity != nullptr) {
-    PyErr_SetString(PyExc_ValueError, "TFLM doesn't support sparse tensors");
-    return nullptr;
-  }
-
-  int py_type_num = TfLiteTypeToPyArrayType(tensor->type);
+  int py_type_num = GetNumpyType(tensor);
   if (py_type_num == NPY_NOTYPE) {
-    PyErr_SetString(PyExc_ValueError, "Unknown tensor type.");
-    return nullptr;
-  }
-
-  if (tensor->bytes == 0 && tensor->data.data != nullptr) {
-    PyErr_SetString(PyExc_ValueError, "Invalid tensor size of 0.");
-    return nullptr;
-  }
-
-  if (tensor->bytes > 0 && tensor->data.data == nullptr) {
-    PyErr_SetString(PyExc_ValueError, "Null tensor pointer.");
     return nullptr;
   }
 
@@ -220,4 +356,271 @@ PyObject* InterpreterWrapper::GetOutputTensor(size_t index) {
   return PyArray_Return(reinterpret_cast<PyArrayObject*>(np_array));
 }
 
+PyObject* InterpreterWrapper::GetInputTensorView(size_t index,
+                                                 PyObject* owner) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!CheckNotReleased()) {
+    return nullptr;
+  }
+  TfLiteTensor* tensor = interpreter_->input(index);
+  if (tensor == nullptr) {
+    PyErr_SetString(PyExc_IndexError,
+                    "Tensor is out of bound, please check tensor index.");
+    return nullptr;
+  }
+  return GetTensorView(tensor, owner, /*writeable=*/true);
+}
+
+PyObject* InterpreterWrapper::GetOutputTensorView(size_t index,
+                                                  PyObject* owner) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!CheckNotReleased()) {
+    return nullptr;
+  }
+  TfLiteTensor* tensor = interpreter_->output(index);
+  if (tensor == nullptr) {
+    PyErr_SetString(PyExc_IndexError, "Tensor is out of bound.");
+    return nullptr;
+  }
+  return GetTensorView(tensor, owner, /*writeable=*/false);
+}
+
+// 1. Check that every input array holds a stack of samples for its tensor
+// 2. Allocate the stacked output arrays
+// 3. Split the samples over this interpreter and its clones, and evaluate them
+//    without the GIL
+PyObject* InterpreterWrapper::EvaluateBatch(PyObject* inputs,
+                                            int num_threads) {
+  if (!CheckNotReleased()) {
+    return nullptr;
+  }
+
+  std::unique_ptr<PyObject, PyDecrefDeleter> inputs_safe(
+      PySequence_Fast(inputs, "Inputs must be a sequence of arrays."));
+  if (!inputs_safe) {
+    return nullptr;
+  }
+
+  const size_t num_inputs = interpreter_->inputs_size();
+  if (static_cast<size_t>(PySequence_Fast_GET_SIZE(inputs_safe.get())) !=
+      num_inputs) {
+    PyErr_Format(PyExc_ValueError, "Got %zd inputs but the model has %zu.",
+                 PySequence_Fast_GET_SIZE(inputs_safe.get()), num_inputs);
+    return nullptr;
+  }
+
+  BatchBuffers batch;
+  std::vector<std::unique_ptr<PyObject, PyDecrefDeleter>> input_arrays;
+  npy_intp num_samples = -1;
+  for (size_t j = 0; j < num_inputs; ++j) {
+    PyObject* array_object = PyArray_FromAny(
+        /*op=*/PySequence_Fast_GET_ITEM(inputs_safe.get(), j),
+        /*dtype=*/nullptr,
+        /*min_depth=*/0,
+        /*max_depth=*/0,
+        /*requirements=*/NPY_ARRAY_CARRAY,
+        /*context=*/nullptr);
+    if (array_object == nullptr) {
+      PyErr_SetString(PyExc_ValueError, "TFLM cannot convert input to PyArray");
+      return nullptr;
+    }
+    input_arrays.emplace_back(array_object);
+    PyArrayObject* array = reinterpret_cast<PyArrayObject*>(array_object);
+
+    const TfLiteTensor* tensor = interpreter_->input(j);
+    if (TfLiteTypeFromPyArray(array) != tensor->type) {
+      PyErr_Format(PyExc_ValueError,
+                   "Got value of type %s but expected type %s for input %zu, "
+                   "name: %s ",
+                   TfLiteTypeGetName(TfLiteTypeFromPyArray(array)),
+                   TfLiteTypeGetName(tensor->type), j, tensor->name);
+      return nullptr;
+    }
+
+    if (PyArray_NDIM(array) != tensor->dims->size + 1) {
+      PyErr_Format(PyExc_ValueError,
+                   "Dimension mismatch. Got %d but expected %d for the "
+                   "stacked samples of input %zu.",
+                   PyArray_NDIM(array), tensor->dims->size + 1, j);
+      return nullptr;
+    }
+
+    for (int k = 0; k < tensor->dims->size; k++) {
+      if (tensor->dims->data[k] != PyArray_SHAPE(array)[k + 1]) {
+        PyErr_Format(PyExc_ValueError,
+                     "Dimension mismatch. Got %zd but expected %d for "
+                     "dimension %d of the samples of input %zu.",
+                     static_cast<Py_ssize_t>(PyArray_SHAPE(array)[k + 1]),
+                     tensor->dims->data[k], k, j);
+        return nullptr;
+      }
+    }
+
+    if (num_samples != -1 && PyArray_SHAPE(array)[0] != num_samples) {
+      PyErr_Format(PyExc_ValueError,
+                   "Got %zd samples for input %zu but %zd for input 0.",
+                   static_cast<Py_ssize_t>(PyArray_SHAPE(array)[0]), j,
+                   static_cast<Py_ssize_t>(num_samples));
+      return nullptr;
+    }
+    num_samples = PyArray_SHAPE(array)[0];
+
+    batch.inputs.push_back(
+        reinterpret_cast<const uint8_t*>(PyArray_DATA(array)));
+    batch.input_bytes.push_back(tensor->bytes);
+  }
+  if (num_samples == -1) {
+    PyErr_SetString(PyExc_ValueError, "The model has no inputs.");
+    return nullptr;
+  }
+
+  const size_t num_outputs = interpreter_->outputs_size();
+  std::unique_ptr<PyObject, PyDecrefDeleter> outputs(PyList_New(num_outputs));
+  if (!outputs) {
+    return nullptr;
+  }
+  for (size_t j = 0; j < num_outputs; ++j) {
+    const TfLiteTensor* tensor = interpreter_->output(j);
+    int py_type_num = GetNumpyType(tensor);
+    if (py_type_num == NPY_NOTYPE) {
+      return nullptr;
+    }
+
+    std::vector<npy_intp> dims(1, num_samples);
+    dims.insert(dims.end(), tensor->dims->data,
+                tensor->dims->data + tensor->dims->size);
+    PyObject* np_array = PyArray_SimpleNew(dims.size(), dims.data(),
+                                           py_type_num);
+    if (np_array == nullptr) {
+      return nullptr;
+    }
+    // The list takes over the reference.
+    PyList_SET_ITEM(outputs.get(), j, np_array);
+
+    batch.outputs.push_back(reinterpret_cast<uint8_t*>(
+        PyArray_DATA(reinterpret_cast<PyArrayObject*>(np_array))));
+    batch.output_bytes.push_back(tensor->bytes);
+  }
+
+  num_threads = std::max<npy_intp>(1, std::min<npy_intp>(num_threads,
+                                                         num_samples));
+  // `clones_` only changes under `mutex_`, as the workers of an
+  // EvaluateBatch() on another thread may be reading it without the GIL. The
+  // missing clones need the GIL to be created, so they are created here and
+  // only moved into `clones_` once the lock is taken below.
+  size_t num_clones;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    num_clones = clones_.size();
+  }
+  std::vector<std::unique_ptr<InterpreterWrapper>> new_clones;
+  while (num_clones + new_clones.size() + 1 <
+         static_cast<size_t>(num_threads)) {
+    std::unique_ptr<InterpreterWrapper> clone(new InterpreterWrapper(
+        const_cast<PyObject*>(model_), arena_size_));
+    if (PyErr_Occurred()) {
+      return nullptr;
+    }
+    new_clones.push_back(std::move(clone));
+  }
+
+  // Every thread evaluates a contiguous share of the samples on its own
+  // interpreter, thread 0 on this one.
+  std::vector<TfLiteStatus> statuses(num_threads, kTfLiteOk);
+  Py_BEGIN_ALLOW_THREADS
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Another thread may have added clones in the meantime. The clones that
+    // aren't needed are destroyed with the GIL held, when this returns.
+    for (auto& clone : new_clones) {
+      if (clones_.size() + 1 >= static_cast<size_t>(num_threads)) {
+        break;
+      }
+      clones_.push_back(std::move(clone));
+    }
+    std::vector<std::thread> workers;
+    for (int t = 1; t < num_threads; ++t) {
+      workers.emplace_back([&, t] {
+        statuses[t] = EvaluateSamples(
+            clones_[t - 1]->interpreter_, batch,
+            num_samples * t / num_threads,
+            num_samples * (t + 1) / num_threads);
+      });
+    }
+    statuses[0] = EvaluateSamples(interpreter_, batch, 0,
+                                  num_samples / num_threads);
+    for (auto& worker : workers) {
+      worker.join();
+    }
+  }
+  Py_END_ALLOW_THREADS
+
+  for (TfLiteStatus status : statuses) {
+    if (status != kTfLiteOk) {
+      PyErr_Format(PyExc_RuntimeError, "TFLM failed to invoke. Error: %d",
+                   status);
+      return nullptr;
+    }
+  }
+
+  return outputs.release();
+}
+
+InterpreterPoolWrapper::InterpreterPoolWrapper(PyObject* model_data,
+                                               size_t arena_size,
+                                               int num_interpreters)
+    : model_(model_data), arena_size_(arena_size) {
+  // See InterpreterWrapper::InterpreterWrapper().
+  Py_INCREF(model_data);
+
+  char* buf = nullptr;
+  Py_ssize_t length;
+  if (ConvertFromPyString(model_data, &buf, &length) == -1 || buf == nullptr) {
+    PyErr_SetString(
+        PyExc_ValueError,
+        "TFLM cannot convert model data from Python object to char *");
+    return;
+  }
+
+  error_reporter_ = std::unique_ptr<ErrorReporter>(new MicroErrorReporter());
+  pool_ = std::unique_ptr<InterpreterPool>(
+      new InterpreterPool(GetModel(buf), all_ops_resolver_, arena_size,
+                          num_interpreters, error_reporter_.get()));
+  if (pool_->initialization_status() != kTfLiteOk) {
+    PyErr_SetString(PyExc_RuntimeError,
+                    "TFLM failed to create the interpreter pool");
+    return;
+  }
+
+  ImportNumpy();
+}
+
+InterpreterPoolWrapper::~InterpreterPoolWrapper() {
+  // The wrappers of acquired interpreters hold a reference to this pool, so
+  // none of them are in use anymore.
+  Py_DECREF(model_);
+}
+
+InterpreterWrapper* InterpreterPoolWrapper::Acquire(bool block,
+                                                    PyObject* owner) {
+  if (!pool_ || pool_->initialization_status() != kTfLiteOk) {
+    PyErr_SetString(PyExc_RuntimeError, "The interpreter pool is not valid.");
+    return nullptr;
+  }
+
+  MicroInterpreter* interpreter;
+  if (block) {
+    // The thread that releases an interpreter needs the GIL to do so.
+    Py_BEGIN_ALLOW_THREADS
+    interpreter = pool_->Acquire();
+    Py_END_ALLOW_THREADS
+  } else {
+    interpreter = pool_->TryAcquire();
+  }
+  if (interpreter == nullptr) {
+    return nullptr;
+  }
+  return new InterpreterWrapper(this, interpreter, owner);
+}
+
 }  // namespace tflite
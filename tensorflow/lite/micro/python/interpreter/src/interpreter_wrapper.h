@@ -17,27 +17,112 @@ limitations under the License.
 
 #include <Python.h>
 
+#include <memory>
+#include <mutex>
+#include <vector>
+
 #include "tensorflow/lite/core/api/error_reporter.h"
 #include "tensorflow/lite/micro/all_ops_resolver.h"
 #include "tensorflow/lite/micro/micro_interpreter.h"
+#include "tensorflow/lite/micro/python/interpreter/src/interpreter_pool.h"
 
 namespace tflite {
 
+class InterpreterPoolWrapper;
+
 class InterpreterWrapper {
  public:
   InterpreterWrapper(PyObject* model_data, size_t arena_size);
+  // Wraps `interpreter`, acquired from `pool`. `pool_owner` is the Python
+  // object that wraps `pool`, and is kept alive as long as this wrapper, so
+  // that tensor views stay valid.
+  InterpreterWrapper(InterpreterPoolWrapper* pool,
+                     MicroInterpreter* interpreter, PyObject* pool_owner);
   ~InterpreterWrapper();
 
+  // Returns an interpreter acquired from a pool to the pool. Any later call
+  // on this wrapper raises an error. Tensor views stay valid memory, but
+  // their contents then belong to the next user of the interpreter. Does
+  // nothing for an interpreter that isn't from a pool. Must not be called
+  // while another thread uses this wrapper.
+  void Release();
+
+  // Runs an inference with the GIL released, so that other Python threads,
+  // including ones invoking other interpreters, can run in the meantime.
   int Invoke();
   void SetInputTensor(PyObject* data, size_t index);
   PyObject* GetOutputTensor(size_t index);
 
+  // Return numpy arrays that alias the arena buffer of an input or output
+  // tensor, without copying. The arrays keep `owner`, the Python object that
+  // wraps this interpreter, alive. The buffers never move, but the arena is
+  // shared between tensors, so:
+  //  - an input view must be written before every Invoke(), as the inference
+  //    may reuse the buffer for intermediate results;
+  //  - an output view is read-only, and only holds the results of the last
+  //    Invoke() until the next write to an input or the next Invoke().
+  // Reads and writes through a view don't take `mutex_`, so they race with an
+  // Invoke() on another thread. Don't touch a view while Invoke() may run.
+  PyObject* GetInputTensorView(size_t index, PyObject* owner);
+  PyObject* GetOutputTensorView(size_t index, PyObject* owner);
+
+  // Runs one inference per sample and returns a list with one array per
+  // output tensor. `inputs` is a sequence with one array per input tensor,
+  // each of shape (num_samples, *tensor_shape). The samples are copied into
+  // the arena and the results out of it without going through Python. With
+  // `num_threads` > 1, the samples are spread over this interpreter and
+  // `num_threads - 1` clones of it, each invoked on its own thread with the
+  // GIL released.
+  PyObject* EvaluateBatch(PyObject* inputs, int num_threads);
+
  private:
+  // Sets a Python error and returns false if the interpreter was released.
+  bool CheckNotReleased();
+
   const PyObject* model_;
+  const size_t arena_size_;
   std::unique_ptr<tflite::ErrorReporter> error_reporter_;
-  std::unique_ptr<tflite::MicroInterpreter> interpreter_;
+  // Only set for a wrapper that owns its interpreter. An interpreter from
+  // `pool_` uses the resolver of the pool. Declared before
+  // `owned_interpreter_`, which uses it until it is destroyed.
+  std::unique_ptr<const tflite::AllOpsResolver> all_ops_resolver_;
+  // Either `owned_interpreter_`, or an interpreter acquired from `pool_`.
+  tflite::MicroInterpreter* interpreter_ = nullptr;
+  std::unique_ptr<tflite::MicroInterpreter> owned_interpreter_;
+  InterpreterPoolWrapper* pool_ = nullptr;
+  PyObject* pool_owner_ = nullptr;
   std::unique_ptr<uint8_t[]> memory_arena_;
+  // Serializes access to the arena, since Invoke() runs without the GIL.
+  std::mutex mutex_;
+  // Interpreters with their own arenas for EvaluateBatch(). They are created
+  // on first use and reused for later batches.
+  std::vector<std::unique_ptr<InterpreterWrapper>> clones_;
+};
+
+// A pool of interpreters for one model, see InterpreterPool, for Python
+// threads that serve concurrent requests.
+class InterpreterPoolWrapper {
+ public:
+  InterpreterPoolWrapper(PyObject* model_data, size_t arena_size,
+                         int num_interpreters);
+  ~InterpreterPoolWrapper();
+
+  size_t size() const { return pool_ ? pool_->size() : 0; }
+
+  // Returns a wrapper for an idle interpreter, which the caller owns. With
+  // `block`, waits for one to be released, with the GIL released. Otherwise
+  // returns nullptr, without a Python error, if all interpreters are in use.
+  // `owner` is the Python object that wraps this pool.
+  InterpreterWrapper* Acquire(bool block, PyObject* owner);
+
+ private:
+  friend class InterpreterWrapper;
+
+  const PyObject* model_;
+  const size_t arena_size_;
+  std::unique_ptr<tflite::ErrorReporter> error_reporter_;
   const tflite::AllOpsResolver all_ops_resolver_;
+  std::unique_ptr<InterpreterPool> pool_;
 };
 
 }  // namespace tflite
@@ -18,6 +18,7 @@ limitations under the License.
 #include "tensorflow/lite/micro/python/interpreter/src/interpreter_wrapper.h"
 
 namespace py = pybind11;
+using tflite::InterpreterPoolWrapper;
 using tflite::InterpreterWrapper;
 
 PYBIND11_MODULE(interpreter_wrapper_pybind, m) {
@@ -28,7 +29,14 @@ PYBIND11_MODULE(interpreter_wrapper_pybind, m) {
         return std::unique_ptr<InterpreterWrapper>(
             new InterpreterWrapper(data.ptr(), arena_size));
       }))
-      .def("Invoke", &InterpreterWrapper::Invoke)
+      .def("Invoke",
+           [](InterpreterWrapper& self) {
+             int status = self.Invoke();
+             if (PyErr_Occurred()) {
+               throw py::error_already_set();
+             }
+             return status;
+           })
       .def(
           "SetInputTensor",
           [](InterpreterWrapper& self, py::handle& x, size_t index) {
@@ -41,5 +49,57 @@ PYBIND11_MODULE(interpreter_wrapper_pybind, m) {
             return py::reinterpret_steal<py::object>(
                 self.GetOutputTensor(index));
           },
-          py::arg("index"));
+          py::arg("index"))
+      .def(
+          "GetInputTensorView",
+          [](py::object self, size_t index) {
+            return py::reinterpret_steal<py::object>(
+                self.cast<InterpreterWrapper&>().GetInputTensorView(
+                    index, self.ptr()));
+          },
+          py::arg("index"))
+      .def(
+          "GetOutputTensorView",
+          [](py::object self, size_t index) {
+            return py::reinterpret_steal<py::object>(
+                self.cast<InterpreterWrapper&>().GetOutputTensorView(
+                    index, self.ptr()));
+          },
+          py::arg("index"))
+      .def(
+          "EvaluateBatch",
+          [](InterpreterWrapper& self, py::handle& inputs, int num_threads) {
+            PyObject* outputs = self.EvaluateBatch(inputs.ptr(), num_threads);
+            if (outputs == nullptr) {
+              throw py::error_already_set();
+            }
+            return py::reinterpret_steal<py::object>(outputs);
+          },
+          py::arg("inputs"), py::arg("num_threads"))
+      .def("Release", &InterpreterWrapper::Release);
+
+  py::class_<InterpreterPoolWrapper>(m, "InterpreterPoolWrapper")
+      .def(py::init([](const py::bytes& data, size_t arena_size,
+                       int num_interpreters) {
+        return std::unique_ptr<InterpreterPoolWrapper>(
+            new InterpreterPoolWrapper(data.ptr(), arena_size,
+                                       num_interpreters));
+      }))
+      .def("Size", &InterpreterPoolWrapper::size)
+      .def(
+          "Acquire",
+          [](py::object self, bool block) -> py::object {
+            InterpreterWrapper* interpreter =
+                self.cast<InterpreterPoolWrapper&>().Acquire(block,
+                                                             self.ptr());
+            if (interpreter == nullptr) {
+              if (PyErr_Occurred()) {
+                throw py::error_already_set();
+              }
+              return py::none();
+            }
+            return py::cast(interpreter,
+                            py::return_value_policy::take_ownership);
+          },
+          py::arg("block"));
 }
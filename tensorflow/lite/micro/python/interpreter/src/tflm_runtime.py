@@ -14,6 +14,7 @@
 # ==============================================================================
 """Python package for TFLM Python Interpreter"""
 
+import contextlib
 import os
 
 from tflite_micro.tensorflow.lite.micro.python.interpreter.src import interpreter_wrapper_pybind
@@ -25,6 +26,12 @@ class Interpreter(object):
     self._interpreter = interpreter_wrapper_pybind.InterpreterWrapper(
         model_data, arena_size)
 
+  @classmethod
+  def _from_wrapper(cls, wrapper):
+    interpreter = cls.__new__(cls)
+    interpreter._interpreter = wrapper
+    return interpreter
+
   @classmethod
   def from_file(self, model_path, arena_size=None):
     """
@@ -76,6 +83,13 @@ class Interpreter(object):
 
     This should be called after `set_input()`.
 
+    The GIL is released during the inference, so different interpreters can be
+    invoked concurrently from several Python threads. `invoke()`,
+    `set_input()`, `get_output()` and `evaluate_batch()` calls on the same
+    interpreter are serialized. Reads and writes through the arrays of
+    `get_input_view()` and `get_output_view()` are not, and must not happen
+    while another thread may be in `invoke()`.
+
     Returns:
       Status code of the C++ invoke function. A RuntimeError will be raised as
       well upon any error.
@@ -121,3 +135,163 @@ class Interpreter(object):
       raise ValueError("Index must be a non-negative integer")
 
     return self._interpreter.GetOutputTensor(index)
+
+  def evaluate_batch(self, inputs, num_threads=1):
+    """
+    Run one inference per sample of a batch.
+
+    This replaces a loop of `set_input()`, `invoke()` and `get_output()` calls.
+    The loop over the samples runs in C++. The samples are copied straight
+    into the tensor arena, and the outputs into preallocated arrays.
+
+    Args:
+      inputs: Stacked input samples, each of the input tensor's shape, as a
+        numpy array of shape (num_samples, *input_shape). For a model with
+        several inputs, a list with one such array per input, in the order of
+        the inputs in the .tflite model.
+      num_threads: Number of threads to evaluate the batch on. With more than
+        one thread, the samples are split over this interpreter and clones of
+        it, which are created on first use and each have their own tensor
+        arena. The clones don't share variable tensors, so this only gives the
+        same results as a sequential loop for models without state.
+
+    Returns:
+      The stacked outputs, as a numpy array of shape
+      (num_samples, *output_shape). For a model with several outputs, a list
+      with one such array per output.
+    """
+    if inputs is None:
+      raise ValueError("Inputs must not be None")
+    if num_threads is None or num_threads < 1:
+      raise ValueError("Number of threads must be a positive integer")
+
+    if not isinstance(inputs, (list, tuple)):
+      inputs = [inputs]
+    outputs = self._interpreter.EvaluateBatch(inputs, num_threads)
+    return outputs[0] if len(outputs) == 1 else outputs
+
+  def get_input_view(self, index):
+    """
+    Get a writeable numpy array that aliases the input tensor's buffer.
+
+    Writing into the array sets the input without the copy in `set_input()`.
+    The array keeps the interpreter alive and stays valid for its lifetime,
+    but an inference may reuse the buffer for intermediate results, so the
+    input must be written again before every `invoke()`. Writes to the array
+    are not synchronized with `invoke()`, so don't write it while another
+    thread may be invoking this interpreter.
+
+    Args:
+      index: An integer between 0 and the number of input tensors (exclusive)
+        consistent with the order defined in the list of inputs in the .tflite
+        model
+
+    Returns:
+      A numpy array with the shape and type of the input tensor.
+    """
+    if index is None or index < 0:
+      raise ValueError("Index must be a non-negative integer")
+
+    return self._interpreter.GetInputTensorView(index)
+
+  def get_output_view(self, index):
+    """
+    Get a read-only numpy array that aliases the output tensor's buffer.
+
+    Unlike `get_output()`, the data are not copied. The array keeps the
+    interpreter alive, but it only holds the output of the most recent
+    `invoke()` until the next write to an input or the next `invoke()`, which
+    may overwrite the buffer. Copy the array to keep the data for longer.
+    Reads from the array are not synchronized with `invoke()`, so don't read
+    it while another thread may be invoking this interpreter.
+
+    Args:
+      index: An integer between 0 and the number of output tensors (exclusive)
+        consistent with the order defined in the list of outputs in the .tflite
+        model
+
+    Returns:
+      A read-only numpy array with the shape and type of the output tensor.
+    """
+    if index is None or index < 0:
+      raise ValueError("Index must be a non-negative integer")
+
+    return self._interpreter.GetOutputTensorView(index)
+
+
+class InterpreterPool(object):
+  """
+  A fixed set of interpreters for one model, for threads that serve
+  concurrent requests.
+
+  Each interpreter has its own tensor arena. The first one is allocated with
+  `arena_size` bytes, the others with only as much as it actually used. A
+  thread acquires an interpreter, uses it like any other `Interpreter`, and
+  releases it for other threads:
+
+    with pool.interpreter() as interpreter:
+      interpreter.set_input(data, 0)
+      interpreter.invoke()
+      output = interpreter.get_output(0)
+  """
+
+  def __init__(self, model_data, num_interpreters, arena_size=None):
+    """
+    Args:
+      model_data: Model in byte array format
+      num_interpreters: Number of interpreters in the pool
+      arena_size: Tensor arena size in bytes for the first interpreter. If
+        unused, tensor arena size will default to 10 times the model size.
+    """
+    if model_data is None:
+      raise ValueError("Model must not be None")
+    if num_interpreters is None or num_interpreters < 1:
+      raise ValueError("Number of interpreters must be a positive integer")
+
+    if arena_size is None:
+      arena_size = len(model_data) * 10
+
+    self._pool = interpreter_wrapper_pybind.InterpreterPoolWrapper(
+        model_data, arena_size, num_interpreters)
+
+  @property
+  def size(self):
+    """Number of interpreters in the pool."""
+    return self._pool.Size()
+
+  def acquire(self, block=True):
+    """
+    Acquire an idle interpreter.
+
+    Args:
+      block: Whether to wait for an interpreter to be released if all of them
+        are in use. The GIL is released while waiting.
+
+    Returns:
+      An `Interpreter`, or None if `block` is False and all interpreters are in
+      use. Pass it to `release()` when done. Its tensors keep the contents left
+      by the previous user.
+    """
+    wrapper = self._pool.Acquire(block)
+    if wrapper is None:
+      return None
+    return Interpreter._from_wrapper(wrapper)
+
+  def release(self, interpreter):
+    """
+    Return an interpreter obtained from `acquire()` to the pool.
+
+    The interpreter can't be used afterwards. Outputs obtained with
+    `get_output()` stay valid, but views from `get_input_view()` and
+    `get_output_view()` then alias the buffers of the interpreter's next user.
+    """
+    interpreter._interpreter.Release()
+
+  @contextlib.contextmanager
+  def interpreter(self):
+    """Context manager that acquires an interpreter and releases it on exit."""
+    interpreter = self.acquire()
+    try:
+      yield interpreter
+    finally:
+      self.release(interpreter)
@@ -0,0 +1,141 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/micro/python/interpreter/src/interpreter_pool.h"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "tensorflow/lite/micro/all_ops_resolver.h"
+#include "tensorflow/lite/micro/micro_error_reporter.h"
+#include "tensorflow/lite/micro/test_helpers.h"
+#include "tensorflow/lite/micro/testing/micro_test.h"
+
+namespace {
+constexpr size_t kArenaSize = 2000;
+}  // namespace
+
+TF_LITE_MICRO_TESTS_BEGIN
+
+TF_LITE_MICRO_TEST(TestAcquireAndRelease) {
+  const tflite::Model* model = tflite::testing::GetSimpleMockModel();
+  tflite::AllOpsResolver op_resolver = tflite::testing::GetOpResolver();
+
+  tflite::InterpreterPool pool(model, op_resolver, kArenaSize,
+                               /*num_interpreters=*/2,
+                               tflite::GetMicroErrorReporter());
+  TF_LITE_MICRO_EXPECT_EQ(kTfLiteOk, pool.initialization_status());
+  TF_LITE_MICRO_EXPECT_EQ(static_cast<size_t>(2), pool.size());
+  // The other interpreters only get the part of the arena that was used.
+  TF_LITE_MICRO_EXPECT_LT(pool.arena_size_per_interpreter(), kArenaSize);
+
+  tflite::MicroInterpreter* first = pool.Acquire();
+  tflite::MicroInterpreter* second = pool.TryAcquire();
+  TF_LITE_MICRO_EXPECT_NE(nullptr, first);
+  TF_LITE_MICRO_EXPECT_NE(nullptr, second);
+  TF_LITE_MICRO_EXPECT_NE(first, second);
+  TF_LITE_MICRO_EXPECT(pool.TryAcquire() == nullptr);
+
+  // Both interpreters work independently.
+  first->input(0)->data.i32[0] = 21;
+  second->input(0)->data.i32[0] = 5;
+  TF_LITE_MICRO_EXPECT_EQ(kTfLiteOk, first->Invoke());
+  TF_LITE_MICRO_EXPECT_EQ(kTfLiteOk, second->Invoke());
+  TF_LITE_MICRO_EXPECT_EQ(42, first->output(0)->data.i32[0]);
+  TF_LITE_MICRO_EXPECT_EQ(26, second->output(0)->data.i32[0]);
+
+  TF_LITE_MICRO_EXPECT_EQ(kTfLiteOk, pool.Release(second));
+  TF_LITE_MICRO_EXPECT(pool.TryAcquire() == second);
+  TF_LITE_MICRO_EXPECT_EQ(kTfLiteOk, pool.Release(first));
+  TF_LITE_MICRO_EXPECT_EQ(kTfLiteOk, pool.Release(second));
+}
+
+TF_LITE_MICRO_TEST(TestReleaseNotAcquired) {
+  const tflite::Model* model = tflite::testing::GetSimpleMockModel();
+  tflite::AllOpsResolver op_resolver = tflite::testing::GetOpResolver();
+
+  tflite::InterpreterPool pool(model, op_resolver, kArenaSize,
+                               /*num_interpreters=*/2,
+                               tflite::GetMicroErrorReporter());
+  TF_LITE_MICRO_EXPECT_EQ(kTfLiteOk, pool.initialization_status());
+
+  tflite::MicroInterpreter* first = pool.Acquire();
+  TF_LITE_MICRO_EXPECT_EQ(kTfLiteOk, pool.Release(first));
+  // A double release and an interpreter from elsewhere are both rejected.
+  TF_LITE_MICRO_EXPECT_EQ(kTfLiteError, pool.Release(first));
+  tflite::InterpreterPool other_pool(model, op_resolver, kArenaSize,
+                                     /*num_interpreters=*/1,
+                                     tflite::GetMicroErrorReporter());
+  tflite::MicroInterpreter* foreign = other_pool.Acquire();
+  TF_LITE_MICRO_EXPECT_EQ(kTfLiteError, pool.Release(foreign));
+  TF_LITE_MICRO_EXPECT_EQ(kTfLiteError, pool.Release(nullptr));
+
+  // The pool still hands out each of its interpreters exactly once.
+  tflite::MicroInterpreter* a = pool.TryAcquire();
+  tflite::MicroInterpreter* b = pool.TryAcquire();
+  TF_LITE_MICRO_EXPECT_NE(nullptr, a);
+  TF_LITE_MICRO_EXPECT_NE(nullptr, b);
+  TF_LITE_MICRO_EXPECT_NE(a, b);
+  TF_LITE_MICRO_EXPECT(pool.TryAcquire() == nullptr);
+}
+
+TF_LITE_MICRO_TEST(TestConcurrentUse) {
+  const tflite::Model* model = tflite::testing::GetSimpleMockModel();
+  tflite::AllOpsResolver op_resolver = tflite::testing::GetOpResolver();
+
+  tflite::InterpreterPool pool(model, op_resolver, kArenaSize,
+                               /*num_interpreters=*/2,
+                               tflite::GetMicroErrorReporter());
+  TF_LITE_MICRO_EXPECT_EQ(kTfLiteOk, pool.initialization_status());
+
+  // More threads than interpreters, so that Acquire() has to wait.
+  constexpr int kNumThreads = 4;
+  std::atomic<int> num_failures(0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&pool, &num_failures, t] {
+      for (int i = 0; i < 100; ++i) {
+        tflite::MicroInterpreter* interpreter = pool.Acquire();
+        const int32_t value = t * 1000 + i;
+        interpreter->input(0)->data.i32[0] = value;
+        if (interpreter->Invoke() != kTfLiteOk ||
+            interpreter->output(0)->data.i32[0] != value + 21) {
+          ++num_failures;
+        }
+        pool.Release(interpreter);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  TF_LITE_MICRO_EXPECT_EQ(0, num_failures.load());
+}
+
+TF_LITE_MICRO_TEST(TestArenaTooSmall) {
+  const tflite::Model* model = tflite::testing::GetSimpleMockModel();
+  tflite::AllOpsResolver op_resolver = tflite::testing::GetOpResolver();
+
+  tflite::InterpreterPool pool(model, op_resolver, /*arena_size=*/16,
+                               /*num_interpreters=*/2,
+                               tflite::GetMicroErrorReporter());
+  TF_LITE_MICRO_EXPECT_EQ(kTfLiteError, pool.initialization_status());
+  TF_LITE_MICRO_EXPECT(pool.Acquire() == nullptr);
+  TF_LITE_MICRO_EXPECT(pool.TryAcquire() == nullptr);
+}
+
+TF_LITE_MICRO_TESTS_END
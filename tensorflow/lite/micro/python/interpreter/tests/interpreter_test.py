@@ -23,6 +23,7 @@
 # 3. (gdb) run bazel-out/k8-fastbuild/bin/tensorflow/lite/micro/python/interpreter/tests/interpreter_test
 
 import gc
+import threading
 import numpy as np
 import tensorflow as tf
 import weakref
@@ -121,6 +122,161 @@ class ConvModelTests(test_util.TensorFlowTestCase):
         self.assertEqual(output.shape, self.output_shape)
         self.assertAllEqual(output, prev_output)
 
+  def testThreadedInvoke(self):
+    model_data = generate_test_models.generate_conv_model(False)
+    num_threads = 4
+    interpreters = [
+        tflm_runtime.Interpreter.from_bytes(model_data)
+        for i in range(num_threads)
+    ]
+    data_x = [
+        np.random.randint(-127, 127, self.input_shape, dtype=np.int8)
+        for i in range(num_threads)
+    ]
+
+    expected = []
+    for interpreter, x in zip(interpreters, data_x):
+      interpreter.set_input(x, 0)
+      interpreter.invoke()
+      expected.append(interpreter.get_output(0))
+
+    outputs = [None] * num_threads
+
+    def run(i):
+      for _ in range(20):
+        interpreters[i].set_input(data_x[i], 0)
+        interpreters[i].invoke()
+        outputs[i] = interpreters[i].get_output(0)
+
+    threads = [
+        threading.Thread(target=run, args=(i,)) for i in range(num_threads)
+    ]
+    for thread in threads:
+      thread.start()
+    for thread in threads:
+      thread.join()
+
+    for i in range(num_threads):
+      self.assertAllEqual(outputs[i], expected[i])
+
+  def testTensorViews(self):
+    model_data = generate_test_models.generate_conv_model(False)
+    view_interpreter = tflm_runtime.Interpreter.from_bytes(model_data)
+    copy_interpreter = tflm_runtime.Interpreter.from_bytes(model_data)
+
+    input_view = view_interpreter.get_input_view(0)
+    output_view = view_interpreter.get_output_view(0)
+    self.assertDTypeEqual(input_view, np.int8)
+    self.assertEqual(input_view.shape, self.input_shape)
+    self.assertDTypeEqual(output_view, np.int8)
+    self.assertEqual(output_view.shape, self.output_shape)
+    self.assertFalse(output_view.flags.writeable)
+
+    num_steps = 10
+    for i in range(0, num_steps):
+      data_x = np.random.randint(-127, 127, self.input_shape, dtype=np.int8)
+
+      input_view[...] = data_x
+      view_interpreter.invoke()
+
+      copy_interpreter.set_input(data_x, 0)
+      copy_interpreter.invoke()
+
+      # The views alias the same buffers across invocations.
+      self.assertAllEqual(output_view, copy_interpreter.get_output(0))
+      self.assertAllEqual(view_interpreter.get_output(0), output_view)
+
+  def testEvaluateBatch(self):
+    model_data = generate_test_models.generate_conv_model(False)
+    interpreter = tflm_runtime.Interpreter.from_bytes(model_data)
+
+    num_samples = 25
+    inputs = np.random.randint(-127,
+                               127, (num_samples,) + self.input_shape,
+                               dtype=np.int8)
+    expected = []
+    for x in inputs:
+      interpreter.set_input(x, 0)
+      interpreter.invoke()
+      expected.append(interpreter.get_output(0))
+
+    for num_threads in [1, 3]:
+      outputs = interpreter.evaluate_batch(inputs, num_threads=num_threads)
+      self.assertDTypeEqual(outputs, np.int8)
+      self.assertEqual(outputs.shape, (num_samples,) + self.output_shape)
+      self.assertAllEqual(outputs, np.stack(expected))
+
+    # The samples must be stacked along a new leading dimension.
+    with self.assertRaises(ValueError):
+      interpreter.evaluate_batch(inputs[0])
+
+  def testInterpreterPool(self):
+    model_data = generate_test_models.generate_conv_model(False)
+    reference = tflm_runtime.Interpreter.from_bytes(model_data)
+    pool = tflm_runtime.InterpreterPool(model_data, num_interpreters=2)
+    self.assertEqual(pool.size, 2)
+
+    first = pool.acquire()
+    second = pool.acquire(block=False)
+    self.assertIsNotNone(first)
+    self.assertIsNotNone(second)
+    self.assertIsNone(pool.acquire(block=False))
+    pool.release(second)
+    with self.assertRaises(RuntimeError):
+      second.invoke()
+    pool.release(first)
+
+    data_x = [
+        np.random.randint(-127, 127, self.input_shape, dtype=np.int8)
+        for i in range(8)
+    ]
+    expected = []
+    for x in data_x:
+      reference.set_input(x, 0)
+      reference.invoke()
+      expected.append(reference.get_output(0))
+
+    # More threads than interpreters, so that acquire() has to wait.
+    outputs = [None] * len(data_x)
+
+    def run(i):
+      with pool.interpreter() as interpreter:
+        interpreter.set_input(data_x[i], 0)
+        interpreter.invoke()
+        outputs[i] = interpreter.get_output(0)
+
+    threads = [
+        threading.Thread(target=run, args=(i,)) for i in range(len(data_x))
+    ]
+    for thread in threads:
+      thread.start()
+    for thread in threads:
+      thread.join()
+
+    for output, expected_output in zip(outputs, expected):
+      self.assertAllEqual(output, expected_output)
+
+  def _helperTensorViewLifetime(self):
+    interpreter = tflm_runtime.Interpreter.from_file(self.filename)
+    int_ref = weakref.finalize(interpreter, self._helperNoop)
+    output_view = interpreter.get_output_view(0)
+    return (int_ref, output_view)
+
+  def testTensorViewLifetime(self):
+    generate_test_models.generate_conv_model(True, self.filename)
+
+    int_ref, output_view = self._helperTensorViewLifetime()
+    # The view keeps the interpreter, and therefore its arena, alive.
+    gc.collect()
+    self.assertTrue(int_ref.alive)
+    self.assertEqual(output_view.shape, self.output_shape)
+
+    output_ref = weakref.finalize(output_view, self._helperNoop)
+    del output_view
+    gc.collect()
+    self.assertFalse(output_ref.alive)
+    self.assertFalse(int_ref.alive)
+
   def _helperNoop(self):
     pass
 
@@ -22,6 +22,7 @@ limitations under the License.
 #include "tensorflow/lite/micro/memory_helpers.h"
 #include "tensorflow/lite/micro/memory_planner/greedy_memory_planner.h"
 #include "tensorflow/lite/micro/micro_allocator.h"
+#include "tensorflow/lite/micro/micro_arena_constants.h"
 #include "tensorflow/lite/micro/micro_error_reporter.h"
 
 namespace tflite {
@@ -45,10 +46,11 @@ size_t RecordingMicroAllocator::GetDefaultTailUsage() {
 
 RecordingMicroAllocator::RecordingMicroAllocator(
     RecordingSimpleMemoryAllocator* recording_memory_allocator,
-    MicroMemoryPlanner* memory_planner, ErrorReporter* error_reporter)
+    GreedyMemoryPlanner* memory_planner, ErrorReporter* error_reporter)
     : MicroAllocator(recording_memory_allocator, memory_planner,
                      error_reporter),
-      recording_memory_allocator_(recording_memory_allocator) {}
+      recording_memory_allocator_(recording_memory_allocator),
+      recording_memory_planner_(memory_planner) {}
 
 RecordingMicroAllocator* RecordingMicroAllocator::Create(
     uint8_t* tensor_arena, size_t arena_size, ErrorReporter* error_reporter) {
@@ -101,6 +103,30 @@ RecordingMicroAllocator::GetSimpleMemoryAllocator() const {
   return recording_memory_allocator_;
 }
 
+size_t RecordingMicroAllocator::GetMinimumArenaSize() const {
+  size_t min_arena_size = recording_memory_allocator_->GetMaxUsedBytes();
+
+  // The memory planner is handed all of the remaining arena while the plan is
+  // created, but only needs room for the buffers it was given.
+  const size_t planner_offset =
+      recording_memory_allocator_->GetRemainingMemoryClaimOffset();
+  if (planner_offset > 0) {
+    const size_t planner_bytes = AlignSizeUp(
+        recording_memory_planner_->GetBufferCount() *
+            GreedyMemoryPlanner::per_buffer_size(),
+        MicroArenaBufferAlignment());
+    if (planner_offset + planner_bytes > min_arena_size) {
+      min_arena_size = planner_offset + planner_bytes;
+    }
+  }
+
+  // The recording classes are larger than the ones they stand in for.
+  min_arena_size -= GetDefaultTailUsage() -
+                    MicroAllocator::GetDefaultTailUsage(
+                        /*is_memory_planner_given=*/false);
+  return AlignSizeUp(min_arena_size, MicroArenaBufferAlignment());
+}
+
 void RecordingMicroAllocator::PrintAllocations() const {
   TF_LITE_REPORT_ERROR(
       error_reporter(),
@@ -18,6 +18,7 @@ limitations under the License.
 
 #include "tensorflow/lite/micro/arena_allocator/recording_simple_memory_allocator.h"
 #include "tensorflow/lite/micro/compatibility.h"
+#include "tensorflow/lite/micro/memory_planner/greedy_memory_planner.h"
 #include "tensorflow/lite/micro/micro_allocator.h"
 
 namespace tflite {
@@ -67,6 +68,14 @@ class RecordingMicroAllocator : public MicroAllocator {
 
   const RecordingSimpleMemoryAllocator* GetSimpleMemoryAllocator() const;
 
+  // Returns the smallest arena size in bytes that the allocations recorded so
+  // far would fit in when made through a MicroAllocator created with the
+  // default GreedyMemoryPlanner. This accounts for the peak temp usage and the
+  // scratch space needed by the memory planner, and excludes the overhead of
+  // the recording classes. The arena is assumed to be aligned to
+  // MicroArenaBufferAlignment(). Only meaningful after FinishModelAllocation().
+  size_t GetMinimumArenaSize() const;
+
   // Logs out through the ErrorReporter all allocation recordings by type
   // defined in RecordedAllocationType.
   void PrintAllocations() const;
@@ -95,7 +104,7 @@ class RecordingMicroAllocator : public MicroAllocator {
 
  private:
   RecordingMicroAllocator(RecordingSimpleMemoryAllocator* memory_allocator,
-                          MicroMemoryPlanner* memory_planner,
+                          GreedyMemoryPlanner* memory_planner,
                           ErrorReporter* error_reporter);
 
   void PrintRecordedAllocation(RecordedAllocationType allocation_type,
@@ -107,6 +116,7 @@ class RecordingMicroAllocator : public MicroAllocator {
                              RecordedAllocation& recorded_allocation);
 
   const RecordingSimpleMemoryAllocator* recording_memory_allocator_;
+  GreedyMemoryPlanner* recording_memory_planner_;
 
   RecordedAllocation recorded_tflite_eval_tensor_data_ = {};
   RecordedAllocation recorded_persistent_tflite_tensor_data_ = {};
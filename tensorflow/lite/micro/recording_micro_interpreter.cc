@@ -0,0 +1,82 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/micro/recording_micro_interpreter.h"
+
+#include "tensorflow/lite/kernels/internal/compatibility.h"
+#include "tensorflow/lite/micro/memory_helpers.h"
+#include "tensorflow/lite/micro/micro_arena_constants.h"
+#include "tensorflow/lite/micro/recording_micro_allocator.h"
+
+namespace tflite {
+
+TfLiteStatus RecordingMicroInterpreter::GetArenaRequirements(
+    const Model* model, const MicroOpResolver& op_resolver,
+    uint8_t* scratch_arena, size_t scratch_arena_size,
+    ErrorReporter* error_reporter, ArenaRequirements* requirements) {
+  TFLITE_DCHECK(requirements != nullptr);
+
+  // Align both ends of the scratch arena so that head and tail allocations are
+  // padded exactly as they would be in an aligned production arena.
+  uint8_t* aligned_arena =
+      AlignPointerUp(scratch_arena, MicroArenaBufferAlignment());
+  uint8_t* aligned_arena_end = AlignPointerDown(
+      scratch_arena + scratch_arena_size, MicroArenaBufferAlignment());
+  if (aligned_arena_end <= aligned_arena) {
+    TF_LITE_REPORT_ERROR(error_reporter,
+                         "Scratch arena of %u bytes is too small",
+                         static_cast<unsigned int>(scratch_arena_size));
+    return kTfLiteError;
+  }
+
+  RecordingMicroAllocator* allocator = RecordingMicroAllocator::Create(
+      aligned_arena, aligned_arena_end - aligned_arena, error_reporter);
+  RecordingMicroInterpreter interpreter(model, op_resolver, allocator,
+                                        error_reporter);
+  TF_LITE_ENSURE_STATUS(interpreter.AllocateTensors());
+
+  const RecordingSimpleMemoryAllocator* memory_allocator =
+      allocator->GetSimpleMemoryAllocator();
+  requirements->arena_size = allocator->GetMinimumArenaSize();
+  requirements->non_persistent_bytes =
+      memory_allocator->GetNonPersistentUsedBytes();
+  requirements->persistent_bytes =
+      memory_allocator->GetPersistentUsedBytes() -
+      (RecordingMicroAllocator::GetDefaultTailUsage() -
+       MicroAllocator::GetDefaultTailUsage(
+           /*is_memory_planner_given=*/false));
+
+  requirements->tflite_eval_tensor_data = allocator->GetRecordedAllocation(
+      RecordedAllocationType::kTfLiteEvalTensorData);
+  requirements->persistent_tflite_tensor_data =
+      allocator->GetRecordedAllocation(
+          RecordedAllocationType::kPersistentTfLiteTensorData);
+  requirements->persistent_tflite_tensor_quantization_data =
+      allocator->GetRecordedAllocation(
+          RecordedAllocationType::kPersistentTfLiteTensorQuantizationData);
+  requirements->persistent_buffer_data = allocator->GetRecordedAllocation(
+      RecordedAllocationType::kPersistentBufferData);
+  requirements->tflite_tensor_variable_buffer_data =
+      allocator->GetRecordedAllocation(
+          RecordedAllocationType::kTfLiteTensorVariableBufferData);
+  requirements->node_and_registration_array =
+      allocator->GetRecordedAllocation(
+          RecordedAllocationType::kNodeAndRegistrationArray);
+  requirements->op_data =
+      allocator->GetRecordedAllocation(RecordedAllocationType::kOpData);
+  return kTfLiteOk;
+}
+
+}  // namespace tflite
@@ -21,6 +21,29 @@ limitations under the License.
 
 namespace tflite {
 
+// Arena usage of a model as measured by
+// RecordingMicroInterpreter::GetArenaRequirements().
+struct ArenaRequirements {
+  // Smallest tensor_arena_size that the model can be allocated in by a
+  // MicroInterpreter, for an arena aligned to MicroArenaBufferAlignment().
+  // Add MicroArenaBufferAlignment() bytes if the arena is not aligned.
+  size_t arena_size;
+  // Size of the non-persistent (head) section after AllocateTensors().
+  size_t non_persistent_bytes;
+  // Size of the persistent (tail) section after AllocateTensors(), excluding
+  // the overhead of the recording classes.
+  size_t persistent_bytes;
+
+  // Breakdown of the allocations recorded by RecordingMicroAllocator.
+  RecordedAllocation tflite_eval_tensor_data;
+  RecordedAllocation persistent_tflite_tensor_data;
+  RecordedAllocation persistent_tflite_tensor_quantization_data;
+  RecordedAllocation persistent_buffer_data;
+  RecordedAllocation tflite_tensor_variable_buffer_data;
+  RecordedAllocation node_and_registration_array;
+  RecordedAllocation op_data;
+};
+
 // Utility subclass that enables internal recordings of the MicroInterpreter.
 // This class should be used to audit and analyze memory arena usage for a given
 // model and interpreter.
@@ -61,6 +84,17 @@ class RecordingMicroInterpreter : public MicroInterpreter {
     return recording_micro_allocator_;
   }
 
+  // Allocates `model` once inside `scratch_arena` and fills `requirements`
+  // with the exact arena size a MicroInterpreter needs for it, so that
+  // production builds do not have to guess kTensorArenaSize. The scratch arena
+  // only has to be large enough to hold the model; on hosts a generously sized
+  // buffer can be used and grown on failure. Nothing allocated in the scratch
+  // arena is valid after this call returns.
+  static TfLiteStatus GetArenaRequirements(
+      const Model* model, const MicroOpResolver& op_resolver,
+      uint8_t* scratch_arena, size_t scratch_arena_size,
+      ErrorReporter* error_reporter, ArenaRequirements* requirements);
+
  private:
   const RecordingMicroAllocator& recording_micro_allocator_;
 };
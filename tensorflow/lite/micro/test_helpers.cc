@@ -919,6 +919,304 @@ const Model* BuildSimpleModelWithSubgraphsAndIf() {
   return model;
 }
 
+const Model* BuildSimpleModelWithConcatenation() {
+  using flatbuffers::Offset;
+  flatbuffers::FlatBufferBuilder* builder = BuilderInstance();
+
+  constexpr size_t buffers_size = 1;
+  const Offset<Buffer> buffers[buffers_size] = {
+      CreateBuffer(*builder),
+  };
+  const int32_t branch_tensor_shape[] = {1, 2};
+  const int32_t output_tensor_shape[] = {1, 4};
+  constexpr size_t tensors_size = 4;
+  const Offset<Tensor> tensors[tensors_size] = {
+      CreateTensor(*builder, builder->CreateVector(branch_tensor_shape, 2),
+                   TensorType_FLOAT32, 0,
+                   builder->CreateString("input_tensor"), 0, false),
+      CreateTensor(*builder, builder->CreateVector(branch_tensor_shape, 2),
+                   TensorType_FLOAT32, 0,
+                   builder->CreateString("branch_tensor1"), 0, false),
+      CreateTensor(*builder, builder->CreateVector(branch_tensor_shape, 2),
+                   TensorType_FLOAT32, 0,
+                   builder->CreateString("branch_tensor2"), 0, false),
+      CreateTensor(*builder, builder->CreateVector(output_tensor_shape, 2),
+                   TensorType_FLOAT32, 0,
+                   builder->CreateString("output_tensor"), 0, false),
+  };
+
+  constexpr size_t inputs_size = 1;
+  const int32_t inputs[inputs_size] = {0};
+  constexpr size_t outputs_size = 1;
+  const int32_t outputs[outputs_size] = {3};
+  const int32_t branch1_outputs[outputs_size] = {1};
+  const int32_t branch2_outputs[outputs_size] = {2};
+  constexpr size_t concatenation_inputs_size = 2;
+  const int32_t concatenation_inputs[concatenation_inputs_size] = {1, 2};
+  constexpr size_t operators_size = 3;
+  const Offset<Operator> operators[operators_size] = {
+      CreateOperator(*builder, 0, builder->CreateVector(inputs, inputs_size),
+                     builder->CreateVector(branch1_outputs, outputs_size),
+                     BuiltinOptions_NONE),
+      CreateOperator(*builder, 0, builder->CreateVector(inputs, inputs_size),
+                     builder->CreateVector(branch2_outputs, outputs_size),
+                     BuiltinOptions_NONE),
+      CreateOperator(
+          *builder, 1,
+          builder->CreateVector(concatenation_inputs,
+                                concatenation_inputs_size),
+          builder->CreateVector(outputs, outputs_size),
+          BuiltinOptions_ConcatenationOptions,
+          CreateConcatenationOptions(*builder, 1).Union()),
+  };
+  constexpr size_t subgraphs_size = 1;
+  const Offset<SubGraph> subgraphs[subgraphs_size] = {
+      CreateSubGraph(*builder, builder->CreateVector(tensors, tensors_size),
+                     builder->CreateVector(inputs, inputs_size),
+                     builder->CreateVector(outputs, outputs_size),
+                     builder->CreateVector(operators, operators_size),
+                     builder->CreateString("test_subgraph")),
+  };
+  constexpr size_t operator_codes_size = 2;
+  const Offset<OperatorCode> operator_codes[operator_codes_size] = {
+      CreateOperatorCodeDirect(*builder, /*deprecated_builtin_code=*/0,
+                               "mock_custom",
+                               /*version=*/0, BuiltinOperator_CUSTOM),
+      CreateOperatorCodeDirect(*builder, /*deprecated_builtin_code=*/0,
+                               "concatenation",
+                               /*version=*/0, BuiltinOperator_CONCATENATION),
+  };
+  const Offset<Model> model_offset = CreateModel(
+      *builder, 0, builder->CreateVector(operator_codes, operator_codes_size),
+      builder->CreateVector(subgraphs, subgraphs_size),
+      builder->CreateString("test_model"),
+      builder->CreateVector(buffers, buffers_size));
+  FinishModelBuffer(*builder, model_offset);
+  void* model_pointer = builder->GetBufferPointer();
+  const Model* model = flatbuffers::GetRoot<Model>(model_pointer);
+  return model;
+}
+
+const Model* BuildSimpleModelWithSplits() {
+  using flatbuffers::Offset;
+  flatbuffers::FlatBufferBuilder* builder = BuilderInstance();
+
+  const int32_t axis_data[] = {1};
+  const int32_t size_splits_data[] = {2, 4};
+  constexpr size_t buffers_size = 3;
+  const Offset<Buffer> buffers[buffers_size] = {
+      CreateBuffer(*builder),
+      CreateBuffer(*builder, builder->CreateVector(
+                                 reinterpret_cast<const uint8_t*>(axis_data),
+                                 sizeof(axis_data))),
+      CreateBuffer(*builder,
+                   builder->CreateVector(
+                       reinterpret_cast<const uint8_t*>(size_splits_data),
+                       sizeof(size_splits_data))),
+  };
+
+  // Tensors are unnamed to keep the model small.
+  auto create_tensor = [builder](std::initializer_list<int32_t> shape,
+                                 TensorType type, uint32_t buffer) {
+    return CreateTensor(*builder,
+                        builder->CreateVector(shape.begin(), shape.size()),
+                        type, buffer, 0, 0, false);
+  };
+  constexpr size_t tensors_size = 17;
+  const Offset<Tensor> tensors[tensors_size] = {
+      // SPLIT along axis 1 of [1, 4]: views.
+      create_tensor({1, 4}, TensorType_FLOAT32, 0),
+      create_tensor({1}, TensorType_INT32, 1),
+      create_tensor({1, 2}, TensorType_FLOAT32, 0),
+      create_tensor({1, 2}, TensorType_FLOAT32, 0),
+      // SPLIT_V into 2 and 4 along axis 1 of [1, 6]: views.
+      create_tensor({1, 6}, TensorType_FLOAT32, 0),
+      create_tensor({2}, TensorType_INT32, 2),
+      create_tensor({1, 2}, TensorType_FLOAT32, 0),
+      create_tensor({1, 4}, TensorType_FLOAT32, 0),
+      // UNPACK along axis 0 of [2, 3]: views.
+      create_tensor({2, 3}, TensorType_FLOAT32, 0),
+      create_tensor({3}, TensorType_FLOAT32, 0),
+      create_tensor({3}, TensorType_FLOAT32, 0),
+      // SPLIT along axis 1 of [2, 4]: the slices are not contiguous.
+      create_tensor({2, 4}, TensorType_FLOAT32, 0),
+      create_tensor({2, 2}, TensorType_FLOAT32, 0),
+      create_tensor({2, 2}, TensorType_FLOAT32, 0),
+      // UNPACK along axis 0 of [2, 2]: the second slice is a subgraph output.
+      create_tensor({2, 2}, TensorType_FLOAT32, 0),
+      create_tensor({2}, TensorType_FLOAT32, 0),
+      create_tensor({2}, TensorType_FLOAT32, 0),
+  };
+
+  constexpr size_t inputs_size = 5;
+  const int32_t inputs[inputs_size] = {0, 4, 8, 11, 14};
+  constexpr size_t outputs_size = 1;
+  const int32_t outputs[outputs_size] = {16};
+  const int32_t split_inputs[] = {1, 0};
+  const int32_t split_outputs[] = {2, 3};
+  const int32_t split_v_inputs[] = {4, 5, 1};
+  const int32_t split_v_outputs[] = {6, 7};
+  const int32_t unpack_inputs[] = {8};
+  const int32_t unpack_outputs[] = {9, 10};
+  const int32_t outer_split_inputs[] = {1, 11};
+  const int32_t outer_split_outputs[] = {12, 13};
+  const int32_t output_unpack_inputs[] = {14};
+  const int32_t output_unpack_outputs[] = {15, 16};
+  constexpr size_t operators_size = 5;
+  const Offset<Operator> operators[operators_size] = {
+      CreateOperator(*builder, 0, builder->CreateVector(split_inputs, 2),
+                     builder->CreateVector(split_outputs, 2),
+                     BuiltinOptions_SplitOptions,
+                     CreateSplitOptions(*builder, 2).Union()),
+      CreateOperator(*builder, 1, builder->CreateVector(split_v_inputs, 3),
+                     builder->CreateVector(split_v_outputs, 2),
+                     BuiltinOptions_SplitVOptions,
+                     CreateSplitVOptions(*builder, 2).Union()),
+      CreateOperator(*builder, 2, builder->CreateVector(unpack_inputs, 1),
+                     builder->CreateVector(unpack_outputs, 2),
+                     BuiltinOptions_UnpackOptions,
+                     CreateUnpackOptions(*builder, 2, 0).Union()),
+      CreateOperator(*builder, 0, builder->CreateVector(outer_split_inputs, 2),
+                     builder->CreateVector(outer_split_outputs, 2),
+                     BuiltinOptions_SplitOptions,
+                     CreateSplitOptions(*builder, 2).Union()),
+      CreateOperator(*builder, 2,
+                     builder->CreateVector(output_unpack_inputs, 1),
+                     builder->CreateVector(output_unpack_outputs, 2),
+                     BuiltinOptions_UnpackOptions,
+                     CreateUnpackOptions(*builder, 2, 0).Union()),
+  };
+  constexpr size_t subgraphs_size = 1;
+  const Offset<SubGraph> subgraphs[subgraphs_size] = {
+      CreateSubGraph(*builder, builder->CreateVector(tensors, tensors_size),
+                     builder->CreateVector(inputs, inputs_size),
+                     builder->CreateVector(outputs, outputs_size),
+                     builder->CreateVector(operators, operators_size),
+                     builder->CreateString("test_subgraph")),
+  };
+  constexpr size_t operator_codes_size = 3;
+  const Offset<OperatorCode> operator_codes[operator_codes_size] = {
+      CreateOperatorCodeDirect(*builder, /*deprecated_builtin_code=*/0,
+                               "split",
+                               /*version=*/0, BuiltinOperator_SPLIT),
+      CreateOperatorCodeDirect(*builder, /*deprecated_builtin_code=*/0,
+                               "split_v",
+                               /*version=*/0, BuiltinOperator_SPLIT_V),
+      CreateOperatorCodeDirect(*builder, /*deprecated_builtin_code=*/0,
+                               "unpack",
+                               /*version=*/0, BuiltinOperator_UNPACK),
+  };
+  const Offset<Model> model_offset = CreateModel(
+      *builder, 0, builder->CreateVector(operator_codes, operator_codes_size),
+      builder->CreateVector(subgraphs, subgraphs_size),
+      builder->CreateString("test_model"),
+      builder->CreateVector(buffers, buffers_size));
+  FinishModelBuffer(*builder, model_offset);
+  void* model_pointer = builder->GetBufferPointer();
+  const Model* model = flatbuffers::GetRoot<Model>(model_pointer);
+  return model;
+}
+
+const Model* BuildSimpleModelWithSplitAndConcatenation() {
+  using flatbuffers::Offset;
+  flatbuffers::FlatBufferBuilder* builder = BuilderInstance();
+
+  const int32_t axis_data[] = {1};
+  constexpr size_t buffers_size = 2;
+  const Offset<Buffer> buffers[buffers_size] = {
+      CreateBuffer(*builder),
+      CreateBuffer(*builder, builder->CreateVector(
+                                 reinterpret_cast<const uint8_t*>(axis_data),
+                                 sizeof(axis_data))),
+  };
+  const int32_t whole_tensor_shape[] = {1, 4};
+  const int32_t half_tensor_shape[] = {1, 2};
+  const int32_t axis_tensor_shape[] = {1};
+  constexpr size_t tensors_size = 7;
+  const Offset<Tensor> tensors[tensors_size] = {
+      CreateTensor(*builder, builder->CreateVector(whole_tensor_shape, 2),
+                   TensorType_FLOAT32, 0,
+                   builder->CreateString("input_tensor"), 0, false),
+      CreateTensor(*builder, builder->CreateVector(axis_tensor_shape, 1),
+                   TensorType_INT32, 1, builder->CreateString("axis_tensor"),
+                   0, false),
+      CreateTensor(*builder, builder->CreateVector(half_tensor_shape, 2),
+                   TensorType_FLOAT32, 0, builder->CreateString("split1"), 0,
+                   false),
+      CreateTensor(*builder, builder->CreateVector(half_tensor_shape, 2),
+                   TensorType_FLOAT32, 0, builder->CreateString("split2"), 0,
+                   false),
+      CreateTensor(*builder, builder->CreateVector(half_tensor_shape, 2),
+                   TensorType_FLOAT32, 0, builder->CreateString("neg1"), 0,
+                   false),
+      CreateTensor(*builder, builder->CreateVector(half_tensor_shape, 2),
+                   TensorType_FLOAT32, 0, builder->CreateString("neg2"), 0,
+                   false),
+      CreateTensor(*builder, builder->CreateVector(whole_tensor_shape, 2),
+                   TensorType_FLOAT32, 0,
+                   builder->CreateString("output_tensor"), 0, false),
+  };
+
+  constexpr size_t inputs_size = 1;
+  const int32_t inputs[inputs_size] = {0};
+  constexpr size_t outputs_size = 1;
+  const int32_t outputs[outputs_size] = {6};
+  const int32_t split_inputs[] = {1, 0};
+  const int32_t split_outputs[] = {2, 3};
+  const int32_t neg1_inputs[] = {2};
+  const int32_t neg1_outputs[] = {4};
+  const int32_t neg2_inputs[] = {3};
+  const int32_t neg2_outputs[] = {5};
+  // The halves are swapped back together.
+  const int32_t concatenation_inputs[] = {5, 4};
+  constexpr size_t operators_size = 4;
+  const Offset<Operator> operators[operators_size] = {
+      CreateOperator(*builder, 0, builder->CreateVector(split_inputs, 2),
+                     builder->CreateVector(split_outputs, 2),
+                     BuiltinOptions_SplitOptions,
+                     CreateSplitOptions(*builder, 2).Union()),
+      CreateOperator(*builder, 1, builder->CreateVector(neg1_inputs, 1),
+                     builder->CreateVector(neg1_outputs, 1),
+                     BuiltinOptions_NONE),
+      CreateOperator(*builder, 1, builder->CreateVector(neg2_inputs, 1),
+                     builder->CreateVector(neg2_outputs, 1),
+                     BuiltinOptions_NONE),
+      CreateOperator(*builder, 2,
+                     builder->CreateVector(concatenation_inputs, 2),
+                     builder->CreateVector(outputs, outputs_size),
+                     BuiltinOptions_ConcatenationOptions,
+                     CreateConcatenationOptions(*builder, 1).Union()),
+  };
+  constexpr size_t subgraphs_size = 1;
+  const Offset<SubGraph> subgraphs[subgraphs_size] = {
+      CreateSubGraph(*builder, builder->CreateVector(tensors, tensors_size),
+                     builder->CreateVector(inputs, inputs_size),
+                     builder->CreateVector(outputs, outputs_size),
+                     builder->CreateVector(operators, operators_size),
+                     builder->CreateString("test_subgraph")),
+  };
+  constexpr size_t operator_codes_size = 3;
+  const Offset<OperatorCode> operator_codes[operator_codes_size] = {
+      CreateOperatorCodeDirect(*builder, /*deprecated_builtin_code=*/0,
+                               "split",
+                               /*version=*/0, BuiltinOperator_SPLIT),
+      CreateOperatorCodeDirect(*builder, /*deprecated_builtin_code=*/0, "neg",
+                               /*version=*/0, BuiltinOperator_NEG),
+      CreateOperatorCodeDirect(*builder, /*deprecated_builtin_code=*/0,
+                               "concatenation",
+                               /*version=*/0, BuiltinOperator_CONCATENATION),
+  };
+  const Offset<Model> model_offset = CreateModel(
+      *builder, 0, builder->CreateVector(operator_codes, operator_codes_size),
+      builder->CreateVector(subgraphs, subgraphs_size),
+      builder->CreateString("test_model"),
+      builder->CreateVector(buffers, buffers_size));
+  FinishModelBuffer(*builder, model_offset);
+  void* model_pointer = builder->GetBufferPointer();
+  const Model* model = flatbuffers::GetRoot<Model>(model_pointer);
+  return model;
+}
+
 const Model* BuildSimpleModelWithSubgraphsAndWhile() {
   using flatbuffers::Offset;
   flatbuffers::FlatBufferBuilder* builder = BuilderInstance();
@@ -1605,6 +1903,30 @@ const Model* GetSimpleModelWithSubgraphsAndIf() {
   return model;
 }
 
+const Model* GetSimpleModelWithConcatenation() {
+  static Model* model = nullptr;
+  if (!model) {
+    model = const_cast<Model*>(BuildSimpleModelWithConcatenation());
+  }
+  return model;
+}
+
+const Model* GetSimpleModelWithSplits() {
+  static Model* model = nullptr;
+  if (!model) {
+    model = const_cast<Model*>(BuildSimpleModelWithSplits());
+  }
+  return model;
+}
+
+const Model* GetSimpleModelWithSplitAndConcatenation() {
+  static Model* model = nullptr;
+  if (!model) {
+    model = const_cast<Model*>(BuildSimpleModelWithSplitAndConcatenation());
+  }
+  return model;
+}
+
 const Model* GetSimpleModelWithSubgraphsAndWhile() {
   static Model* model = nullptr;
   if (!model) {
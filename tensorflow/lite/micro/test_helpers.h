@@ -157,6 +157,20 @@ const Model* GetSimpleStatefulModel();
 // Returns a flatbuffer model with "if" and two subgraphs.
 const Model* GetSimpleModelWithSubgraphsAndIf();
 
+// Returns a flatbuffer model with two branches joined by a CONCATENATION along
+// the outermost non-unit axis.
+const Model* GetSimpleModelWithConcatenation();
+
+// Returns a flatbuffer model with SPLIT, SPLIT_V and UNPACK operators whose
+// outputs can be planned as views of their inputs, followed by a SPLIT whose
+// input has an outer dimension other than 1 and an UNPACK with an output that
+// is also a subgraph output, neither of which can.
+const Model* GetSimpleModelWithSplits();
+
+// Returns a flatbuffer model that splits its [1, 4] float input in two halves
+// along axis 1, negates each half and concatenates them back in swapped order.
+const Model* GetSimpleModelWithSplitAndConcatenation();
+
 // Returns a flatbuffer model with "while" and three subgraphs.
 const Model* GetSimpleModelWithSubgraphsAndWhile();
 